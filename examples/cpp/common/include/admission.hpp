@@ -0,0 +1,181 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       admission.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Per-dataset limit on the operations in flight
+ *
+ ******************************************************************************/
+#ifndef COMMON_ADMISSION_HPP_
+#define COMMON_ADMISSION_HPP_
+
+#include <climits>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <red/red_client_api.h>
+
+#include "../include/reactor.hpp"
+
+namespace common
+{
+
+/**
+ * @brief Limits applied to one dataset
+ */
+struct admission_limits_t
+{
+    unsigned max_inflight = 64;       /* Operations admitted at once */
+    unsigned max_queued   = UINT_MAX; /* Waiters before acquire() rejects */
+};
+
+/**
+ * @brief Counters of one dataset, for sizing num_ring_entries and num_buffers
+ */
+struct admission_stats_t
+{
+    uint64_t depth;       /* Operations admitted and not yet released */
+    uint64_t max_depth;   /* Highest depth seen */
+    uint64_t queued;      /* Waiters now */
+    uint64_t max_queued;  /* Most waiters seen */
+    uint64_t admitted;    /* Admissions, immediate or after waiting */
+    uint64_t waited;      /* Admissions that had to wait */
+    uint64_t wait_ns;     /* Total time admitted waiters spent queued */
+    uint64_t max_wait_ns; /* Longest time a waiter spent queued */
+    uint64_t rejected;    /* try_acquire() failures and acquire() on a full queue */
+};
+
+/**
+ * @brief Request to be admitted, queued when the dataset is at its limit
+ *
+ * Owned by the caller and left untouched until @c fn runs or cancel()
+ * succeeds. @c fn runs on the thread calling release(), outside the
+ * controller's lock, once the waiter holds its admission.
+ */
+struct admission_waiter_t
+{
+    void (*fn)(admission_waiter_t *waiter) = nullptr;
+
+    admission_waiter_t *prev        = nullptr;
+    admission_waiter_t *next        = nullptr;
+    const void         *key         = nullptr;
+    uint64_t            enqueued_ns = 0;
+    bool                queued      = false;
+};
+
+/**
+ * @brief Back-pressure for producers issuing asynchronous operations
+ *
+ * Each dataset (keyed by its rfs_dataset_hndl_t) admits up to max_inflight
+ * operations; acquire() before submitting, release() from the completion.
+ * Waiters are admitted in FIFO order. acquire() never blocks: it queues the
+ * waiter and returns, so event loops and coroutines (see common::admit() in
+ * coro.hpp) suspend instead of blocking the thread. acquire_sync() is the
+ * blocking form for synchronous callers.
+ *
+ * A controller may be shared by several threads.
+ *
+ * @code
+ * common::admission_controller_t admission({.max_inflight = 32});
+ * if (admission.try_acquire(ds) == RED_SUCCESS)
+ *     red_pwrite(oh, buf, size, off, &ret, &ucb, user); // callback calls release(ds)
+ * @endcode
+ */
+class admission_controller_t
+{
+public:
+    explicit admission_controller_t(const admission_limits_t &defaults = {});
+
+    admission_controller_t(const admission_controller_t &)            = delete;
+    admission_controller_t &operator=(const admission_controller_t &) = delete;
+
+    /**
+     * @brief Override the default limits for @p ds
+     *
+     * Raising max_inflight admits queued waiters at once; lowering it lets
+     * the operations in flight drain below the new limit.
+     */
+    void set_limits(rfs_dataset_hndl_t ds, const admission_limits_t &limits);
+
+    /**
+     * @brief Take an admission without waiting
+     *
+     * @return RED_SUCCESS, or RED_EAGAIN if the dataset is at its limit or
+     *         has waiters ahead
+     */
+    red_status_t try_acquire(rfs_dataset_hndl_t ds);
+
+    /**
+     * @brief Take an admission, queueing @p waiter when none is free
+     *
+     * @return RED_SUCCESS if admitted now (@p waiter->fn is not called),
+     *         RED_EINPROGRESS if queued (@p waiter->fn runs once admitted),
+     *         RED_EAGAIN if the queue is full
+     */
+    red_status_t acquire(rfs_dataset_hndl_t ds, admission_waiter_t *waiter);
+
+    /**
+     * @brief Remove a queued waiter
+     *
+     * @return true if it was still queued, false if it has been admitted
+     *         (its fn has run or is about to)
+     */
+    bool cancel(admission_waiter_t *waiter);
+
+    /**
+     * @brief Take an admission, waiting on the calling thread's reactor
+     *
+     * @return RED_SUCCESS, RED_EAGAIN if the queue is full, or RED_ETIMEDOUT
+     */
+    red_status_t acquire_sync(rfs_dataset_hndl_t ds, deadline_t deadline = NO_DEADLINE);
+
+    /**
+     * @brief Return an admission, admitting the next waiter if any
+     */
+    void release(rfs_dataset_hndl_t ds);
+
+    admission_stats_t stats(rfs_dataset_hndl_t ds) const;
+
+    /**
+     * @brief Visit the counters of every dataset seen so far
+     */
+    void for_each(const std::function<void(rfs_dataset_hndl_t, const admission_stats_t &)> &fn)
+        const;
+
+private:
+    struct dataset_t
+    {
+        admission_limits_t  limits;
+        admission_stats_t   stats = {};
+        admission_waiter_t *head  = nullptr;
+        admission_waiter_t *tail  = nullptr;
+    };
+
+    dataset_t &dataset(rfs_dataset_hndl_t ds);
+    void       admit(dataset_t &d);
+    void       admit_waiters(dataset_t &d, admission_waiter_t **ready);
+    static void unlink(dataset_t &d, admission_waiter_t *waiter);
+
+    mutable std::mutex                          lock;
+    admission_limits_t                          defaults;
+    std::unordered_map<const void *, dataset_t> datasets;
+};
+
+} // namespace common
+
+#endif // COMMON_ADMISSION_HPP_
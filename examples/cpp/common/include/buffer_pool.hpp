@@ -0,0 +1,238 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       buffer_pool.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Pool of registered I/O buffers with per-thread magazines
+ *
+ ******************************************************************************/
+#ifndef COMMON_BUFFER_POOL_HPP_
+#define COMMON_BUFFER_POOL_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <red/red_client_api.h>
+
+namespace common
+{
+
+/**
+ * @brief Where the pool's buffers come from
+ *
+ * alloc() returns a page-aligned buffer already registered for I/O, or
+ * nullptr; free() unregisters and frees it.
+ */
+class buffer_source_t
+{
+public:
+    virtual ~buffer_source_t() = default;
+
+    virtual void *alloc(size_t size) = 0;
+
+    virtual void free(void *buf) = 0;
+
+    /* The iomem region holding @p buf, for the zero-copy calls; none by default */
+    virtual red_iomem_hndl_t iomem(void *buf)
+    {
+        (void)buf;
+        return {nullptr};
+    }
+};
+
+/* red_client_alloc_buffer() / red_client_free_buffer() */
+buffer_source_t &red_buffer_source();
+
+/* red_client_iomem_alloc() / red_client_iomem_free() */
+buffer_source_t &red_iomem_buffer_source();
+
+/* Page-aligned heap memory registered with red_client_register_buffer() */
+buffer_source_t &registered_buffer_source();
+
+/* One red_iomem_alloc() region per buffer, whose handle leases pass on */
+buffer_source_t &red_iomem_region_source();
+
+struct buffer_pool_config_t
+{
+    size_t           buffer_size   = 1 << 20;       /* Rounded up to a page */
+    unsigned         magazine_size = 8;             /* Buffers per magazine */
+    unsigned         max_buffers   = 0;             /* Cap on live buffers, 0 for none */
+    unsigned         prealloc      = 0;             /* Buffers allocated by init() */
+    uint64_t         trim_ns       = 1000000000ull; /* Trim interval, 0 to trim only on demand */
+    buffer_source_t *source        = nullptr;       /* red_buffer_source() if not set */
+};
+
+struct buffer_pool_stats_t
+{
+    uint64_t live;        /* Buffers allocated and not yet trimmed */
+    uint64_t depot;       /* Idle buffers in the shared depot */
+    uint64_t hits;        /* Leases served from the thread's magazines */
+    uint64_t depot_hits;  /* Leases that took a magazine from the depot */
+    uint64_t allocs;      /* Buffers allocated from the source */
+    uint64_t trimmed;     /* Buffers given back to the source */
+    uint64_t failures;    /* Leases refused: source failed or max_buffers reached */
+};
+
+class buffer_pool_t;
+
+/**
+ * @brief Registered buffer owned until destroyed or reset(). Move-only.
+ */
+class buffer_lease_t
+{
+public:
+    buffer_lease_t() = default;
+    ~buffer_lease_t();
+
+    buffer_lease_t(buffer_lease_t &&other) noexcept;
+    buffer_lease_t &operator=(buffer_lease_t &&other) noexcept;
+
+    buffer_lease_t(const buffer_lease_t &)            = delete;
+    buffer_lease_t &operator=(const buffer_lease_t &) = delete;
+
+    /**
+     * @brief Give the buffer back to the pool
+     */
+    void reset();
+
+    explicit operator bool() const
+    {
+        return buf != nullptr;
+    }
+
+    void *data() const
+    {
+        return buf;
+    }
+
+    size_t size() const
+    {
+        return len;
+    }
+
+    /* The iomem region of the buffer, if its pool's source has one */
+    red_iomem_hndl_t iomem() const;
+
+private:
+    friend class buffer_pool_t;
+
+    buffer_pool_t *pool = nullptr;
+    void          *buf  = nullptr;
+    size_t         len  = 0;
+};
+
+/**
+ * @brief Fixed-size registered buffers, reused instead of registered per I/O
+ *
+ * Registering memory with the library is expensive, so an I/O path should
+ * register its buffers once and keep reusing them. Each thread holds two
+ * magazines of up to magazine_size buffers: a lease pops from the loaded one
+ * and a release pushes to it, swapping with the other when it runs empty or
+ * full. Only then is the shared depot locked, to exchange a whole magazine.
+ *
+ * Buffers left idle are trimmed against a high-water mark: every trim_ns
+ * (checked when the depot is visited) or on trim(), the buffers that stayed
+ * in the depot for the whole interval, i.e. beyond the peak demand seen in
+ * it, are given back to the source. Leases must be returned before the pool
+ * is destroyed.
+ *
+ * @code
+ * common::buffer_pool_t pool({.buffer_size = 1 << 20});
+ *
+ * common::buffer_lease_t buf;
+ * if (pool.acquire(&buf) == RED_SUCCESS)
+ *     red::red_pwrite(oh, buf.data(), buf.size(), 0, &ret, user);
+ * @endcode
+ */
+class buffer_pool_t
+{
+public:
+    explicit buffer_pool_t(const buffer_pool_config_t &cfg = {});
+    ~buffer_pool_t();
+
+    buffer_pool_t(const buffer_pool_t &)            = delete;
+    buffer_pool_t &operator=(const buffer_pool_t &) = delete;
+
+    /**
+     * @brief Allocate the configured prealloc buffers into the depot
+     */
+    red_status_t init();
+
+    /**
+     * @brief Lease a buffer of buffer_size() bytes
+     *
+     * @return RED_SUCCESS, RED_EAGAIN at max_buffers, or RED_ENOMEM if the
+     *         source failed
+     */
+    red_status_t acquire(buffer_lease_t *lease);
+
+    /**
+     * @brief Free the depot's buffers that stayed idle since the last trim
+     *
+     * @return Buffers freed
+     */
+    unsigned trim();
+
+    size_t buffer_size() const
+    {
+        return cfg.buffer_size;
+    }
+
+    buffer_pool_stats_t stats() const;
+
+private:
+    friend class buffer_lease_t;
+
+    using magazine_t = std::vector<void *>;
+
+    struct cache_t;
+    struct thread_caches_t;
+
+    cache_t     *local_cache();
+    void         release(void *buf);
+    magazine_t  *new_magazine();
+    unsigned     trim_locked(size_t keep);
+    void         maybe_trim();
+    void         detach(cache_t *c);
+
+    buffer_pool_config_t cfg;
+    buffer_source_t     *source;
+    const uint64_t       id; /* Tells caches apart once the pool is gone */
+
+    /* The depot: full magazines, empty ones, and what trimming needs */
+    mutable std::mutex        lock;
+    std::vector<magazine_t *> full;
+    std::vector<magazine_t *> empty;
+    size_t                    low_water; /* Fewest full magazines since the last trim */
+    uint64_t                  last_trim_ns;
+    uint64_t                  live;
+    uint64_t                  depot_hits;
+    uint64_t                  allocs;
+    uint64_t                  trimmed;
+    uint64_t                  failures;
+
+    /* Guarded by the cache registry lock: live caches, and the hits of the
+     * caches whose thread exited */
+    std::vector<cache_t *> caches;
+    uint64_t               retired_hits;
+};
+
+} // namespace common
+
+#endif // COMMON_BUFFER_POOL_HPP_
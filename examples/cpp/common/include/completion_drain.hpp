@@ -0,0 +1,68 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       completion_drain.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Batched draining of the calling thread's completion ring
+ *
+ ******************************************************************************/
+#ifndef COMMON_COMPLETION_DRAIN_HPP_
+#define COMMON_COMPLETION_DRAIN_HPP_
+
+#include <climits>
+#include <cstdint>
+
+namespace common
+{
+
+/* Completions pulled by a single red_client_lib_poll() call */
+constexpr unsigned DRAIN_BATCH = 32;
+
+/* Histogram buckets: 0, 1, 2-3, 4-7, ..., 64 and above */
+constexpr unsigned DRAIN_HISTOGRAM_BUCKETS = 8;
+
+/**
+ * @brief Counters describing how many completions each wakeup drained
+ */
+struct drain_stats_t
+{
+    uint64_t wakeups;        /* Calls to drain_completions() */
+    uint64_t completions;    /* Callbacks dispatched */
+    uint64_t polls;          /* red_client_lib_poll() calls issued */
+    uint64_t max_per_wakeup; /* Largest number of completions drained at once */
+    uint64_t histogram[DRAIN_HISTOGRAM_BUCKETS];
+};
+
+/**
+ * @brief Dispatch completions of the calling thread until its ring is empty
+ *
+ * Pulls up to DRAIN_BATCH completions per red_client_lib_poll() call into a
+ * stack array and runs their callbacks, repeating while full batches come
+ * back, so that completions that piled up behind one wakeup are all handled
+ * before the caller blocks again.
+ *
+ * @param[in,out] stats Optional counters updated with this wakeup's results
+ * @param[in] max_completions Stop after this many completions even if more are
+ *            ready, to bound the time spent when callbacks resubmit work
+ * @return Number of completions dispatched, or a negative red_status_t
+ */
+int drain_completions(drain_stats_t *stats           = nullptr,
+                      unsigned       max_completions = UINT_MAX);
+
+} // namespace common
+
+#endif // COMMON_COMPLETION_DRAIN_HPP_
@@ -0,0 +1,186 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       completion_pool.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Per-thread pool of completion contexts for callback based
+ *                wrappers
+ *
+ ******************************************************************************/
+#ifndef COMMON_COMPLETION_POOL_HPP_
+#define COMMON_COMPLETION_POOL_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <red/red_client_api.h>
+
+#include "../include/mpsc_queue.hpp"
+
+namespace common
+{
+
+/* Bytes of wrapper state a completion context can carry */
+constexpr size_t COMPLETION_CTX_DATA = 192;
+
+/* Contexts allocated at once when a pool runs dry */
+constexpr unsigned COMPLETION_SLAB_SIZE = 64;
+
+class completion_pool_t;
+
+/**
+ * @brief Context of one asynchronous operation
+ *
+ * Pass ucb() to the RED call. When the operation completes, the status is
+ * stored in @c rs and the continuation @c fn runs with the context, on
+ * whichever thread the library runs callbacks. The context stays valid until
+ * release(), which may be called from any thread.
+ *
+ * The ucb_arg handed to the library carries the context's generation, which
+ * changes on every release(): a callback arriving for a context that was
+ * already released (or released and reused) is counted as stale and dropped
+ * instead of running the current owner's continuation.
+ */
+struct completion_ctx_t : mpsc_node_t
+{
+    using continuation_t = void (*)(completion_ctx_t *ctx);
+
+    red_status_t   rs;
+    continuation_t fn;
+    void          *waiter; /* Free for the wrapper: promise, coroutine, flag, ... */
+
+    rfs_usercb_t *ucb()
+    {
+        return &cb;
+    }
+
+    /**
+     * @brief Construct the wrapper's state inside the context
+     */
+    template <typename T, typename... Args>
+    T *emplace(Args &&...args)
+    {
+        static_assert(sizeof(T) <= COMPLETION_CTX_DATA, "state does not fit the context");
+        static_assert(alignof(T) <= alignof(std::max_align_t), "state is over-aligned");
+        static_assert(std::is_trivially_destructible<T>::value,
+                      "state is dropped without running its destructor");
+        return new (storage) T(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    T *data()
+    {
+        return std::launder(reinterpret_cast<T *>(storage));
+    }
+
+    /**
+     * @brief Return the context to the pool it came from
+     */
+    void release();
+
+private:
+    friend class completion_pool_t;
+
+    static void dispatch(red_status_t status, void *token);
+
+    rfs_usercb_t          cb;
+    std::atomic<uint16_t> generation{0};
+    completion_pool_t    *owner     = nullptr;
+    completion_ctx_t     *next_free = nullptr;
+
+    alignas(std::max_align_t) unsigned char storage[COMPLETION_CTX_DATA];
+};
+
+/**
+ * @brief Counters of one thread's pool
+ */
+struct completion_pool_stats_t
+{
+    uint64_t acquired;     /* Contexts handed out */
+    uint64_t in_use;       /* Contexts not back on the free list */
+    uint64_t capacity;     /* Contexts allocated, in slabs of COMPLETION_SLAB_SIZE */
+    uint64_t remote_frees; /* Releases made by another thread, once collected */
+};
+
+/**
+ * @brief Per-thread free list of completion contexts
+ *
+ * acquire() pops the free list and release() from the owning thread pushes
+ * it back, both O(1) without touching the heap. Contexts released on another
+ * thread (a callback on the poller thread) go through a lock-free MPSC queue
+ * that the owner collects when its free list is empty. The heap is only used
+ * to add a slab when every context is in flight; reserve() does that ahead of
+ * time.
+ *
+ * Slabs are freed when the owning thread exits with every context returned,
+ * and are kept otherwise so that late callbacks still find valid memory.
+ */
+class completion_pool_t
+{
+public:
+    /**
+     * @brief Return the pool of the calling thread, creating it on first use
+     */
+    static completion_pool_t &local();
+
+    completion_pool_t(const completion_pool_t &)            = delete;
+    completion_pool_t &operator=(const completion_pool_t &) = delete;
+
+    /**
+     * @brief Take a context whose completion runs @p fn
+     */
+    completion_ctx_t *acquire(completion_ctx_t::continuation_t fn, void *waiter = nullptr);
+
+    /**
+     * @brief Make sure @p count contexts can be in flight without allocating
+     */
+    void reserve(size_t count);
+
+    const completion_pool_stats_t &stats() const;
+
+    /**
+     * @brief Callbacks dropped, process-wide, because their context had been
+     *        released
+     */
+    static uint64_t stale_callbacks();
+
+private:
+    friend struct completion_ctx_t;
+    struct holder_t;
+
+    completion_pool_t();
+    ~completion_pool_t() = default;
+
+    void grow();
+    void collect_remote();
+    void release(completion_ctx_t *ctx);
+
+    completion_ctx_t                                 *free_list;
+    mpsc_queue_t                                      remote;
+    std::vector<std::unique_ptr<completion_ctx_t[]>> slabs;
+    completion_pool_stats_t                           pool_stats;
+    std::atomic<int64_t>                              remote_left{0}; /* See holder_t */
+};
+
+} // namespace common
+
+#endif // COMMON_COMPLETION_POOL_HPP_
@@ -0,0 +1,167 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       completion_slot.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Completion context that can outlive a timed out caller
+ *
+ ******************************************************************************/
+#ifndef COMMON_COMPLETION_SLOT_HPP_
+#define COMMON_COMPLETION_SLOT_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <red/red_client_api.h>
+
+#include "../include/completion_pool.hpp"
+#include "../include/reactor.hpp"
+
+namespace common
+{
+
+/**
+ * @brief Process-wide counters of operations waited for with a deadline
+ */
+struct deadline_stats_t
+{
+    uint64_t timeouts;     /* Waits that gave up with RED_ETIMEDOUT */
+    uint64_t late;         /* Completions that arrived after their waiter gave up */
+    uint64_t late_closed;  /* Handles (or iomem) from late completions closed (freed) again */
+};
+
+/**
+ * @brief Snapshot of the deadline counters
+ */
+deadline_stats_t deadline_stats();
+
+/**
+ * @brief Completion context of one operation
+ *
+ * The library keeps the ucb_arg of an operation until its callback runs, so a
+ * waiter that gives up at its deadline cannot leave that pointer on its stack.
+ * Slots taken with acquire() live in a completion_ctx_t of the calling
+ * thread's completion_pool_t and are reference counted: one reference for the
+ * waiter, one for the callback. Whichever of the two settles the state first
+ * decides the outcome; the slot goes back to the pool when both are done with
+ * it.
+ *
+ * Out-parameters are staged in the slot and copied to the caller once the
+ * operation completed in time, so that a late completion only ever writes into
+ * memory the slot owns. A handle produced by a late completion is closed (and
+ * iomem freed), as nobody is left to do it: on the waiter's thread, or on the
+ * reactor's orphan thread if the waiter's thread has exited meanwhile.
+ *
+ * Slots embedded in the waiter (acquire() not used) skip all of this and are
+ * for waits without a deadline.
+ */
+struct completion_slot_t
+{
+    enum state_e
+    {
+        PENDING,
+        COMPLETED,
+        ABANDONED
+    };
+
+    /* What to do with the staged handle of a late successful completion */
+    enum class cleanup_e
+    {
+        NONE,
+        CLOSE,
+        CLOSE_DATASET,
+        FREE_IOMEM
+    };
+
+    static constexpr unsigned MAX_STAGED  = 2;
+    static constexpr size_t   STAGED_SIZE = 16;
+
+    struct staged_t
+    {
+        void                  *dst;
+        size_t                 size;
+        alignas(16) unsigned char data[STAGED_SIZE];
+    };
+
+    std::atomic<unsigned> refs{0};
+    std::atomic<int>      state{PENDING};
+    std::atomic<bool>     completed{false};
+    red_status_t          rs      = RED_SUCCESS;
+    reactor_t            *reactor = nullptr;
+    rfs_usercb_t          ucb     = {};
+    completion_ctx_t     *ctx     = nullptr; /* Set for pooled slots */
+    bool                  pooled  = false;
+    unsigned              nstaged = 0;
+    staged_t              staged[MAX_STAGED];
+    cleanup_e             cleanup       = cleanup_e::NONE;
+    unsigned              cleanup_index = 0;
+
+    /**
+     * @brief Take a slot from the pool for an operation waited for by the
+     *        calling thread, holding the waiter's and the callback's references
+     */
+    static completion_slot_t *acquire();
+
+    /**
+     * @brief Prepare an embedded slot for the calling thread
+     */
+    void init_inline();
+
+    /**
+     * @brief Drop one reference, returning a pooled slot to the pool on the last
+     */
+    void release();
+
+    /**
+     * @brief Callback to pass to the RED call
+     */
+    rfs_usercb_t *usercb();
+
+    /**
+     * @brief Where the library should write the out-parameter @p dst
+     *
+     * @return @p dst itself for embedded slots, storage inside the slot otherwise
+     */
+    void *stage(void *dst, size_t size, cleanup_e on_late = cleanup_e::NONE);
+
+    /**
+     * @brief Copy the staged out-parameters to the caller
+     */
+    void commit();
+
+    /**
+     * @brief Give up on the operation at the waiter's deadline
+     *
+     * @return true if the callback will find the slot abandoned, false if the
+     *         operation completed concurrently and its result must be used
+     */
+    bool abandon();
+
+private:
+    static void callback(red_status_t status, void *arg);
+    static void on_completion(completion_ctx_t *ctx);
+    static void on_closed(completion_ctx_t *ctx);
+    static void set_completed(void *arg);
+
+    void complete(red_status_t status);
+    void late(red_status_t status);
+    void close_staged();
+};
+
+} // namespace common
+
+#endif // COMMON_COMPLETION_SLOT_HPP_
@@ -0,0 +1,152 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       consumable_ring.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Consumable array reused across red_q_get() calls
+ *
+ ******************************************************************************/
+#ifndef COMMON_CONSUMABLE_RING_HPP_
+#define COMMON_CONSUMABLE_RING_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <red/red_client_api.h>
+
+namespace common
+{
+
+/* Largest queue message payload (BEPT_NODE_MAX_UPSERT_VAL_SIZE) */
+constexpr size_t Q_MSG_MAX = 1024;
+
+struct consumable_ring_config_t
+{
+    uint64_t initial  = 16;        /* Consumables of the first batch */
+    uint64_t max      = 1024;      /* Consumables the array grows to at most */
+    size_t   msg_size = Q_MSG_MAX; /* Payload bytes per consumable */
+};
+
+struct consumable_ring_stats_t
+{
+    uint64_t batches;    /* Batches completed */
+    uint64_t full;       /* ... that filled the array */
+    uint64_t grows;      /* Times the array was reallocated larger */
+    uint64_t high_water; /* Largest batch */
+    uint64_t capacity;   /* Consumables in the array */
+};
+
+/**
+ * @brief Consumable array and payload storage kept across red_q_get() calls
+ *
+ * Replaces red_q_alloc_consumables()/red_q_dealloc_consumables() around
+ * every red_q_get(): the array and one payload slot per consumable are
+ * allocated once, and prepare() only points the consumables the previous
+ * batch used back at their slots. A batch that comes back full means more
+ * messages are waiting, so the next prepare() doubles the array, up to
+ * max. Used by one consumer thread at a time.
+ *
+ * @code
+ * common::consumable_ring_t ring;
+ * while (ring.fetch(ds, queue, partition, gtx, nullptr) == RED_SUCCESS && ring.count() != 0)
+ * {
+ *     for (const red_q_consumable_t &c : ring)
+ *         handle(c.rqo_msg.rqm_data, c.rqo_msg.rqm_size);
+ *     gtx = ring[ring.count() - 1].rqo_gtx;
+ *     gtx.rqt_tick++;
+ * }
+ * @endcode
+ */
+class consumable_ring_t
+{
+public:
+    explicit consumable_ring_t(const consumable_ring_config_t &cfg = {});
+    ~consumable_ring_t();
+
+    consumable_ring_t(const consumable_ring_t &)            = delete;
+    consumable_ring_t &operator=(const consumable_ring_t &) = delete;
+
+    /**
+     * @brief Array to pass to red_q_get() for the next batch
+     *
+     * @param[out] consumables The array
+     * @param[out] size Its length, to pass as red_q_get()'s size
+     * @return RED_SUCCESS, or RED_ENOMEM if the first allocation failed. A
+     *         failed growth keeps the current array.
+     */
+    red_status_t prepare(red_q_consumable_t **consumables, uint64_t *size);
+
+    /**
+     * @brief Record the count red_q_get() returned for the prepared array
+     */
+    void complete(uint64_t count);
+
+    /**
+     * @brief prepare(), a synchronous red_q_get() and complete()
+     *
+     * After an error the batch is empty and every consumable is reset by the
+     * next prepare(), as the library may have written to any of them.
+     */
+    red_status_t fetch(rfs_dataset_hndl_t    ds_hndl,
+                       red_queue_hndl_t      queue,
+                       uint32_t              partition,
+                       red_q_gtx_t           gtx,
+                       const red_api_user_t *user);
+
+    /* Consumables of the last completed batch */
+    uint64_t count() const
+    {
+        return used;
+    }
+
+    const red_q_consumable_t &operator[](uint64_t i) const
+    {
+        return slots[i];
+    }
+
+    const red_q_consumable_t *begin() const
+    {
+        return slots;
+    }
+
+    const red_q_consumable_t *end() const
+    {
+        return slots + used;
+    }
+
+    uint64_t capacity() const
+    {
+        return cap;
+    }
+
+    consumable_ring_stats_t stats() const;
+
+private:
+    bool resize(uint64_t n);
+
+    consumable_ring_config_t cfg;
+    red_q_consumable_t      *slots     = nullptr;
+    char                    *payload   = nullptr;
+    uint64_t                 cap       = 0;
+    uint64_t                 used      = 0; /* Consumables of the last batch */
+    uint64_t                 dirty     = 0; /* Consumables to point back at their slots */
+    bool                     grow_next = false;
+    consumable_ring_stats_t  counters  = {};
+};
+
+} // namespace common
+
+#endif // COMMON_CONSUMABLE_RING_HPP_
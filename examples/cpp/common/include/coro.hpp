@@ -0,0 +1,558 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       coro.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: C++20 coroutine layer over the asynchronous RED API
+ *
+ *   Header only, the rest of the common library stays C++17. Users build
+ *   with -std=c++20:
+ *
+ *       common::task<red_status_t> put(rfs_open_hndl_t root_oh)
+ *       {
+ *           rfs_open_hndl_t oh;
+ *           red_status_t rs = co_await common::red_call(
+ *               ::red_s3_create_version, root_oh, "key", 0, &oh, nullptr);
+ *           ...
+ *       }
+ *
+ *       red_status_t put_rs;
+ *       rs = common::scheduler_t::local().run(put(root_oh), &put_rs);
+ *
+ ******************************************************************************/
+#ifndef COMMON_CORO_HPP_
+#define COMMON_CORO_HPP_
+
+#ifndef __cpp_impl_coroutine
+#error "coro.hpp requires C++20 coroutine support (-std=c++20)"
+#endif
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <red/red_client_api.h>
+
+#include "../include/admission.hpp"
+#include "../include/reactor.hpp"
+
+namespace common
+{
+
+template <typename T = void>
+class task;
+
+class scheduler_t;
+
+namespace coro_detail
+{
+
+/*
+ * State shared by every task promise. A task either has a continuation (the
+ * coroutine awaiting it) or, once handed to scheduler_t::spawn(), is detached
+ * and frees itself on completion.
+ */
+struct promise_base_t
+{
+    std::coroutine_handle<> continuation;
+    scheduler_t            *detached = nullptr;
+
+    struct final_awaiter_t
+    {
+        bool await_ready() const noexcept
+        {
+            return false;
+        }
+
+        template <typename P>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<P> h) noexcept;
+
+        void await_resume() const noexcept
+        {
+        }
+    };
+
+    std::suspend_always initial_suspend() const noexcept
+    {
+        return {};
+    }
+
+    final_awaiter_t final_suspend() const noexcept
+    {
+        return {};
+    }
+
+    /* The examples are built with -fno-exceptions */
+    void unhandled_exception() const noexcept
+    {
+        std::terminate();
+    }
+};
+
+template <typename T>
+struct promise_t : promise_base_t
+{
+    std::optional<T> value;
+
+    task<T> get_return_object() noexcept;
+
+    template <typename U>
+    void return_value(U &&v)
+    {
+        value.emplace(std::forward<U>(v));
+    }
+
+    T result()
+    {
+        return std::move(*value);
+    }
+};
+
+template <>
+struct promise_t<void> : promise_base_t
+{
+    task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept
+    {
+    }
+
+    void result() const noexcept
+    {
+    }
+};
+
+} // namespace coro_detail
+
+/**
+ * @brief Lazily started coroutine producing a T
+ *
+ * The body does not run until the task is awaited, or handed to
+ * scheduler_t::spawn() / scheduler_t::run(). Awaiting resumes the awaiting
+ * coroutine directly when the task finishes, without going through the
+ * scheduler.
+ */
+template <typename T>
+class [[nodiscard]] task
+{
+public:
+    using promise_type = coro_detail::promise_t<T>;
+    using handle_t     = std::coroutine_handle<promise_type>;
+
+    task() = default;
+
+    explicit task(handle_t h) noexcept
+    : handle(h)
+    {
+    }
+
+    task(task &&other) noexcept
+    : handle(std::exchange(other.handle, nullptr))
+    {
+    }
+
+    task &operator=(task &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+                handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+
+    task(const task &)            = delete;
+    task &operator=(const task &) = delete;
+
+    ~task()
+    {
+        if (handle)
+            handle.destroy();
+    }
+
+    bool await_ready() const noexcept
+    {
+        return !handle || handle.done();
+    }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+    {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+
+    T await_resume()
+    {
+        return handle.promise().result();
+    }
+
+    /**
+     * @brief Give up ownership of the coroutine frame
+     */
+    handle_t release() noexcept
+    {
+        return std::exchange(handle, nullptr);
+    }
+
+private:
+    handle_t handle;
+};
+
+/**
+ * @brief Runs coroutines on the calling thread's completion reactor
+ *
+ * Completions are drained with red_client_lib_poll() by the thread's
+ * reactor_t, and each completion resumes the coroutine that issued the call
+ * from inside the drain loop. A single thread can therefore keep as many
+ * operations in flight as it has spawned tasks.
+ *
+ * Not thread-safe: a scheduler and the tasks spawned on it belong to the
+ * thread that obtained it through local().
+ */
+class scheduler_t
+{
+public:
+    /**
+     * @brief Return the scheduler of the calling thread
+     */
+    static scheduler_t &local()
+    {
+        static thread_local scheduler_t scheduler;
+        return scheduler;
+    }
+
+    scheduler_t(const scheduler_t &)            = delete;
+    scheduler_t &operator=(const scheduler_t &) = delete;
+
+    /**
+     * @brief Start @p t now and let it run to completion in the background
+     *
+     * The task runs until its first suspension before spawn() returns. Its
+     * frame is freed when it finishes; use run() to wait for it.
+     */
+    void spawn(task<void> t)
+    {
+        auto h = t.release();
+        if (!h)
+            return;
+
+        h.promise().detached = this;
+        if (live++ == 0)
+            idle.store(false, std::memory_order_relaxed);
+        h.resume();
+    }
+
+    /**
+     * @brief Dispatch completions until every spawned task has finished
+     *
+     * @return RED_SUCCESS, or the reactor's error if polling failed
+     */
+    red_status_t run()
+    {
+        return reactor.wait(idle);
+    }
+
+    /**
+     * @brief Run @p t, and every task spawned meanwhile, to completion
+     *
+     * @return RED_SUCCESS, or the reactor's error if polling failed
+     */
+    red_status_t run(task<void> t)
+    {
+        spawn(std::move(t));
+        return run();
+    }
+
+    /**
+     * @brief Run @p t, and every task spawned meanwhile, to completion
+     *
+     * @param[out] value The value produced by @p t, set only once it finished
+     * @return RED_SUCCESS, or the reactor's error if polling failed
+     */
+    template <typename T>
+    red_status_t run(task<T> t, T *value)
+    {
+        /* Shared with the task: it may outlive a failed wait */
+        auto out = std::make_shared<std::optional<T>>();
+        spawn(store(std::move(t), out));
+
+        red_status_t rs = run();
+        if (!out->has_value())
+            return rs != RED_SUCCESS ? rs : RED_EINVAL;
+        *value = std::move(**out);
+        return rs;
+    }
+
+    /**
+     * @brief Number of spawned tasks that have not finished
+     */
+    size_t pending() const
+    {
+        return live;
+    }
+
+private:
+    friend struct coro_detail::promise_base_t;
+
+    scheduler_t()
+    : reactor(reactor_t::local()),
+      live(0),
+      idle(true)
+    {
+    }
+
+    template <typename T>
+    static task<void> store(task<T> t, std::shared_ptr<std::optional<T>> out)
+    {
+        out->emplace(co_await std::move(t));
+    }
+
+    void finished()
+    {
+        if (--live == 0)
+            idle.store(true, std::memory_order_release);
+    }
+
+    reactor_t        &reactor;
+    size_t            live;
+    std::atomic<bool> idle;
+};
+
+namespace coro_detail
+{
+
+template <typename P>
+std::coroutine_handle<> promise_base_t::final_awaiter_t::await_suspend(
+    std::coroutine_handle<P> h) noexcept
+{
+    promise_base_t &promise = h.promise();
+    if (promise.continuation)
+        return promise.continuation;
+
+    scheduler_t *scheduler = promise.detached;
+    h.destroy();
+    if (scheduler)
+        scheduler->finished();
+    return std::noop_coroutine();
+}
+
+template <typename T>
+task<T> promise_t<T>::get_return_object() noexcept
+{
+    return task<T>(std::coroutine_handle<promise_t<T>>::from_promise(*this));
+}
+
+inline task<void> promise_t<void>::get_return_object() noexcept
+{
+    return task<void>(std::coroutine_handle<promise_t<void>>::from_promise(*this));
+}
+
+} // namespace coro_detail
+
+/**
+ * @brief Awaitable issuing one asynchronous RED call
+ *
+ * Wraps any `int red_xxx(..., rfs_usercb_t *ucb, red_api_user_t *user)`. The
+ * arguments are given without the callback, which is inserted in front of the
+ * trailing api user argument. co_await yields the call's red_status_t: either
+ * the submission error or the status passed to the completion callback.
+ *
+ * The arguments are copied into the awaitable; pointed-to out-parameters and
+ * buffers must stay valid until the co_await returns, which they do when they
+ * are locals of the awaiting coroutine.
+ */
+template <typename Fn, typename... Args>
+class red_call_t
+{
+    static_assert(sizeof...(Args) >= 1, "the trailing red_api_user_t * is required");
+
+public:
+    explicit red_call_t(Fn f, Args... a)
+    : fn(f),
+      args(std::move(a)...),
+      rs(RED_SUCCESS),
+      ucb(),
+      reactor(nullptr)
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> h)
+    {
+        handle      = h;
+        reactor     = &reactor_t::local();
+        ucb.ucb_fun = callback;
+        ucb.ucb_arg = this;
+
+        int rc = submit(std::make_index_sequence<sizeof...(Args) - 1>());
+        if (rc != 0)
+        {
+            /* Nothing was queued, continue without suspending */
+            rs = static_cast<red_status_t>(rc);
+            return false;
+        }
+        return true;
+    }
+
+    red_status_t await_resume() const noexcept
+    {
+        return rs;
+    }
+
+private:
+    template <size_t... I>
+    int submit(std::index_sequence<I...>)
+    {
+        return static_cast<int>(
+            fn(std::get<I>(args)..., &ucb, std::get<sizeof...(Args) - 1>(args)));
+    }
+
+    static void resume(void *address)
+    {
+        std::coroutine_handle<>::from_address(address).resume();
+    }
+
+    static void callback(red_status_t status, void *arg)
+    {
+        auto *me = static_cast<red_call_t *>(arg);
+        me->rs   = status;
+
+        /*
+         * With the poller thread enabled callbacks run on a library thread;
+         * hand the coroutine back to the thread that issued the call.
+         */
+        if (me->reactor->is_local())
+            me->handle.resume();
+        else if (!me->reactor->handoff(resume, me->handle.address()))
+            me->reactor->post(resume, me->handle.address());
+    }
+
+    Fn                      fn;
+    std::tuple<Args...>     args;
+    red_status_t            rs;
+    rfs_usercb_t            ucb;
+    reactor_t              *reactor;
+    std::coroutine_handle<> handle;
+};
+
+/**
+ * @brief Build the awaitable for @p fn called with @p args and a callback
+ *
+ * @code
+ * ssize_t ret;
+ * red_status_t rs = co_await red_call(::red_pread, oh, buf, size, off, &ret, user);
+ * @endcode
+ */
+template <typename Fn, typename... Args>
+red_call_t<Fn, std::decay_t<Args>...> red_call(Fn fn, Args &&...args)
+{
+    return red_call_t<Fn, std::decay_t<Args>...>(fn, std::forward<Args>(args)...);
+}
+
+/**
+ * @brief Awaitable admission to a dataset, see admit()
+ */
+class admission_t : private admission_waiter_t
+{
+public:
+    admission_t(admission_controller_t &controller, rfs_dataset_hndl_t ds)
+    : controller(controller),
+      ds(ds),
+      rs(RED_SUCCESS),
+      reactor(nullptr)
+    {
+    }
+
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    bool await_suspend(std::coroutine_handle<> h)
+    {
+        handle  = h;
+        reactor = &reactor_t::local();
+        fn      = admitted;
+
+        rs = controller.acquire(ds, this);
+        if (rs != RED_EINPROGRESS)
+            return false;
+        rs = RED_SUCCESS;
+        return true;
+    }
+
+    red_status_t await_resume() const noexcept
+    {
+        return rs;
+    }
+
+private:
+    static void resume(void *address)
+    {
+        std::coroutine_handle<>::from_address(address).resume();
+    }
+
+    /* Runs on the thread whose release() made room */
+    static void admitted(admission_waiter_t *waiter)
+    {
+        auto *me = static_cast<admission_t *>(waiter);
+
+        if (me->reactor->is_local())
+            me->handle.resume();
+        else
+            me->reactor->post(resume, me->handle.address());
+    }
+
+    admission_controller_t &controller;
+    rfs_dataset_hndl_t      ds;
+    red_status_t            rs;
+    reactor_t              *reactor;
+    std::coroutine_handle<> handle;
+};
+
+/**
+ * @brief Suspend until @p controller admits one more operation on @p ds
+ *
+ * Resolves to RED_SUCCESS once admitted, the caller then owes a release(),
+ * or to RED_EAGAIN when the dataset's wait queue is full.
+ *
+ * @code
+ * if (co_await common::admit(admission, ds) == RED_SUCCESS)
+ * {
+ *     rs = co_await red_call(::red_pwrite, oh, buf, size, off, &ret, user);
+ *     admission.release(ds);
+ * }
+ * @endcode
+ */
+inline admission_t admit(admission_controller_t &controller, rfs_dataset_hndl_t ds)
+{
+    return admission_t(controller, ds);
+}
+
+} // namespace common
+
+#endif // COMMON_CORO_HPP_
@@ -0,0 +1,50 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       crc32c.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: CRC-32 and CRC-32C checksums for S3 parts
+ *
+ ******************************************************************************/
+#ifndef COMMON_CRC32C_HPP_
+#define COMMON_CRC32C_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace common
+{
+
+/**
+ * @brief CRC-32C (Castagnoli) of @p size bytes at @p data
+ *
+ * Continues from @p crc, the result of the previous block, so a buffer can be
+ * checksummed in pieces; pass 0 for the first. Uses the SSE4.2 crc32
+ * instruction when the CPU has it, and table lookups otherwise.
+ */
+uint32_t crc32c(uint32_t crc, const void *data, size_t size);
+
+/**
+ * @brief CRC-32 (IEEE 802.3, as in zlib) of @p size bytes at @p data
+ *
+ * Continues from @p crc like crc32c(). Table lookups only.
+ */
+uint32_t crc32(uint32_t crc, const void *data, size_t size);
+
+} // namespace common
+
+#endif // COMMON_CRC32C_HPP_
@@ -0,0 +1,282 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       iomem_arena.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Size-classed allocator of I/O memory for the zero-copy paths
+ *
+ ******************************************************************************/
+#ifndef COMMON_IOMEM_ARENA_HPP_
+#define COMMON_IOMEM_ARENA_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <red/red_client_api.h>
+
+namespace common
+{
+
+/* Smallest and largest block handed out, both powers of two */
+constexpr size_t   IOMEM_MIN_CLASS   = 4096;
+constexpr size_t   IOMEM_MAX_CLASS   = 16 << 20;
+constexpr unsigned IOMEM_NUM_CLASSES = 13;
+
+/**
+ * @brief Source of the large regions an arena is carved from
+ */
+class iomem_provider_t
+{
+public:
+    virtual ~iomem_provider_t() = default;
+
+    /**
+     * @brief Map @p size bytes usable with the *_iomem calls
+     *
+     * @param[out] iomem Handle to pass to red_pread_iomem() and friends
+     * @param[out] base Address of offset 0 of the region
+     */
+    virtual red_status_t alloc(size_t size, red_iomem_hndl_t *iomem, void **base) = 0;
+
+    virtual void free(red_iomem_hndl_t iomem, void *base, size_t size) = 0;
+};
+
+/**
+ * @brief Regions from red_iomem_alloc(), resolved with red_iomem_to_addr()
+ */
+iomem_provider_t &red_iomem_provider();
+
+struct iomem_arena_config_t
+{
+    size_t            region_size = 64 << 20; /* Bytes per region */
+    size_t            reserve     = 64 << 20; /* Bytes mapped by init() */
+    size_t            max_bytes   = 0;        /* Cap on the regions mapped, 0 for none */
+    size_t            cache_bytes = 4 << 20;  /* Per thread and size class */
+    iomem_provider_t *provider    = nullptr;  /* red_iomem_provider() if not set */
+};
+
+/**
+ * @brief Counters of an arena, summed over its threads
+ */
+struct iomem_arena_stats_t
+{
+    uint64_t regions;   /* Regions mapped */
+    uint64_t reserved;  /* Bytes of those regions */
+    uint64_t carved;    /* Bytes split into size-class blocks */
+    uint64_t in_use;    /* Bytes of the blocks held by leases */
+    uint64_t requested; /* Bytes the holders of those leases asked for */
+    uint64_t cached;    /* Bytes of free blocks in per-thread caches */
+    uint64_t free;      /* Bytes of free blocks in the shared lists */
+    uint64_t hits;      /* Leases served from the thread's cache */
+    uint64_t misses;    /* Leases that had to refill the cache under the lock */
+
+    /* Share of the leased bytes lost to rounding up to a size class */
+    double internal_fragmentation() const
+    {
+        return in_use != 0 ? 1.0 - static_cast<double>(requested) / in_use : 0.0;
+    }
+
+    /* Share of the mapped bytes not held by a lease */
+    double idle() const
+    {
+        return reserved != 0 ? 1.0 - static_cast<double>(in_use) / reserved : 0.0;
+    }
+
+    double hit_rate() const
+    {
+        return hits + misses != 0 ? static_cast<double>(hits) / (hits + misses) : 0.0;
+    }
+};
+
+class iomem_arena_t;
+
+/**
+ * @brief Block of I/O memory owned until destroyed or reset()
+ *
+ * Carries what red_pread_iomem()/red_pwrite_iomem() take: the region's
+ * handle and the block's address in it. Move-only.
+ */
+class iomem_lease_t
+{
+public:
+    iomem_lease_t() = default;
+    ~iomem_lease_t();
+
+    iomem_lease_t(iomem_lease_t &&other) noexcept;
+    iomem_lease_t &operator=(iomem_lease_t &&other) noexcept;
+
+    iomem_lease_t(const iomem_lease_t &)            = delete;
+    iomem_lease_t &operator=(const iomem_lease_t &) = delete;
+
+    /**
+     * @brief Give the block back to the arena
+     */
+    void reset();
+
+    explicit operator bool() const
+    {
+        return arena != nullptr;
+    }
+
+    red_iomem_hndl_t iomem() const
+    {
+        return hndl;
+    }
+
+    void *addr() const
+    {
+        return ptr;
+    }
+
+    /* Offset of the block in its region */
+    off_t offset() const
+    {
+        return off;
+    }
+
+    /* Bytes asked for */
+    size_t size() const
+    {
+        return requested;
+    }
+
+    /* Bytes usable: the size class */
+    size_t capacity() const
+    {
+        return IOMEM_MIN_CLASS << cls;
+    }
+
+    /* The requested bytes, as the *_iomem and S3 buffer calls take them */
+    red_buffer_t buffer() const
+    {
+        return {hndl, ptr, requested};
+    }
+
+private:
+    friend class iomem_arena_t;
+
+    iomem_arena_t   *arena     = nullptr;
+    red_iomem_hndl_t hndl      = {};
+    void            *ptr       = nullptr;
+    off_t            off       = 0;
+    size_t           requested = 0;
+    unsigned         cls       = 0;
+};
+
+/**
+ * @brief Size-classed allocator over a few large iomem regions
+ *
+ * red_iomem_alloc() is an asynchronous round trip that registers memory, far
+ * too slow to call per request. The arena maps large regions up front and
+ * carves them into power-of-two blocks from IOMEM_MIN_CLASS to
+ * IOMEM_MAX_CLASS. Each thread keeps a small cache of free blocks per class,
+ * so acquire() and releasing a lease take no lock in steady state; the
+ * shared lists are only locked to refill or drain a cache in batches, and
+ * a new region is mapped (without holding the lock) when they run dry.
+ *
+ * Blocks never move between size classes and regions stay mapped until the
+ * arena is destroyed; stats() shows how much of the mapping is idle.
+ *
+ * @code
+ * common::iomem_arena_t arena;
+ * arena.init();
+ *
+ * common::iomem_lease_t buf;
+ * if (arena.acquire(1 << 20, &buf) == RED_SUCCESS)
+ *     red_pread_iomem(oh, buf.iomem(), buf.addr(), buf.size(), off, &ret, &ucb, user);
+ * @endcode
+ */
+class iomem_arena_t
+{
+public:
+    explicit iomem_arena_t(const iomem_arena_config_t &cfg = {});
+    ~iomem_arena_t();
+
+    iomem_arena_t(const iomem_arena_t &)            = delete;
+    iomem_arena_t &operator=(const iomem_arena_t &) = delete;
+
+    /**
+     * @brief Map the configured reserve
+     */
+    red_status_t init();
+
+    /**
+     * @brief Lease a block of at least @p size bytes
+     *
+     * @return RED_SUCCESS, RED_EINVAL if @p size is 0 or above
+     *         IOMEM_MAX_CLASS, RED_ENOMEM past max_bytes, or the provider's
+     *         error
+     */
+    red_status_t acquire(size_t size, iomem_lease_t *lease);
+
+    iomem_arena_stats_t stats() const;
+
+private:
+    friend class iomem_lease_t;
+
+    struct block_t
+    {
+        red_iomem_hndl_t iomem;
+        char            *addr;
+        off_t            offset;
+    };
+
+    struct region_t
+    {
+        red_iomem_hndl_t iomem;
+        char            *base;
+        size_t           size;
+        size_t           used; /* Bytes carved so far */
+    };
+
+    struct cache_t;
+    struct thread_caches_t;
+
+    cache_t     *local_cache();
+    void         release(iomem_lease_t *lease);
+    red_status_t refill(cache_t *c, unsigned cls);
+    void         drain(cache_t *c, unsigned cls, size_t keep);
+    bool         carve(unsigned cls);
+    red_status_t grow(size_t size);
+    void         detach(cache_t *c);
+
+    iomem_arena_config_t cfg;
+    iomem_provider_t    *provider;
+    const uint64_t       id; /* Tells caches apart once the arena is gone */
+    unsigned             cache_cap[IOMEM_NUM_CLASSES];
+
+    mutable std::mutex    lock;
+    std::vector<region_t> regions;
+    std::vector<block_t>  free_blocks[IOMEM_NUM_CLASSES];
+    uint64_t              reserved;
+    uint64_t              carved;
+    uint64_t              free_bytes;
+
+    /* Guarded by the cache registry lock: live caches, and the counters of
+     * the caches whose thread exited */
+    std::vector<cache_t *> caches;
+    uint64_t               retired_hits;
+    uint64_t               retired_misses;
+    int64_t                retired_in_use;
+    int64_t                retired_requested;
+};
+
+} // namespace common
+
+#endif // COMMON_IOMEM_ARENA_HPP_
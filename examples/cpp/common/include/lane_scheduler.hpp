@@ -0,0 +1,189 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       lane_scheduler.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Priority lanes in front of the asynchronous read/write path
+ *
+ ******************************************************************************/
+#ifndef COMMON_LANE_SCHEDULER_HPP_
+#define COMMON_LANE_SCHEDULER_HPP_
+
+#include <climits>
+#include <cstdint>
+#include <mutex>
+#include <red/red_client_api.h>
+#include <red/red_fs_api.h>
+
+namespace common
+{
+
+/**
+ * @brief Lanes, from the most to the least latency-critical
+ */
+enum lane_e
+{
+    LANE_HIGH,   /* Interactive reads: submitted with RWF_HIPRI */
+    LANE_NORMAL, /* Default */
+    LANE_BULK,   /* Backups, large uploads, scans */
+    LANE_COUNT
+};
+
+struct lane_config_t
+{
+    unsigned weight;       /* Share of the bytes dispatched while lanes contend */
+    unsigned max_inflight; /* Operations of this lane submitted at once */
+};
+
+struct lane_scheduler_config_t
+{
+    unsigned      max_inflight = 16;        /* Operations submitted at once, all lanes */
+    uint32_t      quantum      = 64 * 1024; /* Bytes credited per unit of weight each round */
+    bool          hipri        = true;      /* Set RWF_HIPRI on LANE_HIGH operations */
+    lane_config_t lanes[LANE_COUNT] = {{8, UINT_MAX}, {4, UINT_MAX}, {1, UINT_MAX}};
+};
+
+struct lane_stats_t
+{
+    uint64_t queued;      /* Waiting for a submission slot now */
+    uint64_t max_queued;  /* Most operations seen waiting */
+    uint64_t in_flight;   /* Submitted and not yet completed */
+    uint64_t submitted;   /* Operations handed to the library */
+    uint64_t completed;   /* Completions, successful or not */
+    uint64_t bytes;       /* Bytes requested by submitted operations */
+    uint64_t wait_ns;     /* Total time submitted operations spent queued */
+    uint64_t max_wait_ns; /* Longest time an operation spent queued */
+};
+
+class lane_scheduler_t;
+
+/**
+ * @brief One red_preadv2() or red_pwritev2() going through the scheduler
+ *
+ * Owned by the caller, with the iovec array, until @c done runs. @c done
+ * runs on the thread delivering the completion (or on the submitting thread
+ * if the library rejects the operation), with @c bytes set.
+ */
+struct lane_request_t
+{
+    /* Set by the caller */
+    rfs_open_hndl_t   oh;
+    struct red_iovec *iov;
+    int               iovcnt;
+    off_t             offset;
+    int               flags; /* RWF_* flags; the scheduler adds RWF_HIPRI */
+    bool              write;
+    lane_e            lane;
+    red_api_user_t   *user;
+    void (*done)(lane_request_t *req, red_status_t rs);
+    void *arg;
+
+    /* Result */
+    ssize_t bytes;
+
+    /* Owned by the scheduler */
+    lane_scheduler_t *sched;
+    lane_request_t   *next;
+    uint64_t          cost;
+    uint64_t          enqueued_ns;
+    rfs_usercb_t      ucb;
+};
+
+/**
+ * @brief Weighted fair dequeueing of reads and writes over a few lanes
+ *
+ * At most max_inflight operations are submitted to the library at once;
+ * the rest wait in per-lane FIFOs. When a slot frees up, the next operation
+ * is taken by deficit round robin over the lanes, weighted by bytes, so
+ * that small interactive reads are not stuck behind a queue of multi-MB
+ * writes while bulk traffic keeps every slot the high lane leaves idle.
+ * Capping max_inflight of LANE_BULK bounds how much bulk work can be queued
+ * inside the library ahead of a high-lane read.
+ *
+ * The scheduler may be shared by several threads; operations are submitted
+ * from the thread calling submit() or delivering a completion.
+ *
+ * @code
+ * common::lane_scheduler_t sched;
+ * struct red_iovec         iov = {buf, 4096, 0};
+ * common::lane_request_t   req = {};
+ * req.oh     = oh;
+ * req.iov    = &iov;
+ * req.iovcnt = 1;
+ * req.lane   = common::LANE_HIGH;
+ * req.done   = on_read;
+ * sched.submit(&req);
+ * @endcode
+ */
+class lane_scheduler_t
+{
+public:
+    explicit lane_scheduler_t(const lane_scheduler_config_t &cfg = {});
+    virtual ~lane_scheduler_t() = default;
+
+    lane_scheduler_t(const lane_scheduler_t &)            = delete;
+    lane_scheduler_t &operator=(const lane_scheduler_t &) = delete;
+
+    /**
+     * @brief Queue @p req and submit it as soon as its lane gets a slot
+     *
+     * @return RED_SUCCESS (@p req->done will run), or RED_EINVAL
+     */
+    red_status_t submit(lane_request_t *req);
+
+    lane_stats_t stats(lane_e lane) const;
+
+protected:
+    /**
+     * @brief Hand one operation to the library
+     *
+     * Overridden by tests to observe the dispatch order.
+     */
+    virtual red_status_t issue(lane_request_t *req, int flags);
+
+    /**
+     * @brief Completion of an operation handed out by issue()
+     */
+    void complete(lane_request_t *req, red_status_t rs);
+
+private:
+    struct lane_t
+    {
+        lane_request_t *head;
+        lane_request_t *tail;
+        uint64_t        deficit;
+        unsigned        in_flight;
+        lane_stats_t    stats;
+    };
+
+    static void     callback(red_status_t rs, void *arg);
+    bool            eligible(const lane_t &l) const;
+    lane_request_t *pick(uint64_t now);
+    lane_request_t *dispatch();
+    void            run(lane_request_t *ready);
+
+    mutable std::mutex      lock;
+    lane_scheduler_config_t cfg;
+    lane_t                  lanes[LANE_COUNT];
+    unsigned                in_flight;
+    unsigned                current;     /* Lane whose round-robin turn it is */
+    bool                    turn_opened; /* Its quantum has been credited */
+};
+
+} // namespace common
+
+#endif // COMMON_LANE_SCHEDULER_HPP_
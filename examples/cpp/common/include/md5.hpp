@@ -0,0 +1,80 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       md5.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Incremental MD5 for S3 ETags
+ *
+ ******************************************************************************/
+#ifndef COMMON_MD5_HPP_
+#define COMMON_MD5_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+namespace common
+{
+
+/**
+ * @brief MD5 (RFC 1321) of data given in any number of pieces
+ *
+ * red_dhash_data() only hashes one contiguous buffer; this one is fed as
+ * data streams, so an ETag costs no second pass over it.
+ *
+ * @code
+ * common::md5_t md5;
+ * md5.update(chunk, n);
+ * ...
+ * char etag[RED_S3_USER_ETAG_SIZE];
+ * md5.final_hex(etag);
+ * @endcode
+ */
+class md5_t
+{
+public:
+    static constexpr size_t DIGEST_SIZE = 16;
+
+    md5_t()
+    {
+        reset();
+    }
+
+    void reset();
+
+    void update(const void *data, size_t size);
+
+    /**
+     * @brief Finish the digest; reset() before hashing anything else
+     */
+    void final(uint8_t digest[DIGEST_SIZE]);
+
+    /**
+     * @brief final() as 32 lowercase hex digits and a terminating NUL
+     */
+    void final_hex(char hex[2 * DIGEST_SIZE + 1]);
+
+private:
+    void transform(const uint8_t *block);
+
+    uint32_t state[4];
+    uint64_t bytes;
+    uint8_t  buffer[64];
+};
+
+} // namespace common
+
+#endif // COMMON_MD5_HPP_
@@ -0,0 +1,122 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       mpsc_queue.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Intrusive lock-free multi-producer single-consumer queue
+ *
+ ******************************************************************************/
+#ifndef COMMON_MPSC_QUEUE_HPP_
+#define COMMON_MPSC_QUEUE_HPP_
+
+#include <atomic>
+
+namespace common
+{
+
+/**
+ * @brief Link embedded in every element of an mpsc_queue_t
+ */
+struct mpsc_node_t
+{
+    std::atomic<mpsc_node_t *> next{nullptr};
+};
+
+/**
+ * @brief Dmitry Vyukov's intrusive MPSC queue
+ *
+ * push() is wait-free (one exchange) and may be called from any thread.
+ * pop() must only be called by the single consumer. The queue never
+ * allocates; elements embed an mpsc_node_t and stay owned by the caller.
+ *
+ * pop() can return nullptr while a producer is between its two steps. That
+ * producer then completes its push and wakes the consumer, so a consumer
+ * that sleeps until woken after an empty pop() does not lose elements.
+ */
+class mpsc_queue_t
+{
+public:
+    mpsc_queue_t()
+    : head(&stub),
+      tail(&stub)
+    {
+    }
+
+    mpsc_queue_t(const mpsc_queue_t &)            = delete;
+    mpsc_queue_t &operator=(const mpsc_queue_t &) = delete;
+
+    void push(mpsc_node_t *node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        mpsc_node_t *prev = head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    mpsc_node_t *pop()
+    {
+        mpsc_node_t *first = tail;
+        mpsc_node_t *next  = first->next.load(std::memory_order_acquire);
+
+        if (first == &stub)
+        {
+            if (next == nullptr)
+                return nullptr;
+            tail  = next;
+            first = next;
+            next  = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next != nullptr)
+        {
+            tail = next;
+            return first;
+        }
+
+        if (first != head.load(std::memory_order_acquire))
+        {
+            /* A producer has swapped head but not linked its node yet */
+            return nullptr;
+        }
+
+        /* Last element: put the stub back behind it before handing it out */
+        push(&stub);
+        next = first->next.load(std::memory_order_acquire);
+        if (next != nullptr)
+        {
+            tail = next;
+            return first;
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Consumer-side check, same caveat as pop() returning nullptr
+     */
+    bool empty() const
+    {
+        return tail == &stub && stub.next.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    std::atomic<mpsc_node_t *> head;
+    mpsc_node_t               *tail;
+    mpsc_node_t                stub;
+};
+
+} // namespace common
+
+#endif // COMMON_MPSC_QUEUE_HPP_
@@ -0,0 +1,196 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       numa_slab.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Hugepage slabs on the NUMA node of each service thread
+ *
+ ******************************************************************************/
+#ifndef COMMON_NUMA_SLAB_HPP_
+#define COMMON_NUMA_SLAB_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "buffer_pool.hpp"
+
+namespace common
+{
+
+constexpr size_t HUGE_PAGE_2M = 2ul << 20;
+constexpr size_t HUGE_PAGE_1G = 1ul << 30;
+
+/**
+ * @brief NUMA node of a CPU, from sysfs
+ *
+ * @return The node, or -1 if the system does not report one
+ */
+int cpu_to_node(unsigned cpu);
+
+struct hugepage_source_config_t
+{
+    int    node           = -1;           /* Node to bind the slabs to, -1 for none */
+    size_t page_size      = HUGE_PAGE_2M; /* HUGE_PAGE_2M or HUGE_PAGE_1G */
+    size_t slab_size      = 0;            /* Bytes per mapping, 0 for one huge page */
+    bool   register_slabs = true;         /* red_client_iomem_register() each slab */
+};
+
+struct hugepage_source_stats_t
+{
+    uint64_t slabs;     /* Mappings made */
+    uint64_t mapped;    /* Bytes of those mappings */
+    uint64_t hugetlb;   /* Slabs backed by reserved huge pages */
+    uint64_t thp;       /* Slabs left to transparent huge pages instead */
+    uint64_t unbound;   /* Slabs the node binding failed for */
+    uint64_t handed;    /* Buffers currently handed out */
+};
+
+/**
+ * @brief Buffer source carving huge-page slabs bound to one NUMA node
+ *
+ * Each slab is mapped with MAP_HUGETLB at the configured page size, bound to
+ * the node with mbind() before its pages are first touched, registered once
+ * with red_client_iomem_register(), and split into buffers of the sizes
+ * asked for. When the system has no reserved huge pages of that size the
+ * slab falls back to ordinary pages with MADV_HUGEPAGE, so it still gets
+ * transparent huge pages where the kernel allows. Freed buffers are kept for
+ * reuse; slabs stay mapped and registered until the source is destroyed,
+ * which must happen after every pool drawing from it.
+ */
+class hugepage_source_t : public buffer_source_t
+{
+public:
+    explicit hugepage_source_t(const hugepage_source_config_t &cfg = {});
+    ~hugepage_source_t() override;
+
+    hugepage_source_t(const hugepage_source_t &)            = delete;
+    hugepage_source_t &operator=(const hugepage_source_t &) = delete;
+
+    void *alloc(size_t size) override;
+
+    void free(void *buf) override;
+
+    int node() const
+    {
+        return cfg.node;
+    }
+
+    hugepage_source_stats_t stats() const;
+
+private:
+    struct slab_t
+    {
+        char  *base;
+        size_t size;
+        size_t used;
+    };
+
+    bool map_slab(size_t size);
+
+    hugepage_source_config_t               cfg;
+    mutable std::mutex                     lock;
+    std::vector<slab_t>                    slabs;
+    std::map<size_t, std::vector<void *>>  free_bufs; /* By buffer size */
+    std::map<void *, size_t>               sizes;     /* Of the buffers handed out */
+    hugepage_source_stats_t                counters;
+};
+
+struct numa_pools_config_t
+{
+    buffer_pool_config_t pool;                     /* source is set per node */
+    size_t               page_size = HUGE_PAGE_2M; /* Of every node's slabs */
+    size_t               slab_size = 0;            /* 0 for one huge page */
+};
+
+/**
+ * @brief One registered buffer pool per NUMA node of the service threads
+ *
+ * Buffers handed to a call should live on the node of the service thread
+ * that will move them, or every transfer crosses the socket interconnect.
+ * init() resolves each CPU of the coremask to its service thread
+ * (red_client_get_lcore_2_service_thread_id()) and NUMA node, and creates a
+ * hugepage_source_t and buffer_pool_t per node; acquire() then leases from
+ * the pool of the node the target service thread runs on.
+ *
+ * @code
+ * common::numa_buffer_pools_t pools;
+ * pools.init(opts.coremask);
+ *
+ * common::buffer_lease_t buf;
+ * pools.acquire(sthread, &buf);
+ * @endcode
+ */
+class numa_buffer_pools_t
+{
+public:
+    explicit numa_buffer_pools_t(const numa_pools_config_t &cfg = {});
+    ~numa_buffer_pools_t();
+
+    numa_buffer_pools_t(const numa_buffer_pools_t &)            = delete;
+    numa_buffer_pools_t &operator=(const numa_buffer_pools_t &) = delete;
+
+    /**
+     * @brief Set up the pools, after red_client_lib_init_v3()
+     *
+     * @param coremask The coremask passed in red_client_lib_init_opts, or
+     *                 nullptr for a single pool not bound to a node
+     * @return RED_SUCCESS, RED_EINVAL for an unparsable coremask or if
+     *         already initialized, or the pools' init() error
+     */
+    red_status_t init(const char *coremask);
+
+    /**
+     * @brief Lease a buffer on the node of service thread @p sthread
+     *
+     * Service threads not found in the coremask use the first pool.
+     */
+    red_status_t acquire(unsigned sthread, buffer_lease_t *lease);
+
+    /* Node of service thread @p sthread, -1 if unknown */
+    int node_of(unsigned sthread) const;
+
+    buffer_pool_t &pool_of(unsigned sthread);
+
+    hugepage_source_t &source_of(unsigned sthread);
+
+    unsigned num_pools() const
+    {
+        return static_cast<unsigned>(pools.size());
+    }
+
+private:
+    struct node_pool_t
+    {
+        int                                node;
+        std::unique_ptr<hugepage_source_t> source;
+        std::unique_ptr<buffer_pool_t>     pool;
+    };
+
+    unsigned index_of(unsigned sthread) const;
+
+    numa_pools_config_t      cfg;
+    std::vector<node_pool_t> pools;
+    std::vector<unsigned>    by_sthread; /* Index into pools */
+};
+
+} // namespace common
+
+#endif // COMMON_NUMA_SLAB_HPP_
@@ -0,0 +1,217 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       reactor.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Per-thread completion reactor shared by the synchronous wrappers
+ *
+ ******************************************************************************/
+#ifndef COMMON_REACTOR_HPP_
+#define COMMON_REACTOR_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <poll.h>
+#include <vector>
+#include <red/red_client_api.h>
+
+#include "../include/completion_drain.hpp"
+#include "../include/eventfd.hpp"
+#include "../include/spsc_ring.hpp"
+
+namespace common
+{
+
+/* Point in time after which a wait gives up */
+using deadline_t = std::chrono::steady_clock::time_point;
+
+constexpr deadline_t NO_DEADLINE = deadline_t::max();
+
+inline deadline_t deadline_after(std::chrono::nanoseconds timeout)
+{
+    return std::chrono::steady_clock::now() + timeout;
+}
+
+/**
+ * @brief How reactor_t::wait() waits for completions
+ */
+enum class wait_mode_e
+{
+    BLOCK,   /* Sleep in poll() straight away */
+    SPIN,    /* Busy-poll for spin_budget_ns, then sleep in poll() */
+    ADAPTIVE /* Busy-poll for about twice the recent completion latency, up to
+              * spin_budget_ns; do not spin when ops take longer than that, and
+              * back off exponentially while spins keep missing */
+};
+
+struct wait_policy_t
+{
+    wait_mode_e mode           = wait_mode_e::BLOCK;
+    uint64_t    spin_budget_ns = 50000;
+    bool        handoff        = false; /* See reactor_t::handoff() */
+};
+
+/**
+ * @brief Outcome of the waits of one reactor
+ */
+struct wait_stats_t
+{
+    uint64_t waits;      /* Calls to wait() */
+    uint64_t samples;    /* Completed waits timed into latency_ns */
+    uint64_t spun;       /* Waits satisfied while busy-polling */
+    uint64_t blocked;    /* Waits that went to sleep in poll() */
+    uint64_t spin_ns;    /* Time spent busy-polling */
+    uint64_t latency_ns; /* Moving average of the time wait() took to complete */
+};
+
+/**
+ * @brief Completion reactor owned by a single thread
+ *
+ * Holds one eventfd and the thread's red_client_lib_poll_fd() registration for
+ * the lifetime of the thread. Every synchronous call issued by the thread waits
+ * on the same pollfd set instead of creating and destroying its own eventfd.
+ *
+ * A completion may still refer to the reactor after its thread exited (a late
+ * completion of a timed out wait): such callers hold() the reactor, which is
+ * freed on the last unhold(), and what is posted to it once its thread is gone
+ * runs on a process-wide reactor thread instead.
+ */
+class reactor_t
+{
+public:
+    /**
+     * @brief Return the reactor of the calling thread, creating it on first use
+     */
+    static reactor_t &local();
+
+    reactor_t(const reactor_t &)            = delete;
+    reactor_t &operator=(const reactor_t &) = delete;
+
+    /**
+     * @brief Check whether the calling thread owns this reactor
+     */
+    bool is_local() const;
+
+    /**
+     * @brief Wake the owning thread, used by callbacks running on another thread
+     */
+    void kick();
+
+    /**
+     * @brief Run @p fn(@p arg) on the owning thread from its next wait()
+     *
+     * Safe to call from any thread. Used to hand work such as resuming a
+     * coroutine back to the thread that owns it when the completion callback
+     * ran elsewhere (poller thread enabled).
+     */
+    void post(void (*fn)(void *), void *arg);
+
+    /**
+     * @brief Keep the reactor's memory past the exit of its thread
+     *
+     * For a callback that may run after the owning thread is gone; every
+     * hold() is paired with an unhold(), the last of which frees the reactor.
+     */
+    void hold();
+    void unhold();
+
+    /**
+     * @brief Hand @p fn(@p arg) to the owning thread without a lock or syscall
+     *
+     * For the thread delivering completions (the poller thread). With
+     * wait_policy_t::handoff set, the first thread to call handoff() becomes
+     * the producer of a lock-free SPSC ring drained by the owning thread, and
+     * the eventfd is only kicked when the owner is parked in poll(): an owner
+     * that is spinning or running other completions picks the entry up on its
+     * own.
+     *
+     * @return false, doing nothing, if the mode is off, the calling thread is
+     *         not the ring's producer or the ring is full; the caller then
+     *         falls back to post() or kick()
+     */
+    bool handoff(void (*fn)(void *), void *arg);
+
+    /**
+     * @brief Dispatch completions of the owning thread until @p done is set
+     *
+     * @param done Flag set (with release semantics) by the completion callback
+     * @param deadline Give up once this point in time has passed
+     * @return RED_SUCCESS, RED_ETIMEDOUT if the deadline passed first, or
+     *         RED_EINVAL if poll() failed
+     */
+    red_status_t wait(const std::atomic<bool> &done, deadline_t deadline = NO_DEADLINE);
+
+    /**
+     * @brief Completions drained per wakeup by this reactor
+     */
+    const drain_stats_t &stats() const;
+
+    void                 set_policy(const wait_policy_t &policy);
+    const wait_policy_t &policy() const;
+    const wait_stats_t  &spin_stats() const;
+
+private:
+    struct holder_t;
+
+    reactor_t();
+    ~reactor_t();
+
+    struct posted_t
+    {
+        void (*fn)(void *);
+        void *arg;
+    };
+
+    void     retire();
+    void     resolve_poll_fd();
+    void     run_posted();
+    void     run_handoff();
+    bool     park();
+    bool     spin(const std::atomic<bool> &done, uint64_t budget_cycles);
+    int      block(deadline_t deadline);
+    uint64_t spin_budget_cycles();
+
+    eventfd_t     eventfd;
+    struct pollfd pfds[2];
+    nfds_t        nfds;
+    bool          poll_fd_resolved;
+    drain_stats_t drain_stats;
+    wait_policy_t wait_policy;
+    wait_stats_t  wait_stats;
+    uint64_t      timer_hz;
+    unsigned      spin_backoff; /* Waits to skip after the next missed spin */
+    unsigned      spin_skip;    /* Waits left before spinning again */
+
+    std::mutex            posted_lock;
+    std::vector<posted_t> posted;
+    std::atomic<size_t>   posted_count;
+    bool                  retired; /* Thread exited; posts go to the orphan thread */
+    std::atomic<unsigned> refs;    /* The thread's and the hold()s' */
+
+    /* Handoff mode: the ring is created by the owner and never freed before it */
+    std::unique_ptr<spsc_ring_t<posted_t>> ring;
+    std::atomic<bool>                      handoff_on;
+    std::atomic<bool>                      sleeping;
+    std::atomic<const void *>              producer;
+};
+
+} // namespace common
+
+#endif // COMMON_REACTOR_HPP_
@@ -0,0 +1,230 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       sg_list.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Scatter/gather list builder for the KV calls
+ *
+ ******************************************************************************/
+#ifndef COMMON_SG_LIST_HPP_
+#define COMMON_SG_LIST_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <red/red_client_api.h>
+
+#include "iomem_arena.hpp"
+
+namespace common
+{
+
+/* Elements an sg_list_t holds before it spills to the arena */
+constexpr size_t SG_INLINE_ELEMS = 8;
+
+/* Spill arena counters of the calling thread */
+struct sg_arena_stats_t
+{
+    uint64_t spills;  /* Element arrays handed out */
+    uint64_t reused;  /* ... of which came from the thread's free lists */
+    uint64_t mallocs; /* ... of which had to be allocated */
+};
+
+sg_arena_stats_t sg_arena_stats();
+
+/**
+ * @brief red_sg_list_t builder for red_kv_put()/red_kv_get()
+ *
+ * Holds up to SG_INLINE_ELEMS elements inside the object, so building a
+ * short list on the stack allocates nothing. Longer lists move to element
+ * arrays from a per-thread arena of power-of-two sizes, which keeps them
+ * for the next list once this one is destroyed. An element that continues
+ * the previous one in the same region (or, for plain memory, at the next
+ * address) extends it instead of taking a slot.
+ *
+ * @code
+ * common::sg_list_t sg;
+ * sg.append(header, sizeof(header));
+ * sg.append(lease);
+ * red_kv_put(root_oh, RED_NO_TRANSACTION, key, key_len, 0, sg.list(), 0, nullptr, &ucb, nullptr);
+ * @endcode
+ */
+class sg_list_t
+{
+public:
+    sg_list_t() = default;
+    ~sg_list_t();
+
+    sg_list_t(sg_list_t &&other) noexcept;
+    sg_list_t &operator=(sg_list_t &&other) noexcept;
+
+    sg_list_t(const sg_list_t &)            = delete;
+    sg_list_t &operator=(const sg_list_t &) = delete;
+
+    /**
+     * @brief Append @p size bytes of plain memory at @p data
+     *
+     * @return RED_SUCCESS, or RED_ENOMEM if the list could not spill
+     */
+    red_status_t append(const void *data, size_t size)
+    {
+        return push({nullptr}, const_cast<void *>(data), 0, size);
+    }
+
+    /**
+     * @brief Append a buffer, or the range [@p offset, @p offset + @p size) of it
+     *
+     * @return RED_SUCCESS, RED_EINVAL if the range is outside the buffer, or
+     *         RED_ENOMEM if the list could not spill
+     */
+    red_status_t append(const red_buffer_t &buf)
+    {
+        return push(buf.iomem, buf.addr, 0, buf.size);
+    }
+
+    red_status_t append(const red_buffer_t &buf, off_t offset, size_t size)
+    {
+        if (offset < 0 || static_cast<size_t>(offset) > buf.size ||
+            size > buf.size - static_cast<size_t>(offset))
+            return RED_EINVAL;
+        return push(buf.iomem, buf.addr, offset, size);
+    }
+
+    /**
+     * @brief Append @p count buffers, making room for all of them first
+     *
+     * @return RED_SUCCESS, or RED_ENOMEM if the list could not spill, in
+     *         which case nothing was appended
+     */
+    red_status_t append(const red_buffer_t *bufs, size_t count);
+
+    /**
+     * @brief Append an iomem block, or the range [@p offset, @p offset + @p size) of it
+     *
+     * The element refers to the block by its region and offset in it, so
+     * blocks leased one after the other from a region merge.
+     */
+    red_status_t append(const iomem_lease_t &lease);
+    red_status_t append(const iomem_lease_t &lease, off_t offset, size_t size);
+
+    /**
+     * @brief Make room for @p elems elements, spilling straight to the size that holds them
+     *
+     * @return RED_SUCCESS, or RED_ENOMEM if the list could not spill
+     */
+    red_status_t reserve(size_t elems)
+    {
+        if (elems <= capacity)
+            return RED_SUCCESS;
+        return grow(elems) ? RED_SUCCESS : RED_ENOMEM;
+    }
+
+    /**
+     * @brief Drop the elements, keeping any spilled storage for reuse
+     */
+    void clear()
+    {
+        view.num_elems = 0;
+        view.val_size  = 0;
+    }
+
+    /* Elements, after merging */
+    size_t size() const
+    {
+        return view.num_elems;
+    }
+
+    /* Bytes of all the elements */
+    size_t bytes() const
+    {
+        return view.val_size;
+    }
+
+    bool empty() const
+    {
+        return view.num_elems == 0;
+    }
+
+    /* Whether the elements moved off the object to the arena */
+    bool spilled() const
+    {
+        return view.sg_elem != inline_elems;
+    }
+
+    const red_sg_elem_t &operator[](size_t i) const
+    {
+        return view.sg_elem[i];
+    }
+
+    /**
+     * @brief The list as the KV calls take it, without copying
+     *
+     * Valid until the builder is changed, moved or destroyed.
+     */
+    red_sg_list_t *list()
+    {
+        return &view;
+    }
+
+private:
+    /* Inline so that building a short list costs no calls */
+    red_status_t push(red_iomem_hndl_t iomem, void *addr, off_t offset, size_t size)
+    {
+        if (size == 0)
+            return RED_SUCCESS;
+
+        if (view.num_elems != 0)
+        {
+            red_sg_elem_t &last = view.sg_elem[view.num_elems - 1];
+            if (continues(last, iomem, addr, offset))
+            {
+                last.size += size;
+                view.val_size += size;
+                return RED_SUCCESS;
+            }
+        }
+
+        if (view.num_elems == capacity && !grow(capacity * 2))
+            return RED_ENOMEM;
+
+        view.sg_elem[view.num_elems++] = {iomem, addr, offset, size};
+        view.val_size += size;
+        return RED_SUCCESS;
+    }
+
+    /* Plain memory continues at the next address, iomem at the next offset of its region */
+    static bool continues(const red_sg_elem_t &last, red_iomem_hndl_t iomem, void *addr,
+                          off_t offset)
+    {
+        if (iomem.hndl == nullptr)
+            return last.iomem.hndl == nullptr &&
+                   static_cast<char *>(last.addr) + last.offset + last.size ==
+                       static_cast<char *>(addr) + offset;
+        return last.iomem.hndl == iomem.hndl && last.addr == addr &&
+               last.offset + static_cast<off_t>(last.size) == offset;
+    }
+
+    bool grow(size_t elems);
+    void release();
+
+    red_sg_elem_t inline_elems[SG_INLINE_ELEMS];
+    size_t        capacity = SG_INLINE_ELEMS;
+    red_sg_list_t view     = {0, 0, inline_elems};
+};
+
+} // namespace common
+
+#endif // COMMON_SG_LIST_HPP_
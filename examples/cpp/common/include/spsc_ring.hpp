@@ -0,0 +1,133 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       spsc_ring.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Bounded lock-free single-producer single-consumer ring
+ *
+ ******************************************************************************/
+#ifndef COMMON_SPSC_RING_HPP_
+#define COMMON_SPSC_RING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace common
+{
+
+/**
+ * @brief Bounded ring with one producer thread and one consumer thread
+ *
+ * push() and pop() are wait-free and never allocate; the storage is
+ * allocated once, rounded up to a power of two. Each side keeps a cached
+ * copy of the other side's index so that the shared cache line is only
+ * read when the ring looks full (producer) or empty (consumer).
+ */
+template <typename T>
+class spsc_ring_t
+{
+    static_assert(std::is_trivially_copyable<T>::value, "ring entries are copied by value");
+
+public:
+    explicit spsc_ring_t(size_t capacity)
+    : mask(round_up(capacity) - 1),
+      slots(new T[mask + 1])
+    {
+    }
+
+    spsc_ring_t(const spsc_ring_t &)            = delete;
+    spsc_ring_t &operator=(const spsc_ring_t &) = delete;
+
+    /**
+     * @brief Producer side
+     *
+     * @return false if the ring is full
+     */
+    bool push(const T &value)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head_cache > mask)
+        {
+            head_cache = head.load(std::memory_order_acquire);
+            if (t - head_cache > mask)
+                return false;
+        }
+        slots[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer side
+     *
+     * @return false if the ring is empty
+     */
+    bool pop(T *value)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail_cache)
+        {
+            tail_cache = tail.load(std::memory_order_acquire);
+            if (h == tail_cache)
+                return false;
+        }
+        *value = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Consumer-side check; an entry being pushed may not be seen yet
+     */
+    bool empty() const
+    {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const
+    {
+        return mask + 1;
+    }
+
+private:
+    static size_t round_up(size_t n)
+    {
+        size_t p = 1;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+
+    static constexpr size_t CACHE_LINE = 64;
+
+    const size_t         mask;
+    std::unique_ptr<T[]> slots;
+
+    /* Written by the consumer */
+    alignas(CACHE_LINE) std::atomic<size_t> head{0};
+    size_t tail_cache = 0;
+
+    /* Written by the producer */
+    alignas(CACHE_LINE) std::atomic<size_t> tail{0};
+    size_t head_cache = 0;
+};
+
+} // namespace common
+
+#endif // COMMON_SPSC_RING_HPP_
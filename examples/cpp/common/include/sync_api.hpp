@@ -23,57 +23,120 @@
 #ifndef COMMON_SYNC_API_HPP_
 #define COMMON_SYNC_API_HPP_
 
-#include "../include/eventfd.hpp"
+#include <atomic>
 #include <red/red_client_api.h>
 
+#include "../include/completion_slot.hpp"
+#include "../include/reactor.hpp"
+
 namespace common
 {
 
+/**
+ * @brief Waits for one asynchronous operation on the calling thread's reactor
+ *
+ * Without a deadline the completion context lives in this object. With one, it
+ * is a pooled completion_slot_t so that the wait can return RED_ETIMEDOUT
+ * while the operation is still in flight; pass every out-parameter through
+ * stage() so that a late completion does not write to the caller's variables.
+ */
 class sync_api_t
 {
 public:
-    sync_api_t();
+    explicit sync_api_t(deadline_t deadline = NO_DEADLINE);
+    ~sync_api_t();
+
+    sync_api_t(const sync_api_t &)            = delete;
+    sync_api_t &operator=(const sync_api_t &) = delete;
+
     rfs_usercb_t *get_ucb();
     red_status_t  wait(int rc);
 
-private:
-    void        done(red_status_t status);
-    static void callback(red_status_t status, void *arg);
+    template <typename T>
+    T *stage(T *out)
+    {
+        return static_cast<T *>(slot->stage(out, sizeof(T)));
+    }
+
+    /* Handles produced by a late completion are closed (or freed) */
+    rfs_open_hndl_t    *stage(rfs_open_hndl_t *oh);
+    rfs_dataset_hndl_t *stage(rfs_dataset_hndl_t *ds_hndl);
+    red_iomem_hndl_t   *stage(red_iomem_hndl_t *iomem);
 
-    red_status_t rs;
-    rfs_usercb_t ucb;
-    eventfd_t    eventfd;
+private:
+    deadline_t         deadline;
+    completion_slot_t  inline_slot;
+    completion_slot_t *slot;
 };
+
+/**
+ * @brief Choose how the calling thread's synchronous calls wait
+ *
+ * BLOCK (the default) sleeps in poll() until the completion arrives. SPIN and
+ * ADAPTIVE first busy-poll red_client_lib_poll(), trading CPU for the
+ * sleep/wakeup latency on short operations such as small GETs.
+ *
+ * With the poller thread enabled, handoff = true passes completions to the
+ * thread through a lock-free ring and only kicks its eventfd when it is
+ * asleep in poll(), saving the kick and wakeup syscalls when the thread is
+ * spinning or still busy with earlier results.
+ */
+void set_wait_policy(const wait_policy_t &policy);
+
+/**
+ * @brief Wait policy of the calling thread
+ */
+const wait_policy_t &get_wait_policy();
 } // namespace common
 
+/*
+ * Every wrapper takes an optional deadline (see common::deadline_after()).
+ * When it passes, the wrapper returns RED_ETIMEDOUT and the operation is left
+ * to complete on its own: its out-parameters are then not written, and a
+ * handle it opens is closed again. Data buffers, names and the api user
+ * passed in must still stay valid until the library is done with them, and
+ * the calling thread must keep running (and waiting from time to time) for a
+ * late completion to be cleaned up. common::deadline_stats() counts timeouts
+ * and late completions.
+ */
 namespace red
 {
-red_status_t red_s3_create_version(rfs_open_hndl_t  dir_oh,
-                                   const char      *tgt_name,
-                                   int              flags,
-                                   rfs_open_hndl_t *created_oh,
-                                   red_api_user_t  *user);
-
-red_status_t red_s3_open(rfs_open_hndl_t  dir_oh,
-                         const char      *s3_key,
-                         uint64_t         version,
-                         int              flags,
-                         rfs_open_hndl_t *oh,
-                         uint64_t        *out_version,
-                         red_api_user_t  *api_user);
-
-red_status_t red_s3_publish(rfs_open_hndl_t oh, uint64_t *version, red_api_user_t *user);
-
-red_status_t red_pwrite(rfs_open_hndl_t oh,
-                        void           *buff,
-                        size_t          size,
-                        off_t           off,
-                        ssize_t        *ret_size,
-                        red_api_user_t *user);
-
-red_status_t red_close(rfs_open_hndl_t oh, red_api_user_t *user);
-
-red_status_t red_close_dataset(rfs_dataset_hndl_t ds_hndl, red_api_user_t *user);
+red_status_t red_s3_create_version(rfs_open_hndl_t    dir_oh,
+                                   const char        *tgt_name,
+                                   int                flags,
+                                   rfs_open_hndl_t   *created_oh,
+                                   red_api_user_t    *user,
+                                   common::deadline_t deadline = common::NO_DEADLINE);
+
+red_status_t red_s3_open(rfs_open_hndl_t    dir_oh,
+                         const char        *s3_key,
+                         uint64_t           version,
+                         int                flags,
+                         rfs_open_hndl_t   *oh,
+                         uint64_t          *out_version,
+                         red_api_user_t    *api_user,
+                         common::deadline_t deadline = common::NO_DEADLINE);
+
+red_status_t red_s3_publish(rfs_open_hndl_t    oh,
+                            uint64_t          *version,
+                            red_api_user_t    *user,
+                            common::deadline_t deadline = common::NO_DEADLINE);
+
+red_status_t red_pwrite(rfs_open_hndl_t    oh,
+                        void              *buff,
+                        size_t             size,
+                        off_t              off,
+                        ssize_t           *ret_size,
+                        red_api_user_t    *user,
+                        common::deadline_t deadline = common::NO_DEADLINE);
+
+red_status_t red_close(rfs_open_hndl_t    oh,
+                       red_api_user_t    *user,
+                       common::deadline_t deadline = common::NO_DEADLINE);
+
+red_status_t red_close_dataset(rfs_dataset_hndl_t ds_hndl,
+                               red_api_user_t    *user,
+                               common::deadline_t deadline = common::NO_DEADLINE);
 
 red_status_t red_s3_create_bucket(const char         *bucket_name,
                                   const char         *cluster,
@@ -81,45 +144,89 @@ red_status_t red_s3_create_bucket(const char         *bucket_name,
                                   const char         *subtenant,
                                   red_ds_props_t     *bucket_props,
                                   rfs_dataset_hndl_t *bucket_hndl,
-                                  red_api_user_t     *user);
+                                  red_api_user_t     *user,
+                                  common::deadline_t  deadline = common::NO_DEADLINE);
 
 red_status_t red_open_root(rfs_dataset_hndl_t ds_hndl,
                            rfs_open_hndl_t   *root_oh,
-                           red_api_user_t    *user);
-
-red_status_t red_fsetxattr(rfs_open_hndl_t oh,
-                           const char     *name,
-                           const void     *value,
-                           size_t          size,
-                           int             flags,
-                           red_api_user_t *user);
-
-red_status_t red_fgetxattr(rfs_open_hndl_t oh,
-                           const char     *name,
-                           void           *value,
-                           size_t          size,
-                           size_t         *ret_size,
-                           red_api_user_t *user);
+                           red_api_user_t    *user,
+                           common::deadline_t deadline = common::NO_DEADLINE);
+
+red_status_t red_fsetxattr(rfs_open_hndl_t    oh,
+                           const char        *name,
+                           const void        *value,
+                           size_t             size,
+                           int                flags,
+                           red_api_user_t    *user,
+                           common::deadline_t deadline = common::NO_DEADLINE);
+
+red_status_t red_fgetxattr(rfs_open_hndl_t    oh,
+                           const char        *name,
+                           void              *value,
+                           size_t             size,
+                           size_t            *ret_size,
+                           red_api_user_t    *user,
+                           common::deadline_t deadline = common::NO_DEADLINE);
 
 red_status_t red_obtain_dataset(const char         *ds_name,
                                 const char         *cluster,
                                 red_ds_props_t     *ds_props,
                                 rfs_dataset_hndl_t *ds_hndl,
-                                red_api_user_t     *user);
-
-red_status_t red_openat(rfs_open_hndl_t  dir_oh,
-                        const char      *pathname,
-                        int              flags,
-                        mode_t           mode,
-                        rfs_open_hndl_t *oh,
-                        red_api_user_t  *user);
-
-red_status_t red_pread(rfs_open_hndl_t oh,
-                       void           *buff,
-                       size_t          size,
-                       off_t           off,
-                       ssize_t        *ret_size,
-                       red_api_user_t *user);
+                                red_api_user_t     *user,
+                                common::deadline_t  deadline = common::NO_DEADLINE);
+
+red_status_t red_openat(rfs_open_hndl_t    dir_oh,
+                        const char        *pathname,
+                        int                flags,
+                        mode_t             mode,
+                        rfs_open_hndl_t   *oh,
+                        red_api_user_t    *user,
+                        common::deadline_t deadline = common::NO_DEADLINE);
+
+red_status_t red_pread(rfs_open_hndl_t    oh,
+                       void              *buff,
+                       size_t             size,
+                       off_t              off,
+                       ssize_t           *ret_size,
+                       red_api_user_t    *user,
+                       common::deadline_t deadline = common::NO_DEADLINE);
+
+red_status_t red_pread_iomem(rfs_open_hndl_t    oh,
+                             red_iomem_hndl_t   iomem,
+                             void              *addr,
+                             size_t             size,
+                             off_t              off,
+                             ssize_t           *ret_size,
+                             red_api_user_t    *user,
+                             common::deadline_t deadline = common::NO_DEADLINE);
+
+red_status_t red_pwrite_iomem(rfs_open_hndl_t    oh,
+                              red_iomem_hndl_t   iomem,
+                              void              *addr,
+                              size_t             size,
+                              off_t              off,
+                              ssize_t           *ret_size,
+                              red_api_user_t    *user,
+                              common::deadline_t deadline = common::NO_DEADLINE);
+
+red_status_t red_iomem_alloc(size_t             size,
+                             red_iomem_hndl_t  *iomem,
+                             red_api_user_t    *user,
+                             common::deadline_t deadline = common::NO_DEADLINE);
+
+red_status_t red_iomem_free(red_iomem_hndl_t   iomem,
+                            red_api_user_t    *user,
+                            common::deadline_t deadline = common::NO_DEADLINE);
+
+red_status_t red_q_get(rfs_dataset_hndl_t    ds_hndl,
+                       red_queue_hndl_t      queue,
+                       uint32_t              partition,
+                       red_q_gtx_t           gtx,
+                       uint64_t              size,
+                       red_q_consumable_t   *consumables,
+                       uint64_t             *count,
+                       const red_api_user_t *user,
+                       common::deadline_t    deadline = common::NO_DEADLINE);
 
 } // namespace red
 
@@ -0,0 +1,165 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       task_executor.hpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Worker threads implementing the task thread model
+ *
+ ******************************************************************************/
+#ifndef COMMON_TASK_EXECUTOR_HPP_
+#define COMMON_TASK_EXECUTOR_HPP_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <red/red_client_api.h>
+
+#include "../include/completion_drain.hpp"
+#include "../include/eventfd.hpp"
+#include "../include/mpsc_queue.hpp"
+
+namespace common
+{
+
+/**
+ * @brief Unit of work queued to an executor worker
+ *
+ * Intrusive so that submitting does not allocate: embed it in the request
+ * and set @c fn, which receives the item back on the worker thread.
+ */
+struct work_item_t : mpsc_node_t
+{
+    void (*fn)(work_item_t *item) = nullptr;
+};
+
+/**
+ * @brief Parse a coremask into a list of CPU numbers
+ *
+ * Accepts a hexadecimal mask ("0xf0", or "f0" when the string has no ',' or
+ * '-') or a CPU list ("4-7,12").
+ *
+ * @param[in] coremask Mask in one of the formats above
+ * @param[out] cpus CPUs in ascending order
+ * @return RED_SUCCESS, or RED_EINVAL if the string cannot be parsed
+ */
+red_status_t parse_coremask(const char *coremask, std::vector<unsigned> *cpus);
+
+/**
+ * @brief Per-worker counters
+ */
+struct task_executor_stats_t
+{
+    uint64_t      tasks;   /* Work items run */
+    uint64_t      wakeups; /* Returns from epoll_wait() */
+    drain_stats_t drain;   /* Completions drained from the worker's ring */
+};
+
+/**
+ * @brief Task thread model for applications running with poller_thread = false
+ *
+ * Starts one worker per client service thread. Each worker owns its ring:
+ * RED calls made from a work item complete on the same worker, whose event
+ * loop waits in epoll on its eventfd and red_client_lib_poll_fd() and runs
+ * the callbacks inline, so handles opened on a worker stay affine to it and
+ * no completion crosses threads.
+ *
+ * Work is queued through a lock-free MPSC queue per worker and may be
+ * submitted from any thread, including other workers.
+ *
+ * @code
+ * common::task_executor_t executor;
+ * executor.start(opts.coremask);
+ * executor.submit(0, [] { red_pread(oh, buf, size, 0, &ret, &ucb, nullptr); });
+ * @endcode
+ */
+class task_executor_t
+{
+public:
+    task_executor_t();
+    ~task_executor_t();
+
+    task_executor_t(const task_executor_t &)            = delete;
+    task_executor_t &operator=(const task_executor_t &) = delete;
+
+    /**
+     * @brief Start the workers, after red_client_lib_init_v3()
+     *
+     * Worker i serves client service thread i and, when a coremask is given,
+     * is pinned to the CPU of that service thread
+     * (red_client_get_lcore_2_service_thread_id()).
+     *
+     * @param coremask The coremask passed in red_client_lib_init_opts, or
+     *                 nullptr to leave the workers unpinned
+     * @param num_workers Number of workers, 0 for one per service thread
+     * @return RED_SUCCESS, RED_EINVAL for an unparsable coremask or if already
+     *         started, RED_ENOMEM if epoll could not be set up
+     */
+    red_status_t start(const char *coremask, unsigned num_workers = 0);
+
+    /**
+     * @brief Run the queued work and join the workers
+     *
+     * Operations still in flight are not waited for; their callbacks will not
+     * run once the workers have exited.
+     */
+    void stop();
+
+    unsigned num_workers() const;
+
+    /**
+     * @brief Queue @p item to run on worker @p worker
+     */
+    void post(unsigned worker, work_item_t *item);
+
+    /**
+     * @brief Queue a function to run on worker @p worker (allocates)
+     */
+    void submit(unsigned worker, std::function<void()> fn);
+
+    /**
+     * @brief Index of the executor worker running the calling thread, or -1
+     */
+    static int current_worker();
+
+    /**
+     * @brief Counters of worker @p worker, only stable once stopped
+     */
+    const task_executor_stats_t &stats(unsigned worker) const;
+
+private:
+    struct worker_t
+    {
+        mpsc_queue_t          queue;
+        eventfd_t             eventfd;
+        int                   epoll_fd = -1;
+        int                   cpu      = -1;
+        std::thread           thread;
+        task_executor_stats_t stats    = {};
+    };
+
+    void run(unsigned index);
+    bool run_queued(worker_t &w);
+
+    std::vector<std::unique_ptr<worker_t>> workers;
+    std::atomic<bool>                      stopping;
+};
+
+} // namespace common
+
+#endif // COMMON_TASK_EXECUTOR_HPP_
@@ -0,0 +1,274 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       admission.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Per-dataset limit on the operations in flight
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+
+#include "../include/admission.hpp"
+
+namespace common
+{
+
+namespace
+{
+
+uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+/* The handle is a packed struct: copy the pointer out before using it as a key */
+const void *key_of(rfs_dataset_hndl_t ds)
+{
+    return ds.hndl;
+}
+
+/* Waiter of acquire_sync(), woken through the waiting thread's reactor */
+struct sync_waiter_t : admission_waiter_t
+{
+    std::atomic<bool> admitted{false};
+    reactor_t        *reactor = nullptr;
+
+    static void wake(admission_waiter_t *waiter)
+    {
+        auto *me = static_cast<sync_waiter_t *>(waiter);
+
+        /* The waiter returns as soon as 'admitted' is visible */
+        reactor_t *r     = me->reactor;
+        bool       local = r->is_local();
+
+        me->admitted.store(true, std::memory_order_release);
+        if (!local)
+            r->kick();
+    }
+};
+
+/* Run the callbacks of waiters admitted under the lock, after dropping it */
+void notify(admission_waiter_t *ready)
+{
+    while (ready != nullptr)
+    {
+        admission_waiter_t *next = ready->next;
+        ready->fn(ready);
+        ready = next;
+    }
+}
+
+} // namespace
+
+admission_controller_t::admission_controller_t(const admission_limits_t &defaults)
+: defaults(defaults)
+{
+}
+
+admission_controller_t::dataset_t &admission_controller_t::dataset(rfs_dataset_hndl_t ds)
+{
+    auto it = datasets.find(key_of(ds));
+    if (it == datasets.end())
+    {
+        it                = datasets.emplace(key_of(ds), dataset_t()).first;
+        it->second.limits = defaults;
+    }
+    return it->second;
+}
+
+void admission_controller_t::admit(dataset_t &d)
+{
+    d.stats.depth++;
+    d.stats.admitted++;
+    d.stats.max_depth = std::max(d.stats.max_depth, d.stats.depth);
+}
+
+void admission_controller_t::unlink(dataset_t &d, admission_waiter_t *waiter)
+{
+    if (waiter->prev != nullptr)
+        waiter->prev->next = waiter->next;
+    else
+        d.head = waiter->next;
+
+    if (waiter->next != nullptr)
+        waiter->next->prev = waiter->prev;
+    else
+        d.tail = waiter->prev;
+
+    waiter->prev   = nullptr;
+    waiter->next   = nullptr;
+    waiter->queued = false;
+    d.stats.queued--;
+}
+
+void admission_controller_t::admit_waiters(dataset_t &d, admission_waiter_t **ready)
+{
+    admission_waiter_t **last = ready;
+    uint64_t             now  = d.head != nullptr ? now_ns() : 0;
+
+    while (d.head != nullptr && d.stats.depth < d.limits.max_inflight)
+    {
+        admission_waiter_t *waiter = d.head;
+        uint64_t            waited = now - waiter->enqueued_ns;
+
+        unlink(d, waiter);
+        admit(d);
+        d.stats.waited++;
+        d.stats.wait_ns += waited;
+        d.stats.max_wait_ns = std::max(d.stats.max_wait_ns, waited);
+
+        /* Reuse the link for the list of callbacks to run */
+        *last = waiter;
+        last  = &waiter->next;
+    }
+}
+
+void admission_controller_t::set_limits(rfs_dataset_hndl_t ds, const admission_limits_t &limits)
+{
+    admission_waiter_t *ready = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        dataset_t                  &d = dataset(ds);
+        d.limits                      = limits;
+        admit_waiters(d, &ready);
+    }
+    notify(ready);
+}
+
+red_status_t admission_controller_t::try_acquire(rfs_dataset_hndl_t ds)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    dataset_t                  &d = dataset(ds);
+
+    if (d.head != nullptr || d.stats.depth >= d.limits.max_inflight)
+    {
+        d.stats.rejected++;
+        return RED_EAGAIN;
+    }
+    admit(d);
+    return RED_SUCCESS;
+}
+
+red_status_t admission_controller_t::acquire(rfs_dataset_hndl_t ds, admission_waiter_t *waiter)
+{
+    std::lock_guard<std::mutex> guard(lock);
+    dataset_t                  &d = dataset(ds);
+
+    assert(!waiter->queued);
+    if (d.head == nullptr && d.stats.depth < d.limits.max_inflight)
+    {
+        admit(d);
+        return RED_SUCCESS;
+    }
+
+    if (d.stats.queued >= d.limits.max_queued)
+    {
+        d.stats.rejected++;
+        return RED_EAGAIN;
+    }
+
+    waiter->key         = key_of(ds);
+    waiter->enqueued_ns = now_ns();
+    waiter->queued      = true;
+    waiter->next        = nullptr;
+    waiter->prev        = d.tail;
+    if (d.tail != nullptr)
+        d.tail->next = waiter;
+    else
+        d.head = waiter;
+    d.tail = waiter;
+
+    d.stats.queued++;
+    d.stats.max_queued = std::max(d.stats.max_queued, d.stats.queued);
+    return RED_EINPROGRESS;
+}
+
+bool admission_controller_t::cancel(admission_waiter_t *waiter)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    if (!waiter->queued)
+        return false;
+
+    unlink(datasets.at(waiter->key), waiter);
+    return true;
+}
+
+red_status_t admission_controller_t::acquire_sync(rfs_dataset_hndl_t ds, deadline_t deadline)
+{
+    sync_waiter_t waiter;
+    waiter.fn      = sync_waiter_t::wake;
+    waiter.reactor = &reactor_t::local();
+
+    red_status_t rs = acquire(ds, &waiter);
+    if (rs != RED_EINPROGRESS)
+        return rs;
+
+    rs = waiter.reactor->wait(waiter.admitted, deadline);
+    if (rs == RED_ETIMEDOUT)
+    {
+        if (cancel(&waiter))
+            return RED_ETIMEDOUT;
+
+        /* Admitted while timing out: the wakeup is on its way */
+        rs = waiter.reactor->wait(waiter.admitted);
+    }
+    return rs;
+}
+
+void admission_controller_t::release(rfs_dataset_hndl_t ds)
+{
+    admission_waiter_t *ready = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        dataset_t                  &d = dataset(ds);
+
+        assert(d.stats.depth > 0);
+        d.stats.depth--;
+        admit_waiters(d, &ready);
+    }
+    notify(ready);
+}
+
+admission_stats_t admission_controller_t::stats(rfs_dataset_hndl_t ds) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto it = datasets.find(key_of(ds));
+    return it != datasets.end() ? it->second.stats : admission_stats_t{};
+}
+
+void admission_controller_t::for_each(
+    const std::function<void(rfs_dataset_hndl_t, const admission_stats_t &)> &fn) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    for (const auto &entry : datasets)
+    {
+        rfs_dataset_hndl_t ds;
+        ds.hndl = const_cast<void *>(entry.first);
+        fn(ds, entry.second.stats);
+    }
+}
+
+} // namespace common
@@ -0,0 +1,546 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       buffer_pool.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Pool of registered I/O buffers with per-thread magazines
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <unordered_map>
+#include <unistd.h>
+
+#include "../include/buffer_pool.hpp"
+#include "../include/log.hpp"
+#include "../include/sync_api.hpp"
+
+namespace common
+{
+
+namespace
+{
+
+/* Links caches and pools; taken before a pool's own lock */
+std::mutex g_registry;
+
+std::atomic<uint64_t> g_next_id{1};
+
+uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+size_t page_size()
+{
+    static const size_t size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+class red_buffer_source_t : public buffer_source_t
+{
+public:
+    void *alloc(size_t size) override
+    {
+        return red_client_alloc_buffer(size);
+    }
+
+    void free(void *buf) override
+    {
+        red_client_free_buffer(buf);
+    }
+};
+
+class red_iomem_buffer_source_t : public buffer_source_t
+{
+public:
+    void *alloc(size_t size) override
+    {
+        return red_client_iomem_alloc(size);
+    }
+
+    void free(void *buf) override
+    {
+        red_client_iomem_free(buf);
+    }
+};
+
+class registered_buffer_source_t : public buffer_source_t
+{
+public:
+    void *alloc(size_t size) override
+    {
+        void *buf = aligned_alloc(page_size(), size);
+        if (buf == nullptr)
+            return nullptr;
+
+        red_status_t rs = red_client_register_buffer(buf, size);
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("red_client_register_buffer() of %zu bytes failed rs=%d", size, rs);
+            ::free(buf);
+            return nullptr;
+        }
+        return buf;
+    }
+
+    void free(void *buf) override
+    {
+        red_status_t rs = red_client_unregister_buffer(buf);
+        if (rs != RED_SUCCESS)
+            COMMON_LOG("red_client_unregister_buffer() failed rs=%d", rs);
+        ::free(buf);
+    }
+};
+
+class red_iomem_region_source_t : public buffer_source_t
+{
+public:
+    void *alloc(size_t size) override
+    {
+        red_iomem_hndl_t iomem;
+        red_status_t     rs = red::red_iomem_alloc(size, &iomem, nullptr);
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("red_iomem_alloc() of %zu bytes failed rs=%d", size, rs);
+            return nullptr;
+        }
+
+        void *buf = red_iomem_to_addr(iomem, 0);
+        if (buf == nullptr)
+        {
+            red::red_iomem_free(iomem, nullptr);
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        regions.emplace(buf, iomem);
+        return buf;
+    }
+
+    void free(void *buf) override
+    {
+        red_iomem_hndl_t iomem;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            auto                        it = regions.find(buf);
+            if (it == regions.end())
+                return;
+            iomem = it->second;
+            regions.erase(it);
+        }
+        red_status_t rs = red::red_iomem_free(iomem, nullptr);
+        if (rs != RED_SUCCESS)
+            COMMON_LOG("red_iomem_free() failed rs=%d", rs);
+    }
+
+    red_iomem_hndl_t iomem(void *buf) override
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        auto                        it = regions.find(buf);
+        return it != regions.end() ? it->second : red_iomem_hndl_t{nullptr};
+    }
+
+private:
+    std::mutex                                   lock;
+    std::unordered_map<void *, red_iomem_hndl_t> regions;
+};
+
+} // namespace
+
+buffer_source_t &red_buffer_source()
+{
+    static red_buffer_source_t source;
+    return source;
+}
+
+buffer_source_t &red_iomem_buffer_source()
+{
+    static red_iomem_buffer_source_t source;
+    return source;
+}
+
+buffer_source_t &registered_buffer_source()
+{
+    static registered_buffer_source_t source;
+    return source;
+}
+
+buffer_source_t &red_iomem_region_source()
+{
+    static red_iomem_region_source_t source;
+    return source;
+}
+
+/* The two magazines of one thread */
+struct buffer_pool_t::cache_t
+{
+    buffer_pool_t        *pool; /* nullptr once the pool is destroyed */
+    uint64_t              pool_id;
+    magazine_t           *loaded   = nullptr;
+    magazine_t           *previous = nullptr;
+    std::atomic<uint64_t> hits{0};
+
+    ~cache_t()
+    {
+        delete loaded;
+        delete previous;
+    }
+};
+
+/* Caches of one thread, handed back to their pools when it exits */
+struct buffer_pool_t::thread_caches_t
+{
+    std::vector<cache_t *> list;
+
+    ~thread_caches_t()
+    {
+        std::lock_guard<std::mutex> guard(g_registry);
+        for (cache_t *c : list)
+        {
+            if (c->pool != nullptr)
+                c->pool->detach(c);
+            delete c;
+        }
+    }
+};
+
+buffer_lease_t::~buffer_lease_t()
+{
+    reset();
+}
+
+buffer_lease_t::buffer_lease_t(buffer_lease_t &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+buffer_lease_t &buffer_lease_t::operator=(buffer_lease_t &&other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        pool       = other.pool;
+        buf        = other.buf;
+        len        = other.len;
+        other.pool = nullptr;
+        other.buf  = nullptr;
+        other.len  = 0;
+    }
+    return *this;
+}
+
+red_iomem_hndl_t buffer_lease_t::iomem() const
+{
+    return pool != nullptr ? pool->source->iomem(buf) : red_iomem_hndl_t{nullptr};
+}
+
+void buffer_lease_t::reset()
+{
+    if (buf == nullptr)
+        return;
+    pool->release(buf);
+    pool = nullptr;
+    buf  = nullptr;
+    len  = 0;
+}
+
+buffer_pool_t::buffer_pool_t(const buffer_pool_config_t &cfg)
+: cfg(cfg),
+  source(cfg.source != nullptr ? cfg.source : &red_buffer_source()),
+  id(g_next_id.fetch_add(1, std::memory_order_relaxed)),
+  low_water(0),
+  last_trim_ns(now_ns()),
+  live(0),
+  depot_hits(0),
+  allocs(0),
+  trimmed(0),
+  failures(0),
+  retired_hits(0)
+{
+    size_t page           = page_size();
+    this->cfg.buffer_size = (std::max<size_t>(cfg.buffer_size, 1) + page - 1) / page * page;
+    this->cfg.magazine_size = std::max(cfg.magazine_size, 1u);
+}
+
+buffer_pool_t::~buffer_pool_t()
+{
+    std::lock_guard<std::mutex> registry(g_registry);
+    std::lock_guard<std::mutex> guard(lock);
+    uint64_t                    freed = 0;
+
+    /* Threads that used the pool keep their caches until they exit */
+    for (cache_t *c : caches)
+    {
+        for (magazine_t *m : {c->loaded, c->previous})
+        {
+            for (void *buf : *m)
+                source->free(buf);
+            freed += m->size();
+            m->clear();
+        }
+        c->pool = nullptr;
+    }
+
+    for (magazine_t *m : full)
+    {
+        for (void *buf : *m)
+            source->free(buf);
+        freed += m->size();
+        delete m;
+    }
+    for (magazine_t *m : empty)
+        delete m;
+
+    if (freed != live)
+        COMMON_LOG("pool destroyed with %lu buffers leased", live - freed);
+}
+
+red_status_t buffer_pool_t::init()
+{
+    std::vector<void *> bufs;
+
+    for (unsigned i = 0; i < cfg.prealloc; i++)
+    {
+        void *buf = source->alloc(cfg.buffer_size);
+        if (buf == nullptr)
+        {
+            for (void *b : bufs)
+                source->free(b);
+            return RED_ENOMEM;
+        }
+        bufs.push_back(buf);
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    for (size_t i = 0; i < bufs.size(); i += cfg.magazine_size)
+    {
+        magazine_t *m = new_magazine();
+        m->assign(bufs.begin() + i, bufs.begin() + std::min(bufs.size(), i + cfg.magazine_size));
+        full.push_back(m);
+    }
+    live += bufs.size();
+    allocs += bufs.size();
+    return RED_SUCCESS;
+}
+
+buffer_pool_t::magazine_t *buffer_pool_t::new_magazine()
+{
+    if (!empty.empty())
+    {
+        magazine_t *m = empty.back();
+        empty.pop_back();
+        return m;
+    }
+    auto *m = new magazine_t;
+    m->reserve(cfg.magazine_size);
+    return m;
+}
+
+buffer_pool_t::cache_t *buffer_pool_t::local_cache()
+{
+    static thread_local thread_caches_t tls;
+
+    for (cache_t *c : tls.list)
+    {
+        if (c->pool_id == id)
+            return c;
+    }
+
+    auto *c    = new cache_t;
+    c->pool    = this;
+    c->pool_id = id;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        c->loaded   = new_magazine();
+        c->previous = new_magazine();
+    }
+
+    std::lock_guard<std::mutex> guard(g_registry);
+    caches.push_back(c);
+
+    /* Drop the caches of pools destroyed since */
+    auto dead = std::remove_if(tls.list.begin(), tls.list.end(), [](cache_t *old) {
+        if (old->pool != nullptr)
+            return false;
+        delete old;
+        return true;
+    });
+    tls.list.erase(dead, tls.list.end());
+    tls.list.push_back(c);
+    return c;
+}
+
+red_status_t buffer_pool_t::acquire(buffer_lease_t *lease)
+{
+    cache_t *c = local_cache();
+
+    if (c->loaded->empty() && !c->previous->empty())
+        std::swap(c->loaded, c->previous);
+
+    if (!c->loaded->empty())
+    {
+        c->hits.store(c->hits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    else
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        maybe_trim();
+
+        if (!full.empty())
+        {
+            /* Trade the empty loaded magazine for a full one */
+            empty.push_back(c->loaded);
+            c->loaded = full.back();
+            full.pop_back();
+            low_water = std::min(low_water, full.size());
+            depot_hits++;
+        }
+        else
+        {
+            if (cfg.max_buffers != 0 && live >= cfg.max_buffers)
+            {
+                failures++;
+                return RED_EAGAIN;
+            }
+            live++;
+            allocs++;
+            guard.unlock();
+
+            void *buf = source->alloc(cfg.buffer_size);
+            if (buf == nullptr)
+            {
+                guard.lock();
+                live--;
+                allocs--;
+                failures++;
+                return RED_ENOMEM;
+            }
+            c->loaded->push_back(buf);
+        }
+    }
+
+    lease->reset();
+    lease->pool = this;
+    lease->buf  = c->loaded->back();
+    lease->len  = cfg.buffer_size;
+    c->loaded->pop_back();
+    return RED_SUCCESS;
+}
+
+void buffer_pool_t::release(void *buf)
+{
+    cache_t *c = local_cache();
+
+    if (c->loaded->size() == cfg.magazine_size)
+    {
+        if (c->previous->size() < cfg.magazine_size)
+        {
+            std::swap(c->loaded, c->previous);
+        }
+        else
+        {
+            /* Both full: the older one goes to the depot */
+            std::lock_guard<std::mutex> guard(lock);
+            full.push_back(c->previous);
+            c->previous = c->loaded;
+            c->loaded   = new_magazine();
+            maybe_trim();
+        }
+    }
+    c->loaded->push_back(buf);
+}
+
+void buffer_pool_t::maybe_trim()
+{
+    if (cfg.trim_ns == 0 || now_ns() - last_trim_ns < cfg.trim_ns)
+        return;
+    trim_locked(full.size() - low_water);
+}
+
+unsigned buffer_pool_t::trim_locked(size_t keep)
+{
+    /* The magazines at the front of the depot have been idle the longest */
+    size_t   drop  = full.size() - std::min(keep, full.size());
+    unsigned freed = 0;
+
+    for (size_t i = 0; i < drop; i++)
+    {
+        for (void *buf : *full[i])
+            source->free(buf);
+        freed += full[i]->size();
+        full[i]->clear();
+        empty.push_back(full[i]);
+    }
+    full.erase(full.begin(), full.begin() + drop);
+
+    live -= freed;
+    trimmed += freed;
+    low_water    = full.size();
+    last_trim_ns = now_ns();
+    return freed;
+}
+
+unsigned buffer_pool_t::trim()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return trim_locked(full.size() - low_water);
+}
+
+void buffer_pool_t::detach(cache_t *c)
+{
+    /* Called with g_registry held, from the exiting thread */
+    std::lock_guard<std::mutex> guard(lock);
+
+    for (magazine_t *m : {c->loaded, c->previous})
+    {
+        if (m->empty())
+            empty.push_back(m);
+        else
+            full.push_back(m);
+    }
+    c->loaded   = nullptr;
+    c->previous = nullptr;
+
+    retired_hits += c->hits.load(std::memory_order_relaxed);
+    caches.erase(std::find(caches.begin(), caches.end(), c));
+    c->pool = nullptr;
+}
+
+buffer_pool_stats_t buffer_pool_t::stats() const
+{
+    std::lock_guard<std::mutex> registry(g_registry);
+    std::lock_guard<std::mutex> guard(lock);
+
+    buffer_pool_stats_t s = {};
+    s.live                = live;
+    s.depot_hits          = depot_hits;
+    s.allocs              = allocs;
+    s.trimmed             = trimmed;
+    s.failures            = failures;
+    s.hits                = retired_hits;
+    for (const magazine_t *m : full)
+        s.depot += m->size();
+    for (const cache_t *c : caches)
+        s.hits += c->hits.load(std::memory_order_relaxed);
+    return s;
+}
+
+} // namespace common
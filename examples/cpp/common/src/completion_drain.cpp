@@ -0,0 +1,87 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       completion_drain.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Batched draining of the calling thread's completion ring
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <red/red_client_api.h>
+
+#include "../include/completion_drain.hpp"
+
+namespace common
+{
+
+namespace
+{
+unsigned histogram_bucket(unsigned drained)
+{
+    unsigned bucket = 0;
+    while (drained > 0 && bucket < DRAIN_HISTOGRAM_BUCKETS - 1)
+    {
+        drained >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+} // namespace
+
+int drain_completions(drain_stats_t *stats, unsigned max_completions)
+{
+    rfs_usercomp_t ucps[DRAIN_BATCH];
+    unsigned       drained = 0;
+    unsigned       polls   = 0;
+    int            rc;
+
+    do
+    {
+        unsigned want = std::min(DRAIN_BATCH, max_completions - drained);
+        rc            = red_client_lib_poll(ucps, want);
+        polls++;
+        if (rc < 0)
+        {
+            break;
+        }
+
+        for (int i = 0; i < rc; i++)
+        {
+            if (ucps[i].ucp_fun)
+            {
+                ucps[i].ucp_fun(ucps[i].ucp_res, ucps[i].ucp_arg);
+            }
+        }
+        drained += rc;
+
+        /* A short batch means the ring was empty when it was polled */
+    } while (rc == static_cast<int>(DRAIN_BATCH) && drained < max_completions);
+
+    if (stats != nullptr)
+    {
+        stats->wakeups++;
+        stats->completions += drained;
+        stats->polls += polls;
+        stats->max_per_wakeup = std::max<uint64_t>(stats->max_per_wakeup, drained);
+        stats->histogram[histogram_bucket(drained)]++;
+    }
+
+    return rc < 0 ? rc : static_cast<int>(drained);
+}
+
+} // namespace common
@@ -0,0 +1,213 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       completion_pool.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Per-thread pool of completion contexts for callback based
+ *                wrappers
+ *
+ ******************************************************************************/
+
+#include <cassert>
+
+#include "../include/completion_pool.hpp"
+#include "../include/log.hpp"
+
+namespace common
+{
+
+static_assert(sizeof(void *) == 8, "ucb_arg tokens need 64-bit pointers");
+
+namespace
+{
+
+/*
+ * The ucb_arg of a context is its address with the generation in the top 16
+ * bits, which user-space addresses leave clear on x86-64 and aarch64.
+ */
+constexpr unsigned  TOKEN_GEN_SHIFT = 48;
+constexpr uintptr_t TOKEN_PTR_MASK  = (uintptr_t(1) << TOKEN_GEN_SHIFT) - 1;
+
+std::atomic<uint64_t> g_stale_callbacks{0};
+
+thread_local completion_pool_t *tls_pool = nullptr;
+
+void *make_token(completion_ctx_t *ctx, uint16_t generation)
+{
+    return reinterpret_cast<void *>(reinterpret_cast<uintptr_t>(ctx) |
+                                    (static_cast<uintptr_t>(generation) << TOKEN_GEN_SHIFT));
+}
+
+} // namespace
+
+/*
+ * Frees the pool when its thread exits, or once the last context still out
+ * comes back. Every remote release counts remote_left down; on exit the
+ * thread adds what it handed out and did not get back, so that remote_left
+ * reaches zero on the last release, whichever thread makes it.
+ */
+struct completion_pool_t::holder_t
+{
+    completion_pool_t *pool = nullptr;
+
+    ~holder_t()
+    {
+        if (pool == nullptr)
+            return;
+
+        pool->collect_remote();
+        tls_pool = nullptr;
+        if (pool->pool_stats.in_use != 0)
+        {
+            int64_t out = static_cast<int64_t>(pool->pool_stats.in_use +
+                                               pool->pool_stats.remote_frees);
+            if (pool->remote_left.fetch_add(out, std::memory_order_acq_rel) + out != 0)
+            {
+                COMMON_LOG("thread exits with %lu completion contexts in flight, keeping its "
+                           "pool until they return",
+                           static_cast<unsigned long>(pool->pool_stats.in_use));
+                return;
+            }
+        }
+        delete pool;
+    }
+};
+
+void completion_ctx_t::release()
+{
+    owner->release(this);
+}
+
+void completion_ctx_t::dispatch(red_status_t status, void *token)
+{
+    uintptr_t value = reinterpret_cast<uintptr_t>(token);
+    auto     *ctx   = reinterpret_cast<completion_ctx_t *>(value & TOKEN_PTR_MASK);
+    auto      gen   = static_cast<uint16_t>(value >> TOKEN_GEN_SHIFT);
+
+    if (ctx->generation.load(std::memory_order_acquire) != gen)
+    {
+        g_stale_callbacks.fetch_add(1, std::memory_order_relaxed);
+        COMMON_LOG("dropping callback for a released completion context status=%d", status);
+        return;
+    }
+
+    ctx->rs = status;
+    ctx->fn(ctx);
+}
+
+completion_pool_t &completion_pool_t::local()
+{
+    static thread_local holder_t holder;
+
+    if (holder.pool == nullptr)
+    {
+        holder.pool = new completion_pool_t;
+        tls_pool    = holder.pool;
+    }
+    return *holder.pool;
+}
+
+completion_pool_t::completion_pool_t()
+: free_list(nullptr),
+  pool_stats{}
+{
+}
+
+completion_ctx_t *completion_pool_t::acquire(completion_ctx_t::continuation_t fn, void *waiter)
+{
+    if (free_list == nullptr)
+        collect_remote();
+    if (free_list == nullptr)
+        grow();
+
+    completion_ctx_t *ctx = free_list;
+    free_list             = ctx->next_free;
+
+    ctx->rs         = RED_SUCCESS;
+    ctx->fn         = fn;
+    ctx->waiter     = waiter;
+    ctx->cb.ucb_fun = completion_ctx_t::dispatch;
+    ctx->cb.ucb_arg = make_token(ctx, ctx->generation.load(std::memory_order_relaxed));
+
+    pool_stats.acquired++;
+    pool_stats.in_use++;
+    return ctx;
+}
+
+void completion_pool_t::reserve(size_t count)
+{
+    while (pool_stats.capacity - pool_stats.in_use < count)
+        grow();
+}
+
+const completion_pool_stats_t &completion_pool_t::stats() const
+{
+    return pool_stats;
+}
+
+uint64_t completion_pool_t::stale_callbacks()
+{
+    return g_stale_callbacks.load(std::memory_order_relaxed);
+}
+
+void completion_pool_t::grow()
+{
+    std::unique_ptr<completion_ctx_t[]> slab(new completion_ctx_t[COMPLETION_SLAB_SIZE]);
+
+    for (unsigned i = 0; i < COMPLETION_SLAB_SIZE; i++)
+    {
+        completion_ctx_t *ctx = &slab[i];
+        assert((reinterpret_cast<uintptr_t>(ctx) & ~TOKEN_PTR_MASK) == 0);
+        ctx->owner     = this;
+        ctx->next_free = free_list;
+        free_list      = ctx;
+    }
+    slabs.push_back(std::move(slab));
+    pool_stats.capacity += COMPLETION_SLAB_SIZE;
+}
+
+void completion_pool_t::collect_remote()
+{
+    while (mpsc_node_t *node = remote.pop())
+    {
+        auto *ctx      = static_cast<completion_ctx_t *>(node);
+        ctx->next_free = free_list;
+        free_list      = ctx;
+        pool_stats.in_use--;
+        pool_stats.remote_frees++;
+    }
+}
+
+void completion_pool_t::release(completion_ctx_t *ctx)
+{
+    /* Invalidate the token before the context can be handed out again */
+    ctx->generation.fetch_add(1, std::memory_order_release);
+
+    if (tls_pool == this)
+    {
+        ctx->next_free = free_list;
+        free_list      = ctx;
+        pool_stats.in_use--;
+        return;
+    }
+
+    remote.push(ctx);
+    if (remote_left.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete this; /* The last context out of a pool whose thread exited */
+}
+
+} // namespace common
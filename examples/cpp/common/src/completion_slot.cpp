@@ -0,0 +1,233 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       completion_slot.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Completion context that can outlive a timed out caller
+ *
+ ******************************************************************************/
+
+#include <cassert>
+#include <cstring>
+#include <red/red_ds_api.h>
+#include <red/red_fs_api.h>
+
+#include "../include/completion_slot.hpp"
+
+namespace common
+{
+
+namespace
+{
+
+std::atomic<uint64_t> g_timeouts{0};
+std::atomic<uint64_t> g_late{0};
+std::atomic<uint64_t> g_late_closed{0};
+
+} // namespace
+
+deadline_stats_t deadline_stats()
+{
+    return {g_timeouts.load(std::memory_order_relaxed), g_late.load(std::memory_order_relaxed),
+            g_late_closed.load(std::memory_order_relaxed)};
+}
+
+completion_slot_t *completion_slot_t::acquire()
+{
+    completion_ctx_t  *ctx  = completion_pool_t::local().acquire(completion_slot_t::on_completion);
+    completion_slot_t *slot = ctx->emplace<completion_slot_t>();
+
+    slot->refs.store(2, std::memory_order_relaxed);
+    slot->reactor = &reactor_t::local();
+    slot->ctx     = ctx;
+    slot->pooled  = true;
+    return slot;
+}
+
+void completion_slot_t::init_inline()
+{
+    reactor     = &reactor_t::local();
+    ucb.ucb_fun = completion_slot_t::callback;
+    ucb.ucb_arg = this;
+}
+
+void completion_slot_t::release()
+{
+    assert(pooled);
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        ctx->release();
+}
+
+rfs_usercb_t *completion_slot_t::usercb()
+{
+    return pooled ? ctx->ucb() : &ucb;
+}
+
+void *completion_slot_t::stage(void *dst, size_t size, cleanup_e on_late)
+{
+    if (!pooled || dst == nullptr)
+        return dst;
+
+    assert(nstaged < MAX_STAGED && size <= STAGED_SIZE);
+    staged_t &s = staged[nstaged];
+    s.dst       = dst;
+    s.size      = size;
+    memcpy(s.data, dst, size);
+    if (on_late != cleanup_e::NONE)
+    {
+        cleanup       = on_late;
+        cleanup_index = nstaged;
+    }
+    nstaged++;
+    return s.data;
+}
+
+void completion_slot_t::commit()
+{
+    for (unsigned i = 0; i < nstaged; i++)
+        memcpy(staged[i].dst, staged[i].data, staged[i].size);
+}
+
+bool completion_slot_t::abandon()
+{
+    /* The late completion may run after this thread and its reactor are gone */
+    reactor->hold();
+
+    int expected = PENDING;
+    if (!state.compare_exchange_strong(expected, ABANDONED, std::memory_order_acq_rel))
+    {
+        reactor->unhold();
+        return false;
+    }
+
+    g_timeouts.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void completion_slot_t::callback(red_status_t status, void *arg)
+{
+    static_cast<completion_slot_t *>(arg)->complete(status);
+}
+
+void completion_slot_t::on_completion(completion_ctx_t *ctx)
+{
+    auto *slot     = ctx->data<completion_slot_t>();
+    int   expected = PENDING;
+
+    if (slot->state.compare_exchange_strong(expected, COMPLETED, std::memory_order_acq_rel))
+    {
+        slot->complete(ctx->rs);
+        slot->release();
+    }
+    else
+    {
+        slot->late(ctx->rs);
+    }
+}
+
+void completion_slot_t::on_closed(completion_ctx_t *ctx)
+{
+    ctx->data<completion_slot_t>()->release();
+}
+
+void completion_slot_t::complete(red_status_t status)
+{
+    /*
+     * An embedded slot may be destroyed as soon as 'completed' is visible, so
+     * everything needed afterwards is read up front.
+     */
+    reactor_t *r     = reactor;
+    bool       local = r->is_local();
+
+    rs = status;
+
+    /* In handoff mode the waiter sets the flag itself when it takes the entry */
+    if (!local && r->handoff(completion_slot_t::set_completed, this))
+        return;
+
+    completed.store(true, std::memory_order_release);
+
+    /* Callbacks dispatched by the waiter's own reactor need no wakeup */
+    if (!local)
+    {
+        r->kick();
+    }
+}
+
+void completion_slot_t::set_completed(void *arg)
+{
+    static_cast<completion_slot_t *>(arg)->completed.store(true, std::memory_order_release);
+}
+
+void completion_slot_t::late(red_status_t status)
+{
+    /* Held by abandon(); the slot may be reused once the close is under way */
+    reactor_t *r = reactor;
+
+    g_late.fetch_add(1, std::memory_order_relaxed);
+
+    if (status != RED_SUCCESS || cleanup == cleanup_e::NONE)
+    {
+        release();
+        r->unhold();
+        return;
+    }
+
+    /* The callback's reference is handed to the close; handles are closed by
+     * the thread that opened them, or the orphan thread once it exited */
+    if (r->is_local())
+        close_staged();
+    else
+        r->post([](void *arg) { static_cast<completion_slot_t *>(arg)->close_staged(); }, this);
+    r->unhold();
+}
+
+void completion_slot_t::close_staged()
+{
+    const staged_t &s = staged[cleanup_index];
+    int             rc;
+
+    /* The close completes through the same context */
+    ctx->fn = completion_slot_t::on_closed;
+    if (cleanup == cleanup_e::CLOSE)
+    {
+        rfs_open_hndl_t oh;
+        memcpy(&oh, s.data, sizeof(oh));
+        rc = ::red_close(oh, ctx->ucb(), nullptr);
+    }
+    else if (cleanup == cleanup_e::CLOSE_DATASET)
+    {
+        rfs_dataset_hndl_t ds;
+        memcpy(&ds, s.data, sizeof(ds));
+        rc = ::red_close_dataset(ds, ctx->ucb(), nullptr);
+    }
+    else
+    {
+        red_iomem_hndl_t iomem;
+        memcpy(&iomem, s.data, sizeof(iomem));
+        rc = ::red_iomem_free(iomem, ctx->ucb(), nullptr);
+    }
+
+    if (rc != 0)
+    {
+        release();
+        return;
+    }
+    g_late_closed.fetch_add(1, std::memory_order_relaxed);
+}
+
+} // namespace common
@@ -0,0 +1,141 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       consumable_ring.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Consumable array reused across red_q_get() calls
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "../include/consumable_ring.hpp"
+#include "../include/log.hpp"
+#include "../include/sync_api.hpp"
+
+namespace common
+{
+
+consumable_ring_t::consumable_ring_t(const consumable_ring_config_t &cfg)
+: cfg(cfg)
+{
+    this->cfg.initial  = std::max<uint64_t>(cfg.initial, 1);
+    this->cfg.max      = std::max(cfg.max, this->cfg.initial);
+    this->cfg.msg_size = std::max<size_t>(cfg.msg_size, 1);
+}
+
+consumable_ring_t::~consumable_ring_t()
+{
+    free(slots);
+    free(payload);
+}
+
+bool consumable_ring_t::resize(uint64_t n)
+{
+    auto *s = static_cast<red_q_consumable_t *>(malloc(n * sizeof(red_q_consumable_t)));
+    auto *p = static_cast<char *>(malloc(n * cfg.msg_size));
+    if (s == nullptr || p == nullptr)
+    {
+        COMMON_LOG("allocating %lu consumables of %zu bytes failed", n, cfg.msg_size);
+        free(s);
+        free(p);
+        return false;
+    }
+
+    free(slots);
+    free(payload);
+    slots   = s;
+    payload = p;
+    cap     = n;
+    dirty   = n;
+    if (counters.capacity != 0)
+        counters.grows++;
+    counters.capacity = n;
+    return true;
+}
+
+red_status_t consumable_ring_t::prepare(red_q_consumable_t **consumables, uint64_t *size)
+{
+    if (slots == nullptr && !resize(cfg.initial))
+        return RED_ENOMEM;
+
+    /* A failed growth is retried after the next full batch */
+    if (grow_next)
+    {
+        grow_next = false;
+        resize(std::min(cap * 2, cfg.max));
+    }
+
+    /* Only what the last batch touched; the rest still points at its slot */
+    for (uint64_t i = 0; i < dirty; i++)
+    {
+        slots[i].rqo_msg.rqm_data = payload + i * cfg.msg_size;
+        slots[i].rqo_msg.rqm_size = cfg.msg_size;
+    }
+    dirty = 0;
+    used  = 0;
+
+    *consumables = slots;
+    *size        = cap;
+    return RED_SUCCESS;
+}
+
+void consumable_ring_t::complete(uint64_t count)
+{
+    used  = std::min(count, cap);
+    dirty = used;
+
+    counters.batches++;
+    counters.high_water = std::max(counters.high_water, used);
+    if (used == cap)
+    {
+        counters.full++;
+        grow_next = cap < cfg.max;
+    }
+}
+
+red_status_t consumable_ring_t::fetch(rfs_dataset_hndl_t    ds_hndl,
+                                      red_queue_hndl_t      queue,
+                                      uint32_t              partition,
+                                      red_q_gtx_t           gtx,
+                                      const red_api_user_t *user)
+{
+    red_q_consumable_t *consumables;
+    uint64_t            size;
+    uint64_t            count = 0;
+
+    red_status_t rs = prepare(&consumables, &size);
+    if (rs != RED_SUCCESS)
+        return rs;
+
+    rs = red::red_q_get(ds_hndl, queue, partition, gtx, size, consumables, &count, user);
+    if (rs != RED_SUCCESS)
+    {
+        dirty = cap;
+        return rs;
+    }
+    complete(count);
+    return RED_SUCCESS;
+}
+
+consumable_ring_stats_t consumable_ring_t::stats() const
+{
+    return counters;
+}
+
+} // namespace common
@@ -0,0 +1,122 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       crc32c.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: CRC-32 and CRC-32C checksums for S3 parts
+ *
+ ******************************************************************************/
+
+#include <array>
+#include <cstring>
+
+#include "../include/crc32c.hpp"
+
+namespace common
+{
+
+namespace
+{
+
+/* Reflected Castagnoli and IEEE 802.3 polynomials */
+constexpr uint32_t POLY_C    = 0x82f63b78;
+constexpr uint32_t POLY_IEEE = 0xedb88320;
+
+using crc_tables_t = std::array<std::array<uint32_t, 256>, 8>;
+
+/* Slicing-by-8 tables: [0] is the bytewise table, [k] advances k more bytes */
+constexpr crc_tables_t make_tables(uint32_t poly)
+{
+    crc_tables_t t{};
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+            c = (c >> 1) ^ (poly & (0u - (c & 1)));
+        t[0][i] = c;
+    }
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        for (size_t k = 1; k < 8; k++)
+            t[k][i] = (t[k - 1][i] >> 8) ^ t[0][t[k - 1][i] & 0xff];
+    }
+    return t;
+}
+
+constexpr crc_tables_t TABLES_C    = make_tables(POLY_C);
+constexpr crc_tables_t TABLES_IEEE = make_tables(POLY_IEEE);
+
+uint32_t crc_sw(const crc_tables_t &t, uint32_t crc, const unsigned char *p, size_t size)
+{
+    while (size >= 8)
+    {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        v ^= crc;
+        crc = t[7][v & 0xff] ^ t[6][(v >> 8) & 0xff] ^ t[5][(v >> 16) & 0xff] ^
+              t[4][(v >> 24) & 0xff] ^ t[3][(v >> 32) & 0xff] ^ t[2][(v >> 40) & 0xff] ^
+              t[1][(v >> 48) & 0xff] ^ t[0][v >> 56];
+        p += 8;
+        size -= 8;
+    }
+    while (size-- > 0)
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xff];
+    return crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) uint32_t crc32c_hw(uint32_t crc, const unsigned char *p,
+                                                     size_t size)
+{
+    uint64_t c = crc;
+    while (size >= 8)
+    {
+        uint64_t v;
+        memcpy(&v, p, sizeof(v));
+        c = __builtin_ia32_crc32di(c, v);
+        p += 8;
+        size -= 8;
+    }
+    crc = static_cast<uint32_t>(c);
+    while (size-- > 0)
+        crc = __builtin_ia32_crc32qi(crc, *p++);
+    return crc;
+}
+
+const bool HAVE_SSE42 = __builtin_cpu_supports("sse4.2");
+#endif
+
+} // namespace
+
+uint32_t crc32c(uint32_t crc, const void *data, size_t size)
+{
+    const unsigned char *p = static_cast<const unsigned char *>(data);
+
+    crc = ~crc;
+#if defined(__x86_64__)
+    if (HAVE_SSE42)
+        return ~crc32c_hw(crc, p, size);
+#endif
+    return ~crc_sw(TABLES_C, crc, p, size);
+}
+
+uint32_t crc32(uint32_t crc, const void *data, size_t size)
+{
+    return ~crc_sw(TABLES_IEEE, ~crc, static_cast<const unsigned char *>(data), size);
+}
+
+} // namespace common
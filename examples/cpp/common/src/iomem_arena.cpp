@@ -0,0 +1,456 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       iomem_arena.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Size-classed allocator of I/O memory for the zero-copy paths
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+
+#include "../include/iomem_arena.hpp"
+#include "../include/log.hpp"
+#include "../include/sync_api.hpp"
+
+namespace common
+{
+
+namespace
+{
+
+/* Links caches and arenas; taken before an arena's own lock */
+std::mutex g_registry;
+
+std::atomic<uint64_t> g_next_id{1};
+
+/* Bytes split into blocks of one class at a time (at least one block) */
+constexpr size_t CARVE_BYTES = 2 << 20;
+
+/* Most blocks of one class a thread keeps */
+constexpr unsigned MAX_CACHED = 64;
+
+/* Counters written by the owning thread only and read by stats() */
+template <typename T>
+inline void add(std::atomic<T> &counter, T delta)
+{
+    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+}
+
+unsigned class_of(size_t size)
+{
+    unsigned cls = 0;
+    while ((IOMEM_MIN_CLASS << cls) < size)
+        cls++;
+    return cls;
+}
+
+class red_provider_t : public iomem_provider_t
+{
+public:
+    red_status_t alloc(size_t size, red_iomem_hndl_t *iomem, void **base) override
+    {
+        red_status_t rs = red::red_iomem_alloc(size, iomem, nullptr);
+        if (rs != RED_SUCCESS)
+            return rs;
+
+        *base = red_iomem_to_addr(*iomem, 0);
+        if (*base == nullptr)
+        {
+            red::red_iomem_free(*iomem, nullptr);
+            return RED_EIO;
+        }
+        return RED_SUCCESS;
+    }
+
+    void free(red_iomem_hndl_t iomem, void *, size_t size) override
+    {
+        red_status_t rs = red::red_iomem_free(iomem, nullptr);
+        if (rs != RED_SUCCESS)
+            COMMON_LOG("red_iomem_free() of %zu bytes failed rs=%d", size, rs);
+    }
+};
+
+} // namespace
+
+iomem_provider_t &red_iomem_provider()
+{
+    static red_provider_t provider;
+    return provider;
+}
+
+/*
+ * Free blocks of one thread. The counters are deltas: a lease released by
+ * another thread than the one that took it is counted there.
+ */
+struct iomem_arena_t::cache_t
+{
+    iomem_arena_t        *arena; /* nullptr once the arena is destroyed */
+    uint64_t              arena_id;
+    std::vector<block_t>  blocks[IOMEM_NUM_CLASSES];
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<int64_t>  cached{0};
+    std::atomic<int64_t>  in_use{0};
+    std::atomic<int64_t>  requested{0};
+};
+
+/* Caches of one thread, handed back to their arenas when it exits */
+struct iomem_arena_t::thread_caches_t
+{
+    std::vector<cache_t *> list;
+
+    ~thread_caches_t()
+    {
+        std::lock_guard<std::mutex> guard(g_registry);
+        for (cache_t *c : list)
+        {
+            if (c->arena != nullptr)
+                c->arena->detach(c);
+            delete c;
+        }
+    }
+};
+
+iomem_lease_t::~iomem_lease_t()
+{
+    reset();
+}
+
+iomem_lease_t::iomem_lease_t(iomem_lease_t &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+iomem_lease_t &iomem_lease_t::operator=(iomem_lease_t &&other) noexcept
+{
+    if (this != &other)
+    {
+        reset();
+        arena         = other.arena;
+        hndl          = other.hndl;
+        ptr           = other.ptr;
+        off           = other.off;
+        requested     = other.requested;
+        cls           = other.cls;
+        other.arena   = nullptr;
+        other.ptr     = nullptr;
+    }
+    return *this;
+}
+
+void iomem_lease_t::reset()
+{
+    if (arena == nullptr)
+        return;
+    arena->release(this);
+    arena = nullptr;
+    ptr   = nullptr;
+}
+
+iomem_arena_t::iomem_arena_t(const iomem_arena_config_t &cfg)
+: cfg(cfg),
+  provider(cfg.provider != nullptr ? cfg.provider : &red_iomem_provider()),
+  id(g_next_id.fetch_add(1, std::memory_order_relaxed)),
+  reserved(0),
+  carved(0),
+  free_bytes(0),
+  retired_hits(0),
+  retired_misses(0),
+  retired_in_use(0),
+  retired_requested(0)
+{
+    this->cfg.region_size = std::max(this->cfg.region_size, IOMEM_MAX_CLASS);
+    for (unsigned cls = 0; cls < IOMEM_NUM_CLASSES; cls++)
+    {
+        size_t blocks  = this->cfg.cache_bytes / (IOMEM_MIN_CLASS << cls);
+        cache_cap[cls] = static_cast<unsigned>(
+            std::max<size_t>(1, std::min<size_t>(MAX_CACHED, blocks)));
+    }
+}
+
+iomem_arena_t::~iomem_arena_t()
+{
+    std::lock_guard<std::mutex> guard(g_registry);
+
+    int64_t in_use = retired_in_use;
+    for (cache_t *c : caches)
+    {
+        in_use += c->in_use.load(std::memory_order_relaxed);
+        c->arena = nullptr;
+    }
+
+    if (in_use != 0)
+    {
+        /* Leases still point into the regions: leave them mapped */
+        COMMON_LOG("arena destroyed with %ld bytes leased, keeping its %zu regions", in_use,
+                   regions.size());
+        return;
+    }
+
+    for (const region_t &r : regions)
+        provider->free(r.iomem, r.base, r.size);
+}
+
+red_status_t iomem_arena_t::init()
+{
+    size_t mapped;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        mapped = reserved;
+    }
+
+    while (mapped < cfg.reserve)
+    {
+        red_status_t rs = grow(cfg.region_size);
+        if (rs != RED_SUCCESS)
+            return rs;
+        mapped += cfg.region_size;
+    }
+    return RED_SUCCESS;
+}
+
+iomem_arena_t::cache_t *iomem_arena_t::local_cache()
+{
+    static thread_local thread_caches_t tls;
+
+    for (cache_t *c : tls.list)
+    {
+        if (c->arena_id == id)
+            return c;
+    }
+
+    auto *c     = new cache_t;
+    c->arena    = this;
+    c->arena_id = id;
+    for (unsigned cls = 0; cls < IOMEM_NUM_CLASSES; cls++)
+        c->blocks[cls].reserve(cache_cap[cls] + 1);
+
+    std::lock_guard<std::mutex> guard(g_registry);
+    caches.push_back(c);
+
+    /* Drop the caches of arenas destroyed since */
+    auto dead = std::remove_if(tls.list.begin(), tls.list.end(), [](cache_t *old) {
+        if (old->arena != nullptr)
+            return false;
+        delete old;
+        return true;
+    });
+    tls.list.erase(dead, tls.list.end());
+    tls.list.push_back(c);
+    return c;
+}
+
+red_status_t iomem_arena_t::acquire(size_t size, iomem_lease_t *lease)
+{
+    if (size == 0 || size > IOMEM_MAX_CLASS)
+        return RED_EINVAL;
+
+    unsigned              cls    = class_of(size);
+    int64_t               bytes  = static_cast<int64_t>(IOMEM_MIN_CLASS << cls);
+    cache_t              *c      = local_cache();
+    std::vector<block_t> &blocks = c->blocks[cls];
+
+    if (blocks.empty())
+    {
+        red_status_t rs = refill(c, cls);
+        if (rs != RED_SUCCESS)
+            return rs;
+        add(c->misses, uint64_t(1));
+    }
+    else
+    {
+        add(c->hits, uint64_t(1));
+    }
+
+    block_t b = blocks.back();
+    blocks.pop_back();
+    add(c->cached, -bytes);
+    add(c->in_use, bytes);
+    add(c->requested, static_cast<int64_t>(size));
+
+    lease->reset();
+    lease->arena     = this;
+    lease->hndl      = b.iomem;
+    lease->ptr       = b.addr;
+    lease->off       = b.offset;
+    lease->requested = size;
+    lease->cls       = cls;
+    return RED_SUCCESS;
+}
+
+void iomem_arena_t::release(iomem_lease_t *lease)
+{
+    unsigned              cls    = lease->cls;
+    int64_t               bytes  = static_cast<int64_t>(IOMEM_MIN_CLASS << cls);
+    cache_t              *c      = local_cache();
+    std::vector<block_t> &blocks = c->blocks[cls];
+
+    blocks.push_back({lease->hndl, static_cast<char *>(lease->ptr), lease->off});
+    add(c->cached, bytes);
+    add(c->in_use, -bytes);
+    add(c->requested, -static_cast<int64_t>(lease->requested));
+
+    /* Keep half, so that the next few acquires and releases stay local */
+    if (blocks.size() > cache_cap[cls])
+        drain(c, cls, cache_cap[cls] / 2);
+}
+
+red_status_t iomem_arena_t::refill(cache_t *c, unsigned cls)
+{
+    size_t want  = std::max(1u, cache_cap[cls] / 2);
+    size_t bsize = IOMEM_MIN_CLASS << cls;
+
+    for (;;)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            std::vector<block_t>       &shared = free_blocks[cls];
+
+            if (!shared.empty() || carve(cls))
+            {
+                size_t n = std::min(want, shared.size());
+                c->blocks[cls].insert(c->blocks[cls].end(), shared.end() - n, shared.end());
+                shared.resize(shared.size() - n);
+                free_bytes -= n * bsize;
+                add(c->cached, static_cast<int64_t>(n * bsize));
+                return RED_SUCCESS;
+            }
+        }
+
+        /* Every region is carved: map another one, without the lock */
+        red_status_t rs = grow(cfg.region_size);
+        if (rs != RED_SUCCESS)
+            return rs;
+    }
+}
+
+void iomem_arena_t::drain(cache_t *c, unsigned cls, size_t keep)
+{
+    std::vector<block_t> &blocks = c->blocks[cls];
+    size_t                n      = blocks.size() - keep;
+    size_t                bytes  = n * (IOMEM_MIN_CLASS << cls);
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        free_blocks[cls].insert(free_blocks[cls].end(), blocks.end() - n, blocks.end());
+        free_bytes += bytes;
+    }
+    blocks.resize(keep);
+    add(c->cached, -static_cast<int64_t>(bytes));
+}
+
+bool iomem_arena_t::carve(unsigned cls)
+{
+    size_t bsize = IOMEM_MIN_CLASS << cls;
+
+    for (region_t &r : regions)
+    {
+        size_t room = r.size - r.used;
+        if (room < bsize)
+            continue;
+
+        size_t n = std::min(room, std::max(CARVE_BYTES, bsize)) / bsize;
+        for (size_t i = 0; i < n; i++)
+        {
+            free_blocks[cls].push_back({r.iomem, r.base + r.used, static_cast<off_t>(r.used)});
+            r.used += bsize;
+        }
+        carved += n * bsize;
+        free_bytes += n * bsize;
+        return true;
+    }
+    return false;
+}
+
+red_status_t iomem_arena_t::grow(size_t size)
+{
+    {
+        /* Counted up front so that concurrent growers respect max_bytes */
+        std::lock_guard<std::mutex> guard(lock);
+        if (cfg.max_bytes != 0 && reserved + size > cfg.max_bytes)
+            return RED_ENOMEM;
+        reserved += size;
+    }
+
+    region_t     r  = {{}, nullptr, size, 0};
+    void        *base;
+    red_status_t rs = provider->alloc(size, &r.iomem, &base);
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (rs != RED_SUCCESS)
+    {
+        reserved -= size;
+        return rs;
+    }
+    r.base = static_cast<char *>(base);
+    regions.push_back(r);
+    return RED_SUCCESS;
+}
+
+void iomem_arena_t::detach(cache_t *c)
+{
+    /* Called with g_registry held, from the exiting thread */
+    std::lock_guard<std::mutex> guard(lock);
+
+    for (unsigned cls = 0; cls < IOMEM_NUM_CLASSES; cls++)
+    {
+        std::vector<block_t> &blocks = c->blocks[cls];
+        free_blocks[cls].insert(free_blocks[cls].end(), blocks.begin(), blocks.end());
+        free_bytes += blocks.size() * (IOMEM_MIN_CLASS << cls);
+        blocks.clear();
+    }
+
+    retired_hits += c->hits.load(std::memory_order_relaxed);
+    retired_misses += c->misses.load(std::memory_order_relaxed);
+    retired_in_use += c->in_use.load(std::memory_order_relaxed);
+    retired_requested += c->requested.load(std::memory_order_relaxed);
+    caches.erase(std::find(caches.begin(), caches.end(), c));
+    c->arena = nullptr;
+}
+
+iomem_arena_stats_t iomem_arena_t::stats() const
+{
+    std::lock_guard<std::mutex> registry(g_registry);
+    std::lock_guard<std::mutex> guard(lock);
+
+    iomem_arena_stats_t s = {};
+    int64_t             in_use    = retired_in_use;
+    int64_t             requested = retired_requested;
+    int64_t             cached    = 0;
+
+    s.regions  = regions.size();
+    s.reserved = reserved;
+    s.carved   = carved;
+    s.free     = free_bytes;
+    s.hits     = retired_hits;
+    s.misses   = retired_misses;
+    for (const cache_t *c : caches)
+    {
+        s.hits += c->hits.load(std::memory_order_relaxed);
+        s.misses += c->misses.load(std::memory_order_relaxed);
+        cached += c->cached.load(std::memory_order_relaxed);
+        in_use += c->in_use.load(std::memory_order_relaxed);
+        requested += c->requested.load(std::memory_order_relaxed);
+    }
+    s.cached    = static_cast<uint64_t>(std::max<int64_t>(cached, 0));
+    s.in_use    = static_cast<uint64_t>(std::max<int64_t>(in_use, 0));
+    s.requested = static_cast<uint64_t>(std::max<int64_t>(requested, 0));
+    return s;
+}
+
+} // namespace common
@@ -0,0 +1,251 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       lane_scheduler.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Priority lanes in front of the asynchronous read/write path
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <sys/uio.h>
+
+#include "../include/lane_scheduler.hpp"
+
+namespace common
+{
+
+namespace
+{
+
+uint64_t now_ns()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now().time_since_epoch())
+                                     .count());
+}
+
+} // namespace
+
+lane_scheduler_t::lane_scheduler_t(const lane_scheduler_config_t &cfg)
+: cfg(cfg),
+  lanes(),
+  in_flight(0),
+  current(0),
+  turn_opened(false)
+{
+    /* A lane without weight or slots would never dispatch */
+    for (lane_config_t &lane : this->cfg.lanes)
+    {
+        lane.weight       = std::max(lane.weight, 1u);
+        lane.max_inflight = std::max(lane.max_inflight, 1u);
+    }
+    this->cfg.max_inflight = std::max(this->cfg.max_inflight, 1u);
+    this->cfg.quantum      = std::max(this->cfg.quantum, 1u);
+}
+
+red_status_t lane_scheduler_t::submit(lane_request_t *req)
+{
+    if (req == nullptr || req->iov == nullptr || req->iovcnt <= 0 || req->done == nullptr ||
+        req->lane < LANE_HIGH || req->lane >= LANE_COUNT)
+        return RED_EINVAL;
+
+    req->sched       = this;
+    req->next        = nullptr;
+    req->cost        = 0;
+    req->bytes       = 0;
+    req->ucb.ucb_fun = callback;
+    req->ucb.ucb_arg = req;
+    for (int i = 0; i < req->iovcnt; i++)
+        req->cost += req->iov[i].iov_len;
+
+    lane_request_t *ready;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        lane_t                     &l = lanes[req->lane];
+
+        req->enqueued_ns = now_ns();
+        if (l.tail != nullptr)
+            l.tail->next = req;
+        else
+            l.head = req;
+        l.tail = req;
+        l.stats.queued++;
+        l.stats.max_queued = std::max(l.stats.max_queued, l.stats.queued);
+
+        ready = dispatch();
+    }
+    run(ready);
+    return RED_SUCCESS;
+}
+
+lane_stats_t lane_scheduler_t::stats(lane_e lane) const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return lanes[lane].stats;
+}
+
+red_status_t lane_scheduler_t::issue(lane_request_t *req, int flags)
+{
+    int rc = req->write ? red_pwritev2(req->oh, req->iov, req->iovcnt, req->offset, flags,
+                                       &req->bytes, &req->ucb, req->user)
+                        : red_preadv2(req->oh, req->iov, req->iovcnt, req->offset, flags,
+                                      &req->bytes, &req->ucb, req->user);
+    return static_cast<red_status_t>(rc);
+}
+
+void lane_scheduler_t::callback(red_status_t rs, void *arg)
+{
+    auto *req = static_cast<lane_request_t *>(arg);
+    req->sched->complete(req, rs);
+}
+
+void lane_scheduler_t::complete(lane_request_t *req, red_status_t rs)
+{
+    lane_request_t *ready;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        lane_t                     &l = lanes[req->lane];
+
+        in_flight--;
+        l.in_flight--;
+        l.stats.in_flight--;
+        l.stats.completed++;
+        ready = dispatch();
+    }
+
+    /* Refill the freed slot before running the caller's completion */
+    run(ready);
+    req->done(req, rs);
+}
+
+bool lane_scheduler_t::eligible(const lane_t &l) const
+{
+    return l.head != nullptr && l.in_flight < cfg.lanes[&l - lanes].max_inflight;
+}
+
+lane_request_t *lane_scheduler_t::pick(uint64_t now)
+{
+    if (in_flight >= cfg.max_inflight ||
+        std::none_of(lanes, lanes + LANE_COUNT, [this](const lane_t &l) { return eligible(l); }))
+        return nullptr;
+
+    /*
+     * Deficit round robin: each turn credits the lane with quantum x weight
+     * bytes, and the lane dispatches while its head fits in the credit.
+     * Terminates because an eligible lane gains credit on every turn.
+     */
+    for (;;)
+    {
+        lane_t &l = lanes[current];
+        if (eligible(l))
+        {
+            if (!turn_opened)
+            {
+                l.deficit += static_cast<uint64_t>(cfg.quantum) * cfg.lanes[current].weight;
+                turn_opened = true;
+            }
+            if (l.head->cost <= l.deficit)
+            {
+                lane_request_t *req    = l.head;
+                uint64_t        waited = now - req->enqueued_ns;
+
+                l.head = req->next;
+                if (l.head == nullptr)
+                    l.tail = nullptr;
+                req->next = nullptr;
+                l.deficit -= req->cost;
+
+                in_flight++;
+                l.in_flight++;
+                l.stats.queued--;
+                l.stats.in_flight++;
+                l.stats.submitted++;
+                l.stats.bytes += req->cost;
+                l.stats.wait_ns += waited;
+                l.stats.max_wait_ns = std::max(l.stats.max_wait_ns, waited);
+                return req;
+            }
+        }
+        else if (l.head == nullptr)
+        {
+            /* An idle lane does not bank credit for later */
+            l.deficit = 0;
+        }
+
+        current     = (current + 1) % LANE_COUNT;
+        turn_opened = false;
+    }
+}
+
+lane_request_t *lane_scheduler_t::dispatch()
+{
+    lane_request_t  *ready = nullptr;
+    lane_request_t **last  = &ready;
+    uint64_t         now   = now_ns();
+
+    while (lane_request_t *req = pick(now))
+    {
+        *last = req;
+        last  = &req->next;
+    }
+    return ready;
+}
+
+void lane_scheduler_t::run(lane_request_t *ready)
+{
+    while (ready != nullptr)
+    {
+        lane_request_t *req = ready;
+        ready               = req->next;
+        req->next           = nullptr;
+
+        int flags = req->flags;
+        if (req->lane == LANE_HIGH && cfg.hipri)
+            flags |= RWF_HIPRI;
+
+        red_status_t rs = issue(req, flags);
+        if (rs == RED_SUCCESS)
+            continue;
+
+        /* Rejected at submission: free the slot and report the error */
+        lane_request_t *more;
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            lane_t                     &l = lanes[req->lane];
+
+            in_flight--;
+            l.in_flight--;
+            l.stats.in_flight--;
+            l.stats.completed++;
+            more = dispatch();
+        }
+        req->done(req, rs);
+
+        if (more != nullptr)
+        {
+            lane_request_t *tail = more;
+            while (tail->next != nullptr)
+                tail = tail->next;
+            tail->next = ready;
+            ready      = more;
+        }
+    }
+}
+
+} // namespace common
@@ -0,0 +1,163 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       md5.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Incremental MD5 for S3 ETags
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#include "../include/md5.hpp"
+
+namespace common
+{
+
+namespace
+{
+
+/* Per-round shift amounts and sine-derived constants of RFC 1321 */
+constexpr uint32_t SHIFTS[64] = {7,  12, 17, 22, 7,  12, 17, 22, 7,  12, 17, 22, 7,  12, 17, 22,
+                                 5,  9,  14, 20, 5,  9,  14, 20, 5,  9,  14, 20, 5,  9,  14, 20,
+                                 4,  11, 16, 23, 4,  11, 16, 23, 4,  11, 16, 23, 4,  11, 16, 23,
+                                 6,  10, 15, 21, 6,  10, 15, 21, 6,  10, 15, 21, 6,  10, 15, 21};
+
+constexpr uint32_t K[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613,
+    0xfd469501, 0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193,
+    0xa679438e, 0x49b40821, 0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d,
+    0x02441453, 0xd8a1e681, 0xe7d3fbc8, 0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed,
+    0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a, 0xfffa3942, 0x8771f681, 0x6d9d6122,
+    0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70, 0x289b7ec6, 0xeaa127fa,
+    0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665, 0xf4292244,
+    0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb,
+    0xeb86d391};
+
+inline uint32_t rotl(uint32_t x, uint32_t n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+} // namespace
+
+void md5_t::reset()
+{
+    state[0] = 0x67452301;
+    state[1] = 0xefcdab89;
+    state[2] = 0x98badcfe;
+    state[3] = 0x10325476;
+    bytes    = 0;
+}
+
+void md5_t::transform(const uint8_t *block)
+{
+    uint32_t m[16];
+    uint32_t a = state[0];
+    uint32_t b = state[1];
+    uint32_t c = state[2];
+    uint32_t d = state[3];
+
+    /* The words are little-endian, as is every host this library runs on */
+    memcpy(m, block, sizeof(m));
+
+    for (uint32_t i = 0; i < 64; i++)
+    {
+        uint32_t f;
+        uint32_t g;
+
+        if (i < 16)
+        {
+            f = (b & c) | (~b & d);
+            g = i;
+        }
+        else if (i < 32)
+        {
+            f = (d & b) | (~d & c);
+            g = (5 * i + 1) & 15;
+        }
+        else if (i < 48)
+        {
+            f = b ^ c ^ d;
+            g = (3 * i + 5) & 15;
+        }
+        else
+        {
+            f = c ^ (b | ~d);
+            g = (7 * i) & 15;
+        }
+
+        f = f + a + K[i] + m[g];
+        a = d;
+        d = c;
+        c = b;
+        b = b + rotl(f, SHIFTS[i]);
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+}
+
+void md5_t::update(const void *data, size_t size)
+{
+    const uint8_t *p    = static_cast<const uint8_t *>(data);
+    size_t         used = bytes & 63;
+
+    bytes += size;
+    if (used != 0)
+    {
+        size_t n = std::min(size, sizeof(buffer) - used);
+        memcpy(buffer + used, p, n);
+        p += n;
+        size -= n;
+        if (used + n < sizeof(buffer))
+            return;
+        transform(buffer);
+    }
+    for (; size >= sizeof(buffer); p += sizeof(buffer), size -= sizeof(buffer))
+        transform(p);
+    memcpy(buffer, p, size);
+}
+
+void md5_t::final(uint8_t digest[DIGEST_SIZE])
+{
+    static const uint8_t PAD[64] = {0x80};
+    uint64_t             bits    = bytes * 8;
+    size_t               used    = bytes & 63;
+
+    /* 0x80, zeros up to 56 bytes into a block, then the length in bits */
+    update(PAD, used < 56 ? 56 - used : 120 - used);
+    memcpy(buffer + 56, &bits, sizeof(bits));
+    transform(buffer);
+    memcpy(digest, state, DIGEST_SIZE);
+}
+
+void md5_t::final_hex(char hex[2 * DIGEST_SIZE + 1])
+{
+    uint8_t digest[DIGEST_SIZE];
+
+    final(digest);
+    for (size_t i = 0; i < DIGEST_SIZE; i++)
+        snprintf(hex + 2 * i, 3, "%02x", digest[i]);
+}
+
+} // namespace common
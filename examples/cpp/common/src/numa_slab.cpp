@@ -0,0 +1,349 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       numa_slab.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Hugepage slabs on the NUMA node of each service thread
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "../include/log.hpp"
+#include "../include/numa_slab.hpp"
+#include "../include/task_executor.hpp"
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#endif
+#ifndef MAP_HUGE_1GB
+#define MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+#endif
+
+namespace common
+{
+
+namespace
+{
+
+constexpr size_t SMALL_PAGE = 4096;
+
+size_t round_up(size_t n, size_t align)
+{
+    return (n + align - 1) / align * align;
+}
+
+/* Without libnuma: the examples do not link it */
+bool bind_to_node(void *addr, size_t len, int node)
+{
+    unsigned long mask[16] = {};
+    constexpr size_t BITS  = sizeof(unsigned long) * 8;
+
+    if (node < 0 || static_cast<size_t>(node) >= sizeof(mask) * 8)
+        return false;
+    mask[node / BITS] = 1ul << (node % BITS);
+    return syscall(SYS_mbind, addr, len, MPOL_BIND, mask, sizeof(mask) * 8, 0) == 0;
+}
+
+/* Ordinary pages aligned to @p align, so that they can become huge pages */
+void *map_aligned(size_t size, size_t align)
+{
+    size_t span = size + align;
+    void  *raw  = mmap(nullptr, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED)
+        return nullptr;
+
+    char  *start = static_cast<char *>(raw);
+    char  *base  = reinterpret_cast<char *>(round_up(reinterpret_cast<uintptr_t>(start), align));
+    size_t head  = static_cast<size_t>(base - start);
+    if (head != 0)
+        munmap(start, head);
+    if (span - head - size != 0)
+        munmap(base + size, span - head - size);
+    return base;
+}
+
+} // namespace
+
+int cpu_to_node(unsigned cpu)
+{
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u", cpu);
+
+    DIR *dir = opendir(path);
+    if (dir == nullptr)
+        return -1;
+
+    int            node = -1;
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        unsigned n;
+        char     tail;
+        if (sscanf(entry->d_name, "node%u%c", &n, &tail) == 1)
+        {
+            node = static_cast<int>(n);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+hugepage_source_t::hugepage_source_t(const hugepage_source_config_t &cfg)
+: cfg(cfg),
+  counters()
+{
+    if (this->cfg.page_size != HUGE_PAGE_1G)
+        this->cfg.page_size = HUGE_PAGE_2M;
+    this->cfg.slab_size = round_up(std::max(cfg.slab_size, this->cfg.page_size),
+                                   this->cfg.page_size);
+}
+
+hugepage_source_t::~hugepage_source_t()
+{
+    if (counters.handed != 0)
+        COMMON_LOG("hugepage source destroyed with %lu buffers handed out", counters.handed);
+
+    for (const slab_t &s : slabs)
+    {
+        if (cfg.register_slabs)
+            red_client_iomem_unregister(s.base);
+        munmap(s.base, s.size);
+    }
+}
+
+bool hugepage_source_t::map_slab(size_t size)
+{
+    int   huge = MAP_HUGETLB | (cfg.page_size == HUGE_PAGE_1G ? MAP_HUGE_1GB : MAP_HUGE_2MB);
+    void *base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | huge,
+                      -1, 0);
+    bool  hugetlb = base != MAP_FAILED;
+
+    if (!hugetlb)
+    {
+        /* No reserved huge pages of that size: let THP back the slab if it can */
+        base = map_aligned(size, cfg.page_size);
+        if (base == nullptr)
+        {
+            COMMON_LOG("mmap() of a %zu byte slab failed errno=%d", size, errno);
+            return false;
+        }
+        madvise(base, size, MADV_HUGEPAGE);
+    }
+
+    /* Bind before the first touch, which is what places the pages */
+    if (cfg.node >= 0 && !bind_to_node(base, size, cfg.node))
+    {
+        COMMON_LOG("mbind() to node %d failed errno=%d", cfg.node, errno);
+        counters.unbound++;
+    }
+    for (size_t off = 0; off < size; off += SMALL_PAGE)
+        static_cast<volatile char *>(base)[off] = 0;
+
+    if (cfg.register_slabs)
+    {
+        red_status_t rs = red_client_iomem_register(base, size);
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("red_client_iomem_register() of %zu bytes failed rs=%d", size, rs);
+            munmap(base, size);
+            return false;
+        }
+    }
+
+    slabs.push_back({static_cast<char *>(base), size, 0});
+    counters.slabs++;
+    counters.mapped += size;
+    if (hugetlb)
+        counters.hugetlb++;
+    else
+        counters.thp++;
+    return true;
+}
+
+void *hugepage_source_t::alloc(size_t size)
+{
+    size = round_up(std::max<size_t>(size, 1), SMALL_PAGE);
+
+    std::lock_guard<std::mutex> guard(lock);
+    std::vector<void *>        &reuse = free_bufs[size];
+    void                       *buf   = nullptr;
+
+    if (!reuse.empty())
+    {
+        buf = reuse.back();
+        reuse.pop_back();
+    }
+    else
+    {
+        auto fits = [size](const slab_t &s) { return s.size - s.used >= size; };
+        auto it   = std::find_if(slabs.begin(), slabs.end(), fits);
+        if (it == slabs.end())
+        {
+            if (!map_slab(round_up(std::max(size, cfg.slab_size), cfg.page_size)))
+                return nullptr;
+            it = slabs.end() - 1;
+        }
+        buf = it->base + it->used;
+        it->used += size;
+    }
+
+    sizes[buf] = size;
+    counters.handed++;
+    return buf;
+}
+
+void hugepage_source_t::free(void *buf)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto it = sizes.find(buf);
+    if (it == sizes.end())
+    {
+        COMMON_LOG("buffer %p was not handed out by this source", buf);
+        return;
+    }
+    free_bufs[it->second].push_back(buf);
+    sizes.erase(it);
+    counters.handed--;
+}
+
+hugepage_source_stats_t hugepage_source_t::stats() const
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return counters;
+}
+
+numa_buffer_pools_t::numa_buffer_pools_t(const numa_pools_config_t &cfg)
+: cfg(cfg)
+{
+}
+
+numa_buffer_pools_t::~numa_buffer_pools_t() = default;
+
+red_status_t numa_buffer_pools_t::init(const char *coremask)
+{
+    std::vector<unsigned> cpus;
+
+    if (!pools.empty())
+        return RED_EINVAL;
+
+    if (coremask != nullptr)
+    {
+        red_status_t rs = parse_coremask(coremask, &cpus);
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("invalid coremask '%s'", coremask);
+            return rs;
+        }
+    }
+
+    auto pool_for_node = [this](int node) {
+        for (unsigned i = 0; i < pools.size(); i++)
+        {
+            if (pools[i].node == node)
+                return i;
+        }
+
+        node_pool_t np;
+        np.node   = node;
+        np.source = std::make_unique<hugepage_source_t>(
+            hugepage_source_config_t{node, cfg.page_size, cfg.slab_size, true});
+
+        buffer_pool_config_t pcfg = cfg.pool;
+        pcfg.source               = np.source.get();
+        np.pool                   = std::make_unique<buffer_pool_t>(pcfg);
+        pools.push_back(std::move(np));
+        return static_cast<unsigned>(pools.size() - 1);
+    };
+
+    /* The first CPU of the coremask a service thread runs on decides its node */
+    std::vector<bool> placed;
+    for (unsigned cpu : cpus)
+    {
+        red_rc_t id = red_client_get_lcore_2_service_thread_id(cpu);
+        if (id < 0)
+            continue;
+
+        auto sthread = static_cast<unsigned>(id);
+        if (sthread >= by_sthread.size())
+        {
+            by_sthread.resize(sthread + 1, 0);
+            placed.resize(sthread + 1, false);
+        }
+        if (placed[sthread])
+            continue;
+        by_sthread[sthread] = pool_for_node(cpu_to_node(cpu));
+        placed[sthread]     = true;
+    }
+    if (pools.empty())
+        pool_for_node(-1);
+
+    for (node_pool_t &np : pools)
+    {
+        red_status_t rs = np.pool->init();
+        if (rs != RED_SUCCESS)
+        {
+            pools.clear();
+            by_sthread.clear();
+            return rs;
+        }
+    }
+    return RED_SUCCESS;
+}
+
+unsigned numa_buffer_pools_t::index_of(unsigned sthread) const
+{
+    return sthread < by_sthread.size() ? by_sthread[sthread] : 0;
+}
+
+red_status_t numa_buffer_pools_t::acquire(unsigned sthread, buffer_lease_t *lease)
+{
+    if (pools.empty())
+        return RED_EINVAL;
+    return pools[index_of(sthread)].pool->acquire(lease);
+}
+
+int numa_buffer_pools_t::node_of(unsigned sthread) const
+{
+    return pools.empty() ? -1 : pools[index_of(sthread)].node;
+}
+
+buffer_pool_t &numa_buffer_pools_t::pool_of(unsigned sthread)
+{
+    return *pools[index_of(sthread)].pool;
+}
+
+hugepage_source_t &numa_buffer_pools_t::source_of(unsigned sthread)
+{
+    return *pools[index_of(sthread)].source;
+}
+
+} // namespace common
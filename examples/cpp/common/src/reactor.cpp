@@ -0,0 +1,498 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       reactor.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Per-thread completion reactor shared by the synchronous wrappers
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cerrno>
+#include <future>
+#include <poll.h>
+#include <thread>
+
+#include "../include/log.hpp"
+#include "../include/reactor.hpp"
+
+namespace common
+{
+
+namespace
+{
+thread_local reactor_t *tls_reactor = nullptr;
+
+/* Weight of the latest sample in wait_stats_t::latency_ns, as a shift */
+constexpr unsigned LATENCY_EWMA_SHIFT = 3;
+
+/* Longest run of waits the adaptive policy skips spinning after misses */
+constexpr unsigned MAX_SPIN_BACKOFF = 64;
+
+/* Entries of the handoff ring; a full ring falls back to post() */
+constexpr size_t HANDOFF_RING_SIZE = 1024;
+
+/* Identifies the calling thread as a handoff producer */
+thread_local char tls_producer_tag;
+
+inline uint64_t cycles_to_ns(uint64_t cycles, uint64_t hz)
+{
+    return static_cast<uint64_t>(static_cast<double>(cycles) * 1e9 / static_cast<double>(hz));
+}
+
+inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+} // namespace
+
+/*
+ * Runs what is posted to reactors whose thread has exited, such as the close
+ * of a handle from a late completion, on a thread of its own started on first
+ * use. Completions of the calls it makes are drained by its own reactor.
+ */
+class orphan_thread_t
+{
+public:
+    static orphan_thread_t &get()
+    {
+        static orphan_thread_t orphans;
+        return orphans;
+    }
+
+    ~orphan_thread_t()
+    {
+        if (!thread.joinable())
+            return;
+        stop.store(true, std::memory_order_release);
+        reactor->kick();
+        thread.join();
+    }
+
+    void post(void (*fn)(void *), void *arg)
+    {
+        std::call_once(started, [this]() { start(); });
+        if (stop.load(std::memory_order_acquire))
+        {
+            COMMON_LOG("dropping work posted to an exited thread at shutdown");
+            return;
+        }
+        reactor->post(fn, arg);
+    }
+
+    bool owns(const reactor_t *r) const
+    {
+        return r == own.load(std::memory_order_acquire);
+    }
+
+private:
+    void start()
+    {
+        std::promise<reactor_t *> ready;
+        thread = std::thread([this, &ready]() {
+            reactor_t &r = reactor_t::local();
+            own.store(&r, std::memory_order_release);
+            ready.set_value(&r);
+            while (!stop.load(std::memory_order_acquire))
+            {
+                if (r.wait(stop) != RED_SUCCESS)
+                {
+                    COMMON_LOG("orphan thread wait failed, stopping");
+                    break;
+                }
+            }
+        });
+        reactor = ready.get_future().get();
+    }
+
+    std::once_flag           started;
+    std::thread              thread;
+    reactor_t               *reactor = nullptr;
+    std::atomic<reactor_t *> own{nullptr};
+    std::atomic<bool>        stop{false};
+};
+
+/* Retires the reactor when its thread exits */
+struct reactor_t::holder_t
+{
+    reactor_t *reactor = nullptr;
+
+    ~holder_t()
+    {
+        if (reactor != nullptr)
+            reactor->retire();
+        reactor = nullptr;
+    }
+};
+
+reactor_t &reactor_t::local()
+{
+    static thread_local holder_t holder;
+
+    if (holder.reactor == nullptr)
+        holder.reactor = new reactor_t;
+    return *holder.reactor;
+}
+
+reactor_t::reactor_t()
+: nfds(1),
+  poll_fd_resolved(false),
+  drain_stats(),
+  wait_policy(),
+  wait_stats(),
+  timer_hz(0),
+  spin_backoff(0),
+  spin_skip(0),
+  posted_count(0),
+  retired(false),
+  refs(1),
+  handoff_on(false),
+  sleeping(false),
+  producer(nullptr)
+{
+    pfds[0] = {.fd = eventfd.get_fd(), .events = POLLIN, .revents = 0};
+    pfds[1] = {.fd = -1, .events = POLLIN, .revents = 0};
+    tls_reactor = this;
+}
+
+reactor_t::~reactor_t()
+{
+    if (tls_reactor == this)
+        tls_reactor = nullptr;
+}
+
+void reactor_t::retire()
+{
+    std::vector<posted_t> left;
+
+    tls_reactor = nullptr;
+    {
+        std::lock_guard<std::mutex> guard(posted_lock);
+        retired = true;
+        left.swap(posted);
+        posted_count.store(0, std::memory_order_relaxed);
+    }
+
+    /* Nobody waits here any more: hand what is pending to the orphan thread */
+    orphan_thread_t &orphans = orphan_thread_t::get();
+    if (orphans.owns(this))
+    {
+        if (!left.empty())
+            COMMON_LOG("orphan thread exits with %zu posted entries", left.size());
+    }
+    else
+    {
+        for (const posted_t &p : left)
+            orphans.post(p.fn, p.arg);
+    }
+    unhold();
+}
+
+void reactor_t::hold()
+{
+    refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+void reactor_t::unhold()
+{
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        delete this;
+}
+
+bool reactor_t::is_local() const
+{
+    return tls_reactor == this;
+}
+
+void reactor_t::kick()
+{
+    eventfd.kick();
+}
+
+void reactor_t::post(void (*fn)(void *), void *arg)
+{
+    bool gone;
+    {
+        std::lock_guard<std::mutex> guard(posted_lock);
+        gone = retired;
+        if (!gone)
+        {
+            posted.push_back({fn, arg});
+            posted_count.fetch_add(1, std::memory_order_release);
+        }
+    }
+    if (gone)
+        orphan_thread_t::get().post(fn, arg);
+    else
+        eventfd.kick();
+}
+
+bool reactor_t::handoff(void (*fn)(void *), void *arg)
+{
+    if (!handoff_on.load(std::memory_order_acquire))
+        return false;
+
+    /* The ring has a single producer: the first thread to get here */
+    const void *self = &tls_producer_tag;
+    const void *prev = producer.load(std::memory_order_relaxed);
+    if (prev != self && (prev != nullptr || !producer.compare_exchange_strong(
+                                                prev, self, std::memory_order_relaxed)))
+        return false;
+
+    if (!ring->push({fn, arg}))
+        return false;
+
+    /* Pairs with the fence in park(): either the owner sees the entry before
+     * sleeping, or we see it asleep and kick */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping.load(std::memory_order_relaxed))
+        eventfd.kick();
+    return true;
+}
+
+void reactor_t::run_handoff()
+{
+    posted_t p;
+    while (ring->pop(&p))
+        p.fn(p.arg);
+}
+
+bool reactor_t::park()
+{
+    if (!ring)
+        return true;
+
+    sleeping.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ring->empty())
+        return true;
+
+    sleeping.store(false, std::memory_order_relaxed);
+    run_handoff();
+    return false;
+}
+
+void reactor_t::run_posted()
+{
+    /* Taken by value: a posted function may itself wait on this reactor */
+    std::vector<posted_t> batch;
+    {
+        std::lock_guard<std::mutex> guard(posted_lock);
+        batch.swap(posted);
+        posted_count.store(0, std::memory_order_relaxed);
+    }
+    for (const posted_t &p : batch)
+    {
+        p.fn(p.arg);
+    }
+}
+
+void reactor_t::resolve_poll_fd()
+{
+    /*
+     * The thread's ring only exists once it has issued an operation, so the
+     * poll fd is looked up on the first wait rather than at construction.
+     * With the poller thread enabled there is no fd (-1) and completions only
+     * arrive through kick().
+     */
+    pfds[1].fd       = red_client_lib_poll_fd();
+    timer_hz         = red_client_get_timer_hz();
+    nfds             = pfds[1].fd >= 0 ? 2 : 1;
+    poll_fd_resolved = true;
+}
+
+uint64_t reactor_t::spin_budget_cycles()
+{
+    uint64_t budget_ns = wait_policy.spin_budget_ns;
+
+    if (wait_policy.mode == wait_mode_e::BLOCK || timer_hz == 0)
+        return 0;
+
+    if (wait_policy.mode == wait_mode_e::ADAPTIVE && spin_skip > 0)
+    {
+        spin_skip--;
+        return 0;
+    }
+
+    if (wait_policy.mode == wait_mode_e::ADAPTIVE && wait_stats.samples > 0)
+    {
+        /*
+         * Spinning only pays off when the completion is likely to arrive
+         * within the budget; slower ops go to sleep straight away.
+         */
+        uint64_t expected = 2 * wait_stats.latency_ns;
+        budget_ns         = expected <= budget_ns ? expected : 0;
+    }
+
+    return budget_ns * timer_hz / 1000000000ull;
+}
+
+bool reactor_t::spin(const std::atomic<bool> &done, uint64_t budget_cycles)
+{
+    uint64_t start = red_client_get_timer_cycles();
+    uint64_t now   = start;
+
+    while (!done.load(std::memory_order_acquire) && now - start < budget_cycles)
+    {
+        if (nfds > 1)
+            drain_completions(&drain_stats);
+        if (posted_count.load(std::memory_order_acquire) != 0)
+            run_posted();
+        if (ring)
+            run_handoff();
+        if (done.load(std::memory_order_acquire))
+            break;
+
+        cpu_relax();
+        now = red_client_get_timer_cycles();
+    }
+
+    wait_stats.spin_ns += cycles_to_ns(now - start, timer_hz);
+    return done.load(std::memory_order_acquire);
+}
+
+int reactor_t::block(deadline_t deadline)
+{
+    if (deadline == NO_DEADLINE)
+        return poll(pfds, nfds, -1);
+
+    auto remaining = deadline - std::chrono::steady_clock::now();
+    if (remaining <= std::chrono::steady_clock::duration::zero())
+    {
+        errno = ETIMEDOUT;
+        return -1;
+    }
+
+    auto            ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining);
+    struct timespec ts = {.tv_sec  = static_cast<time_t>(ns.count() / 1000000000),
+                          .tv_nsec = static_cast<long>(ns.count() % 1000000000)};
+    return ppoll(pfds, nfds, &ts, nullptr);
+}
+
+red_status_t reactor_t::wait(const std::atomic<bool> &done, deadline_t deadline)
+{
+    if (!poll_fd_resolved)
+    {
+        resolve_poll_fd();
+    }
+    wait_stats.waits++;
+
+    uint64_t start  = red_client_get_timer_cycles();
+    uint64_t budget = spin_budget_cycles();
+    if (budget > 0 && deadline != NO_DEADLINE)
+    {
+        /* Never spin past the deadline */
+        double left = std::chrono::duration<double>(deadline - std::chrono::steady_clock::now())
+                          .count();
+        budget      = left > 0 ? std::min(budget, static_cast<uint64_t>(left * timer_hz)) : 0;
+    }
+    bool spun = budget > 0 && spin(done, budget);
+
+    if (spun)
+    {
+        wait_stats.spun++;
+        spin_backoff = 0;
+    }
+    else if (!done.load(std::memory_order_acquire))
+    {
+        wait_stats.blocked++;
+        if (budget > 0 && wait_policy.mode == wait_mode_e::ADAPTIVE)
+        {
+            /* The spin missed: the service may be slower than it looks, or
+             * has no free core to complete on while we spin */
+            spin_backoff = std::min(std::max(1u, spin_backoff * 2), MAX_SPIN_BACKOFF);
+            spin_skip    = spin_backoff;
+        }
+    }
+
+    while (!done.load(std::memory_order_acquire))
+    {
+        if (!park())
+            continue;
+
+        int rc = block(deadline);
+        sleeping.store(false, std::memory_order_relaxed);
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return errno == ETIMEDOUT ? RED_ETIMEDOUT : RED_EINVAL;
+        }
+
+        if (rc == 0)
+            continue;
+
+        if (pfds[0].revents & POLLIN)
+        {
+            /* kicked by a callback running on another thread */
+            eventfd.read();
+            run_posted();
+        }
+
+        if (ring)
+            run_handoff();
+
+        if (nfds > 1 && (pfds[1].revents & POLLIN))
+        {
+            /* Handle everything that is ready before blocking in poll() again */
+            drain_completions(&drain_stats);
+        }
+    }
+
+    if (timer_hz == 0)
+        return RED_SUCCESS;
+
+    /* Timed out waits return above and do not feed the latency estimate */
+    uint64_t latency_ns = cycles_to_ns(red_client_get_timer_cycles() - start, timer_hz);
+    if (wait_stats.samples++ == 0)
+        wait_stats.latency_ns = latency_ns;
+    else
+        wait_stats.latency_ns = wait_stats.latency_ns -
+                                (wait_stats.latency_ns >> LATENCY_EWMA_SHIFT) +
+                                (latency_ns >> LATENCY_EWMA_SHIFT);
+
+    return RED_SUCCESS;
+}
+
+const drain_stats_t &reactor_t::stats() const
+{
+    return drain_stats;
+}
+
+void reactor_t::set_policy(const wait_policy_t &policy)
+{
+    wait_policy = policy;
+    if (policy.handoff && !ring)
+        ring.reset(new spsc_ring_t<posted_t>(HANDOFF_RING_SIZE));
+    handoff_on.store(policy.handoff, std::memory_order_release);
+}
+
+const wait_policy_t &reactor_t::policy() const
+{
+    return wait_policy;
+}
+
+const wait_stats_t &reactor_t::spin_stats() const
+{
+    return wait_stats;
+}
+
+} // namespace common
@@ -0,0 +1,219 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       sg_list.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Scatter/gather list builder for the KV calls
+ *
+ ******************************************************************************/
+
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "../include/sg_list.hpp"
+
+namespace common
+{
+
+namespace
+{
+
+/* Spilled arrays hold 16 to 64K elements; larger ones are not kept */
+constexpr unsigned MIN_SHIFT = 4;
+constexpr unsigned MAX_SHIFT = 16;
+constexpr unsigned KEEP      = 4; /* Arrays kept per size */
+
+struct spill_cache_t
+{
+    red_sg_elem_t   *free_arrays[MAX_SHIFT + 1][KEEP];
+    unsigned         count[MAX_SHIFT + 1] = {};
+    sg_arena_stats_t stats                = {};
+
+    ~spill_cache_t()
+    {
+        for (unsigned s = MIN_SHIFT; s <= MAX_SHIFT; s++)
+        {
+            for (unsigned i = 0; i < count[s]; i++)
+                ::free(free_arrays[s][i]);
+        }
+    }
+};
+
+spill_cache_t &local_spills()
+{
+    static thread_local spill_cache_t cache;
+    return cache;
+}
+
+unsigned shift_for(size_t elems)
+{
+    unsigned s = MIN_SHIFT;
+    while ((size_t(1) << s) < elems)
+        s++;
+    return s;
+}
+
+red_sg_elem_t *spill_alloc(size_t elems, size_t *capacity)
+{
+    spill_cache_t &c = local_spills();
+    unsigned       s = shift_for(elems);
+
+    red_sg_elem_t *arr;
+    if (s <= MAX_SHIFT && c.count[s] != 0)
+    {
+        arr = c.free_arrays[s][--c.count[s]];
+        c.stats.reused++;
+    }
+    else
+    {
+        arr = static_cast<red_sg_elem_t *>(malloc(sizeof(red_sg_elem_t) << s));
+        if (arr == nullptr)
+            return nullptr;
+        c.stats.mallocs++;
+    }
+    c.stats.spills++;
+    *capacity = size_t(1) << s;
+    return arr;
+}
+
+void spill_free(red_sg_elem_t *arr, size_t capacity)
+{
+    spill_cache_t &c = local_spills();
+    unsigned       s = shift_for(capacity);
+
+    if (s <= MAX_SHIFT && c.count[s] < KEEP)
+        c.free_arrays[s][c.count[s]++] = arr;
+    else
+        ::free(arr);
+}
+
+} // namespace
+
+sg_arena_stats_t sg_arena_stats()
+{
+    return local_spills().stats;
+}
+
+sg_list_t::~sg_list_t()
+{
+    release();
+}
+
+sg_list_t::sg_list_t(sg_list_t &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+sg_list_t &sg_list_t::operator=(sg_list_t &&other) noexcept
+{
+    if (this == &other)
+        return *this;
+
+    release();
+    view     = other.view;
+    capacity = other.capacity;
+    if (!other.spilled())
+    {
+        memcpy(inline_elems, other.inline_elems, view.num_elems * sizeof(red_sg_elem_t));
+        view.sg_elem = inline_elems;
+    }
+
+    other.view     = {0, 0, other.inline_elems};
+    other.capacity = SG_INLINE_ELEMS;
+    return *this;
+}
+
+void sg_list_t::release()
+{
+    if (spilled())
+        spill_free(view.sg_elem, capacity);
+    view     = {0, 0, inline_elems};
+    capacity = SG_INLINE_ELEMS;
+}
+
+bool sg_list_t::grow(size_t elems)
+{
+    size_t         grown;
+    red_sg_elem_t *arr = spill_alloc(elems, &grown);
+    if (arr == nullptr)
+        return false;
+
+    memcpy(arr, view.sg_elem, view.num_elems * sizeof(red_sg_elem_t));
+    if (spilled())
+        spill_free(view.sg_elem, capacity);
+    view.sg_elem = arr;
+    capacity     = grown;
+    return true;
+}
+
+red_status_t sg_list_t::append(const red_buffer_t *bufs, size_t count)
+{
+    if (view.num_elems + count > capacity && !grow(view.num_elems + count))
+        return RED_ENOMEM;
+
+    /*
+     * The sizes and where the last element ends are kept in locals, so that
+     * the loop only stores: each element store could otherwise alias them.
+     * Buffers start at offset 0 of their own address, so only plain memory
+     * continues the last element.
+     */
+    red_sg_elem_t *elems = view.sg_elem;
+    size_t         n     = view.num_elems;
+    size_t         bytes = view.val_size;
+    char          *end   = nullptr;
+    if (n != 0 && elems[n - 1].iomem.hndl == nullptr)
+        end = static_cast<char *>(elems[n - 1].addr) + elems[n - 1].offset + elems[n - 1].size;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const red_buffer_t &b = bufs[i];
+        if (b.size == 0)
+            continue;
+
+        bytes += b.size;
+        if (b.iomem.hndl == nullptr && end != nullptr && b.addr == end)
+        {
+            elems[n - 1].size += b.size;
+            end += b.size;
+            continue;
+        }
+        elems[n++] = {b.iomem, b.addr, 0, b.size};
+        end        = b.iomem.hndl == nullptr ? static_cast<char *>(b.addr) + b.size : nullptr;
+    }
+    view.num_elems = n;
+    view.val_size  = bytes;
+    return RED_SUCCESS;
+}
+
+red_status_t sg_list_t::append(const iomem_lease_t &lease)
+{
+    return append(lease, 0, lease.size());
+}
+
+red_status_t sg_list_t::append(const iomem_lease_t &lease, off_t offset, size_t size)
+{
+    if (offset < 0 || static_cast<size_t>(offset) > lease.size() ||
+        size > lease.size() - static_cast<size_t>(offset))
+        return RED_EINVAL;
+
+    /* Region base and offset in it, as the library resolves iomem elements */
+    char *base = static_cast<char *>(lease.addr()) - lease.offset();
+    return push(lease.iomem(), base, lease.offset() + offset, size);
+}
+
+} // namespace common
@@ -22,148 +22,161 @@
  ******************************************************************************/
 
 #include "../include/sync_api.hpp"
-#include <cerrno>
-#include <poll.h>
 #include <red/red_client_api.h>
 #include <red/red_ds_api.h>
 #include <red/red_s3_api.h>
 #include <red/red_fs_api.h>
+#include <red/red_queue_api.h>
 
 namespace common
 {
 
-sync_api_t::sync_api_t()
-: rs(RED_SUCCESS)
+sync_api_t::sync_api_t(deadline_t deadline)
+: deadline(deadline),
+  slot(&inline_slot)
 {
-    ucb.ucb_fun = sync_api_t::callback;
-    ucb.ucb_arg = this;
+    if (deadline == NO_DEADLINE)
+        inline_slot.init_inline();
+    else
+        slot = completion_slot_t::acquire();
 }
 
-void sync_api_t::done(red_status_t status)
+sync_api_t::~sync_api_t()
 {
-    rs = status;
-    eventfd.kick();
+    if (slot->pooled)
+        slot->release();
 }
 
-void sync_api_t::callback(red_status_t status, void *arg)
+void set_wait_policy(const wait_policy_t &policy)
 {
-    auto *me = static_cast<sync_api_t *>(arg);
-    me->done(status);
+    reactor_t::local().set_policy(policy);
+}
+
+const wait_policy_t &get_wait_policy()
+{
+    return reactor_t::local().policy();
 }
 
 rfs_usercb_t *sync_api_t::get_ucb()
 {
-    return &ucb;
+    return slot->usercb();
+}
+
+rfs_open_hndl_t *sync_api_t::stage(rfs_open_hndl_t *oh)
+{
+    return static_cast<rfs_open_hndl_t *>(
+        slot->stage(oh, sizeof(*oh), completion_slot_t::cleanup_e::CLOSE));
+}
+
+rfs_dataset_hndl_t *sync_api_t::stage(rfs_dataset_hndl_t *ds_hndl)
+{
+    return static_cast<rfs_dataset_hndl_t *>(
+        slot->stage(ds_hndl, sizeof(*ds_hndl), completion_slot_t::cleanup_e::CLOSE_DATASET));
+}
+
+red_iomem_hndl_t *sync_api_t::stage(red_iomem_hndl_t *iomem)
+{
+    return static_cast<red_iomem_hndl_t *>(
+        slot->stage(iomem, sizeof(*iomem), completion_slot_t::cleanup_e::FREE_IOMEM));
 }
 
 red_status_t sync_api_t::wait(int rc)
 {
     if (rc != 0)
     {
-        done((red_status_t)rc);
-        return rs;
+        /* The callback will not run: drop its reference */
+        if (slot->pooled)
+            slot->release();
+        return (red_status_t)rc;
     }
 
-    struct pollfd pfds[2] = {
-        {.fd = eventfd.get_fd(), .events = POLLIN, .revents = 0},
-        {.fd = red_client_lib_poll_fd(), .events = POLLIN, .revents = 0}};
+    red_status_t wait_rs = slot->reactor->wait(slot->completed, deadline);
+    if (wait_rs == RED_ETIMEDOUT)
+    {
+        if (slot->abandon())
+            return RED_ETIMEDOUT;
 
-    while (true)
+        /* Completed while we were giving up: the flag is about to be set */
+        wait_rs = slot->reactor->wait(slot->completed);
+    }
+    if (wait_rs != RED_SUCCESS)
     {
-        rc = poll(pfds, 2, -1);
-        if (rc < 0)
-        {
-            if (errno == EINTR)
-                continue;
-            return RED_EINVAL;
-        }
-
-        if (rc == 0)
-            continue;
-
-        if (pfds[0].revents & POLLIN)
-        {
-            /* evenfd kicked in done() */
-            if (!eventfd.read())
-            {
-                continue;
-            }
-            break;
-        }
-
-        if (pfds[1].revents & POLLIN)
-        {
-            rfs_usercomp_t ucp = {};
-            rc                 = red_client_lib_poll(&ucp, 1);
-            if (rc == 1 && ucp.ucp_fun)
-            {
-                ucp.ucp_fun(ucp.ucp_res, ucp.ucp_arg);
-            }
-        }
+        return wait_rs;
     }
 
-    return rs;
+    slot->commit();
+    return slot->rs;
 }
 } // namespace common
 
 namespace red
 {
-red_status_t red_s3_create_version(rfs_open_hndl_t  dir_oh,
-                                   const char      *tgt_name,
-                                   int              flags,
-                                   rfs_open_hndl_t *created_oh,
-                                   red_api_user_t  *user)
+red_status_t red_s3_create_version(rfs_open_hndl_t    dir_oh,
+                                   const char        *tgt_name,
+                                   int                flags,
+                                   rfs_open_hndl_t   *created_oh,
+                                   red_api_user_t    *user,
+                                   common::deadline_t deadline)
 {
-    common::sync_api_t sync;
-    int rc = ::red_s3_create_version(dir_oh, tgt_name, flags, created_oh, sync.get_ucb(),
-                                     user);
+    common::sync_api_t sync(deadline);
+    int rc = ::red_s3_create_version(dir_oh, tgt_name, flags, sync.stage(created_oh),
+                                     sync.get_ucb(), user);
     return sync.wait(rc);
 }
 
-red_status_t red_s3_open(rfs_open_hndl_t  dir_oh,
-                         const char      *s3_key,
-                         uint64_t         version,
-                         int              flags,
-                         rfs_open_hndl_t *oh,
-                         uint64_t        *out_version,
-                         red_api_user_t  *api_user)
+red_status_t red_s3_open(rfs_open_hndl_t    dir_oh,
+                         const char        *s3_key,
+                         uint64_t           version,
+                         int                flags,
+                         rfs_open_hndl_t   *oh,
+                         uint64_t          *out_version,
+                         red_api_user_t    *api_user,
+                         common::deadline_t deadline)
 {
-    common::sync_api_t sync;
+    common::sync_api_t sync(deadline);
 
-    int rc = ::red_s3_open(dir_oh, s3_key, version, flags, oh, out_version,
-                           sync.get_ucb(), api_user);
+    int rc = ::red_s3_open(dir_oh, s3_key, version, flags, sync.stage(oh),
+                           sync.stage(out_version), sync.get_ucb(), api_user);
     return sync.wait(rc);
 }
 
-red_status_t red_s3_publish(rfs_open_hndl_t oh, uint64_t *version, red_api_user_t *user)
+red_status_t red_s3_publish(rfs_open_hndl_t    oh,
+                            uint64_t          *version,
+                            red_api_user_t    *user,
+                            common::deadline_t deadline)
 {
-    common::sync_api_t sync;
-    int                rc = ::red_s3_publish(oh, version, sync.get_ucb(), user);
+    common::sync_api_t sync(deadline);
+    int rc = ::red_s3_publish(oh, sync.stage(version), sync.get_ucb(), user);
     return sync.wait(rc);
 }
 
-red_status_t red_pwrite(rfs_open_hndl_t oh,
-                        void           *buff,
-                        size_t          size,
-                        off_t           off,
-                        ssize_t        *ret_size,
-                        red_api_user_t *user)
+red_status_t red_pwrite(rfs_open_hndl_t    oh,
+                        void              *buff,
+                        size_t             size,
+                        off_t              off,
+                        ssize_t           *ret_size,
+                        red_api_user_t    *user,
+                        common::deadline_t deadline)
 {
-    common::sync_api_t sync;
-    int rc = red_pwrite(oh, buff, size, off, ret_size, sync.get_ucb(), user);
+    common::sync_api_t sync(deadline);
+    int rc = red_pwrite(oh, buff, size, off, sync.stage(ret_size), sync.get_ucb(), user);
     return sync.wait(rc);
 }
 
-red_status_t red_close(rfs_open_hndl_t oh, red_api_user_t *user)
+red_status_t red_close(rfs_open_hndl_t    oh,
+                       red_api_user_t    *user,
+                       common::deadline_t deadline)
 {
-    common::sync_api_t sync;
+    common::sync_api_t sync(deadline);
     int                rc = ::red_close(oh, sync.get_ucb(), user);
     return sync.wait(rc);
 }
 
-red_status_t red_close_dataset(rfs_dataset_hndl_t ds_hndl, red_api_user_t *user)
+red_status_t red_close_dataset(rfs_dataset_hndl_t ds_hndl,
+                               red_api_user_t    *user,
+                               common::deadline_t deadline)
 {
-    common::sync_api_t sync;
+    common::sync_api_t sync(deadline);
     int                rc = ::red_close_dataset(ds_hndl, sync.get_ucb(), user);
     return sync.wait(rc);
 }
@@ -174,44 +187,49 @@ red_status_t red_s3_create_bucket(const char         *bucket_name,
                                   const char         *subtenant,
                                   red_ds_props_t     *bucket_props,
                                   rfs_dataset_hndl_t *bucket_hndl,
-                                  red_api_user_t     *user)
+                                  red_api_user_t     *user,
+                                  common::deadline_t  deadline)
 {
-    common::sync_api_t sync;
+    common::sync_api_t sync(deadline);
     int rc = ::red_s3_create_bucket(bucket_name, cluster, tenant, subtenant, bucket_props,
-                                    bucket_hndl, sync.get_ucb(), user);
+                                    sync.stage(bucket_hndl), sync.get_ucb(), user);
     return sync.wait(rc);
 }
 
 red_status_t red_open_root(rfs_dataset_hndl_t ds_hndl,
                            rfs_open_hndl_t   *root_oh,
-                           red_api_user_t    *user)
+                           red_api_user_t    *user,
+                           common::deadline_t deadline)
 {
-    common::sync_api_t sync;
-    int                rc = ::red_open_root(ds_hndl, root_oh, sync.get_ucb(), user);
+    common::sync_api_t sync(deadline);
+    int rc = ::red_open_root(ds_hndl, sync.stage(root_oh), sync.get_ucb(), user);
     return sync.wait(rc);
 }
 
-red_status_t red_fsetxattr(rfs_open_hndl_t oh,
-                           const char     *name,
-                           const void     *value,
-                           size_t          size,
-                           int             flags,
-                           red_api_user_t *user)
+red_status_t red_fsetxattr(rfs_open_hndl_t    oh,
+                           const char        *name,
+                           const void        *value,
+                           size_t             size,
+                           int                flags,
+                           red_api_user_t    *user,
+                           common::deadline_t deadline)
 {
-    common::sync_api_t sync;
+    common::sync_api_t sync(deadline);
     int rc = ::red_fsetxattr(oh, name, value, size, flags, sync.get_ucb(), user);
     return sync.wait(rc);
 }
 
-red_status_t red_fgetxattr(rfs_open_hndl_t oh,
-                           const char     *name,
-                           void           *value,
-                           size_t          size,
-                           size_t         *ret_size,
-                           red_api_user_t *user)
+red_status_t red_fgetxattr(rfs_open_hndl_t    oh,
+                           const char        *name,
+                           void              *value,
+                           size_t             size,
+                           size_t            *ret_size,
+                           red_api_user_t    *user,
+                           common::deadline_t deadline)
 {
-    common::sync_api_t sync;
-    int rc = ::red_fgetxattr(oh, name, value, size, ret_size, sync.get_ucb(), user);
+    common::sync_api_t sync(deadline);
+    int rc = ::red_fgetxattr(oh, name, value, size, sync.stage(ret_size), sync.get_ucb(),
+                             user);
     return sync.wait(rc);
 }
 
@@ -219,35 +237,103 @@ red_status_t red_obtain_dataset(const char         *ds_name,
                                 const char         *cluster,
                                 red_ds_props_t     *ds_props,
                                 rfs_dataset_hndl_t *ds_hndl,
-                                red_api_user_t     *user)
+                                red_api_user_t     *user,
+                                common::deadline_t  deadline)
+{
+    common::sync_api_t sync(deadline);
+    int rc = ::red_obtain_dataset(ds_name, cluster, ds_props, sync.stage(ds_hndl),
+                                  sync.get_ucb(), user);
+    return sync.wait(rc);
+}
+
+red_status_t red_openat(rfs_open_hndl_t    dir_oh,
+                        const char        *pathname,
+                        int                flags,
+                        mode_t             mode,
+                        rfs_open_hndl_t   *oh,
+                        red_api_user_t    *user,
+                        common::deadline_t deadline)
+{
+    common::sync_api_t sync(deadline);
+    int rc = ::red_openat(dir_oh, pathname, flags, mode, sync.stage(oh), sync.get_ucb(), user);
+    return sync.wait(rc);
+}
+
+red_status_t red_pread(rfs_open_hndl_t    oh,
+                       void              *buff,
+                       size_t             size,
+                       off_t              off,
+                       ssize_t           *ret_size,
+                       red_api_user_t    *user,
+                       common::deadline_t deadline)
+{
+    common::sync_api_t sync(deadline);
+    int rc = ::red_pread(oh, buff, size, off, sync.stage(ret_size), sync.get_ucb(), user);
+    return sync.wait(rc);
+}
+
+red_status_t red_pread_iomem(rfs_open_hndl_t    oh,
+                             red_iomem_hndl_t   iomem,
+                             void              *addr,
+                             size_t             size,
+                             off_t              off,
+                             ssize_t           *ret_size,
+                             red_api_user_t    *user,
+                             common::deadline_t deadline)
+{
+    common::sync_api_t sync(deadline);
+    int rc = ::red_pread_iomem(oh, iomem, addr, size, off, sync.stage(ret_size), sync.get_ucb(),
+                               user);
+    return sync.wait(rc);
+}
+
+red_status_t red_pwrite_iomem(rfs_open_hndl_t    oh,
+                              red_iomem_hndl_t   iomem,
+                              void              *addr,
+                              size_t             size,
+                              off_t              off,
+                              ssize_t           *ret_size,
+                              red_api_user_t    *user,
+                              common::deadline_t deadline)
+{
+    common::sync_api_t sync(deadline);
+    int rc = ::red_pwrite_iomem(oh, iomem, addr, size, off, sync.stage(ret_size),
+                                sync.get_ucb(), user);
+    return sync.wait(rc);
+}
+
+red_status_t red_iomem_alloc(size_t             size,
+                             red_iomem_hndl_t  *iomem,
+                             red_api_user_t    *user,
+                             common::deadline_t deadline)
 {
-    common::sync_api_t sync;
-    int rc = ::red_obtain_dataset(ds_name, cluster, ds_props, ds_hndl, sync.get_ucb(),
-                                  user);
+    common::sync_api_t sync(deadline);
+    int rc = ::red_iomem_alloc(size, sync.stage(iomem), sync.get_ucb(), user);
     return sync.wait(rc);
 }
 
-red_status_t red_openat(rfs_open_hndl_t  dir_oh,
-                        const char      *pathname,
-                        int              flags,
-                        mode_t           mode,
-                        rfs_open_hndl_t *oh,
-                        red_api_user_t  *user)
+red_status_t red_iomem_free(red_iomem_hndl_t   iomem,
+                            red_api_user_t    *user,
+                            common::deadline_t deadline)
 {
-    common::sync_api_t sync;
-    int rc = ::red_openat(dir_oh, pathname, flags, mode, oh, sync.get_ucb(), user);
+    common::sync_api_t sync(deadline);
+    int                rc = ::red_iomem_free(iomem, sync.get_ucb(), user);
     return sync.wait(rc);
 }
 
-red_status_t red_pread(rfs_open_hndl_t oh,
-                       void           *buff,
-                       size_t          size,
-                       off_t           off,
-                       ssize_t        *ret_size,
-                       red_api_user_t *user)
+red_status_t red_q_get(rfs_dataset_hndl_t    ds_hndl,
+                       red_queue_hndl_t      queue,
+                       uint32_t              partition,
+                       red_q_gtx_t           gtx,
+                       uint64_t              size,
+                       red_q_consumable_t   *consumables,
+                       uint64_t             *count,
+                       const red_api_user_t *user,
+                       common::deadline_t    deadline)
 {
-    common::sync_api_t sync;
-    int rc = ::red_pread(oh, buff, size, off, ret_size, sync.get_ucb(), user);
+    common::sync_api_t sync(deadline);
+    int rc = ::red_q_get(ds_hndl, queue, partition, gtx, size, consumables, sync.stage(count),
+                         sync.get_ucb(), user);
     return sync.wait(rc);
 }
 
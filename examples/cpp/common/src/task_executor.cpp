@@ -0,0 +1,357 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       task_executor.cpp
+ *   Project:    Red SDK examples common library
+ *
+ *   Description: Worker threads implementing the task thread model
+ *
+ ******************************************************************************/
+
+#include <cassert>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <sched.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include "../include/log.hpp"
+#include "../include/task_executor.hpp"
+
+namespace common
+{
+
+namespace
+{
+
+thread_local int tls_worker = -1;
+
+/* Largest CPU number accepted in a coremask */
+constexpr unsigned MAX_CPUS = CPU_SETSIZE;
+
+struct function_item_t : work_item_t
+{
+    std::function<void()> body;
+
+    static void run(work_item_t *item)
+    {
+        auto *me = static_cast<function_item_t *>(item);
+        me->body();
+        delete me;
+    }
+};
+
+red_status_t parse_hex_mask(const char *s, std::vector<unsigned> *cpus)
+{
+    if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X'))
+        s += 2;
+
+    size_t len = strlen(s);
+    if (len == 0)
+        return RED_EINVAL;
+
+    /* The last digit holds CPUs 0-3 */
+    for (size_t i = 0; i < len; i++)
+    {
+        char c = s[len - 1 - i];
+        if (!isxdigit(static_cast<unsigned char>(c)))
+            return RED_EINVAL;
+
+        unsigned nibble = isdigit(static_cast<unsigned char>(c))
+                              ? static_cast<unsigned>(c - '0')
+                              : static_cast<unsigned>(tolower(c) - 'a' + 10);
+        for (unsigned bit = 0; bit < 4; bit++)
+        {
+            if (nibble & (1u << bit))
+            {
+                unsigned cpu = static_cast<unsigned>(i * 4 + bit);
+                if (cpu >= MAX_CPUS)
+                    return RED_EINVAL;
+                cpus->push_back(cpu);
+            }
+        }
+    }
+    return RED_SUCCESS;
+}
+
+red_status_t parse_cpu_list(const char *s, std::vector<unsigned> *cpus)
+{
+    std::vector<bool> seen(MAX_CPUS, false);
+
+    while (*s != '\0')
+    {
+        char         *end;
+        unsigned long first = strtoul(s, &end, 10);
+        unsigned long last  = first;
+
+        if (end == s)
+            return RED_EINVAL;
+        s = end;
+        if (*s == '-')
+        {
+            s++;
+            last = strtoul(s, &end, 10);
+            if (end == s)
+                return RED_EINVAL;
+            s = end;
+        }
+        if (first > last || last >= MAX_CPUS)
+            return RED_EINVAL;
+
+        for (unsigned long cpu = first; cpu <= last; cpu++)
+            seen[cpu] = true;
+
+        if (*s == ',')
+            s++;
+        else if (*s != '\0')
+            return RED_EINVAL;
+    }
+
+    for (unsigned cpu = 0; cpu < MAX_CPUS; cpu++)
+    {
+        if (seen[cpu])
+            cpus->push_back(cpu);
+    }
+    return RED_SUCCESS;
+}
+
+} // namespace
+
+red_status_t parse_coremask(const char *coremask, std::vector<unsigned> *cpus)
+{
+    cpus->clear();
+    if (coremask == nullptr || coremask[0] == '\0')
+        return RED_EINVAL;
+
+    bool is_list = strchr(coremask, ',') != nullptr || strchr(coremask, '-') != nullptr;
+    bool is_hex  = coremask[0] == '0' && (coremask[1] == 'x' || coremask[1] == 'X');
+
+    red_status_t rs = (is_list && !is_hex) ? parse_cpu_list(coremask, cpus)
+                                           : parse_hex_mask(coremask, cpus);
+    if (rs == RED_SUCCESS && cpus->empty())
+        rs = RED_EINVAL;
+    if (rs != RED_SUCCESS)
+        cpus->clear();
+    return rs;
+}
+
+task_executor_t::task_executor_t()
+: stopping(false)
+{
+}
+
+task_executor_t::~task_executor_t()
+{
+    stop();
+}
+
+red_status_t task_executor_t::start(const char *coremask, unsigned num_workers)
+{
+    std::vector<unsigned> cpus;
+
+    if (!workers.empty())
+        return RED_EINVAL;
+
+    if (coremask != nullptr)
+    {
+        red_status_t rs = parse_coremask(coremask, &cpus);
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("invalid coremask '%s'", coremask);
+            return rs;
+        }
+    }
+
+    if (num_workers == 0)
+        num_workers = red_client_get_num_service_threads();
+    if (num_workers == 0)
+        num_workers = 1;
+
+    for (unsigned i = 0; i < num_workers; i++)
+    {
+        auto w      = std::make_unique<worker_t>();
+        w->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (w->epoll_fd < 0)
+        {
+            COMMON_LOG("epoll_create1() failed errno=%d", errno);
+            workers.clear();
+            return RED_ENOMEM;
+        }
+
+        struct epoll_event ev = {};
+        ev.events             = EPOLLIN;
+        ev.data.fd            = w->eventfd.get_fd();
+        epoll_ctl(w->epoll_fd, EPOLL_CTL_ADD, ev.data.fd, &ev);
+        workers.push_back(std::move(w));
+    }
+
+    /* Put each worker on the core of the service thread it pairs with */
+    for (unsigned cpu : cpus)
+    {
+        red_rc_t id = red_client_get_lcore_2_service_thread_id(cpu);
+        if (id >= 0 && static_cast<unsigned>(id) < num_workers && workers[id]->cpu < 0)
+            workers[id]->cpu = static_cast<int>(cpu);
+    }
+    for (unsigned i = 0; i < num_workers && !cpus.empty(); i++)
+    {
+        if (workers[i]->cpu < 0)
+            workers[i]->cpu = static_cast<int>(cpus[i % cpus.size()]);
+    }
+
+    stopping.store(false, std::memory_order_relaxed);
+    for (unsigned i = 0; i < num_workers; i++)
+    {
+        workers[i]->thread = std::thread(&task_executor_t::run, this, i);
+    }
+
+    return RED_SUCCESS;
+}
+
+void task_executor_t::stop()
+{
+    if (workers.empty())
+        return;
+
+    stopping.store(true, std::memory_order_release);
+    for (auto &w : workers)
+    {
+        w->eventfd.kick();
+    }
+
+    for (auto &w : workers)
+    {
+        if (w->thread.joinable())
+            w->thread.join();
+        close(w->epoll_fd);
+        w->epoll_fd = -1;
+    }
+    workers.clear();
+}
+
+unsigned task_executor_t::num_workers() const
+{
+    return static_cast<unsigned>(workers.size());
+}
+
+void task_executor_t::post(unsigned worker, work_item_t *item)
+{
+    assert(worker < workers.size());
+    workers[worker]->queue.push(item);
+    workers[worker]->eventfd.kick();
+}
+
+void task_executor_t::submit(unsigned worker, std::function<void()> fn)
+{
+    auto *item = new function_item_t;
+    item->fn   = function_item_t::run;
+    item->body = std::move(fn);
+    post(worker, item);
+}
+
+int task_executor_t::current_worker()
+{
+    return tls_worker;
+}
+
+const task_executor_stats_t &task_executor_t::stats(unsigned worker) const
+{
+    return workers[worker]->stats;
+}
+
+bool task_executor_t::run_queued(worker_t &w)
+{
+    bool ran = false;
+
+    while (mpsc_node_t *node = w.queue.pop())
+    {
+        auto *item = static_cast<work_item_t *>(node);
+        item->fn(item);
+        w.stats.tasks++;
+        ran = true;
+    }
+    return ran;
+}
+
+void task_executor_t::run(unsigned index)
+{
+    worker_t          &w          = *workers[index];
+    int                ring_fd    = -1;
+    bool               ring_ready = false;
+    struct epoll_event events[2];
+
+    tls_worker = static_cast<int>(index);
+
+    if (w.cpu >= 0)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(w.cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0)
+            COMMON_LOG("worker %u: cannot pin to cpu %d errno=%d", index, w.cpu, errno);
+    }
+
+    for (;;)
+    {
+        run_queued(w);
+
+        /* The ring is created by the first operation issued from this thread */
+        if (ring_fd < 0)
+        {
+            ring_fd = red_client_lib_poll_fd();
+            if (ring_fd >= 0)
+            {
+                struct epoll_event ev = {};
+                ev.events             = EPOLLIN;
+                ev.data.fd            = ring_fd;
+                epoll_ctl(w.epoll_fd, EPOLL_CTL_ADD, ring_fd, &ev);
+                ring_ready = true;
+            }
+        }
+
+        if (ring_ready)
+        {
+            drain_completions(&w.stats.drain);
+            ring_ready = false;
+        }
+
+        if (stopping.load(std::memory_order_acquire) && w.queue.empty())
+            break;
+
+        int n = epoll_wait(w.epoll_fd, events, 2, -1);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            COMMON_LOG("worker %u: epoll_wait() failed errno=%d", index, errno);
+            break;
+        }
+
+        w.stats.wakeups++;
+        for (int i = 0; i < n; i++)
+        {
+            if (events[i].data.fd == w.eventfd.get_fd())
+                w.eventfd.read();
+            else
+                ring_ready = true;
+        }
+    }
+
+    tls_worker = -1;
+}
+
+} // namespace common
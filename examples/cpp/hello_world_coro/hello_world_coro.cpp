@@ -0,0 +1,544 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       hello_world_coro.cpp
+ *   Project:    RED
+ *
+ *   Description: The hello_world PUT written with C++20 coroutines. Creates a
+ *                bucket and writes objects HelloWorld-0 .. HelloWorld-<n-1>
+ *                concurrently from a single thread.
+ *
+ ******************************************************************************/
+#include <iostream>
+#include <string>
+#include <getopt.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <string.h>
+#include <sys/xattr.h>
+
+#include <red/red_client_api.h>
+#include <red/red_ds_api.h>
+#include <red/red_client_types.h>
+#include <red/red_dhash_api.h>
+#include <red/red_fs_api.h>
+#include <red/red_s3_api.h>
+
+#include "../common/include/admission.hpp"
+#include "../common/include/coro.hpp"
+#include "../common/include/sync_api.hpp"
+#include "../common/include/log.hpp"
+#include "../common/include/string_utils.hpp"
+
+using common::red_call;
+using common::task;
+
+/*
+ * Some environment variables to store information
+ */
+#define RED_CLUSTER_ENV "RED_CLUSTER"
+#define RED_TENANT_ENV  "RED_TENANT"
+#define RED_USER_ENV    "RED_USER"
+
+#define RSMT_MAX_NAME 256
+
+/*
+ * Information pulled from command line parameters
+ */
+const char *p_cluster       = "infinia";
+const char *p_ten_subten    = "red/red";
+char       *p_bucket_name   = nullptr;
+char       *p_user_id       = nullptr;
+unsigned    p_num_objects   = 16;
+unsigned    p_queue_depth   = 8;
+uint32_t    p_dp_profile_id = RED_DS_DEFAULT_DP_PROFILE;
+
+/*
+ * Main Program
+ */
+namespace
+{
+
+void print_help(const char *argv)
+{
+    std::cout << "Usage: " << argv
+              << " [OPTION]\n"
+                 "hello-world-coro creates a bucket and writes HelloWorld objects\n"
+                 "concurrently using C++20 coroutines on a single thread.\n"
+                 "-----------------------------------------\n"
+                 "   -c --cluster      <name>    Cluster name\n"
+                 "   -N --tenant       <name>    Tenant name\n"
+                 "   -n --subtenant    <name>    Subtenant name\n"
+                 "   -B --bucket       <name>    Bucket name\n"
+                 "   -I --id           <user id> User Id\n"
+                 "   -o --objects      <count>   Objects written concurrently (default 16)\n"
+                 "   -q --queue-depth  <count>   PUTs in flight on the bucket at once (default 8)\n"
+                 " ***********************************************************\n";
+}
+
+red_status_t parse_args(int argc, char **argv)
+{
+    int         option_index = 0;
+    int         c;
+    const char *clus_arg = NULL;
+    const char *ten_arg  = NULL;
+    const char *sten_arg = NULL;
+
+    static struct option options[] = {{"cluster", required_argument, 0, 'c'},
+                                      {"bucket", required_argument, 0, 'B'},
+                                      {"help", no_argument, 0, 'h'},
+                                      {"tenant", required_argument, 0, 'N'},
+                                      {"subtenant", required_argument, 0, 'n'},
+                                      {"id", required_argument, 0, 'I'},
+                                      {"objects", required_argument, 0, 'o'},
+                                      {"queue-depth", required_argument, 0, 'q'},
+                                      {0, 0, 0, 0}};
+
+    for (;;)
+    {
+        c = getopt_long(argc, argv, "N:n:B:c:I:o:q:h", options, &option_index);
+        if (c == -1)
+            break;
+
+        switch (c)
+        {
+        case 'c':
+            clus_arg = optarg;
+            break;
+
+        case 'N':
+            ten_arg = optarg;
+            break;
+
+        case 'n':
+            sten_arg = optarg;
+            break;
+
+        case 'B':
+            p_bucket_name = optarg;
+            break;
+
+        case 'I':
+            p_user_id = optarg;
+            break;
+
+        case 'o':
+            p_num_objects = static_cast<unsigned>(atoi(optarg));
+            if (p_num_objects == 0)
+            {
+                fprintf(stderr, "%s: at least one object must be written\n", argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        case 'q':
+            p_queue_depth = static_cast<unsigned>(atoi(optarg));
+            if (p_queue_depth == 0)
+            {
+                fprintf(stderr, "%s: the queue depth must be at least 1\n", argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            break;
+
+        case 'h':
+            print_help(argv[0]);
+            exit(EXIT_SUCCESS);
+
+        default:
+            print_help(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    if (p_bucket_name == nullptr)
+    {
+        std::cerr << "Please specify bucket name (-B <bucket name>)\n";
+        exit(EXIT_FAILURE);
+    }
+
+    if (p_user_id == nullptr)
+    {
+        std::cerr << "Please specify user id to set the user.s3_acl (-I <user id>)\n";
+        exit(EXIT_FAILURE);
+    }
+
+    if (getenv(RED_USER_ENV) == NULL)
+    {
+        std::cerr << "Please specify correct " << RED_USER_ENV << " env!\n";
+        exit(EXIT_FAILURE);
+    }
+
+    if (clus_arg != NULL)
+    {
+        setenv(RED_CLUSTER_ENV, clus_arg, 1);
+    }
+
+    if (ten_arg != NULL || sten_arg != NULL)
+    {
+        char red_tenant[2 * RSMT_MAX_NAME + 2] = {}; /*tenant/subtenant\0*/
+
+        snprintf(red_tenant, sizeof(red_tenant), "%s/%s",
+                 ten_arg != NULL ? ten_arg : "red", sten_arg != NULL ? sten_arg : "red");
+        setenv(RED_TENANT_ENV, red_tenant, 1);
+    }
+
+    const char *clus = getenv(RED_CLUSTER_ENV);
+    if (clus != NULL)
+        p_cluster = clus;
+
+    const char *tds = getenv(RED_TENANT_ENV);
+    if (tds != NULL)
+        p_ten_subten = tds;
+
+    return RED_SUCCESS;
+}
+
+std::string acl_for_user(const char *user_id)
+{
+    char acl_value[1024];
+
+    snprintf(acl_value, sizeof(acl_value),
+             "{\"Owner\":{\"ID\":\"%s\",\"DisplayName\":\"admin\"},"
+             "\"Grants\":[{\"Grantee\":{\"Type\":\"CanonicalUser\","
+             "\"ID\":\"%s\",\"DisplayName\":\"admin\"},\"Permission\":"
+             "\"FULL_CONTROL\"}]}",
+             user_id, user_id);
+    return acl_value;
+}
+
+/*
+ * Set a default ACL on either the object or the root of the bucket
+ */
+task<red_status_t> rfs_set_acl(rfs_open_hndl_t oh, red_api_user_t *user)
+{
+    std::string acl = acl_for_user(p_user_id);
+
+    red_status_t rs = co_await red_call(::red_fsetxattr, oh, RED_S3_USER_ACL_XATTR_KEY,
+                                        acl.data(), acl.size(), XATTR_CREATE, user);
+    if (rs != RED_SUCCESS)
+    {
+        COMMON_LOG("set %s ACL=%s rs=%d", RED_S3_USER_ACL_XATTR_KEY, acl.c_str(), rs);
+    }
+    co_return rs;
+}
+
+/*
+ * Write the buffer and compute the MD5 etag expected after red_s3_publish()
+ */
+task<red_status_t> rfs_example_write(rfs_open_hndl_t obj_oh,
+                                     void           *wr_buffer,
+                                     size_t          io_size,
+                                     char           *md5_etag,
+                                     red_api_user_t *user)
+{
+    ssize_t  write_ret_size = 0;
+    uint8_t  md5_hash[16];
+    red_rc_t rc;
+
+    red_status_t rs = co_await red_call(::red_pwrite, obj_oh, wr_buffer, io_size, 0,
+                                        &write_ret_size, user);
+    if (rs != RED_SUCCESS || ((size_t)write_ret_size) != io_size)
+    {
+        COMMON_LOG("red_pwrite() failed! ret_size=%ld io_size=%lu rc=%d", write_ret_size,
+                   io_size, rs);
+        co_return rs == RED_SUCCESS ? RED_EINVAL : rs;
+    }
+
+    rc = red_dhash_data(RED_DHASH_MD5, wr_buffer, io_size, md5_hash);
+    if (rc != 0)
+    {
+        COMMON_LOG("red_dhash_data failed rc=%d", rc);
+        co_return RED_EINVAL;
+    }
+
+    red_bin_to_hex(md5_hash, sizeof(md5_hash), md5_etag);
+    md5_etag[RED_S3_USER_ETAG_SIZE - 1] = '\0';
+    co_return RED_SUCCESS;
+}
+
+task<red_status_t> rfs_validate_etag(rfs_open_hndl_t obj_oh,
+                                     const char     *expected_etag,
+                                     red_api_user_t *user)
+{
+    char   actual_etag[RED_S3_USER_ETAG_SIZE] = {0};
+    size_t xattr_size = RED_S3_USER_ETAG_SIZE - 1; /* No need for null terminator */
+
+    red_status_t rs = co_await red_call(::red_fgetxattr, obj_oh, RED_S3_ETAG_KEY,
+                                        actual_etag, xattr_size, &xattr_size, user);
+    if (rs != RED_SUCCESS)
+    {
+        COMMON_LOG("Failed to get %s, rs=%d", RED_S3_ETAG_KEY, rs);
+        co_return rs;
+    }
+
+    actual_etag[xattr_size] = '\0';
+    if (strcmp(expected_etag, actual_etag) != 0)
+    {
+        COMMON_LOG("Etag mismatch! Expected=%s, Actual=%s", expected_etag, actual_etag);
+        co_return RED_FAILURE;
+    }
+
+    co_return RED_SUCCESS;
+}
+
+/*
+ * Same sequence of operations as rfs_create_object() in hello_world.cpp:
+ * create version, write, set ACL, publish, close, reopen and validate the etag.
+ * Each co_await suspends this object's PUT and lets the others make progress.
+ */
+task<red_status_t> rfs_create_object(rfs_open_hndl_t root_oh,
+                                     std::string     name,
+                                     red_api_user_t *user)
+{
+    red_status_t    rs;
+    rfs_open_hndl_t obj_oh = RED_INVALID_OPEN_HANDLE;
+    uint64_t        version;
+    char            data[12];
+    char            md5_etag[RED_S3_USER_ETAG_SIZE] = {0};
+
+    rs = co_await red_call(::red_s3_create_version, root_oh, name.c_str(), 0, &obj_oh,
+                           user);
+    if (rs != RED_SUCCESS)
+    {
+        COMMON_LOG("red_s3_create_version(%s) failed! rs=%d", name.c_str(), rs);
+        co_return rs;
+    }
+
+    strcpy(data, "Hello World");
+    rs = co_await rfs_example_write(obj_oh, data, strlen(data), md5_etag, user);
+    if (rs == RED_SUCCESS)
+        rs = co_await rfs_set_acl(obj_oh, user);
+    if (rs == RED_SUCCESS)
+        rs = co_await red_call(::red_s3_publish, obj_oh, &version, user);
+
+    /* Close the object to ensure the extended attributes are written */
+    red_status_t cls_rs = co_await red_call(::red_close, obj_oh, user);
+    obj_oh              = RED_INVALID_OPEN_HANDLE;
+    if (rs == RED_SUCCESS)
+        rs = cls_rs;
+    if (rs != RED_SUCCESS)
+    {
+        COMMON_LOG("PUT %s failed! rs=%d", name.c_str(), rs);
+        co_return rs;
+    }
+
+    /* Reopen the object to validate the etag */
+    rs = co_await red_call(::red_s3_open, root_oh, name.c_str(), 0, 0, &obj_oh, &version,
+                           user);
+    if (rs != RED_SUCCESS)
+    {
+        COMMON_LOG("red_s3_open(%s) failed! rs=%d", name.c_str(), rs);
+        co_return rs;
+    }
+
+    rs     = co_await rfs_validate_etag(obj_oh, md5_etag, user);
+    cls_rs = co_await red_call(::red_close, obj_oh, user);
+    co_return rs == RED_SUCCESS ? cls_rs : rs;
+}
+
+/*
+ * Wait for the bucket to admit one more PUT, so that a large -o does not
+ * flood the client ring with requests
+ */
+task<void> rfs_put_one(common::admission_controller_t *admission,
+                       rfs_dataset_hndl_t              bucket_hndl,
+                       rfs_open_hndl_t                 root_oh,
+                       std::string                     name,
+                       red_api_user_t                 *user,
+                       unsigned                       *failed)
+{
+    if (co_await common::admit(*admission, bucket_hndl) != RED_SUCCESS)
+    {
+        (*failed)++;
+        co_return;
+    }
+
+    red_status_t rs = co_await rfs_create_object(root_oh, name, user);
+    admission->release(bucket_hndl);
+
+    if (rs != RED_SUCCESS)
+        (*failed)++;
+    else
+        COMMON_LOG("Object %s created and written successfully", name.c_str());
+}
+
+/*
+ * Start one PUT per object, then dispatch completions until all have finished
+ */
+red_status_t rfs_create_objects(rfs_dataset_hndl_t bucket_hndl,
+                                rfs_open_hndl_t    root_oh,
+                                unsigned           count,
+                                red_api_user_t    *user)
+{
+    common::scheduler_t           &scheduler = common::scheduler_t::local();
+    common::admission_controller_t admission({.max_inflight = p_queue_depth});
+    unsigned                       failed = 0;
+    red_status_t                   rs;
+
+    for (unsigned i = 0; i < count; i++)
+    {
+        scheduler.spawn(rfs_put_one(&admission, bucket_hndl, root_oh,
+                                    "HelloWorld-" + std::to_string(i), user, &failed));
+    }
+
+    rs = scheduler.run();
+    if (rs != RED_SUCCESS)
+        return rs;
+
+    common::admission_stats_t stats = admission.stats(bucket_hndl);
+    COMMON_LOG("PUTs in flight: max %lu of %u, %lu waited %lu us on average",
+               stats.max_depth, p_queue_depth, stats.waited,
+               stats.waited != 0 ? stats.wait_ns / stats.waited / 1000 : 0);
+
+    return failed == 0 ? RED_SUCCESS : RED_FAILURE;
+}
+
+/*
+ * Create a bucket and open the root handle, with the synchronous wrappers
+ */
+red_status_t rfs_open_bucket(const char         *bucket_name,
+                             const char         *cluster,
+                             const char         *tenant,
+                             const char         *subtenant,
+                             rfs_dataset_hndl_t *bucket_hndl,
+                             rfs_open_hndl_t    *root_oh,
+                             red_api_user_t     *user)
+{
+    red_status_t   rs;
+    red_ds_props_t bucket_props;
+
+    rs = red_ds_get_default_props(&bucket_props, p_dp_profile_id);
+    if (rs != RED_SUCCESS)
+    {
+        COMMON_LOG("red_ds_get_default_props() failed! dp_id=%d, rs=%d", p_dp_profile_id,
+                   rs);
+        return rs;
+    }
+
+    bucket_props.nstripes    = RED_MAX_STRIPES;
+    bucket_props.bucket_size = 256 * 1024;
+    bucket_props.block_size  = 4 * 1024;
+    bucket_props.ec_nparity  = 2;
+
+    rs = red::red_s3_create_bucket(bucket_name, cluster, tenant, subtenant, &bucket_props,
+                                   bucket_hndl, user);
+    if ((rs != RED_SUCCESS) && (rs != RED_EEXIST))
+    {
+        COMMON_LOG("red_s3_create_bucket_v3() failed! rs=%d", rs);
+        return rs;
+    }
+
+    rs = red::red_open_root(*bucket_hndl, root_oh, user);
+    if (rs != RED_SUCCESS)
+    {
+        COMMON_LOG("red_open_root() failed! rs=%d", rs);
+        return rs;
+    }
+
+    std::string acl = acl_for_user(p_user_id);
+    rs = red::red_fsetxattr(*root_oh, RED_S3_USER_ACL_XATTR_KEY, acl.data(), acl.size(),
+                            XATTR_CREATE, user);
+    if (rs != RED_SUCCESS)
+    {
+        COMMON_LOG("set %s ACL on root rs=%d", RED_S3_USER_ACL_XATTR_KEY, rs);
+    }
+    return rs;
+}
+
+} /* namespace */
+
+const struct red_client_lib_init_opts opts{.num_sthreads = 1,
+                                           .coremask     = NULL, /* Default coremask */
+                                           .num_buffers  = RFS_NUM_DEF_BUFFERS,
+                                           .num_ring_entries = 64,
+                                           .poller_thread    = true};
+
+int main(int argc, char **argv)
+{
+    int                timeout     = 30; /* in seconds */
+    rfs_dataset_hndl_t bucket_hndl = RED_INVALID_HANDLE;
+    rfs_open_hndl_t    root_oh     = RED_INVALID_OPEN_HANDLE;
+    char              *tenname     = nullptr;
+    char              *subname     = nullptr;
+    red_api_user_t     user        = {};
+
+    red_status_t rs = parse_args(argc, argv);
+    if (rs != RED_SUCCESS)
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    int rc = red_client_lib_init_v3(&opts);
+    if (rc != 0)
+    {
+        std::cout << "Error: red_client_lib_init failed with rs=" << rc << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    if (!red_client_is_ready(timeout))
+    {
+        std::cout << "Error: red_client_is_ready failed" << std::endl;
+        red_client_lib_fini();
+        exit(EXIT_FAILURE);
+    }
+
+    common::split_tensubten(p_ten_subten, &tenname, &subname);
+
+    rc = red_establish_session(p_cluster, tenname, subname, (uint64_t)geteuid(),
+                               (uint64_t)getegid(), &user);
+    if (rc != RED_SUCCESS)
+    {
+        std::cerr << "ERROR: Could not establish session for ten/subten=" << tenname
+                  << "/" << subname << ", err: " << red_strerror(rs) << std::endl;
+        rs = static_cast<red_status_t>(rc);
+        goto exit_error;
+    }
+
+    rs = rfs_open_bucket(p_bucket_name, p_cluster, tenname, subname, &bucket_hndl,
+                         &root_oh, &user);
+    if (rs != RED_SUCCESS)
+    {
+        std::cout << "Unable to create bucket" << std::endl;
+        goto exit_error;
+    }
+
+    rs = rfs_create_objects(bucket_hndl, root_oh, p_num_objects, &user);
+    if (rs != RED_SUCCESS)
+    {
+        std::cout << "Unable to create objects" << std::endl;
+    }
+    else
+    {
+        COMMON_LOG("%u objects created and written successfully", p_num_objects);
+    }
+
+exit_error:
+    if (RED_IS_VALID_OPEN_HANDLE(root_oh))
+    {
+        red::red_close(root_oh, &user);
+    }
+
+    if (RED_IS_VALID_HANDLE(bucket_hndl))
+    {
+        red::red_close_dataset(bucket_hndl, &user);
+    }
+
+    red_cleanup_session(&user);
+    red_client_lib_fini();
+
+    COMMON_LOG("Program finished with status %d", rs);
+    exit(rs != RED_SUCCESS ? EXIT_FAILURE : EXIT_SUCCESS);
+}
@@ -0,0 +1,137 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_events.hpp
+ *   Project:    RED
+ *
+ *   Description: Completion events of the example S3 client's blocking
+ *                multi-call operations
+ *
+ ******************************************************************************/
+#ifndef S3_EVENTS_HPP
+#define S3_EVENTS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "simple_s3_client.hpp"
+#include "../common/include/log.hpp"
+#include "../common/include/reactor.hpp"
+
+/*
+ * Completions of one blocking call of s3client that keeps many library calls
+ * in flight (multipart upload, ranged get). Completion callbacks only queue
+ * an event tagged with the caller's id; every step is taken by the calling
+ * thread as it drains the events, so the operation's state needs no lock
+ * even when the poller thread delivers completions.
+ *
+ * A call writes its outputs until it completes, so an operation never
+ * returns with calls in flight: a failed wait() fails it, and it still
+ * waits out every call it started before returning.
+ */
+class s3_events_t
+{
+public:
+    struct event_t
+    {
+        uint32_t     id;
+        red_status_t rs;
+    };
+
+    /* Id of the calls made through control() */
+    static constexpr uint32_t CONTROL = UINT32_MAX;
+
+    s3_events_t() : reactor(&common::reactor_t::local()) {}
+
+    s3_events_t(const s3_events_t &)            = delete;
+    s3_events_t &operator=(const s3_events_t &) = delete;
+
+    red_done_t on_done(uint32_t id)
+    {
+        return [this, id](red_status_t rs) { post(id, rs); };
+    }
+
+    /*
+     * Wait for at least one event, then take() them. A failure is returned
+     * after a pause, for the caller to fail the operation and wait again.
+     */
+    red_status_t wait()
+    {
+        red_status_t rs = reactor->wait(progress);
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to wait for completions: %s", red_strerror(rs));
+            std::this_thread::sleep_for(WAIT_RETRY);
+        }
+        return rs;
+    }
+
+    /* The events queued so far, without waiting for any */
+    const std::vector<event_t> &take()
+    {
+        progress.store(false, std::memory_order_relaxed);
+
+        ready.clear();
+        std::lock_guard<std::mutex> guard(lock);
+        ready.swap(queued);
+        return ready;
+    }
+
+    /* Run one call on its own, while no other call of the operation is in flight */
+    template <typename F>
+    red_status_t control(F submit)
+    {
+        red_status_t rs = submit(on_done(CONTROL));
+        if (rs != RED_SUCCESS)
+            return rs;
+        for (;;)
+        {
+            /* The call's outputs are only settled once it completes: a failed wait is retried */
+            wait();
+            for (const event_t &e : take())
+            {
+                if (e.id == CONTROL)
+                    return e.rs;
+            }
+        }
+    }
+
+private:
+    static constexpr std::chrono::milliseconds WAIT_RETRY{10};
+
+    void post(uint32_t id, red_status_t rs)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            queued.push_back({id, rs});
+        }
+        progress.store(true, std::memory_order_release);
+        if (!reactor->is_local())
+            reactor->kick();
+    }
+
+    common::reactor_t   *reactor;
+    std::mutex           lock;
+    std::vector<event_t> queued;
+    std::vector<event_t> ready;
+    std::atomic<bool>    progress{false};
+};
+
+#endif /* S3_EVENTS_HPP */
@@ -0,0 +1,99 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_multipart.cpp
+ *   Project:    RED
+ *
+ *   Description: Parallel multipart upload engine of the example S3 client
+ *
+ *   Created:    10/16/2026
+ *   Author(s):  Dana Helwig (dhelwig@ddn.com)
+ *
+ ******************************************************************************/
+#include "s3_multipart.hpp"
+#include "../common/include/crc32c.hpp"
+
+/*
+ * The object is cut into cfg.part_size parts, enlarged if that would take
+ * more than RED_S3_MAX_PARTS, each uploaded, written and closed through
+ * IAsyncRedClient with up to cfg.concurrency parts in flight, and the upload
+ * is completed with every part's checksum and ETag. A part that fails is
+ * retried cfg.retries times; after that no new parts start, and once those
+ * in flight are done the upload is aborted. The calling thread's reactor
+ * dispatches the completions until then.
+ */
+red_status_t s3client::put_object_multipart(std::weak_ptr<s3bucket>   bucket_weak,
+                                            const std::string        &key,
+                                            const red_buffer_t       &data,
+                                            const multipart_config_t &cfg,
+                                            red_mp_info_t            *info)
+{
+    auto bucket = bucket_weak.lock();
+    if (!bucket)
+    {
+        COMMON_LOG("ERROR: Invalid bucket handle");
+        return RED_EINVAL;
+    }
+    if (cfg.part_size == 0)
+    {
+        COMMON_LOG("ERROR: Invalid part size");
+        return RED_EINVAL;
+    }
+
+    if (cache_cfg.capacity != 0)
+        invalidate_cached(bucket.get(), key);
+
+    size_t   part = cfg.part_size;
+    uint32_t n;
+
+    if ((data.size + part - 1) / part > RED_S3_MAX_PARTS)
+        part = (data.size + RED_S3_MAX_PARTS - 1) / RED_S3_MAX_PARTS;
+    n = std::max<size_t>(1, (data.size + part - 1) / part); /* An empty object is one empty part */
+
+    red_mp_info_t  ignored;
+    mpart_upload_t upload(this, std::move(bucket), key, data.iomem, cfg.retries);
+    red_status_t   rs = upload.create();
+    if (rs != RED_SUCCESS)
+        return rs;
+
+    unsigned depth = std::max(1u, cfg.concurrency);
+    uint32_t next  = 0;
+    for (;;)
+    {
+        while (upload.error == RED_SUCCESS && upload.in_flight < depth && next < n)
+        {
+            char             *addr     = static_cast<char *>(data.addr) + next * part;
+            size_t            size     = std::min(part, data.size - next * part);
+            red_s3_checksum_t checksum = {};
+            if (cfg.checksums)
+            {
+                checksum.type           = RED_S3CS_CRC32C;
+                checksum.checksum.crc32 = common::crc32c(0, addr, size);
+            }
+            upload.add(addr, size, checksum);
+            next++;
+        }
+        if (upload.in_flight == 0)
+            break;
+        upload.poll();
+    }
+    rs = upload.finish(RED_SUCCESS, info != nullptr ? info : &ignored);
+
+    /* Again once completed: a reader may have cached the handle while the parts uploaded */
+    if (cache_cfg.capacity != 0)
+        invalidate_cached(upload.bucket.get(), key);
+    return rs;
+}
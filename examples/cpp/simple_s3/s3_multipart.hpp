@@ -0,0 +1,342 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_multipart.hpp
+ *   Project:    RED
+ *
+ *   Description: Parallel multipart upload engine of the example S3 client
+ *
+ ******************************************************************************/
+#ifndef S3_MULTIPART_HPP
+#define S3_MULTIPART_HPP
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "simple_s3_client.hpp"
+#include "s3_events.hpp"
+#include "../common/include/log.hpp"
+
+/*
+ * One multipart upload, driven by the calling thread from the events of its
+ * parts (tagged with the part index) and of its create, complete, abort and
+ * close calls (s3_events_t::CONTROL). The caller create()s it, add()s parts
+ * as their data is ready, poll()s while parts are in flight and finish()es
+ * it; a part's data must stay put until done() says so.
+ */
+struct s3client::mpart_upload_t
+{
+    enum step_e
+    {
+        UPLOAD, /* red_upload_part() */
+        WRITE,  /* pwrite of the part's data */
+        CLOSE,  /* red_close_part() with the part's checksum */
+        DONE    /* Finished or failed for good */
+    };
+
+    struct part_t
+    {
+        char                *addr;
+        off_t                offset;
+        size_t               size;
+        step_e               step;
+        unsigned             attempts;
+        rfs_open_hndl_t      oh;
+        ssize_t              written;
+        red_status_t         failed;    /* Of the write, acted on once the part is closed */
+        red_data_integrity_t integrity; /* Checksum given, ETag returned by the close */
+    };
+
+    s3client                 *client;
+    std::shared_ptr<s3bucket> bucket;
+    const std::string        &key;
+    red_iomem_hndl_t          iomem;
+    unsigned                  retries;
+    rfs_open_hndl_t           root_oh    = {0};
+    rfs_open_hndl_t           created_oh = {0};
+    char                      upload_id[RFS_UPLOAD_ID_LEN] = {};
+    std::deque<part_t>        parts; /* Stable addresses for the calls' outputs */
+    uint64_t                  size      = 0;
+    uint32_t                  in_flight = 0;
+    red_status_t              error     = RED_SUCCESS;
+    s3_events_t               events;
+
+    mpart_upload_t(s3client                 *client,
+                   std::shared_ptr<s3bucket> bucket,
+                   const std::string        &key,
+                   red_iomem_hndl_t          iomem,
+                   unsigned                  retries)
+    : client(client),
+      bucket(std::move(bucket)),
+      key(key),
+      iomem(iomem),
+      retries(retries)
+    {
+    }
+
+    red_done_t on_done(uint32_t part)
+    {
+        return events.on_done(part);
+    }
+
+    template <typename F>
+    red_status_t control(F submit)
+    {
+        return events.control(submit);
+    }
+
+    /* Start the next part, @p part_size bytes at @p addr, closed with @p checksum */
+    void add(char *addr, size_t part_size, const red_s3_checksum_t &checksum)
+    {
+        uint32_t i = static_cast<uint32_t>(parts.size());
+
+        parts.emplace_back();
+        part_t &p            = parts.back();
+        p.addr               = addr;
+        p.offset             = static_cast<off_t>(size);
+        p.size               = part_size;
+        p.attempts           = 0;
+        p.integrity.checksum = checksum;
+        size += part_size;
+        in_flight++;
+        upload(i);
+    }
+
+    bool done(uint32_t i) const
+    {
+        return parts[i].step == DONE;
+    }
+
+    /* Wait for parts to make progress; a failed wait fails the upload */
+    void poll()
+    {
+        red_status_t rs = events.wait();
+        if (rs != RED_SUCCESS && error == RED_SUCCESS)
+            error = rs;
+        for (const s3_events_t::event_t &e : events.take())
+            advance(e);
+    }
+
+    void upload(uint32_t i)
+    {
+        part_t &p = parts[i];
+        p.step    = UPLOAD;
+        p.oh      = {0};
+        p.failed  = RED_SUCCESS;
+
+        red_status_t rs = client->async_client->upload_part(
+            root_oh, key.c_str(), upload_id, i + 1, 0, &p.oh, client->api_user, on_done(i));
+        if (rs != RED_SUCCESS)
+            failed(i, rs);
+    }
+
+    void write(uint32_t i)
+    {
+        part_t      &p   = parts[i];
+        red_buffer_t buf = {iomem, p.addr, p.size};
+        red_status_t rs;
+
+        p.step = WRITE;
+        if (client->zero_copy(buf))
+            rs = client->async_client->pwrite_iomem(p.oh, buf.iomem, buf.addr, buf.size, 0,
+                                                    &p.written, client->api_user, on_done(i));
+        else
+            rs = client->async_client->pwrite(p.oh, buf.addr, buf.size, 0, &p.written,
+                                              client->api_user, on_done(i));
+        if (rs != RED_SUCCESS)
+        {
+            p.failed = rs;
+            close(i);
+        }
+    }
+
+    void close(uint32_t i)
+    {
+        part_t &p = parts[i];
+        p.step    = CLOSE;
+
+        /* The checksum stays from add(); the ETag is the close's to fill in */
+        memset(p.integrity.etag, 0, sizeof(p.integrity.etag));
+
+        red_status_t rs = client->async_client->close_part(p.oh, &p.integrity, client->api_user,
+                                                           on_done(i));
+        if (rs != RED_SUCCESS)
+        {
+            /* Release the part's handle before a retry opens another */
+            client->red_client->close(p.oh, client->api_user);
+            failed(i, rs);
+        }
+    }
+
+    void advance(const s3_events_t::event_t &e)
+    {
+        part_t &p = parts[e.id];
+
+        switch (p.step)
+        {
+        case UPLOAD:
+            if (e.rs != RED_SUCCESS)
+                failed(e.id, e.rs);
+            else
+                write(e.id);
+            break;
+        case WRITE:
+            p.failed = e.rs;
+            if (e.rs == RED_SUCCESS && p.written != static_cast<ssize_t>(p.size))
+                p.failed = RED_EIO;
+            close(e.id);
+            break;
+        case CLOSE:
+            if (e.rs != RED_SUCCESS || p.failed != RED_SUCCESS)
+                failed(e.id, e.rs != RED_SUCCESS ? e.rs : p.failed);
+            else
+                finished(e.id);
+            break;
+        case DONE:
+            break;
+        }
+    }
+
+    void failed(uint32_t i, red_status_t rs)
+    {
+        part_t &p = parts[i];
+
+        if (error == RED_SUCCESS && p.attempts < retries)
+        {
+            p.attempts++;
+            COMMON_LOG("WARNING: Part %u of %s failed, retrying: %s", i + 1, key.c_str(),
+                       red_strerror(rs));
+            upload(i);
+            return;
+        }
+
+        COMMON_LOG("ERROR: Part %u of %s failed: %s", i + 1, key.c_str(), red_strerror(rs));
+        if (error == RED_SUCCESS)
+            error = rs;
+        p.step = DONE;
+        in_flight--;
+    }
+
+    void finished(uint32_t i)
+    {
+        parts[i].step = DONE;
+        in_flight--;
+    }
+
+    red_status_t create()
+    {
+        red_status_t rs;
+
+        for (int attempt = 0; attempt < 2; attempt++)
+        {
+            rs = bucket->root(&root_oh);
+            if (rs != RED_SUCCESS)
+                break;
+
+            rs = control([this](red_done_t done) {
+                return client->async_client->create_mpart_upload(root_oh, key.c_str(), 0,
+                                                                 upload_id, sizeof(upload_id),
+                                                                 &created_oh, client->api_user,
+                                                                 std::move(done));
+            });
+            if (!stale_root(rs))
+                break;
+            bucket->invalidate_root(root_oh);
+        }
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to create upload of %s: %s", key.c_str(), red_strerror(rs));
+        }
+        return rs;
+    }
+
+    red_status_t complete(red_mp_info_t *info)
+    {
+        uint32_t                        n = static_cast<uint32_t>(parts.size());
+        std::vector<red_part_info_v2_t> infos(n);
+
+        for (uint32_t i = 0; i < n; i++)
+        {
+            const part_t       &p  = parts[i];
+            red_part_info_v2_t &pi = infos[i];
+
+            memset(&pi, 0, sizeof(pi));
+            pi.pi_part_num            = i + 1;
+            pi.pi_range               = {p.offset, p.size};
+            pi.pi_xattr_info.checksum = p.integrity.checksum;
+            strncpy(pi.pi_xattr_info.etag, p.integrity.etag, sizeof(pi.pi_xattr_info.etag) - 1);
+        }
+
+        /* At most RED_MAX_PARTS_PER_COMP_REQ parts per call, the last one final */
+        for (uint32_t first = 0; first < n; first += RED_MAX_PARTS_PER_COMP_REQ)
+        {
+            uint32_t count = std::min<uint32_t>(n - first, RED_MAX_PARTS_PER_COMP_REQ);
+            bool     last  = first + count == n;
+
+            red_status_t rs = control([&](red_done_t done) {
+                return client->async_client->comp_mpart_upload(
+                    root_oh, key.c_str(), upload_id, n, count, &infos[first], last, 0, info,
+                    client->api_user, std::move(done));
+            });
+            if (rs != RED_SUCCESS)
+            {
+                COMMON_LOG("ERROR: Failed to complete upload of %s: %s", key.c_str(),
+                           red_strerror(rs));
+                return rs;
+            }
+        }
+        return RED_SUCCESS;
+    }
+
+    void abort()
+    {
+        red_status_t rs = control([this](red_done_t done) {
+            return client->async_client->abort_mpart(root_oh, key.c_str(), upload_id,
+                                                     client->api_user, std::move(done));
+        });
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to abort upload of %s: %s", key.c_str(), red_strerror(rs));
+        }
+    }
+
+    /*
+     * Once no part is in flight: complete the upload, or abort it if a part
+     * (or the caller, with @p rs) failed, and close it
+     */
+    red_status_t finish(red_status_t rs, red_mp_info_t *info)
+    {
+        if (rs == RED_SUCCESS)
+            rs = error;
+        if (rs == RED_SUCCESS)
+            rs = complete(info);
+        if (rs != RED_SUCCESS)
+            abort();
+
+        if (RED_IS_VALID_OPEN_HANDLE(created_oh))
+        {
+            control([this](red_done_t done) {
+                return client->async_client->close(created_oh, client->api_user,
+                                                   std::move(done));
+            });
+        }
+        return rs;
+    }
+};
+
+#endif /* S3_MULTIPART_HPP */
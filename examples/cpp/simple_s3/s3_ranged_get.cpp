@@ -0,0 +1,486 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_ranged_get.cpp
+ *   Project:    RED
+ *
+ *   Description: Parallel ranged GET engine of the example S3 client
+ *
+ *   Created:    10/16/2026
+ *   Author(s):  Dana Helwig (dhelwig@ddn.com)
+ *
+ ******************************************************************************/
+#include "simple_s3_client.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <strings.h>
+#include "s3_events.hpp"
+#include "../common/include/crc32c.hpp"
+#include "../common/include/log.hpp"
+#include "../common/include/md5.hpp"
+
+static uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/* Error of red_get_part_size_v2() for a part the object does not have; any other fails the get */
+static bool no_such_part(red_status_t rs)
+{
+    return rs == RED_ENOENT;
+}
+
+/* An ETag that is the hex MD5 of the data, as S3 gives a part by default */
+static bool md5_etag(const char *etag, size_t size)
+{
+    size_t len = strnlen(etag, size);
+    if (len != 2 * common::md5_t::DIGEST_SIZE)
+        return false;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (!isxdigit(static_cast<unsigned char>(etag[i])))
+            return false;
+    }
+    return true;
+}
+
+/*
+ * One get_object_parallel() call. Part 1 is sized first: if the object has
+ * parts, the following ones are sized and read in a pipeline until a part
+ * number comes back missing; otherwise the buffer is read in byte ranges,
+ * and a byte past it tells whether the object fits.
+ */
+struct s3client::ranged_get_t
+{
+    enum step_e
+    {
+        SIZE, /* red_get_part_size_v2() */
+        READ, /* red_pread_part() */
+        DONE,
+        NONE /* Past the end of the object */
+    };
+
+    struct read_t
+    {
+        uint32_t part_num; /* 0 for a byte range */
+        step_e   step;
+        size_t   size;
+        uint64_t offset;
+        ssize_t  bytes;
+        uint64_t start_ns;
+        uint64_t latency_ns;
+        bool     verified;
+        char     etag[RED_S3_USER_ETAG_SIZE];
+
+        /* red_part_xattr_info_t and the ETag that follows it */
+        alignas(red_part_xattr_info_t) char xattr[sizeof(red_part_xattr_info_t) +
+                                                  RED_S3_USER_ETAG_SIZE];
+
+        red_part_xattr_info_t *xattr_info()
+        {
+            return reinterpret_cast<red_part_xattr_info_t *>(xattr);
+        }
+    };
+
+    s3client                 *client;
+    std::shared_ptr<s3bucket> bucket;
+    const std::string        &key;
+    red_buffer_t              buffer;
+    ranged_get_config_t       cfg;
+    rfs_open_hndl_t           root_oh = {0};
+    rfs_open_hndl_t           oh      = {0};
+    uint64_t                  version = 0;
+    std::deque<read_t>        reads; /* Stable addresses for the calls' outputs */
+    bool                      probing; /* Part 1 not sized yet */
+    bool                      by_part    = false;
+    uint32_t                  next_part  = 1;
+    uint32_t                  last_part  = RED_S3_MAX_PARTS;
+    uint64_t                  next_off   = 0;
+    uint64_t                  eof;     /* Shortest end seen by a range read */
+    uint32_t                  in_flight  = 0;
+    uint32_t                  unverified = 0;
+    red_status_t              error      = RED_SUCCESS;
+    s3_events_t               events;
+
+    ranged_get_t(s3client                  *client,
+                 std::shared_ptr<s3bucket>  bucket,
+                 const std::string         &key,
+                 const red_buffer_t        &buffer,
+                 const ranged_get_config_t &cfg)
+    : client(client),
+      bucket(std::move(bucket)),
+      key(key),
+      buffer(buffer),
+      cfg(cfg),
+      probing(cfg.by_part),
+      eof(buffer.size)
+    {
+    }
+
+    char *dest(uint64_t offset) const
+    {
+        return static_cast<char *>(buffer.addr) + offset;
+    }
+
+    read_t &add(uint32_t part_num, step_e step)
+    {
+        reads.emplace_back();
+        read_t &r  = reads.back();
+        r.part_num = part_num;
+        r.step     = step;
+        r.start_ns = now_ns();
+        in_flight++;
+        return r;
+    }
+
+    void fail(red_status_t rs)
+    {
+        if (error == RED_SUCCESS)
+            error = rs;
+    }
+
+    void start_part(uint32_t part_num)
+    {
+        uint32_t id = static_cast<uint32_t>(reads.size());
+        read_t  &r  = add(part_num, SIZE);
+
+        red_status_t rs = client->async_client->get_part_size_v2(
+            oh, part_num, &r.size, &r.offset, r.etag, client->api_user, events.on_done(id));
+        if (rs != RED_SUCCESS)
+            sized(id, rs);
+    }
+
+    void start_range()
+    {
+        uint32_t id = static_cast<uint32_t>(reads.size());
+        read_t  &r  = add(0, READ);
+
+        r.offset = next_off;
+        r.size   = std::min<uint64_t>(cfg.range_size, buffer.size - next_off);
+        next_off += r.size;
+
+        red_status_t rs = client->async_client->pread_part(
+            oh, buffer.iomem, dest(r.offset), UINT32_MAX, static_cast<off_t>(r.offset), r.size,
+            &r.bytes, nullptr, client->api_user, events.on_done(id));
+        if (rs != RED_SUCCESS)
+            done(id, rs);
+    }
+
+    void sized(uint32_t id, red_status_t rs)
+    {
+        read_t &r = reads[id];
+
+        if (r.part_num == 1)
+            probing = false;
+
+        if (no_such_part(rs))
+        {
+            r.step = NONE;
+            in_flight--;
+            if (r.part_num == 1)
+            {
+                /* No parts: read the object by byte range */
+                by_part = false;
+                return;
+            }
+            last_part = std::min(last_part, r.part_num - 1);
+            return;
+        }
+        if (rs == RED_SUCCESS && r.offset + r.size > buffer.size)
+            rs = RED_ETRUNC;
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to size part %u of %s: %s", r.part_num, key.c_str(),
+                       red_strerror(rs));
+            r.step = NONE;
+            in_flight--;
+            return fail(rs);
+        }
+        if (error != RED_SUCCESS)
+        {
+            /* The get failed meanwhile: start no read */
+            r.step = NONE;
+            in_flight--;
+            return;
+        }
+
+        r.step = READ;
+        if (r.part_num == 1)
+            by_part = true;
+
+        red_part_xattr_info_t *xattr = r.xattr_info();
+        memset(r.xattr, 0, sizeof(r.xattr));
+        xattr->etag_size = RED_S3_USER_ETAG_SIZE;
+
+        rs = client->async_client->pread_part(oh, buffer.iomem, dest(r.offset), r.part_num, 0,
+                                              r.size, &r.bytes, xattr, client->api_user,
+                                              events.on_done(id));
+        if (rs != RED_SUCCESS)
+            done(id, rs);
+    }
+
+    void done(uint32_t id, red_status_t rs)
+    {
+        read_t &r = reads[id];
+
+        r.step       = DONE;
+        r.latency_ns = now_ns() - r.start_ns;
+        in_flight--;
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to read %s at %lu: %s", key.c_str(), r.offset,
+                       red_strerror(rs));
+            return fail(rs);
+        }
+
+        if (r.part_num == 0)
+        {
+            if (static_cast<size_t>(r.bytes) < r.size)
+                eof = std::min(eof, r.offset + r.bytes);
+            return;
+        }
+
+        if (static_cast<size_t>(r.bytes) != r.size)
+        {
+            COMMON_LOG("ERROR: Part %u of %s read %zd of %zu bytes", r.part_num, key.c_str(),
+                       r.bytes, r.size);
+            return fail(RED_EIO);
+        }
+        if (cfg.verify)
+            verify(r);
+    }
+
+    /* Check the part against its CRC-32C or CRC-32, or else an MD5 ETag */
+    void verify(read_t &r)
+    {
+        const red_part_xattr_info_t *xattr = r.xattr_info();
+        const char                  *data  = dest(r.offset);
+        bool                         match;
+
+        switch (xattr->checksum_type)
+        {
+        case RED_S3CS_CRC32C:
+            match = common::crc32c(0, data, r.size) == xattr->checksum.crc32;
+            break;
+        case RED_S3CS_CRC32:
+            match = common::crc32(0, data, r.size) == xattr->checksum.crc32;
+            break;
+        case RED_S3CS_NONE:
+        {
+            size_t etag_size = std::min<size_t>(xattr->etag_size, RED_S3_USER_ETAG_SIZE);
+            if (!md5_etag(xattr->etag, etag_size))
+            {
+                /* Nothing stored to check it against */
+                unverified++;
+                return;
+            }
+            char          computed[RED_S3_USER_ETAG_SIZE];
+            common::md5_t md5;
+            md5.update(data, r.size);
+            md5.final_hex(computed);
+            match = strncasecmp(computed, xattr->etag, 2 * common::md5_t::DIGEST_SIZE) == 0;
+            break;
+        }
+        default:
+            COMMON_LOG("ERROR: Part %u of %s has a checksum of type %d that cannot be verified",
+                       r.part_num, key.c_str(), xattr->checksum_type);
+            return fail(RED_ENOTSUP);
+        }
+        if (!match)
+        {
+            COMMON_LOG("ERROR: Part %u of %s does not match its checksum", r.part_num,
+                       key.c_str());
+            return fail(RED_ECKSUM);
+        }
+        r.verified = true;
+    }
+
+    /* Whether an object read by byte range goes on past the buffer it filled */
+    void probe_end()
+    {
+        char    byte;
+        ssize_t n = 0;
+
+        red_status_t rs = events.control([&](red_done_t done) {
+            return client->async_client->pread(oh, &byte, 1, static_cast<off_t>(buffer.size), &n,
+                                               client->api_user, std::move(done));
+        });
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to read %s at %zu: %s", key.c_str(), buffer.size,
+                       red_strerror(rs));
+            return fail(rs);
+        }
+        if (n > 0)
+        {
+            COMMON_LOG("ERROR: %s does not fit in %zu bytes", key.c_str(), buffer.size);
+            fail(RED_ETRUNC);
+        }
+    }
+
+    void advance(const s3_events_t::event_t &e)
+    {
+        if (reads[e.id].step == SIZE)
+            sized(e.id, e.rs);
+        else
+            done(e.id, e.rs);
+    }
+
+    /* Start what the depth allows: part 1 alone until it shows whether there are parts */
+    void launch()
+    {
+        unsigned depth = std::max(1u, cfg.concurrency);
+
+        if (probing)
+        {
+            if (reads.empty())
+                start_part(next_part++);
+            return;
+        }
+
+        while (error == RED_SUCCESS && in_flight < depth)
+        {
+            if (by_part && next_part <= last_part)
+                start_part(next_part++);
+            else if (!by_part && next_off < eof)
+                start_range();
+            else
+                break;
+        }
+    }
+
+    red_status_t open()
+    {
+        red_status_t rs;
+
+        for (int attempt = 0; attempt < 2; attempt++)
+        {
+            rs = bucket->root(&root_oh);
+            if (rs != RED_SUCCESS)
+                return rs;
+
+            rs = events.control([this](red_done_t done) {
+                return client->async_client->s3_open(root_oh, key.c_str(), 0, O_RDONLY, &oh,
+                                                     &version, client->api_user,
+                                                     std::move(done));
+            });
+            if (!stale_root(rs))
+                break;
+            bucket->invalidate_root(root_oh);
+        }
+        return rs;
+    }
+
+    red_status_t run(ssize_t *bytes_read, ranged_get_result_t *result)
+    {
+        red_status_t rs = open();
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to open file %s: %s", key.c_str(), red_strerror(rs));
+            return rs;
+        }
+
+        for (;;)
+        {
+            launch();
+            if (in_flight == 0)
+                break;
+            rs = events.wait();
+            if (rs != RED_SUCCESS)
+                fail(rs);
+            for (const s3_events_t::event_t &e : events.take())
+                advance(e);
+        }
+        if (error == RED_SUCCESS && !by_part && eof == buffer.size)
+            probe_end();
+
+        events.control([this](red_done_t done) {
+            return client->async_client->close(oh, client->api_user, std::move(done));
+        });
+        if (error != RED_SUCCESS)
+            return error;
+
+        uint64_t end = 0;
+        for (const read_t &r : reads)
+        {
+            if (r.step == DONE)
+                end = std::max(end, r.offset + r.bytes);
+        }
+        *bytes_read = static_cast<ssize_t>(end);
+
+        if (result != nullptr)
+            report(result);
+        return RED_SUCCESS;
+    }
+
+    void report(ranged_get_result_t *result) const
+    {
+        result->by_part    = by_part;
+        result->verified   = 0;
+        result->unverified = unverified;
+        result->reads.clear();
+        for (const read_t &r : reads)
+        {
+            /* Range reads past the end read nothing */
+            if (r.step != DONE || (r.part_num == 0 && r.bytes == 0))
+                continue;
+            result->reads.push_back(
+                {r.part_num, static_cast<off_t>(r.offset), static_cast<size_t>(r.bytes),
+                 r.latency_ns, r.verified});
+            result->verified += r.verified;
+        }
+    }
+};
+
+/*
+ * Up to cfg.concurrency reads are in flight through IAsyncRedClient, each
+ * straight into its place in the buffer. The object is opened with
+ * red_s3_open(); if red_get_part_size_v2() finds parts, each part is sized
+ * and read with red_pread_part() by part number, and its CRC-32C or CRC-32,
+ * or else its ETag when that is an MD5, is checked against the data.
+ * Objects without parts, or any object with cfg.by_part off, are read in
+ * cfg.range_size byte ranges instead. Fails with RED_ETRUNC if the object
+ * does not fit in the buffer, RED_ECKSUM if a part does not match its
+ * checksum, and RED_ENOTSUP if a part's checksum cannot be verified.
+ */
+red_status_t s3client::get_object_parallel(std::weak_ptr<s3bucket>    bucket_weak,
+                                           const std::string         &key,
+                                           const red_buffer_t        &buffer,
+                                           ssize_t                   *bytes_read,
+                                           const ranged_get_config_t &cfg,
+                                           ranged_get_result_t       *result)
+{
+    auto bucket = bucket_weak.lock();
+    if (!bucket)
+    {
+        COMMON_LOG("ERROR: Invalid bucket handle");
+        return RED_EINVAL;
+    }
+    if (buffer.iomem.hndl == nullptr || cfg.range_size == 0)
+    {
+        COMMON_LOG("ERROR: Ranged reads need an iomem buffer and a range size");
+        return RED_EINVAL;
+    }
+
+    ranged_get_t get(this, std::move(bucket), key, buffer, cfg);
+    return get.run(bytes_read, result);
+}
@@ -0,0 +1,430 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_readahead.cpp
+ *   Project:    RED
+ *
+ *   Description: Object reader with sequential read-ahead of the example S3
+ *                client
+ *
+ *   Created:    10/16/2026
+ *   Author(s):  Dana Helwig (dhelwig@ddn.com)
+ *
+ ******************************************************************************/
+#include "simple_s3_client.hpp"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include "s3_events.hpp"
+#include "../common/include/log.hpp"
+
+/*
+ * Read-ahead in the manner of Linux's ondemand readahead. A sequential read
+ * that misses starts a window of cfg.initial_window (or twice the read)
+ * read through IAsyncRedClient; when a read first reaches the newest
+ * window, the next one, twice as large up to cfg.max_window, is started
+ * behind it, so the reads that follow find their data arrived or in flight.
+ * A read neither at the end of the previous one nor inside the window is
+ * random: the window is dropped, what it read ahead counted as wasted, and
+ * the read goes to the object directly. A reader belongs to the thread that
+ * opened it, as its handle does, and must not outlive its client.
+ *
+ * The window is a run of segments in object order, each one read-ahead
+ * into its own buffer. Segments dropped while their read is in flight are
+ * kept aside until it completes, since the read still writes into them.
+ */
+struct s3reader::state_t
+{
+    struct buffer_t
+    {
+        std::unique_ptr<char[]> data;
+        size_t                  capacity = 0;
+    };
+
+    struct segment_t
+    {
+        uint32_t     id;
+        uint64_t     offset;
+        size_t       size;
+        buffer_t     buf;
+        ssize_t      bytes;
+        bool         ready;
+        red_status_t rs;
+        size_t       copied;  /* Bytes handed to reads */
+        bool         trigger; /* Its first read starts the next segment */
+    };
+
+    using segment_ptr = std::unique_ptr<segment_t>;
+
+    IAsyncRedClient         *async_client;
+    red_api_user_t          *api_user;
+    std::string              key;
+    readahead_config_t       cfg;
+    rfs_open_hndl_t          oh             = {0};
+    std::deque<segment_ptr>  window;
+    std::vector<segment_ptr> dropped;
+    std::vector<buffer_t>    spare;
+    bool                     started        = false;
+    uint64_t                 prev_end       = 0; /* End of the previous read */
+    uint64_t                 eof            = UINT64_MAX;
+    size_t                   ra_size        = 0;
+    uint32_t                 next_id        = 0;
+    bool                     direct_pending = false;
+    red_status_t             direct_rs      = RED_SUCCESS;
+    readahead_stats_t        stats          = {};
+    s3_events_t              events;
+
+    state_t(IAsyncRedClient *async_client, red_api_user_t *api_user, const std::string &key,
+            const readahead_config_t &cfg)
+    : async_client(async_client),
+      api_user(api_user),
+      key(key),
+      cfg(cfg)
+    {
+    }
+
+    ~state_t()
+    {
+        drop_window();
+        while (!dropped.empty())
+            poll();
+        if (RED_IS_VALID_OPEN_HANDLE(oh))
+        {
+            events.control([this](red_done_t done) {
+                return async_client->close(oh, api_user, std::move(done));
+            });
+        }
+    }
+
+    buffer_t take_buffer(size_t size)
+    {
+        for (buffer_t &b : spare)
+        {
+            if (b.capacity >= size)
+            {
+                buffer_t found = std::move(b);
+                b              = std::move(spare.back());
+                spare.pop_back();
+                return found;
+            }
+        }
+        return {std::unique_ptr<char[]>(new char[size]), size};
+    }
+
+    void give_buffer(buffer_t buf)
+    {
+        /* Enough for the window and the one behind it */
+        if (spare.size() < 2)
+            spare.push_back(std::move(buf));
+    }
+
+    /* Bytes a segment read that no read took */
+    static uint64_t unread(const segment_t &s)
+    {
+        if (s.rs != RED_SUCCESS || s.bytes <= 0)
+            return 0;
+        return static_cast<uint64_t>(s.bytes) - std::min<uint64_t>(s.copied, s.bytes);
+    }
+
+    void prefetch(uint64_t offset, size_t size)
+    {
+        if (offset >= eof || size == 0)
+            return;
+
+        auto s     = std::make_unique<segment_t>();
+        s->id      = next_id++;
+        s->offset  = offset;
+        s->size    = size;
+        s->buf     = take_buffer(size);
+        s->bytes   = 0;
+        s->ready   = false;
+        s->rs      = RED_SUCCESS;
+        s->copied  = 0;
+        s->trigger = true;
+
+        red_status_t rs = async_client->pread(oh, s->buf.data.get(), size,
+                                              static_cast<off_t>(offset), &s->bytes, api_user,
+                                              events.on_done(s->id));
+        if (rs != RED_SUCCESS)
+        {
+            /* The read that wanted it goes to the object instead */
+            COMMON_LOG("WARNING: Read-ahead of %s at %lu failed: %s", key.c_str(), offset,
+                       red_strerror(rs));
+            give_buffer(std::move(s->buf));
+            return;
+        }
+        stats.window = size;
+        window.push_back(std::move(s));
+    }
+
+    void complete(const s3_events_t::event_t &e)
+    {
+        if (e.id == s3_events_t::CONTROL)
+        {
+            direct_pending = false;
+            direct_rs      = e.rs;
+            return;
+        }
+        for (segment_ptr &s : window)
+        {
+            if (s->id != e.id)
+                continue;
+            s->ready = true;
+            s->rs    = e.rs;
+            if (e.rs == RED_SUCCESS)
+            {
+                stats.prefetched += s->bytes;
+                if (static_cast<size_t>(s->bytes) < s->size)
+                    eof = std::min(eof, s->offset + s->bytes);
+            }
+            return;
+        }
+        for (auto it = dropped.begin(); it != dropped.end(); ++it)
+        {
+            segment_t &s = **it;
+            if (s.id != e.id)
+                continue;
+            if (e.rs == RED_SUCCESS && s.bytes > 0)
+            {
+                stats.prefetched += s.bytes;
+                stats.wasted += s.bytes;
+            }
+            give_buffer(std::move(s.buf));
+            dropped.erase(it);
+            return;
+        }
+    }
+
+    /* A failed wait is retried: calls in flight still write into segments or the caller's buffer */
+    void poll()
+    {
+        events.wait();
+        for (const s3_events_t::event_t &e : events.take())
+            complete(e);
+    }
+
+    void drop(segment_ptr s)
+    {
+        if (!s->ready)
+        {
+            dropped.push_back(std::move(s));
+            return;
+        }
+        stats.wasted += unread(*s);
+        give_buffer(std::move(s->buf));
+    }
+
+    void drop_window()
+    {
+        while (!window.empty())
+        {
+            drop(std::move(window.front()));
+            window.pop_front();
+        }
+    }
+
+    /* Segments wholly before @p pos are done with */
+    void trim(uint64_t pos)
+    {
+        while (!window.empty() && window.front()->offset + window.front()->size <= pos)
+        {
+            drop(std::move(window.front()));
+            window.pop_front();
+        }
+    }
+
+    segment_t *find(uint64_t pos)
+    {
+        for (segment_ptr &s : window)
+        {
+            if (pos >= s->offset && pos < s->offset + s->size)
+                return s.get();
+        }
+        return nullptr;
+    }
+
+    uint64_t window_end() const
+    {
+        return window.empty() ? 0 : window.back()->offset + window.back()->size;
+    }
+
+    /* Twice the read that starts a window, and no less than the initial window */
+    size_t initial_size(size_t size) const
+    {
+        return std::min(std::max(cfg.initial_window, 2 * size), cfg.max_window);
+    }
+
+    /* A read of the object itself, taking the read-ahead completions that come meanwhile */
+    red_status_t direct(void *buf, size_t size, uint64_t offset, ssize_t *bytes_read)
+    {
+        red_status_t rs = async_client->pread(oh, buf, size, static_cast<off_t>(offset),
+                                              bytes_read, api_user,
+                                              events.on_done(s3_events_t::CONTROL));
+        if (rs != RED_SUCCESS)
+            return rs;
+        for (direct_pending = true; direct_pending;)
+            poll();
+        return direct_rs;
+    }
+
+    red_status_t read(char *buf, size_t size, uint64_t offset, ssize_t *bytes_read)
+    {
+        stats.reads++;
+
+        bool sequential = !started || offset == prev_end || find(offset) != nullptr;
+        started         = true;
+        if (cfg.max_window == 0 || !sequential)
+        {
+            if (cfg.max_window != 0)
+            {
+                stats.random++;
+                drop_window();
+                ra_size = 0;
+            }
+            red_status_t rs = direct(buf, size, offset, bytes_read);
+            if (rs == RED_SUCCESS)
+                prev_end = offset + *bytes_read;
+            return rs;
+        }
+
+        bool hit = find(offset) != nullptr;
+        if (!hit)
+        {
+            drop_window();
+            ra_size = initial_size(size);
+            prefetch(offset, ra_size);
+        }
+
+        uint64_t pos = offset;
+        uint64_t end = offset + size;
+        while (pos < end && pos < eof)
+        {
+            segment_t *s = find(pos);
+            if (s == nullptr)
+            {
+                /* A read larger than the window runs past it */
+                size_t before = window.size();
+                prefetch(window.empty() ? pos : window_end(), ra_size);
+                if (window.size() == before)
+                    break;
+                continue;
+            }
+
+            /* Reaching the newest segment starts the next, larger one behind it */
+            if (s->trigger && s == window.back().get())
+            {
+                s->trigger = false;
+                ra_size    = std::min(ra_size * 2, cfg.max_window);
+                prefetch(s->offset + s->size, ra_size);
+            }
+
+            while (!s->ready)
+                poll();
+            if (s->rs != RED_SUCCESS)
+            {
+                COMMON_LOG("WARNING: Read-ahead of %s at %lu failed: %s", key.c_str(), s->offset,
+                           red_strerror(s->rs));
+                break;
+            }
+
+            uint64_t avail = s->offset + s->bytes;
+            if (pos >= avail)
+                break;
+            size_t n = static_cast<size_t>(std::min(end, avail) - pos);
+            memcpy(buf + (pos - offset), s->buf.data.get() + (pos - s->offset), n);
+            s->copied += n;
+            pos += n;
+        }
+
+        /* What the window could not serve, after a failed read-ahead, comes from the object */
+        if (pos < end && pos < eof)
+        {
+            hit = false;
+            drop_window();
+            ssize_t      rest = 0;
+            red_status_t rs   = direct(buf + (pos - offset), end - pos, pos, &rest);
+            if (rs != RED_SUCCESS)
+                return rs;
+            pos += rest;
+        }
+
+        trim(pos);
+        stats.hits += hit;
+        prev_end    = pos;
+        *bytes_read = static_cast<ssize_t>(pos - offset);
+        return RED_SUCCESS;
+    }
+};
+
+s3reader::s3reader(std::unique_ptr<state_t> state) : state(std::move(state)) {}
+
+s3reader::~s3reader() = default;
+
+red_status_t s3reader::read(void *buf, size_t size, off_t offset, ssize_t *bytes_read)
+{
+    if (offset < 0)
+        return RED_EINVAL;
+    return state->read(static_cast<char *>(buf), size, static_cast<uint64_t>(offset),
+                       bytes_read);
+}
+
+const readahead_stats_t &s3reader::stats() const
+{
+    return state->stats;
+}
+
+red_status_t s3client::open_reader(std::weak_ptr<s3bucket>    bucket_weak,
+                                   const std::string         &key,
+                                   std::unique_ptr<s3reader> *reader,
+                                   const readahead_config_t  &cfg)
+{
+    auto bucket = bucket_weak.lock();
+    if (!bucket)
+    {
+        COMMON_LOG("ERROR: Invalid bucket handle");
+        return RED_EINVAL;
+    }
+
+    auto            state   = std::make_unique<s3reader::state_t>(async_client.get(), api_user,
+                                                                  key, cfg);
+    rfs_open_hndl_t root_oh = {0};
+    uint64_t        version = 0;
+    red_status_t    rs;
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        rs = bucket->root(&root_oh);
+        if (rs != RED_SUCCESS)
+            return rs;
+
+        rs = state->events.control([&](red_done_t done) {
+            return async_client->s3_open(root_oh, key.c_str(), 0, O_RDONLY, &state->oh, &version,
+                                         api_user, std::move(done));
+        });
+        if (!stale_root(rs))
+            break;
+        bucket->invalidate_root(root_oh);
+    }
+    if (rs != RED_SUCCESS)
+    {
+        COMMON_LOG("ERROR: Failed to open file %s: %s", key.c_str(), red_strerror(rs));
+        return rs;
+    }
+
+    reader->reset(new s3reader(std::move(state)));
+    return RED_SUCCESS;
+}
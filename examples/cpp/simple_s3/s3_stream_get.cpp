@@ -0,0 +1,497 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_stream_get.cpp
+ *   Project:    RED
+ *
+ *   Description: Streaming GET of the example S3 client into a sink or a
+ *                file descriptor
+ *
+ *   Created:    10/16/2026
+ *   Author(s):  Dana Helwig (dhelwig@ddn.com)
+ *
+ ******************************************************************************/
+#include "simple_s3_client.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "s3_events.hpp"
+#include "../common/include/buffer_pool.hpp"
+#include "../common/include/log.hpp"
+#include "../common/include/md5.hpp"
+
+static uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/*
+ * One get_object_to_sink() call. Windows are read in object order, window
+ * i taking reads i, i + windows, ..., and handed to the sink in that order
+ * on the calling thread, each as soon as the ones before it have been; a
+ * window is read again once delivered. The data is hashed as it is
+ * delivered, part by part when the ETag says the object was uploaded in
+ * parts, whose boundaries are sized before the first read.
+ */
+struct s3client::stream_get_t
+{
+    struct window_t
+    {
+        char    *addr;
+        uint64_t offset;
+        ssize_t  bytes;
+        bool     ready; /* Read, not yet delivered */
+    };
+
+    struct part_t
+    {
+        size_t   size;
+        uint64_t offset;
+        char     etag[RED_S3_USER_ETAG_SIZE];
+    };
+
+    s3client                 *client;
+    std::shared_ptr<s3bucket> bucket;
+    const std::string        &key;
+    object_sink_t            &sink;
+    stream_get_config_t       cfg;
+    std::vector<window_t>     windows;
+    rfs_open_hndl_t           root_oh   = {0};
+    rfs_open_hndl_t           oh        = {0};
+    uint64_t                  version   = 0;
+    uint64_t                  reads     = 0; /* Started */
+    uint64_t                  delivered = 0; /* Reads handed to the sink */
+    uint64_t                  next_off  = 0;
+    uint64_t                  eof       = UINT64_MAX; /* End seen by a short read */
+    uint64_t                  bytes     = 0; /* Delivered */
+    uint64_t                  hashed    = 0;
+    uint32_t                  in_flight = 0;
+    red_status_t              error     = RED_SUCCESS;
+    char                      etag[RED_S3_USER_MPART_ETAG_SIZE] = {};
+    std::vector<uint64_t>     part_ends; /* Empty unless the ETag is a multipart one */
+    size_t                    part = 0;  /* Being hashed */
+    common::md5_t             md5;       /* Of the data, or of the current part */
+    common::md5_t             parts_md5; /* Of the parts' MD5s */
+    uint64_t                  start_ns;
+    uint64_t                  first_byte_ns = 0;
+    s3_events_t               events;
+
+    stream_get_t(s3client                  *client,
+                 std::shared_ptr<s3bucket>  bucket,
+                 const std::string         &key,
+                 object_sink_t             &sink,
+                 const stream_get_config_t &cfg)
+    : client(client),
+      bucket(std::move(bucket)),
+      key(key),
+      sink(sink),
+      cfg(cfg),
+      start_ns(now_ns())
+    {
+    }
+
+    ~stream_get_t()
+    {
+        for (window_t &w : windows)
+            common::registered_buffer_source().free(w.addr);
+    }
+
+    void fail(red_status_t rs)
+    {
+        if (error == RED_SUCCESS)
+            error = rs;
+    }
+
+    red_status_t alloc()
+    {
+        /* Registered buffers come in whole pages */
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+
+        windows.resize(std::max(1u, cfg.windows));
+        for (window_t &w : windows)
+        {
+            w.addr = static_cast<char *>(common::registered_buffer_source().alloc(
+                (cfg.window_size + page - 1) / page * page));
+            if (w.addr == nullptr)
+            {
+                windows.resize(&w - windows.data());
+                return RED_ENOMEM;
+            }
+            w.ready = false;
+        }
+        return RED_SUCCESS;
+    }
+
+    red_status_t open()
+    {
+        red_status_t rs;
+
+        for (int attempt = 0; attempt < 2; attempt++)
+        {
+            rs = bucket->root(&root_oh);
+            if (rs != RED_SUCCESS)
+                return rs;
+
+            rs = events.control([this](red_done_t done) {
+                return client->async_client->s3_open(root_oh, key.c_str(), 0, O_RDONLY, &oh,
+                                                     &version, client->api_user,
+                                                     std::move(done));
+            });
+            if (!stale_root(rs))
+                break;
+            bucket->invalidate_root(root_oh);
+        }
+        return rs;
+    }
+
+    /* The ETag of the version opened; an object without one is not verified */
+    red_status_t fetch_etag()
+    {
+        size_t       len = 0;
+        red_status_t rs  = events.control([this, &len](red_done_t done) {
+            return client->async_client->fgetxattr(oh, RED_S3_ETAG_KEY, etag, sizeof(etag) - 1,
+                                                   &len, client->api_user, std::move(done));
+        });
+        if (rs == RED_ENODATA)
+        {
+            COMMON_LOG("WARNING: %s has no ETag, it will not be verified", key.c_str());
+            return RED_SUCCESS;
+        }
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to get the ETag of %s: %s", key.c_str(), red_strerror(rs));
+            return rs;
+        }
+        etag[std::min(len, sizeof(etag) - 1)] = '\0';
+
+        const char *dash = strchr(etag, '-');
+        if (dash == nullptr)
+            return RED_SUCCESS;
+        unsigned long parts = strtoul(dash + 1, nullptr, 10);
+        if (parts == 0 || parts > RED_S3_MAX_PARTS)
+        {
+            COMMON_LOG("ERROR: Malformed ETag %s of %s", etag, key.c_str());
+            return RED_EINVAL;
+        }
+        return size_parts(static_cast<uint32_t>(parts));
+    }
+
+    /* Where the @p count parts of a multipart ETag end, sized with up to cfg.windows in flight */
+    red_status_t size_parts(uint32_t count)
+    {
+        std::vector<part_t> parts(count);
+        uint32_t            next    = 0;
+        uint32_t            pending = 0;
+        red_status_t        rs      = RED_SUCCESS;
+
+        for (;;)
+        {
+            while (rs == RED_SUCCESS && next < count && pending < windows.size())
+            {
+                part_t &p = parts[next];
+                rs        = client->async_client->get_part_size_v2(
+                    oh, next + 1, &p.size, &p.offset, p.etag, client->api_user,
+                    events.on_done(next));
+                if (rs == RED_SUCCESS)
+                {
+                    next++;
+                    pending++;
+                }
+            }
+            if (pending == 0)
+                break;
+            red_status_t ws = events.wait();
+            if (ws != RED_SUCCESS && rs == RED_SUCCESS)
+                rs = ws;
+            for (const s3_events_t::event_t &e : events.take())
+            {
+                pending--;
+                if (e.rs != RED_SUCCESS && rs == RED_SUCCESS)
+                    rs = e.rs;
+            }
+        }
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to size the parts of %s: %s", key.c_str(),
+                       red_strerror(rs));
+            return rs;
+        }
+
+        part_ends.reserve(count);
+        for (const part_t &p : parts)
+            part_ends.push_back(p.offset + p.size);
+        return RED_SUCCESS;
+    }
+
+    void close_part()
+    {
+        uint8_t digest[common::md5_t::DIGEST_SIZE];
+        md5.final(digest);
+        parts_md5.update(digest, sizeof(digest));
+        md5.reset();
+        part++;
+    }
+
+    void hash(const char *data, size_t size)
+    {
+        if (part_ends.empty())
+        {
+            md5.update(data, size);
+            return;
+        }
+        while (size > 0)
+        {
+            uint64_t end = part < part_ends.size() ? part_ends[part] : UINT64_MAX;
+            size_t   n   = static_cast<size_t>(std::min<uint64_t>(size, end - hashed));
+            md5.update(data, n);
+            data += n;
+            size -= n;
+            hashed += n;
+            if (hashed == end)
+                close_part();
+        }
+    }
+
+    /* Whether what was delivered hashes to the ETag */
+    bool matches()
+    {
+        char computed[RED_S3_USER_MPART_ETAG_SIZE];
+
+        if (part_ends.empty())
+        {
+            md5.final_hex(computed);
+            return strcmp(computed, etag) == 0;
+        }
+        if (part < part_ends.size() && hashed > (part == 0 ? 0 : part_ends[part - 1]))
+            close_part();
+        parts_md5.final_hex(computed);
+        snprintf(computed + 2 * common::md5_t::DIGEST_SIZE,
+                 sizeof(computed) - 2 * common::md5_t::DIGEST_SIZE, "-%zu", part);
+        return strcmp(computed, etag) == 0;
+    }
+
+    void launch()
+    {
+        size_t window_size = cfg.window_size;
+
+        while (error == RED_SUCCESS && next_off < eof && reads < delivered + windows.size())
+        {
+            uint32_t  id = static_cast<uint32_t>(reads % windows.size());
+            window_t &w  = windows[id];
+
+            w.offset = next_off;
+            w.bytes  = 0;
+            w.ready  = false;
+
+            red_status_t rs = client->async_client->pread(oh, w.addr, window_size,
+                                                          static_cast<off_t>(w.offset), &w.bytes,
+                                                          client->api_user, events.on_done(id));
+            if (rs != RED_SUCCESS)
+            {
+                COMMON_LOG("ERROR: Failed to read %s at %lu: %s", key.c_str(), w.offset,
+                           red_strerror(rs));
+                return fail(rs);
+            }
+            reads++;
+            next_off += window_size;
+            in_flight++;
+        }
+    }
+
+    void done(const s3_events_t::event_t &e)
+    {
+        window_t &w = windows[e.id];
+
+        in_flight--;
+        w.ready = true;
+        if (e.rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to read %s at %lu: %s", key.c_str(), w.offset,
+                       red_strerror(e.rs));
+            return fail(e.rs);
+        }
+        if (static_cast<size_t>(w.bytes) < cfg.window_size)
+            eof = std::min(eof, w.offset + w.bytes);
+    }
+
+    /* Hand the windows read to the sink, in object order */
+    void deliver()
+    {
+        while (error == RED_SUCCESS && delivered < reads)
+        {
+            window_t &w = windows[delivered % windows.size()];
+            if (!w.ready)
+                break;
+            w.ready = false;
+            delivered++;
+
+            /* Windows started before the end was known read nothing */
+            if (w.offset >= eof || w.bytes <= 0)
+                continue;
+
+            size_t size = static_cast<size_t>(w.bytes);
+            if (first_byte_ns == 0)
+                first_byte_ns = now_ns() - start_ns;
+            if (cfg.verify && etag[0] != '\0')
+                hash(w.addr, size);
+            bytes += size;
+
+            red_status_t rs = sink(w.offset, w.addr, size);
+            if (rs != RED_SUCCESS)
+            {
+                COMMON_LOG("ERROR: The sink of %s failed at %lu: %s", key.c_str(), w.offset,
+                           red_strerror(rs));
+                return fail(rs);
+            }
+        }
+    }
+
+    red_status_t run(stream_get_result_t *result)
+    {
+        red_status_t rs = alloc();
+        if (rs != RED_SUCCESS)
+            return rs;
+
+        rs = open();
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to open file %s: %s", key.c_str(), red_strerror(rs));
+            return rs;
+        }
+        if (cfg.verify)
+            error = fetch_etag();
+
+        for (;;)
+        {
+            launch();
+            if (in_flight == 0)
+                break;
+            rs = events.wait();
+            if (rs != RED_SUCCESS)
+                fail(rs);
+            for (const s3_events_t::event_t &e : events.take())
+                done(e);
+            deliver();
+        }
+
+        events.control([this](red_done_t done) {
+            return client->async_client->close(oh, client->api_user, std::move(done));
+        });
+        if (error != RED_SUCCESS)
+            return error;
+
+        bool verified = cfg.verify && etag[0] != '\0';
+        if (verified && !matches())
+        {
+            COMMON_LOG("ERROR: %s does not match its ETag %s", key.c_str(), etag);
+            return RED_ECKSUM;
+        }
+
+        if (result != nullptr)
+        {
+            memset(result, 0, sizeof(*result));
+            result->bytes         = bytes;
+            result->memory        = windows.size() * cfg.window_size;
+            result->first_byte_ns = first_byte_ns;
+            result->verified      = verified;
+            memcpy(result->etag, etag, sizeof(result->etag));
+        }
+        return RED_SUCCESS;
+    }
+};
+
+/*
+ * cfg.windows reads of cfg.window_size bytes are kept in flight through
+ * IAsyncRedClient, so the sink starts before the object is read and no more
+ * than the windows are held; a sink error stops the reads. With cfg.verify
+ * the data is checked against the ETag of the version opened, and an object
+ * without an ETag is delivered unverified. Fails with the sink's error, or
+ * with RED_ECKSUM once everything is delivered if the data does not match.
+ */
+red_status_t s3client::get_object_to_sink(std::weak_ptr<s3bucket>    bucket_weak,
+                                          const std::string         &key,
+                                          object_sink_t              sink,
+                                          const stream_get_config_t &cfg,
+                                          stream_get_result_t       *result)
+{
+    auto bucket = bucket_weak.lock();
+    if (!bucket)
+    {
+        COMMON_LOG("ERROR: Invalid bucket handle");
+        return RED_EINVAL;
+    }
+    if (!sink || cfg.window_size == 0)
+    {
+        COMMON_LOG("ERROR: Streaming %s needs a sink and a window size", key.c_str());
+        return RED_EINVAL;
+    }
+
+    stream_get_t get(this, std::move(bucket), key, sink, cfg);
+    return get.run(result);
+}
+
+red_status_t s3client::get_object_to_fd(std::weak_ptr<s3bucket>    bucket,
+                                        const std::string         &key,
+                                        int                        fd,
+                                        const stream_get_config_t &cfg,
+                                        stream_get_result_t       *result)
+{
+    /*
+     * Regular files are written at their offsets, and the file offset moved
+     * past the data last; pipes, sockets and other streams take write(), in
+     * order. vmsplice() is not used as windows are read again as soon as
+     * delivered.
+     */
+    struct stat st;
+    off_t       base = -1;
+    if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+        base = lseek(fd, 0, SEEK_CUR);
+
+    uint64_t      end  = 0;
+    object_sink_t sink = [fd, base, &end](uint64_t offset, const void *data,
+                                          size_t size) -> red_status_t {
+        const char *p = static_cast<const char *>(data);
+        while (size > 0)
+        {
+            ssize_t n = base >= 0 ? pwrite(fd, p, size, base + static_cast<off_t>(offset))
+                                  : write(fd, p, size);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+            {
+                COMMON_LOG("ERROR: Failed to write to fd %d: %s", fd, strerror(errno));
+                return RED_EIO;
+            }
+            p += n;
+            size -= n;
+            offset += n;
+        }
+        end = offset;
+        return RED_SUCCESS;
+    };
+
+    red_status_t rs = get_object_to_sink(bucket, key, std::move(sink), cfg, result);
+    if (base >= 0 && end > 0)
+        lseek(fd, base + static_cast<off_t>(end), SEEK_SET);
+    return rs;
+}
@@ -0,0 +1,495 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_stream_put.cpp
+ *   Project:    RED
+ *
+ *   Description: Streaming PUT from a file descriptor for the example S3 client
+ *
+ *   Created:    10/16/2026
+ *   Author(s):  Dana Helwig (dhelwig@ddn.com)
+ *
+ ******************************************************************************/
+#include "simple_s3_client.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "s3_events.hpp"
+#include "s3_multipart.hpp"
+#include "../common/include/buffer_pool.hpp"
+#include "../common/include/crc32c.hpp"
+#include "../common/include/log.hpp"
+#include "../common/include/md5.hpp"
+
+/* Checksum types that can be computed a chunk at a time */
+static bool incremental(red_s3_checksum_type_e type)
+{
+    return type == RED_S3CS_NONE || type == RED_S3CS_CRC32 || type == RED_S3CS_CRC32C;
+}
+
+static uint32_t checksum_update(red_s3_checksum_type_e type,
+                                uint32_t               crc,
+                                const void            *data,
+                                size_t                 size)
+{
+    switch (type)
+    {
+    case RED_S3CS_CRC32:
+        return common::crc32(crc, data, size);
+    case RED_S3CS_CRC32C:
+        return common::crc32c(crc, data, size);
+    default:
+        return 0;
+    }
+}
+
+/*
+ * One put_object_from_fd() call. Chunks are read, hashed and handed to the
+ * writes in order on the calling thread, and come back once written. While
+ * the size of a stream is unknown, the chunks read are held until the
+ * stream ends (one object) or outgrows the threshold or the chunks
+ * (multipart).
+ */
+struct s3client::stream_put_t
+{
+    enum mode_e
+    {
+        UNDECIDED,
+        SINGLE,
+        MULTIPART
+    };
+
+    /* Part index of a chunk not handed to a multipart upload */
+    static constexpr uint32_t NO_PART = UINT32_MAX;
+
+    struct chunk_t
+    {
+        char    *addr;
+        size_t   size;   /* Bytes of data in it */
+        uint64_t offset; /* In the object */
+        bool     busy;   /* Holds data not yet written */
+        uint32_t part;
+        uint32_t crc;    /* Of the chunk alone, as a part's checksum */
+        ssize_t  written;
+    };
+
+    s3client                       *client;
+    std::shared_ptr<s3bucket>       bucket;
+    const std::string              &key;
+    int                             fd;
+    stream_put_config_t             cfg;
+    size_t                          chunk_size = 0;
+    std::vector<chunk_t>            chunks;
+    std::vector<uint32_t>           held; /* Chunks read while UNDECIDED */
+    mode_e                          mode      = UNDECIDED;
+    uint64_t                        bytes     = 0;
+    bool                            eof       = false;
+    rfs_open_hndl_t                 oh        = {0};
+    uint32_t                        in_flight = 0; /* Writes of a single object */
+    red_status_t                    error     = RED_SUCCESS;
+    common::md5_t                   md5;       /* Of the data */
+    common::md5_t                   parts_md5; /* Of the parts' MD5s */
+    uint32_t                        crc       = 0; /* Of the data */
+    uint32_t                        parts_crc = 0; /* Of the parts' checksums */
+    std::unique_ptr<mpart_upload_t> upload;
+    s3_events_t                     events;
+
+    stream_put_t(s3client                  *client,
+                 std::shared_ptr<s3bucket>  bucket,
+                 const std::string         &key,
+                 int                        fd,
+                 const stream_put_config_t &cfg)
+    : client(client),
+      bucket(std::move(bucket)),
+      key(key),
+      fd(fd),
+      cfg(cfg)
+    {
+    }
+
+    ~stream_put_t()
+    {
+        for (chunk_t &c : chunks)
+            common::registered_buffer_source().free(c.addr);
+    }
+
+    /*
+     * Size the chunks: parts of a known size stay within RED_S3_MAX_PARTS,
+     * and as many chunks as cfg.buffers asks for and the memory limit allows
+     */
+    red_status_t alloc(uint64_t known_size)
+    {
+        chunk_size = std::min(cfg.chunk_size, cfg.memory_limit);
+        if (mode == MULTIPART)
+            chunk_size = std::max<uint64_t>(chunk_size,
+                                            (known_size + RED_S3_MAX_PARTS - 1) / RED_S3_MAX_PARTS);
+        if (chunk_size == 0 || chunk_size > cfg.memory_limit)
+        {
+            COMMON_LOG("ERROR: %s needs chunks of %zu bytes within a %zu byte limit", key.c_str(),
+                       chunk_size, cfg.memory_limit);
+            return chunk_size == 0 ? RED_EINVAL : RED_EFBIG;
+        }
+
+        /* Registered buffers come in whole pages */
+        size_t page  = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t count = std::min<size_t>(std::max(1u, cfg.buffers), cfg.memory_limit / chunk_size);
+        chunks.resize(count);
+        for (chunk_t &c : chunks)
+        {
+            c.addr = static_cast<char *>(common::registered_buffer_source().alloc(
+                (chunk_size + page - 1) / page * page));
+            if (c.addr == nullptr)
+            {
+                chunks.resize(&c - chunks.data());
+                return RED_ENOMEM;
+            }
+            c.busy = false;
+        }
+        return RED_SUCCESS;
+    }
+
+    chunk_t *free_chunk()
+    {
+        for (chunk_t &c : chunks)
+        {
+            if (!c.busy)
+                return &c;
+        }
+        return nullptr;
+    }
+
+    bool failing() const
+    {
+        return error != RED_SUCCESS || (upload && upload->error != RED_SUCCESS);
+    }
+
+    void fail(red_status_t rs)
+    {
+        if (error == RED_SUCCESS)
+            error = rs;
+    }
+
+    /* Read a whole chunk, short only at the end of the stream */
+    red_status_t fill(chunk_t &c)
+    {
+        c.size = 0;
+        while (c.size < chunk_size)
+        {
+            ssize_t n = read(fd, c.addr + c.size, chunk_size - c.size);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0)
+            {
+                COMMON_LOG("ERROR: Failed to read the data of %s: %s", key.c_str(),
+                           strerror(errno));
+                return RED_EIO;
+            }
+            if (n == 0)
+            {
+                eof = true;
+                break;
+            }
+            c.size += n;
+        }
+        return RED_SUCCESS;
+    }
+
+    /* Hash the chunk in stream order, for the object or for its part */
+    void hash(chunk_t &c)
+    {
+        if (mode != MULTIPART)
+        {
+            md5.update(c.addr, c.size);
+            crc = checksum_update(cfg.checksum, crc, c.addr, c.size);
+        }
+        if (mode != SINGLE)
+        {
+            common::md5_t part_md5;
+            uint8_t       digest[common::md5_t::DIGEST_SIZE];
+            part_md5.update(c.addr, c.size);
+            part_md5.final(digest);
+            parts_md5.update(digest, sizeof(digest));
+
+            /* Part checksums are combined big-endian, as S3 composite checksums are */
+            c.crc       = checksum_update(cfg.checksum, 0, c.addr, c.size);
+            uint32_t be = __builtin_bswap32(c.crc);
+            parts_crc   = checksum_update(cfg.checksum, parts_crc, &be, sizeof(be));
+        }
+    }
+
+    red_status_t start()
+    {
+        if (mode == SINGLE)
+            return client->open_object(bucket, key, O_CREAT | O_WRONLY, &oh);
+
+        upload = std::make_unique<mpart_upload_t>(client, bucket, key, red_iomem_hndl_t{nullptr},
+                                                  cfg.retries);
+        return upload->create();
+    }
+
+    void submit(chunk_t &c)
+    {
+        uint32_t     id = static_cast<uint32_t>(&c - chunks.data());
+        red_status_t rs;
+
+        if (mode == MULTIPART)
+        {
+            if (upload->parts.size() >= RED_S3_MAX_PARTS)
+            {
+                COMMON_LOG("ERROR: %s is larger than %u parts of %zu bytes", key.c_str(),
+                           RED_S3_MAX_PARTS, chunk_size);
+                c.busy = false;
+                return fail(RED_EFBIG);
+            }
+            red_s3_checksum_t checksum = {};
+            if (cfg.checksum != RED_S3CS_NONE)
+            {
+                checksum.type           = cfg.checksum;
+                checksum.checksum.crc32 = c.crc;
+            }
+            c.part = static_cast<uint32_t>(upload->parts.size());
+            upload->add(c.addr, c.size, checksum);
+            return;
+        }
+
+        rs = client->async_client->pwrite(oh, c.addr, c.size, static_cast<off_t>(c.offset),
+                                          &c.written, client->api_user, events.on_done(id));
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to write data: %s", red_strerror(rs));
+            c.busy = false;
+            return fail(rs);
+        }
+        in_flight++;
+    }
+
+    /*
+     * Once the stream ends or outgrows what can be held, start the object or
+     * upload and the writes of what was read, which was hashed both ways
+     */
+    void decide()
+    {
+        if (eof && bytes <= cfg.multipart_threshold)
+            mode = SINGLE;
+        else if (eof || bytes > cfg.multipart_threshold || free_chunk() == nullptr)
+            mode = MULTIPART;
+        else
+            return;
+
+        red_status_t rs = start();
+        for (uint32_t id : held)
+        {
+            chunk_t &c = chunks[id];
+            if (rs != RED_SUCCESS)
+                c.busy = false;
+            else
+                submit(c);
+        }
+        held.clear();
+        if (rs != RED_SUCCESS)
+            fail(rs);
+    }
+
+    void written(const s3_events_t::event_t &e)
+    {
+        chunk_t &c = chunks[e.id];
+
+        in_flight--;
+        c.busy = false;
+        if (e.rs == RED_SUCCESS && c.written != static_cast<ssize_t>(c.size))
+        {
+            COMMON_LOG("ERROR: Short write of %s at %lu: %zd of %zu bytes", key.c_str(), c.offset,
+                       c.written, c.size);
+            return fail(RED_EIO);
+        }
+        if (e.rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to write data: %s", red_strerror(e.rs));
+            fail(e.rs);
+        }
+    }
+
+    void wait()
+    {
+        if (mode == SINGLE)
+        {
+            red_status_t rs = events.wait();
+            if (rs != RED_SUCCESS)
+                fail(rs);
+            for (const s3_events_t::event_t &e : events.take())
+                written(e);
+            return;
+        }
+
+        upload->poll();
+        for (chunk_t &c : chunks)
+        {
+            if (c.busy && c.part != NO_PART && upload->done(c.part))
+                c.busy = false;
+        }
+    }
+
+    bool writing() const
+    {
+        return mode == SINGLE ? in_flight != 0 : (mode == MULTIPART && upload->in_flight != 0);
+    }
+
+    red_status_t run(stream_put_result_t *result)
+    {
+        struct stat st;
+        uint64_t    known_size = 0;
+
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+        {
+            known_size = static_cast<uint64_t>(st.st_size);
+            mode       = known_size > cfg.multipart_threshold ? MULTIPART : SINGLE;
+        }
+
+        red_status_t rs = alloc(known_size);
+        if (rs == RED_SUCCESS && mode != UNDECIDED)
+            rs = start();
+        if (rs != RED_SUCCESS)
+            return rs;
+
+        for (;;)
+        {
+            chunk_t *c;
+            while (!failing() && !eof && (c = free_chunk()) != nullptr)
+            {
+                rs = fill(*c);
+                if (rs != RED_SUCCESS)
+                {
+                    fail(rs);
+                    break;
+                }
+                if (c->size == 0)
+                {
+                    /* An empty stream is an empty object */
+                    if (mode == UNDECIDED)
+                        decide();
+                    break;
+                }
+
+                c->busy   = true;
+                c->part   = NO_PART;
+                c->offset = bytes;
+                bytes += c->size;
+                hash(*c);
+                if (mode == UNDECIDED)
+                {
+                    held.push_back(static_cast<uint32_t>(c - chunks.data()));
+                    decide();
+                }
+                else
+                {
+                    submit(*c);
+                }
+            }
+            if (!writing())
+                break;
+            wait();
+        }
+
+        return finish(result);
+    }
+
+    red_status_t finish(stream_put_result_t *result)
+    {
+        red_mp_info_t info;
+        red_status_t  rs = error;
+
+        if (mode == SINGLE && RED_IS_VALID_OPEN_HANDLE(oh))
+            client->red_client->close(oh, client->api_user);
+        else if (mode == MULTIPART && upload)
+            rs = upload->finish(error, &info);
+        if (rs != RED_SUCCESS)
+            return rs;
+
+        if (result != nullptr)
+        {
+            memset(result, 0, sizeof(*result));
+            result->bytes         = bytes;
+            result->memory        = chunks.size() * chunk_size;
+            result->checksum.type = cfg.checksum;
+            if (mode == SINGLE)
+            {
+                result->checksum.checksum.crc32 = crc;
+                md5.final_hex(result->etag);
+            }
+            else
+            {
+                result->parts                   = static_cast<uint32_t>(upload->parts.size());
+                result->checksum.checksum.crc32 = parts_crc;
+                parts_md5.final_hex(result->etag);
+                snprintf(result->etag + 2 * common::md5_t::DIGEST_SIZE,
+                         sizeof(result->etag) - 2 * common::md5_t::DIGEST_SIZE, "-%u",
+                         result->parts);
+            }
+            if (cfg.checksum == RED_S3CS_NONE)
+                result->checksum.checksum.crc32 = 0;
+        }
+        return RED_SUCCESS;
+    }
+};
+
+/*
+ * No more than cfg.memory_limit of the data is held: cfg.buffers chunks of
+ * cfg.chunk_size (fewer if the limit says so) cycle between read() on the
+ * calling thread and writes in flight through IAsyncRedClient. A regular
+ * file larger than cfg.multipart_threshold, or a stream of unknown size
+ * that does not end within the first chunks, is uploaded in parts of a
+ * chunk each (enlarged to stay within RED_S3_MAX_PARTS when the size is
+ * known), retried and aborted as put_object_multipart() does; anything else
+ * is written as one object. The MD5 ETag and cfg.checksum are computed as
+ * the data is read, the checksum also per part. Fails with RED_ENOTSUP for
+ * a checksum that cannot be computed incrementally, RED_EIO if reading @p fd
+ * fails, and RED_EFBIG if a stream outgrows RED_S3_MAX_PARTS chunks.
+ */
+red_status_t s3client::put_object_from_fd(std::weak_ptr<s3bucket>    bucket_weak,
+                                          const std::string         &key,
+                                          int                        fd,
+                                          const stream_put_config_t &cfg,
+                                          stream_put_result_t       *result)
+{
+    auto bucket = bucket_weak.lock();
+    if (!bucket)
+    {
+        COMMON_LOG("ERROR: Invalid bucket handle");
+        return RED_EINVAL;
+    }
+    if (!incremental(cfg.checksum))
+    {
+        COMMON_LOG("ERROR: Checksum type %d cannot be computed as the data streams",
+                   cfg.checksum);
+        return RED_ENOTSUP;
+    }
+
+    if (cache_cfg.capacity != 0)
+        invalidate_cached(bucket.get(), key);
+
+    s3bucket    *target = bucket.get();
+    stream_put_t put(this, std::move(bucket), key, fd, cfg);
+    red_status_t rs = put.run(result);
+
+    /* Again once completed: a reader may have cached the handle while the data streamed */
+    if (cache_cfg.capacity != 0)
+        invalidate_cached(target, key);
+    return rs;
+}
@@ -0,0 +1,407 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_write_behind.cpp
+ *   Project:    RED
+ *
+ *   Description: Object writer with write-behind coalescing of the example
+ *                S3 client
+ *
+ *   Created:    10/16/2026
+ *   Author(s):  Dana Helwig (dhelwig@ddn.com)
+ *
+ ******************************************************************************/
+#include "simple_s3_client.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <unistd.h>
+#include "s3_events.hpp"
+#include "../common/include/buffer_pool.hpp"
+#include "../common/include/log.hpp"
+
+static uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/*
+ * Contiguous writes are copied into page-aligned buffers of
+ * cfg.buffer_size; once cfg.flush_size bytes are gathered, or the oldest of
+ * them is cfg.flush_ns old, or on flush() or close(), the buffers go out in
+ * one red_pwritev2() through IAsyncRedClient while the next writes gather.
+ * A write that does not follow the previous one flushes what was gathered
+ * first. At most cfg.max_in_flight flushes are in flight, and a flush
+ * overlapping one in flight waits for it, so later data lands last. The age
+ * is checked whenever the writer is called: a writer that may go idle is
+ * poll()ed from the caller's loop, or keeps its data until the next call.
+ * A failed flush is returned by the next call, and by every one after it,
+ * as the data it held is lost. A writer belongs to the thread that opened
+ * it and must not outlive its client.
+ *
+ * The run is the data gathered since the last flush, contiguous from
+ * run_offset across buffers; a flush hands its buffers and their iovecs to
+ * red_pwritev2() and gets them back when it completes.
+ */
+struct s3writer::state_t
+{
+    struct chunk_t
+    {
+        char  *addr;
+        size_t used;
+    };
+
+    struct flush_t
+    {
+        uint32_t                id;
+        uint64_t                offset;
+        size_t                  size;
+        std::vector<char *>     buffers;
+        std::vector<red_iovec>  iov;
+        ssize_t                 written;
+    };
+
+    IAsyncRedClient                     *async_client;
+    red_api_user_t                      *api_user;
+    std::string                          key;
+    write_behind_config_t                cfg;
+    rfs_open_hndl_t                      oh = {0};
+    std::function<void()>                on_close;
+    size_t                               buffer_size;
+    std::vector<char *>                  buffers; /* Every buffer allocated */
+    std::vector<char *>                  idle;
+    std::vector<chunk_t>                 run;
+    uint64_t                             run_offset   = 0;
+    size_t                               run_size     = 0;
+    uint64_t                             run_start_ns = 0;
+    std::deque<std::unique_ptr<flush_t>> in_flight; /* Stable addresses for the calls' outputs */
+    uint32_t                             next_id = 0;
+    red_status_t                         error   = RED_SUCCESS;
+    bool                                 closed  = false;
+    write_behind_stats_t                 stats   = {};
+    s3_events_t                          events;
+
+    state_t(IAsyncRedClient             *async_client,
+            red_api_user_t              *api_user,
+            const std::string           &key,
+            const write_behind_config_t &cfg)
+    : async_client(async_client),
+      api_user(api_user),
+      key(key),
+      cfg(cfg)
+    {
+        /* Registered buffers come in whole pages */
+        size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        buffer_size = (std::max<size_t>(cfg.buffer_size, 1) + page - 1) / page * page;
+    }
+
+    ~state_t()
+    {
+        for (char *b : buffers)
+            common::registered_buffer_source().free(b);
+    }
+
+    void fail(red_status_t rs)
+    {
+        if (error == RED_SUCCESS)
+            error = rs;
+    }
+
+    char *take_buffer()
+    {
+        if (!idle.empty())
+        {
+            char *b = idle.back();
+            idle.pop_back();
+            return b;
+        }
+        char *b = static_cast<char *>(common::registered_buffer_source().alloc(buffer_size));
+        if (b != nullptr)
+            buffers.push_back(b);
+        return b;
+    }
+
+    void complete(const s3_events_t::event_t &e)
+    {
+        auto it = std::find_if(in_flight.begin(), in_flight.end(),
+                               [&e](const std::unique_ptr<flush_t> &f) { return f->id == e.id; });
+        if (it == in_flight.end())
+            return;
+
+        flush_t     &f  = **it;
+        red_status_t rs = e.rs;
+        if (rs == RED_SUCCESS && f.written != static_cast<ssize_t>(f.size))
+        {
+            COMMON_LOG("ERROR: Short write of %s at %lu: %zd of %zu bytes", key.c_str(), f.offset,
+                       f.written, f.size);
+            rs = RED_EIO;
+        }
+        else if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to write %zu bytes of %s at %lu: %s", f.size, key.c_str(),
+                       f.offset, red_strerror(rs));
+        }
+        fail(rs);
+        idle.insert(idle.end(), f.buffers.begin(), f.buffers.end());
+        in_flight.erase(it);
+    }
+
+    /* Take the completions already delivered */
+    void harvest()
+    {
+        for (const s3_events_t::event_t &e : events.take())
+            complete(e);
+    }
+
+    /* Wait for flushes to complete; a failed wait fails the writer */
+    void wait()
+    {
+        red_status_t rs = events.wait();
+        if (rs != RED_SUCCESS)
+            fail(rs);
+        for (const s3_events_t::event_t &e : events.take())
+            complete(e);
+    }
+
+    bool overlaps(uint64_t offset, size_t size) const
+    {
+        for (const std::unique_ptr<flush_t> &f : in_flight)
+        {
+            if (offset < f->offset + f->size && f->offset < offset + size)
+                return true;
+        }
+        return false;
+    }
+
+    /* Send the run out in one gathered write */
+    void submit()
+    {
+        if (run_size == 0)
+            return;
+
+        bool stalled = false;
+        harvest();
+        while (in_flight.size() >= std::max(1u, cfg.max_in_flight) ||
+               overlaps(run_offset, run_size))
+        {
+            stalled = true;
+            wait();
+        }
+        stats.stalls += stalled;
+        if (error != RED_SUCCESS)
+            return;
+
+        auto f     = std::make_unique<flush_t>();
+        f->id      = next_id++;
+        f->offset  = run_offset;
+        f->size    = run_size;
+        f->written = 0;
+        for (const chunk_t &c : run)
+        {
+            f->buffers.push_back(c.addr);
+            f->iov.push_back({c.addr, c.used, 0});
+        }
+        run.clear();
+        run_size = 0;
+
+        red_status_t rs = async_client->pwritev2(
+            oh, f->iov.data(), static_cast<int>(f->iov.size()), static_cast<off_t>(f->offset), 0,
+            &f->written, api_user, events.on_done(f->id));
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to write %zu bytes of %s at %lu: %s", f->size, key.c_str(),
+                       f->offset, red_strerror(rs));
+            idle.insert(idle.end(), f->buffers.begin(), f->buffers.end());
+            return fail(rs);
+        }
+        stats.flushes++;
+        in_flight.push_back(std::move(f));
+    }
+
+    red_status_t write(const char *data, size_t size, uint64_t offset)
+    {
+        if (closed)
+            return RED_EBADF;
+        harvest();
+        if (error != RED_SUCCESS || size == 0)
+            return error;
+
+        if (run_size != 0 && offset != run_offset + run_size)
+        {
+            submit();
+            if (error != RED_SUCCESS)
+                return error;
+        }
+        stats.writes++;
+        stats.bytes += size;
+        if (run_size == 0)
+        {
+            run_offset   = offset;
+            run_start_ns = now_ns();
+        }
+
+        while (size > 0)
+        {
+            if (run.empty() || run.back().used == buffer_size)
+            {
+                char *b = take_buffer();
+                if (b == nullptr)
+                {
+                    fail(RED_ENOMEM);
+                    break;
+                }
+                run.push_back({b, 0});
+            }
+            chunk_t &c = run.back();
+            size_t   n = std::min(size, buffer_size - c.used);
+            memcpy(c.addr + c.used, data, n);
+            c.used += n;
+            run_size += n;
+            data += n;
+            size -= n;
+
+            if (run_size >= cfg.flush_size)
+            {
+                uint64_t next = run_offset + run_size;
+                stats.by_size++;
+                submit();
+                if (error != RED_SUCCESS)
+                    break;
+                run_offset   = next;
+                run_start_ns = now_ns();
+            }
+        }
+
+        flush_aged();
+        return error;
+    }
+
+    /* Send the run out once it is older than cfg.flush_ns */
+    void flush_aged()
+    {
+        if (cfg.flush_ns != 0 && run_size != 0 && now_ns() - run_start_ns >= cfg.flush_ns)
+        {
+            stats.by_age++;
+            submit();
+        }
+    }
+
+    red_status_t poll()
+    {
+        if (closed)
+            return RED_EBADF;
+        harvest();
+        if (error == RED_SUCCESS)
+            flush_aged();
+        return error;
+    }
+
+    red_status_t flush()
+    {
+        if (closed)
+            return RED_EBADF;
+        if (error == RED_SUCCESS)
+            submit();
+        while (!in_flight.empty())
+            wait();
+        return error;
+    }
+
+    red_status_t close()
+    {
+        if (closed)
+            return RED_EBADF;
+
+        red_status_t rs = flush();
+        closed          = true;
+        red_status_t cs = events.control([this](red_done_t done) {
+            return async_client->close(oh, api_user, std::move(done));
+        });
+        if (cs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to close %s: %s", key.c_str(), red_strerror(cs));
+        }
+        if (on_close)
+            on_close();
+        return rs != RED_SUCCESS ? rs : cs;
+    }
+};
+
+s3writer::s3writer(std::unique_ptr<state_t> state) : state(std::move(state)) {}
+
+s3writer::~s3writer()
+{
+    if (!state->closed)
+        state->close();
+}
+
+red_status_t s3writer::write(const void *data, size_t size, off_t offset)
+{
+    if (offset < 0)
+        return RED_EINVAL;
+    return state->write(static_cast<const char *>(data), size, static_cast<uint64_t>(offset));
+}
+
+red_status_t s3writer::poll()
+{
+    return state->poll();
+}
+
+red_status_t s3writer::flush()
+{
+    return state->flush();
+}
+
+red_status_t s3writer::close()
+{
+    return state->close();
+}
+
+const write_behind_stats_t &s3writer::stats() const
+{
+    return state->stats;
+}
+
+red_status_t s3client::open_writer(std::weak_ptr<s3bucket>      bucket_weak,
+                                   const std::string           &key,
+                                   std::unique_ptr<s3writer>   *writer,
+                                   const write_behind_config_t &cfg)
+{
+    auto bucket = bucket_weak.lock();
+    if (!bucket)
+    {
+        COMMON_LOG("ERROR: Invalid bucket handle");
+        return RED_EINVAL;
+    }
+
+    auto state = std::make_unique<s3writer::state_t>(async_client.get(), api_user, key, cfg);
+
+    red_status_t rs = open_object(bucket, key, O_CREAT | O_WRONLY, &state->oh);
+    if (rs != RED_SUCCESS)
+        return rs;
+
+    if (cache_cfg.capacity != 0)
+    {
+        const s3bucket *b = bucket.get();
+        state->on_close   = [this, b, key]() { invalidate_cached(b, key); };
+    }
+    writer->reset(new s3writer(std::move(state)));
+    return RED_SUCCESS;
+}
@@ -24,14 +24,293 @@
  *
  ******************************************************************************/
 #include "simple_s3_client.hpp"
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <fcntl.h>
+#include <list>
+#include <thread>
+#include <unordered_map>
+#include <utility>
 #include "../common/include/log.hpp"
 
 #define RED_CLUSTER_ENV "RED_CLUSTER"
 #define RED_TENANT_ENV  "RED_TENANT"
 #define RED_USER_ENV    "RED_USER"
 
+/*
+ * One asynchronous call in flight: the callback the library runs and its
+ * continuation. A call that was queued runs it once on completion, from
+ * whichever thread delivers the completion (the caller's
+ * red_client_lib_poll(), e.g. through common::drain_completions(), or the
+ * poller thread), and its output arguments must stay valid until then. A
+ * call that fails to queue returns the error and never runs it.
+ */
+struct async_call_t
+{
+    rfs_usercb_t ucb;
+    red_done_t   done;
+};
+
+static void async_call_done(red_status_t rs, void *arg)
+{
+    auto      *call = static_cast<async_call_t *>(arg);
+    red_done_t done = std::move(call->done);
+
+    delete call;
+    done(rs);
+}
+
+static rfs_usercb_t *async_call(red_done_t done)
+{
+    auto *call        = new async_call_t{{async_call_done, nullptr, 0}, std::move(done)};
+    call->ucb.ucb_arg = call;
+    return &call->ucb;
+}
+
+/* The status of queueing the call; the library keeps the callback only if it was queued */
+static red_status_t async_queued(int rc, rfs_usercb_t *ucb)
+{
+    if (rc != RED_SUCCESS)
+        delete static_cast<async_call_t *>(ucb->ucb_arg);
+    return static_cast<red_status_t>(rc);
+}
+
+red_status_t AsyncRedClientImpl::obtain_dataset(const char         *name,
+                                                const char         *cluster,
+                                                red_ds_props_t     *props,
+                                                rfs_dataset_hndl_t *hndl,
+                                                red_api_user_t     *user,
+                                                red_done_t          done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_obtain_dataset(name, cluster, props, hndl, ucb, user), ucb);
+}
+
+red_status_t AsyncRedClientImpl::open_root(rfs_dataset_hndl_t ds_hndl,
+                                           rfs_open_hndl_t   *root_oh,
+                                           red_api_user_t    *user,
+                                           red_done_t         done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_open_root(ds_hndl, root_oh, ucb, user), ucb);
+}
+
+red_status_t AsyncRedClientImpl::openat(rfs_open_hndl_t  dir_oh,
+                                        const char      *path,
+                                        int              flags,
+                                        mode_t           mode,
+                                        rfs_open_hndl_t *oh,
+                                        red_api_user_t  *user,
+                                        red_done_t       done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_openat(dir_oh, path, flags, mode, oh, ucb, user), ucb);
+}
+
+red_status_t AsyncRedClientImpl::pwrite(rfs_open_hndl_t oh,
+                                        void           *buf,
+                                        size_t          count,
+                                        off_t           offset,
+                                        ssize_t        *bytes_written,
+                                        red_api_user_t *user,
+                                        red_done_t      done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_pwrite(oh, buf, count, offset, bytes_written, ucb, user), ucb);
+}
+
+red_status_t AsyncRedClientImpl::pread(rfs_open_hndl_t oh,
+                                       void           *buf,
+                                       size_t          count,
+                                       off_t           offset,
+                                       ssize_t        *bytes_read,
+                                       red_api_user_t *user,
+                                       red_done_t      done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_pread(oh, buf, count, offset, bytes_read, ucb, user), ucb);
+}
+
+red_status_t AsyncRedClientImpl::pwrite_iomem(rfs_open_hndl_t  oh,
+                                              red_iomem_hndl_t iomem,
+                                              void            *addr,
+                                              size_t           count,
+                                              off_t            offset,
+                                              ssize_t         *bytes_written,
+                                              red_api_user_t  *user,
+                                              red_done_t       done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(
+        ::red_pwrite_iomem(oh, iomem, addr, count, offset, bytes_written, ucb, user), ucb);
+}
+
+red_status_t AsyncRedClientImpl::pread_iomem(rfs_open_hndl_t  oh,
+                                             red_iomem_hndl_t iomem,
+                                             void            *addr,
+                                             size_t           count,
+                                             off_t            offset,
+                                             ssize_t         *bytes_read,
+                                             red_api_user_t  *user,
+                                             red_done_t       done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_pread_iomem(oh, iomem, addr, count, offset, bytes_read, ucb, user),
+                        ucb);
+}
+
+red_status_t AsyncRedClientImpl::pwritev2(rfs_open_hndl_t   oh,
+                                          struct red_iovec *iov,
+                                          int               iovcnt,
+                                          off_t             offset,
+                                          int               flags,
+                                          ssize_t          *bytes_written,
+                                          red_api_user_t   *user,
+                                          red_done_t        done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(
+        ::red_pwritev2(oh, iov, iovcnt, offset, flags, bytes_written, ucb, user), ucb);
+}
+
+red_status_t AsyncRedClientImpl::close(rfs_open_hndl_t oh, red_api_user_t *user, red_done_t done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_close(oh, ucb, user), ucb);
+}
+
+red_status_t AsyncRedClientImpl::close_dataset(rfs_dataset_hndl_t ds_hndl,
+                                               red_api_user_t    *user,
+                                               red_done_t         done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_close_dataset(ds_hndl, ucb, user), ucb);
+}
+
+red_status_t AsyncRedClientImpl::create_mpart_upload(rfs_open_hndl_t  root_oh,
+                                                     const char      *key,
+                                                     int              flags,
+                                                     char            *upload_id,
+                                                     size_t           upload_id_nob,
+                                                     rfs_open_hndl_t *created_oh,
+                                                     red_api_user_t  *user,
+                                                     red_done_t       done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_create_mpart_upload(root_oh, key, flags, upload_id, upload_id_nob,
+                                                  created_oh, ucb, user),
+                        ucb);
+}
+
+red_status_t AsyncRedClientImpl::upload_part(rfs_open_hndl_t  root_oh,
+                                             const char      *key,
+                                             const char      *upload_id,
+                                             uint32_t         part_num,
+                                             int              flags,
+                                             rfs_open_hndl_t *part_oh,
+                                             red_api_user_t  *user,
+                                             red_done_t       done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(
+        ::red_upload_part(root_oh, key, upload_id, part_num, flags, part_oh, ucb, user), ucb);
+}
+
+red_status_t AsyncRedClientImpl::close_part(rfs_open_hndl_t       part_oh,
+                                            red_data_integrity_t *integrity,
+                                            red_api_user_t       *user,
+                                            red_done_t            done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_close_part(part_oh, integrity, ucb, user), ucb);
+}
+
+red_status_t AsyncRedClientImpl::comp_mpart_upload(rfs_open_hndl_t     root_oh,
+                                                   const char         *key,
+                                                   const char         *upload_id,
+                                                   uint32_t            num_parts,
+                                                   uint32_t            upload_parts,
+                                                   red_part_info_v2_t *parts,
+                                                   bool                final_parts,
+                                                   uint32_t            flags,
+                                                   red_mp_info_t      *info,
+                                                   red_api_user_t     *user,
+                                                   red_done_t          done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_comp_mpart_upload(root_oh, key, upload_id, num_parts, upload_parts,
+                                                parts, final_parts, flags, info, ucb, user),
+                        ucb);
+}
+
+red_status_t AsyncRedClientImpl::abort_mpart(rfs_open_hndl_t root_oh,
+                                             const char     *key,
+                                             const char     *upload_id,
+                                             red_api_user_t *user,
+                                             red_done_t      done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_abort_mpart(root_oh, key, upload_id, ucb, user), ucb);
+}
+
+red_status_t AsyncRedClientImpl::s3_open(rfs_open_hndl_t  root_oh,
+                                         const char      *key,
+                                         uint64_t         version,
+                                         int              flags,
+                                         rfs_open_hndl_t *oh,
+                                         uint64_t        *out_version,
+                                         red_api_user_t  *user,
+                                         red_done_t       done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_s3_open(root_oh, key, version, flags, oh, out_version, ucb, user),
+                        ucb);
+}
+
+red_status_t AsyncRedClientImpl::get_part_size_v2(rfs_open_hndl_t oh,
+                                                  uint32_t        part_num,
+                                                  size_t         *part_size,
+                                                  uint64_t       *part_offset,
+                                                  char           *part_etag,
+                                                  red_api_user_t *user,
+                                                  red_done_t      done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(
+        ::red_get_part_size_v2(oh, part_num, part_size, part_offset, part_etag, ucb, user), ucb);
+}
+
+red_status_t AsyncRedClientImpl::pread_part(rfs_open_hndl_t        oh,
+                                            red_iomem_hndl_t       iomem,
+                                            void                  *addr,
+                                            uint32_t               part_num,
+                                            off_t                  offset,
+                                            size_t                 size,
+                                            ssize_t               *byte_cnt,
+                                            red_part_xattr_info_t *xattr_info,
+                                            red_api_user_t        *user,
+                                            red_done_t             done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_pread_part(oh, iomem, addr, part_num, offset, size, byte_cnt,
+                                         xattr_info, ucb, user),
+                        ucb);
+}
+
+red_status_t AsyncRedClientImpl::fgetxattr(rfs_open_hndl_t oh,
+                                           const char     *name,
+                                           void           *value,
+                                           size_t          size,
+                                           size_t         *ret_size,
+                                           red_api_user_t *user,
+                                           red_done_t      done)
+{
+    rfs_usercb_t *ucb = async_call(std::move(done));
+    return async_queued(::red_fgetxattr(oh, name, value, size, ret_size, ucb, user), ucb);
+}
+
 s3bucket::s3bucket(const std::string &bucket_name,
                    rfs_dataset_hndl_t hndl,
                    red_api_user_t    *user,
@@ -45,23 +324,319 @@ s3bucket::s3bucket(const std::string &bucket_name,
 
 s3bucket::~s3bucket()
 {
+    if (RED_IS_VALID_OPEN_HANDLE(root_oh))
+    {
+        red_client->close(root_oh, api_user);
+    }
     if (RED_IS_VALID_HANDLE(bucket_hndl))
     {
         red_client->close_dataset(bucket_hndl, api_user);
     }
 }
 
-s3client::s3client(red_api_user_t *user, std::unique_ptr<IRedClient> client)
+/*
+ * The root is shared by every object operation and thread until the bucket
+ * is destroyed, instead of costing an open_root()/close() pair per request
+ */
+red_status_t s3bucket::root(rfs_open_hndl_t *oh)
+{
+    std::lock_guard<std::mutex> guard(root_lock);
+
+    if (!RED_IS_VALID_OPEN_HANDLE(root_oh))
+    {
+        red_status_t rs = red_client->open_root(bucket_hndl, &root_oh, api_user);
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to open root: %s", red_strerror(rs));
+            root_oh = {0};
+            return rs;
+        }
+    }
+    *oh = root_oh;
+    return RED_SUCCESS;
+}
+
+/* The next root() opens a new handle; one another thread already replaced is left alone */
+void s3bucket::invalidate_root(rfs_open_hndl_t stale)
+{
+    std::lock_guard<std::mutex> guard(root_lock);
+
+    if (root_oh.fd == stale.fd)
+    {
+        red_client->close(root_oh, api_user);
+        root_oh = {0};
+    }
+}
+
+/* Guards every client's list of thread caches and the caches' client pointers */
+static std::mutex            g_cache_registry;
+static std::atomic<uint64_t> g_next_client_id{1};
+
+static uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/*
+ * The handles get_object() opens, per thread since handles are affined to
+ * the thread that opened them, in an LRU keyed by bucket and key. A
+ * put_object() through the client closes the cached handles of that object
+ * on its own thread and has the other threads close theirs on their next
+ * get_object(). Handles are closed on eviction, expiry, thread exit and
+ * client destruction. Destroying the client closes the calling thread's
+ * handles; those of other threads are left to them, closed when they next
+ * make a client's cache or exit, and their buckets stay open until then.
+ */
+struct s3client::thread_cache_t
+{
+    using object_t = std::pair<const s3bucket *, std::string>;
+
+    struct entry_t
+    {
+        object_t        object;
+        rfs_open_hndl_t oh;
+        uint64_t        opened_ns;
+    };
+
+    struct object_hash
+    {
+        size_t operator()(const object_t &o) const
+        {
+            return std::hash<std::string>()(o.second) ^ std::hash<const void *>()(o.first);
+        }
+    };
+
+    s3client                   *client; /* nullptr once the client is gone */
+    uint64_t                    client_id;
+    std::shared_ptr<IRedClient> red;
+    red_api_user_t             *api_user;
+    std::thread::id             owner;
+    /* Of a client destroyed while this thread held handles, open until they are closed */
+    std::vector<std::shared_ptr<s3bucket>> orphaned;
+    std::list<entry_t> lru;    /* Most recently used first */
+    std::unordered_map<object_t, std::list<entry_t>::iterator, object_hash> index;
+
+    /* Objects written by other threads, closed here on the next lookup */
+    std::mutex            pending_lock;
+    std::vector<object_t> pending;
+    std::atomic<bool>     has_pending{false};
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> evictions{0};
+    std::atomic<uint64_t> expired{0};
+    std::atomic<uint64_t> invalidated{0};
+
+    void close(std::list<entry_t>::iterator it)
+    {
+        red->close(it->oh, api_user);
+        index.erase(it->object);
+        lru.erase(it);
+    }
+
+    bool drop(const object_t &object)
+    {
+        auto it = index.find(object);
+        if (it == index.end())
+            return false;
+        close(it->second);
+        return true;
+    }
+
+    void close_all()
+    {
+        while (!lru.empty())
+            close(lru.begin());
+    }
+
+    void apply_pending()
+    {
+        std::vector<object_t> written;
+        {
+            std::lock_guard<std::mutex> guard(pending_lock);
+            written.swap(pending);
+            has_pending.store(false, std::memory_order_relaxed);
+        }
+        for (const object_t &object : written)
+        {
+            if (drop(object))
+                invalidated.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void add_to(handle_cache_stats_t *s) const
+    {
+        s->hits += hits.load(std::memory_order_relaxed);
+        s->misses += misses.load(std::memory_order_relaxed);
+        s->evictions += evictions.load(std::memory_order_relaxed);
+        s->expired += expired.load(std::memory_order_relaxed);
+        s->invalidated += invalidated.load(std::memory_order_relaxed);
+    }
+};
+
+/* The calling thread's caches, one per client; closes its handles on thread exit */
+struct s3client::thread_caches_t
+{
+    std::vector<thread_cache_t *> list;
+
+    ~thread_caches_t()
+    {
+        std::lock_guard<std::mutex> guard(g_cache_registry);
+        for (thread_cache_t *c : list)
+        {
+            c->close_all();
+            if (c->client != nullptr)
+                c->client->detach(c);
+            delete c;
+        }
+    }
+};
+
+s3client::s3client(red_api_user_t                  *user,
+                   std::unique_ptr<IRedClient>      client,
+                   std::unique_ptr<IAsyncRedClient> async)
 : api_user(user),
-  red_client(std::move(client))
+  red_client(std::move(client)),
+  async_client(std::move(async)),
+  cache_id(g_next_client_id.fetch_add(1, std::memory_order_relaxed)),
+  retired()
 {
 }
 
 s3client::~s3client()
 {
+    {
+        /*
+         * Handles are affined to their thread: other threads close theirs
+         * themselves, keeping the buckets open for them meanwhile
+         */
+        std::lock_guard<std::mutex> guard(g_cache_registry);
+        for (thread_cache_t *c : caches)
+        {
+            if (c->owner == std::this_thread::get_id())
+                c->close_all();
+            else if (!c->lru.empty())
+                c->orphaned.assign(buckets.begin(), buckets.end());
+            c->client = nullptr;
+        }
+        caches.clear();
+    }
     buckets.clear();
 }
 
+s3client::thread_cache_t *s3client::local_cache()
+{
+    static thread_local thread_caches_t tls;
+
+    for (thread_cache_t *c : tls.list)
+    {
+        if (c->client_id == cache_id)
+            return c;
+    }
+
+    std::lock_guard<std::mutex> guard(g_cache_registry);
+
+    /* Caches of clients destroyed since are only closed here or at thread exit */
+    auto dead = [](thread_cache_t *c) {
+        if (c->client != nullptr)
+            return false;
+        c->close_all();
+        delete c;
+        return true;
+    };
+    tls.list.erase(std::remove_if(tls.list.begin(), tls.list.end(), dead), tls.list.end());
+
+    auto *c      = new thread_cache_t;
+    c->client    = this;
+    c->client_id = cache_id;
+    c->red       = red_client;
+    c->api_user  = api_user;
+    c->owner     = std::this_thread::get_id();
+    tls.list.push_back(c);
+    caches.push_back(c);
+    return c;
+}
+
+void s3client::detach(thread_cache_t *cache)
+{
+    cache->add_to(&retired);
+    caches.erase(std::remove(caches.begin(), caches.end(), cache), caches.end());
+}
+
+red_status_t s3client::open_cached(const std::shared_ptr<s3bucket> &bucket,
+                                   const std::string               &key,
+                                   rfs_open_hndl_t                 *oh)
+{
+    thread_cache_t *c = local_cache();
+    if (c->has_pending.load(std::memory_order_acquire))
+        c->apply_pending();
+
+    thread_cache_t::object_t object(bucket.get(), key);
+    uint64_t                 now = now_ns();
+
+    auto it = c->index.find(object);
+    if (it != c->index.end())
+    {
+        auto entry = it->second;
+        if (cache_cfg.ttl_ns == 0 || now - entry->opened_ns < cache_cfg.ttl_ns)
+        {
+            c->lru.splice(c->lru.begin(), c->lru, entry);
+            c->hits.fetch_add(1, std::memory_order_relaxed);
+            *oh = entry->oh;
+            return RED_SUCCESS;
+        }
+        c->expired.fetch_add(1, std::memory_order_relaxed);
+        c->close(entry);
+    }
+    c->misses.fetch_add(1, std::memory_order_relaxed);
+
+    red_status_t rs = open_object(bucket, key, O_RDONLY, oh);
+    if (rs != RED_SUCCESS)
+        return rs;
+
+    if (c->lru.size() >= cache_cfg.capacity)
+    {
+        c->close(std::prev(c->lru.end()));
+        c->evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+    c->lru.push_front({std::move(object), *oh, now});
+    c->index.emplace(c->lru.front().object, c->lru.begin());
+    return RED_SUCCESS;
+}
+
+void s3client::drop_cached(const s3bucket *bucket, const std::string &key)
+{
+    local_cache()->drop({bucket, key});
+}
+
+void s3client::invalidate_cached(const s3bucket *bucket, const std::string &key)
+{
+    thread_cache_t *self = local_cache();
+    if (self->drop({bucket, key}))
+        self->invalidated.fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> guard(g_cache_registry);
+    for (thread_cache_t *c : caches)
+    {
+        if (c == self)
+            continue;
+        std::lock_guard<std::mutex> pending_guard(c->pending_lock);
+        c->pending.emplace_back(bucket, key);
+        c->has_pending.store(true, std::memory_order_release);
+    }
+}
+
+handle_cache_stats_t s3client::handle_cache_stats() const
+{
+    std::lock_guard<std::mutex> guard(g_cache_registry);
+    handle_cache_stats_t        s = retired;
+    for (const thread_cache_t *c : caches)
+        c->add_to(&s);
+    return s;
+}
+
 std::weak_ptr<s3bucket> s3client::create_bucket(const std::string &cluster,
                                                 const std::string &bucket_name)
 {
@@ -91,10 +666,72 @@ std::weak_ptr<s3bucket> s3client::create_bucket(const std::string &cluster,
     return bucket;
 }
 
+/* Errors after which the cached root handle is reopened once */
+bool s3client::stale_root(red_status_t rs)
+{
+    return rs == RED_ESTALE || rs == RED_EBADF;
+}
+
+red_status_t s3client::open_object(const std::shared_ptr<s3bucket> &bucket,
+                                   const std::string               &key,
+                                   int                              flags,
+                                   rfs_open_hndl_t                 *oh)
+{
+    mode_t       mode = (flags & O_CREAT) ? 0644 : 0;
+    red_status_t rs;
+
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        rfs_open_hndl_t root_oh;
+
+        rs = bucket->root(&root_oh);
+        if (rs != RED_SUCCESS)
+            return rs;
+
+        rs = red_client->openat(root_oh, key.c_str(), flags, mode, oh, api_user);
+        if (!stale_root(rs))
+            break;
+        bucket->invalidate_root(root_oh);
+    }
+
+    if (rs != RED_SUCCESS)
+    {
+        COMMON_LOG("ERROR: Failed to open file %s: %s", key.c_str(), red_strerror(rs));
+    }
+    return rs;
+}
+
+bool s3client::zero_copy(const red_buffer_t &buf) const
+{
+    red_iomem_hndl_t iomem = buf.iomem;
+    return iomem.hndl != nullptr && buf.size >= zero_copy_min;
+}
+
 red_status_t s3client::put_object(std::weak_ptr<s3bucket> bucket_weak,
                                   const std::string      &key,
                                   void                   *data,
                                   size_t                  size)
+{
+    return put_object(bucket_weak, key, red_buffer_t{{nullptr}, data, size});
+}
+
+red_status_t s3client::get_object(std::weak_ptr<s3bucket> bucket_weak,
+                                  const std::string      &key,
+                                  void                   *buffer,
+                                  size_t                  size,
+                                  ssize_t                *bytes_read)
+{
+    return get_object(bucket_weak, key, red_buffer_t{{nullptr}, buffer, size}, bytes_read);
+}
+
+/*
+ * Buffers in an iomem region (iomem.hndl set) of at least the zero-copy
+ * threshold go through pwrite_iomem()/pread_iomem() and are not copied by
+ * the library; smaller ones, or plain memory, take pwrite()/pread().
+ */
+red_status_t s3client::put_object(std::weak_ptr<s3bucket> bucket_weak,
+                                  const std::string      &key,
+                                  const red_buffer_t     &data)
 {
     auto bucket = bucket_weak.lock();
     if (!bucket)
@@ -103,40 +740,41 @@ red_status_t s3client::put_object(std::weak_ptr<s3bucket> bucket_weak,
         return RED_EINVAL;
     }
 
-    rfs_open_hndl_t root_oh;
     rfs_open_hndl_t oh;
 
-    red_status_t rs = red_client->open_root(bucket->handle(), &root_oh, api_user);
-    if (rs != RED_SUCCESS)
-    {
-        COMMON_LOG("ERROR: Failed to open root: %s", red_strerror(rs));
-        return rs;
-    }
-
-    rs = red_client->openat(root_oh, key.c_str(), O_CREAT | O_WRONLY, 0644, &oh,
-                            api_user);
+    red_status_t rs = open_object(bucket, key, O_CREAT | O_WRONLY, &oh);
     if (rs != RED_SUCCESS)
-    {
-        COMMON_LOG("ERROR: Failed to open file %s: %s", key.c_str(), red_strerror(rs));
-        red_client->close(root_oh, api_user);
         return rs;
-    }
 
     ssize_t bytes_written;
-    rs = red_client->pwrite(oh, data, size, 0, &bytes_written, api_user);
-    if (rs != RED_SUCCESS || bytes_written != static_cast<ssize_t>(size))
+    if (zero_copy(data))
+        rs = red_client->pwrite_iomem(oh, data.iomem, data.addr, data.size, 0, &bytes_written,
+                                      api_user);
+    else
+        rs = red_client->pwrite(oh, data.addr, data.size, 0, &bytes_written, api_user);
+    if (rs != RED_SUCCESS || bytes_written != static_cast<ssize_t>(data.size))
     {
         COMMON_LOG("ERROR: Failed to write data: %s", red_strerror(rs));
     }
     red_client->close(oh, api_user);
-    red_client->close(root_oh, api_user);
+    if (cache_cfg.capacity != 0)
+        invalidate_cached(bucket.get(), key);
     return rs;
 }
 
+red_status_t s3client::read_object(rfs_open_hndl_t     oh,
+                                   const red_buffer_t &buffer,
+                                   ssize_t            *bytes_read)
+{
+    if (zero_copy(buffer))
+        return red_client->pread_iomem(oh, buffer.iomem, buffer.addr, buffer.size, 0, bytes_read,
+                                       api_user);
+    return red_client->pread(oh, buffer.addr, buffer.size, 0, bytes_read, api_user);
+}
+
 red_status_t s3client::get_object(std::weak_ptr<s3bucket> bucket_weak,
                                   const std::string      &key,
-                                  void                   *buffer,
-                                  size_t                  size,
+                                  const red_buffer_t     &buffer,
                                   ssize_t                *bytes_read)
 {
     auto bucket = bucket_weak.lock();
@@ -146,30 +784,222 @@ red_status_t s3client::get_object(std::weak_ptr<s3bucket> bucket_weak,
         return RED_EINVAL;
     }
 
-    rfs_open_hndl_t root_oh;
     rfs_open_hndl_t oh;
+    red_status_t    rs;
 
-    red_status_t rs = red_client->open_root(bucket->handle(), &root_oh, api_user);
-    if (rs != RED_SUCCESS)
+    if (cache_cfg.capacity == 0)
     {
-        COMMON_LOG("ERROR: Failed to open root: %s", red_strerror(rs));
+        rs = open_object(bucket, key, O_RDONLY, &oh);
+        if (rs != RED_SUCCESS)
+            return rs;
+
+        rs = read_object(oh, buffer, bytes_read);
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to read data: %s", red_strerror(rs));
+        }
+        red_client->close(oh, api_user);
         return rs;
     }
 
-    rs = red_client->openat(root_oh, key.c_str(), O_RDONLY, 0, &oh, api_user);
-    if (rs != RED_SUCCESS)
+    /* A cached handle stays open; one that went stale is dropped and reopened once */
+    for (int attempt = 0;; attempt++)
     {
-        COMMON_LOG("ERROR: Failed to open file %s: %s", key.c_str(), red_strerror(rs));
-        red_client->close(root_oh, api_user);
-        return rs;
+        rs = open_cached(bucket, key, &oh);
+        if (rs != RED_SUCCESS)
+            return rs;
+
+        rs = read_object(oh, buffer, bytes_read);
+        if (rs == RED_SUCCESS)
+            return rs;
+
+        drop_cached(bucket.get(), key);
+        if (attempt != 0 || !stale_root(rs))
+            break;
+    }
+    COMMON_LOG("ERROR: Failed to read data: %s", red_strerror(rs));
+    return rs;
+}
+
+/*
+ * One put_object_async()/get_object_async() request, advanced from the
+ * completion of each step: open, transfer, close, then the caller's done
+ * with the transfer's status and byte count (the close's is not reported).
+ * Each step is queued from the completion of the previous one, so a thread
+ * can keep many requests in flight; only the bucket's root may be opened
+ * synchronously, the first time it is used. The buffer must stay valid
+ * until done runs, and the client must not be destroyed with requests in
+ * flight. Gets always open the object, without the handle cache; puts
+ * invalidate it before the write and again once it completes.
+ */
+struct s3client::async_op_t
+{
+    s3client                 *client;
+    std::shared_ptr<s3bucket> bucket;
+    std::string               key;
+    red_buffer_t              buf;
+    bool                      write;
+    bool                      retried = false;
+    rfs_open_hndl_t           root_oh = {0};
+    rfs_open_hndl_t           oh      = {0};
+    ssize_t                   bytes   = 0;
+    red_status_t              result  = RED_SUCCESS; /* Of the transfer */
+    object_done_t             done;
+
+    red_status_t open()
+    {
+        red_status_t rs = bucket->root(&root_oh);
+        if (rs != RED_SUCCESS)
+            return rs;
+
+        int flags = write ? O_CREAT | O_WRONLY : O_RDONLY;
+        return client->async_client->openat(root_oh, key.c_str(), flags, write ? 0644 : 0, &oh,
+                                            client->api_user,
+                                            [this](red_status_t rs) { opened(rs); });
+    }
+
+    void opened(red_status_t rs)
+    {
+        if (stale_root(rs) && !retried)
+        {
+            retried = true;
+            bucket->invalidate_root(root_oh);
+            rs = open();
+            if (rs == RED_SUCCESS)
+                return;
+        }
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to open file %s: %s", key.c_str(), red_strerror(rs));
+            return finish(rs);
+        }
+
+        IAsyncRedClient *async = client->async_client.get();
+        red_api_user_t  *user  = client->api_user;
+        auto             next  = [this](red_status_t rs) { transferred(rs); };
+
+        if (client->zero_copy(buf))
+            rs = write ? async->pwrite_iomem(oh, buf.iomem, buf.addr, buf.size, 0, &bytes, user,
+                                             next)
+                       : async->pread_iomem(oh, buf.iomem, buf.addr, buf.size, 0, &bytes, user,
+                                            next);
+        else
+            rs = write ? async->pwrite(oh, buf.addr, buf.size, 0, &bytes, user, next)
+                       : async->pread(oh, buf.addr, buf.size, 0, &bytes, user, next);
+        if (rs != RED_SUCCESS)
+            transferred(rs);
+    }
+
+    void transferred(red_status_t rs)
+    {
+        result = rs;
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to %s data: %s", write ? "write" : "read", red_strerror(rs));
+        }
+
+        rs = client->async_client->close(oh, client->api_user,
+                                         [this](red_status_t) { finish(result); });
+        if (rs != RED_SUCCESS)
+            finish(result);
+    }
+
+    void finish(red_status_t rs)
+    {
+        object_done_t cb    = std::move(done);
+        ssize_t       count = bytes;
+
+        /* Again once written: a reader may have cached the handle while the write ran */
+        if (write && client->cache_cfg.capacity != 0)
+            client->invalidate_cached(bucket.get(), key);
+        delete this;
+        cb(rs, count);
     }
+};
 
-    rs = red_client->pread(oh, buffer, size, 0, bytes_read, api_user);
+red_status_t s3client::start_async(std::weak_ptr<s3bucket> bucket_weak,
+                                   const std::string      &key,
+                                   const red_buffer_t     &buf,
+                                   bool                    write,
+                                   object_done_t           done)
+{
+    auto bucket = bucket_weak.lock();
+    if (!bucket)
+    {
+        COMMON_LOG("ERROR: Invalid bucket handle");
+        return RED_EINVAL;
+    }
+
+    if (write && cache_cfg.capacity != 0)
+        invalidate_cached(bucket.get(), key);
+
+    auto *op   = new async_op_t;
+    op->client = this;
+    op->bucket = std::move(bucket);
+    op->key    = key;
+    op->buf    = buf;
+    op->write  = write;
+    op->done   = std::move(done);
+
+    red_status_t rs = op->open();
     if (rs != RED_SUCCESS)
     {
-        COMMON_LOG("ERROR: Failed to read data: %s", red_strerror(rs));
+        COMMON_LOG("ERROR: Failed to open file %s: %s", key.c_str(), red_strerror(rs));
+        delete op;
     }
-    red_client->close(oh, api_user);
-    red_client->close(root_oh, api_user);
     return rs;
 }
+
+red_status_t s3client::put_object_async(std::weak_ptr<s3bucket> bucket,
+                                        const std::string      &key,
+                                        const red_buffer_t     &data,
+                                        object_done_t           done)
+{
+    return start_async(std::move(bucket), key, data, true, std::move(done));
+}
+
+red_status_t s3client::get_object_async(std::weak_ptr<s3bucket> bucket,
+                                        const std::string      &key,
+                                        const red_buffer_t     &buffer,
+                                        object_done_t           done)
+{
+    return start_async(std::move(bucket), key, buffer, false, std::move(done));
+}
+
+/* Leases from an iomem source such as common::red_iomem_region_source() carry its region */
+red_status_t s3client::put_object(std::weak_ptr<s3bucket>       bucket_weak,
+                                  const std::string            &key,
+                                  const common::buffer_lease_t &data,
+                                  size_t                        size)
+{
+    if (!data || size > data.size())
+    {
+        COMMON_LOG("ERROR: Invalid buffer lease");
+        return RED_EINVAL;
+    }
+    return put_object(bucket_weak, key, red_buffer_t{data.iomem(), data.data(), size});
+}
+
+red_status_t s3client::get_object(std::weak_ptr<s3bucket> bucket_weak,
+                                  const std::string      &key,
+                                  common::buffer_lease_t *buffer,
+                                  ssize_t                *bytes_read)
+{
+    if (!*buffer)
+    {
+        if (buffer_pool == nullptr)
+        {
+            COMMON_LOG("ERROR: No buffer pool set");
+            return RED_EINVAL;
+        }
+
+        red_status_t rs = buffer_pool->acquire(buffer);
+        if (rs != RED_SUCCESS)
+        {
+            COMMON_LOG("ERROR: Failed to lease a buffer: %s", red_strerror(rs));
+            return rs;
+        }
+    }
+    red_buffer_t buf = {buffer->iomem(), buffer->data(), buffer->size()};
+    return get_object(bucket_weak, key, buf, bytes_read);
+}
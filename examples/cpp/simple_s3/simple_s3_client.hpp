@@ -26,15 +26,20 @@
  ******************************************************************************/
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <vector>
 #include <stdexcept>
 
 #include <red/red_client_api.h>
 #include <red/red_ds_api.h>
 #include <red/red_fs_api.h>
+#include <red/red_s3_api.h>
 
+#include "../common/include/buffer_pool.hpp"
 #include "../common/include/sync_api.hpp"
 
 class IRedClient
@@ -73,6 +78,23 @@ public:
                                ssize_t        *bytes_read,
                                red_api_user_t *user) = 0;
 
+    /* Zero-copy transfers from memory in a region of red_iomem_alloc() */
+    virtual red_status_t pwrite_iomem(rfs_open_hndl_t  oh,
+                                      red_iomem_hndl_t iomem,
+                                      void            *addr,
+                                      size_t           count,
+                                      off_t            offset,
+                                      ssize_t         *bytes_written,
+                                      red_api_user_t  *user) = 0;
+
+    virtual red_status_t pread_iomem(rfs_open_hndl_t  oh,
+                                     red_iomem_hndl_t iomem,
+                                     void            *addr,
+                                     size_t           count,
+                                     off_t            offset,
+                                     ssize_t         *bytes_read,
+                                     red_api_user_t  *user) = 0;
+
     virtual red_status_t close(rfs_open_hndl_t oh, red_api_user_t *user) = 0;
 
     virtual red_status_t close_dataset(rfs_dataset_hndl_t ds_hndl,
@@ -128,6 +150,28 @@ public:
         return red::red_pread(oh, buf, count, offset, bytes_read, user);
     }
 
+    red_status_t pwrite_iomem(rfs_open_hndl_t  oh,
+                              red_iomem_hndl_t iomem,
+                              void            *addr,
+                              size_t           count,
+                              off_t            offset,
+                              ssize_t         *bytes_written,
+                              red_api_user_t  *user) override
+    {
+        return red::red_pwrite_iomem(oh, iomem, addr, count, offset, bytes_written, user);
+    }
+
+    red_status_t pread_iomem(rfs_open_hndl_t  oh,
+                             red_iomem_hndl_t iomem,
+                             void            *addr,
+                             size_t           count,
+                             off_t            offset,
+                             ssize_t         *bytes_read,
+                             red_api_user_t  *user) override
+    {
+        return red::red_pread_iomem(oh, iomem, addr, count, offset, bytes_read, user);
+    }
+
     red_status_t close(rfs_open_hndl_t oh, red_api_user_t *user) override
     {
         return red::red_close(oh, user);
@@ -139,6 +183,317 @@ public:
     }
 };
 
+/* Continuation of an asynchronous call, given the operation's status */
+using red_done_t = std::function<void(red_status_t)>;
+
+/* Asynchronous IRedClient: a call that was queued runs @p done once, on completion */
+class IAsyncRedClient
+{
+public:
+    virtual ~IAsyncRedClient() = default;
+
+    virtual red_status_t obtain_dataset(const char         *name,
+                                        const char         *cluster,
+                                        red_ds_props_t     *props,
+                                        rfs_dataset_hndl_t *hndl,
+                                        red_api_user_t     *user,
+                                        red_done_t          done) = 0;
+
+    virtual red_status_t open_root(rfs_dataset_hndl_t ds_hndl,
+                                   rfs_open_hndl_t   *root_oh,
+                                   red_api_user_t    *user,
+                                   red_done_t         done) = 0;
+
+    virtual red_status_t openat(rfs_open_hndl_t  dir_oh,
+                                const char      *path,
+                                int              flags,
+                                mode_t           mode,
+                                rfs_open_hndl_t *oh,
+                                red_api_user_t  *user,
+                                red_done_t       done) = 0;
+
+    virtual red_status_t pwrite(rfs_open_hndl_t oh,
+                                void           *buf,
+                                size_t          count,
+                                off_t           offset,
+                                ssize_t        *bytes_written,
+                                red_api_user_t *user,
+                                red_done_t      done) = 0;
+
+    virtual red_status_t pread(rfs_open_hndl_t oh,
+                               void           *buf,
+                               size_t          count,
+                               off_t           offset,
+                               ssize_t        *bytes_read,
+                               red_api_user_t *user,
+                               red_done_t      done) = 0;
+
+    virtual red_status_t pwrite_iomem(rfs_open_hndl_t  oh,
+                                      red_iomem_hndl_t iomem,
+                                      void            *addr,
+                                      size_t           count,
+                                      off_t            offset,
+                                      ssize_t         *bytes_written,
+                                      red_api_user_t  *user,
+                                      red_done_t       done) = 0;
+
+    virtual red_status_t pread_iomem(rfs_open_hndl_t  oh,
+                                     red_iomem_hndl_t iomem,
+                                     void            *addr,
+                                     size_t           count,
+                                     off_t            offset,
+                                     ssize_t         *bytes_read,
+                                     red_api_user_t  *user,
+                                     red_done_t       done) = 0;
+
+    /* Gathered write of @p iovcnt buffers, laid out from @p offset */
+    virtual red_status_t pwritev2(rfs_open_hndl_t   oh,
+                                  struct red_iovec *iov,
+                                  int               iovcnt,
+                                  off_t             offset,
+                                  int               flags,
+                                  ssize_t          *bytes_written,
+                                  red_api_user_t   *user,
+                                  red_done_t        done) = 0;
+
+    virtual red_status_t close(rfs_open_hndl_t oh, red_api_user_t *user, red_done_t done) = 0;
+
+    virtual red_status_t close_dataset(rfs_dataset_hndl_t ds_hndl,
+                                       red_api_user_t    *user,
+                                       red_done_t         done) = 0;
+
+    /* Multipart uploads */
+    virtual red_status_t create_mpart_upload(rfs_open_hndl_t  root_oh,
+                                             const char      *key,
+                                             int              flags,
+                                             char            *upload_id,
+                                             size_t           upload_id_nob,
+                                             rfs_open_hndl_t *created_oh,
+                                             red_api_user_t  *user,
+                                             red_done_t       done) = 0;
+
+    virtual red_status_t upload_part(rfs_open_hndl_t  root_oh,
+                                     const char      *key,
+                                     const char      *upload_id,
+                                     uint32_t         part_num,
+                                     int              flags,
+                                     rfs_open_hndl_t *part_oh,
+                                     red_api_user_t  *user,
+                                     red_done_t       done) = 0;
+
+    virtual red_status_t close_part(rfs_open_hndl_t       part_oh,
+                                    red_data_integrity_t *integrity,
+                                    red_api_user_t       *user,
+                                    red_done_t            done) = 0;
+
+    virtual red_status_t comp_mpart_upload(rfs_open_hndl_t     root_oh,
+                                           const char         *key,
+                                           const char         *upload_id,
+                                           uint32_t            num_parts,
+                                           uint32_t            upload_parts,
+                                           red_part_info_v2_t *parts,
+                                           bool                final_parts,
+                                           uint32_t            flags,
+                                           red_mp_info_t      *info,
+                                           red_api_user_t     *user,
+                                           red_done_t          done) = 0;
+
+    virtual red_status_t abort_mpart(rfs_open_hndl_t root_oh,
+                                     const char     *key,
+                                     const char     *upload_id,
+                                     red_api_user_t *user,
+                                     red_done_t      done) = 0;
+
+    /* Reads of S3 objects by part */
+    virtual red_status_t s3_open(rfs_open_hndl_t  root_oh,
+                                 const char      *key,
+                                 uint64_t         version,
+                                 int              flags,
+                                 rfs_open_hndl_t *oh,
+                                 uint64_t        *out_version,
+                                 red_api_user_t  *user,
+                                 red_done_t       done) = 0;
+
+    virtual red_status_t get_part_size_v2(rfs_open_hndl_t oh,
+                                          uint32_t        part_num,
+                                          size_t         *part_size,
+                                          uint64_t       *part_offset,
+                                          char           *part_etag,
+                                          red_api_user_t *user,
+                                          red_done_t      done) = 0;
+
+    virtual red_status_t pread_part(rfs_open_hndl_t        oh,
+                                    red_iomem_hndl_t       iomem,
+                                    void                  *addr,
+                                    uint32_t               part_num,
+                                    off_t                  offset,
+                                    size_t                 size,
+                                    ssize_t               *byte_cnt,
+                                    red_part_xattr_info_t *xattr_info,
+                                    red_api_user_t        *user,
+                                    red_done_t             done) = 0;
+
+    /* Extended attributes, such as the ETag stored under RED_S3_ETAG_KEY */
+    virtual red_status_t fgetxattr(rfs_open_hndl_t oh,
+                                   const char     *name,
+                                   void           *value,
+                                   size_t          size,
+                                   size_t         *ret_size,
+                                   red_api_user_t *user,
+                                   red_done_t      done) = 0;
+};
+
+class AsyncRedClientImpl : public IAsyncRedClient
+{
+public:
+    red_status_t obtain_dataset(const char         *name,
+                                const char         *cluster,
+                                red_ds_props_t     *props,
+                                rfs_dataset_hndl_t *hndl,
+                                red_api_user_t     *user,
+                                red_done_t          done) override;
+
+    red_status_t open_root(rfs_dataset_hndl_t ds_hndl,
+                           rfs_open_hndl_t   *root_oh,
+                           red_api_user_t    *user,
+                           red_done_t         done) override;
+
+    red_status_t openat(rfs_open_hndl_t  dir_oh,
+                        const char      *path,
+                        int              flags,
+                        mode_t           mode,
+                        rfs_open_hndl_t *oh,
+                        red_api_user_t  *user,
+                        red_done_t       done) override;
+
+    red_status_t pwrite(rfs_open_hndl_t oh,
+                        void           *buf,
+                        size_t          count,
+                        off_t           offset,
+                        ssize_t        *bytes_written,
+                        red_api_user_t *user,
+                        red_done_t      done) override;
+
+    red_status_t pread(rfs_open_hndl_t oh,
+                       void           *buf,
+                       size_t          count,
+                       off_t           offset,
+                       ssize_t        *bytes_read,
+                       red_api_user_t *user,
+                       red_done_t      done) override;
+
+    red_status_t pwrite_iomem(rfs_open_hndl_t  oh,
+                              red_iomem_hndl_t iomem,
+                              void            *addr,
+                              size_t           count,
+                              off_t            offset,
+                              ssize_t         *bytes_written,
+                              red_api_user_t  *user,
+                              red_done_t       done) override;
+
+    red_status_t pread_iomem(rfs_open_hndl_t  oh,
+                             red_iomem_hndl_t iomem,
+                             void            *addr,
+                             size_t           count,
+                             off_t            offset,
+                             ssize_t         *bytes_read,
+                             red_api_user_t  *user,
+                             red_done_t       done) override;
+
+    red_status_t pwritev2(rfs_open_hndl_t   oh,
+                          struct red_iovec *iov,
+                          int               iovcnt,
+                          off_t             offset,
+                          int               flags,
+                          ssize_t          *bytes_written,
+                          red_api_user_t   *user,
+                          red_done_t        done) override;
+
+    red_status_t close(rfs_open_hndl_t oh, red_api_user_t *user, red_done_t done) override;
+
+    red_status_t close_dataset(rfs_dataset_hndl_t ds_hndl,
+                               red_api_user_t    *user,
+                               red_done_t         done) override;
+
+    red_status_t create_mpart_upload(rfs_open_hndl_t  root_oh,
+                                     const char      *key,
+                                     int              flags,
+                                     char            *upload_id,
+                                     size_t           upload_id_nob,
+                                     rfs_open_hndl_t *created_oh,
+                                     red_api_user_t  *user,
+                                     red_done_t       done) override;
+
+    red_status_t upload_part(rfs_open_hndl_t  root_oh,
+                             const char      *key,
+                             const char      *upload_id,
+                             uint32_t         part_num,
+                             int              flags,
+                             rfs_open_hndl_t *part_oh,
+                             red_api_user_t  *user,
+                             red_done_t       done) override;
+
+    red_status_t close_part(rfs_open_hndl_t       part_oh,
+                            red_data_integrity_t *integrity,
+                            red_api_user_t       *user,
+                            red_done_t            done) override;
+
+    red_status_t comp_mpart_upload(rfs_open_hndl_t     root_oh,
+                                   const char         *key,
+                                   const char         *upload_id,
+                                   uint32_t            num_parts,
+                                   uint32_t            upload_parts,
+                                   red_part_info_v2_t *parts,
+                                   bool                final_parts,
+                                   uint32_t            flags,
+                                   red_mp_info_t      *info,
+                                   red_api_user_t     *user,
+                                   red_done_t          done) override;
+
+    red_status_t abort_mpart(rfs_open_hndl_t root_oh,
+                             const char     *key,
+                             const char     *upload_id,
+                             red_api_user_t *user,
+                             red_done_t      done) override;
+
+    red_status_t s3_open(rfs_open_hndl_t  root_oh,
+                         const char      *key,
+                         uint64_t         version,
+                         int              flags,
+                         rfs_open_hndl_t *oh,
+                         uint64_t        *out_version,
+                         red_api_user_t  *user,
+                         red_done_t       done) override;
+
+    red_status_t get_part_size_v2(rfs_open_hndl_t oh,
+                                  uint32_t        part_num,
+                                  size_t         *part_size,
+                                  uint64_t       *part_offset,
+                                  char           *part_etag,
+                                  red_api_user_t *user,
+                                  red_done_t      done) override;
+
+    red_status_t pread_part(rfs_open_hndl_t        oh,
+                            red_iomem_hndl_t       iomem,
+                            void                  *addr,
+                            uint32_t               part_num,
+                            off_t                  offset,
+                            size_t                 size,
+                            ssize_t               *byte_cnt,
+                            red_part_xattr_info_t *xattr_info,
+                            red_api_user_t        *user,
+                            red_done_t             done) override;
+
+    red_status_t fgetxattr(rfs_open_hndl_t oh,
+                           const char     *name,
+                           void           *value,
+                           size_t          size,
+                           size_t         *ret_size,
+                           red_api_user_t *user,
+                           red_done_t      done) override;
+};
+
+/* A bucket, whose root handle is opened on first use and kept until it is destroyed */
 class s3bucket
 {
 private:
@@ -146,6 +501,8 @@ private:
     std::string        bucket_name;
     red_api_user_t    *api_user;
     IRedClient        *red_client;
+    std::mutex         root_lock;
+    rfs_open_hndl_t    root_oh = {0};
 
 public:
     s3bucket(const std::string &bucket_name,
@@ -162,19 +519,247 @@ public:
     {
         return bucket_name;
     }
+
+    /* The cached root handle, opening it if needed */
+    red_status_t root(rfs_open_hndl_t *oh);
+
+    /* Forget a root handle that came back stale, unless another thread replaced it */
+    void invalidate_root(rfs_open_hndl_t stale);
+};
+
+struct handle_cache_config_t
+{
+    size_t   capacity = 0;             /* Open object handles per thread, 0 for no cache */
+    uint64_t ttl_ns   = 1000000000ull; /* Age at which a cached handle is reopened, 0 for none */
 };
 
+struct handle_cache_stats_t
+{
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t evictions;   /* Least recently used handles closed to make room */
+    uint64_t expired;     /* Handles reopened after ttl_ns */
+    uint64_t invalidated; /* Handles closed because the object was written */
+};
+
+struct multipart_config_t
+{
+    size_t   part_size   = 8 << 20; /* Bytes per part, the last one may be shorter */
+    unsigned concurrency = 8;       /* Parts in flight */
+    unsigned retries     = 1;       /* Times a failed part is uploaded again */
+    bool     checksums   = true;    /* Send each part's CRC-32C to red_close_part() */
+};
+
+struct ranged_get_config_t
+{
+    size_t   range_size  = 8 << 20; /* Bytes per read when not reading by part */
+    unsigned concurrency = 8;       /* Reads in flight */
+    bool     by_part     = true;    /* Read multipart objects part by part */
+    bool     verify      = true;    /* Check each part against its CRC-32C, CRC-32 or MD5 ETag */
+};
+
+/* One read of get_object_parallel(): a part, or a byte range */
+struct ranged_read_t
+{
+    uint32_t part_num;   /* 0 for a byte range */
+    off_t    offset;     /* In the object and in the buffer */
+    size_t   size;       /* Bytes read */
+    uint64_t latency_ns; /* From the first call for it to its data */
+    bool     verified;   /* Its checksum was checked */
+};
+
+struct ranged_get_result_t
+{
+    bool                       by_part; /* Read part by part, otherwise by byte range */
+    uint32_t                   verified;
+    uint32_t                   unverified; /* Parts stored without a checksum or MD5 ETag */
+    std::vector<ranged_read_t> reads;      /* In object order */
+};
+
+struct stream_put_config_t
+{
+    size_t                 chunk_size          = 8 << 20;  /* Per read, and write or part */
+    unsigned               buffers             = 3;        /* Chunks: 2 double, 3 triple */
+    size_t                 memory_limit        = 64 << 20; /* Ceiling on chunk buffers */
+    uint64_t               multipart_threshold = 64 << 20; /* Larger objects go multipart */
+    unsigned               retries             = 1;        /* Retries of a failed part */
+    red_s3_checksum_type_e checksum = RED_S3CS_CRC32C;     /* NONE, CRC32 or CRC32C */
+};
+
+struct stream_put_result_t
+{
+    uint64_t          bytes;
+    uint32_t          parts;    /* 0 for a single object */
+    size_t            memory;   /* Bytes of chunk buffers used */
+    red_s3_checksum_t checksum; /* Of the whole stream */
+    /* Hex MD5 of the data; of a multipart upload, the MD5 of its parts' MD5s and "-<parts>" */
+    char etag[RED_S3_USER_MPART_ETAG_SIZE];
+};
+
+struct stream_get_config_t
+{
+    size_t   window_size = 8 << 20; /* Bytes per read */
+    unsigned windows     = 4;       /* Reads in flight, each into its own window */
+    bool     verify      = true;    /* Check the data against the object's ETag */
+};
+
+struct stream_get_result_t
+{
+    uint64_t bytes;
+    size_t   memory;        /* Bytes of windows used */
+    uint64_t first_byte_ns; /* From the call to the first data handed to the sink */
+    bool     verified;      /* The data matched the ETag; false if not checked */
+    char     etag[RED_S3_USER_MPART_ETAG_SIZE]; /* The object's, empty if it has none */
+};
+
+struct readahead_config_t
+{
+    size_t initial_window = 128 << 10; /* First read-ahead, at least twice the read starting it */
+    size_t max_window     = 8 << 20;   /* Cap of the doubling; 0 turns read-ahead off */
+};
+
+struct readahead_stats_t
+{
+    uint64_t reads;
+    uint64_t hits;       /* Reads served from data read ahead, arrived or in flight */
+    uint64_t random;     /* Reads that were not sequential, which dropped the window */
+    uint64_t prefetched; /* Bytes read ahead */
+    uint64_t wasted;     /* Bytes read ahead and dropped unread */
+    size_t   window;     /* Size of the latest read-ahead */
+
+    double hit_rate() const
+    {
+        return reads != 0 ? static_cast<double>(hits) / reads : 0.0;
+    }
+};
+
+/* Reads of one open object with sequential read-ahead, on the thread that opened it */
+class s3reader
+{
+public:
+    ~s3reader();
+
+    s3reader(const s3reader &)            = delete;
+    s3reader &operator=(const s3reader &) = delete;
+
+    /* Up to @p size bytes at @p offset; short only at the end of the object */
+    red_status_t read(void *buf, size_t size, off_t offset, ssize_t *bytes_read);
+
+    const readahead_stats_t &stats() const;
+
+private:
+    friend class s3client;
+    struct state_t;
+
+    explicit s3reader(std::unique_ptr<state_t> state);
+
+    std::unique_ptr<state_t> state;
+};
+
+struct write_behind_config_t
+{
+    size_t   buffer_size   = 256 << 10; /* Bytes per gathering buffer, rounded up to a page */
+    size_t   flush_size    = 4 << 20;   /* Gathered bytes that start a flush */
+    unsigned max_in_flight = 4;         /* Flushes in flight; the next one waits for a slot */
+    uint64_t flush_ns      = 10000000;  /* Age of gathered data that starts a flush, 0 for none */
+};
+
+struct write_behind_stats_t
+{
+    uint64_t writes;
+    uint64_t bytes;
+    uint64_t flushes; /* red_pwritev2() calls */
+    uint64_t by_size; /* Flushes for reaching flush_size */
+    uint64_t by_age;  /* Flushes for the age of the data */
+    uint64_t stalls;  /* Flushes that waited for a slot, or for an overlapping one to land */
+};
+
+/* Write-behind of the small writes of one open object, on the thread that opened it */
+class s3writer
+{
+public:
+    /* Closes the writer if close() was not called, logging what it fails with */
+    ~s3writer();
+
+    s3writer(const s3writer &)            = delete;
+    s3writer &operator=(const s3writer &) = delete;
+
+    red_status_t write(const void *data, size_t size, off_t offset);
+
+    /* Take the flushes completed and flush data older than cfg.flush_ns, without waiting */
+    red_status_t poll();
+
+    /* Write out what is gathered and wait for every flush */
+    red_status_t flush();
+
+    /* flush(), then close the object */
+    red_status_t close();
+
+    const write_behind_stats_t &stats() const;
+
+private:
+    friend class s3client;
+    struct state_t;
+
+    explicit s3writer(std::unique_ptr<state_t> state);
+
+    std::unique_ptr<state_t> state;
+};
+
+/* Continuation of an asynchronous put or get, given its status and the bytes transferred */
+using object_done_t = std::function<void(red_status_t rs, ssize_t bytes)>;
+
+/* Consumer of a streamed get: @p size bytes of the object at @p offset, delivered in order */
+using object_sink_t = std::function<red_status_t(uint64_t offset, const void *data, size_t size)>;
+
 class s3client
 {
 private:
+    struct thread_cache_t;
+    struct thread_caches_t;
+    struct async_op_t;
+    struct mpart_upload_t;
+    struct ranged_get_t;
+    struct stream_put_t;
+    struct stream_get_t;
+
     red_api_user_t                     *api_user;
     std::set<std::shared_ptr<s3bucket>> buckets;
-    std::unique_ptr<IRedClient>         red_client;
+    std::shared_ptr<IRedClient>         red_client; /* Shared with caches it outlives */
+    std::unique_ptr<IAsyncRedClient>    async_client;
+    common::buffer_pool_t              *buffer_pool   = nullptr;
+    size_t                              zero_copy_min = 64 << 10;
+    handle_cache_config_t               cache_cfg;
+    uint64_t                            cache_id;
+    std::vector<thread_cache_t *>       caches;  /* Of every thread, under the registry lock */
+    handle_cache_stats_t                retired; /* Counters of caches whose thread exited */
+
+    red_status_t open_object(const std::shared_ptr<s3bucket> &bucket,
+                             const std::string               &key,
+                             int                              flags,
+                             rfs_open_hndl_t                 *oh);
+    bool         zero_copy(const red_buffer_t &buf) const;
+    static bool  stale_root(red_status_t rs);
+    red_status_t read_object(rfs_open_hndl_t oh, const red_buffer_t &buffer, ssize_t *bytes_read);
+    red_status_t start_async(std::weak_ptr<s3bucket> bucket,
+                             const std::string      &key,
+                             const red_buffer_t     &buf,
+                             bool                    write,
+                             object_done_t           done);
+
+    thread_cache_t *local_cache();
+    red_status_t    open_cached(const std::shared_ptr<s3bucket> &bucket,
+                                const std::string               &key,
+                                rfs_open_hndl_t                 *oh);
+    void            drop_cached(const s3bucket *bucket, const std::string &key);
+    void            invalidate_cached(const s3bucket *bucket, const std::string &key);
+    void            detach(thread_cache_t *cache);
 
 public:
     explicit s3client(
-        red_api_user_t             *user,
-        std::unique_ptr<IRedClient> client = std::make_unique<RedClientImpl>());
+        red_api_user_t                  *user,
+        std::unique_ptr<IRedClient>      client = std::make_unique<RedClientImpl>(),
+        std::unique_ptr<IAsyncRedClient> async  = std::make_unique<AsyncRedClientImpl>());
     ~s3client();
 
     // Prevent copying
@@ -194,4 +779,105 @@ public:
                             void                   *buffer,
                             size_t                  size,
                             ssize_t                *bytes_read);
+
+    /* From or into a red_buffer_t; large enough iomem buffers take the zero-copy calls */
+    red_status_t put_object(std::weak_ptr<s3bucket> bucket,
+                            const std::string      &key,
+                            const red_buffer_t     &data);
+
+    red_status_t get_object(std::weak_ptr<s3bucket> bucket,
+                            const std::string      &key,
+                            const red_buffer_t     &buffer,
+                            ssize_t                *bytes_read);
+
+    /* put_object()/get_object() without blocking; @p done runs once if they were queued */
+    red_status_t put_object_async(std::weak_ptr<s3bucket> bucket,
+                                  const std::string      &key,
+                                  const red_buffer_t     &data,
+                                  object_done_t           done);
+
+    red_status_t get_object_async(std::weak_ptr<s3bucket> bucket,
+                                  const std::string      &key,
+                                  const red_buffer_t     &buffer,
+                                  object_done_t           done);
+
+    /* Write @p data as a multipart upload of parts in parallel; @p info is optional */
+    red_status_t put_object_multipart(std::weak_ptr<s3bucket>   bucket,
+                                      const std::string        &key,
+                                      const red_buffer_t       &data,
+                                      const multipart_config_t &cfg  = {},
+                                      red_mp_info_t            *info = nullptr);
+
+    /* Read @p key into an iomem @p buffer by part or byte range in parallel */
+    red_status_t get_object_parallel(std::weak_ptr<s3bucket>    bucket,
+                                     const std::string         &key,
+                                     const red_buffer_t        &buffer,
+                                     ssize_t                   *bytes_read,
+                                     const ranged_get_config_t &cfg    = {},
+                                     ranged_get_result_t       *result = nullptr);
+
+    /* Write what @p fd holds up to its end, in chunks read while earlier ones are written */
+    red_status_t put_object_from_fd(std::weak_ptr<s3bucket>    bucket,
+                                    const std::string         &key,
+                                    int                        fd,
+                                    const stream_put_config_t &cfg    = {},
+                                    stream_put_result_t       *result = nullptr);
+
+    /* Hand @p key to @p sink in order as it arrives; trust the data once this succeeds */
+    red_status_t get_object_to_sink(std::weak_ptr<s3bucket>    bucket,
+                                    const std::string         &key,
+                                    object_sink_t              sink,
+                                    const stream_get_config_t &cfg    = {},
+                                    stream_get_result_t       *result = nullptr);
+
+    /* get_object_to_sink() into @p fd, from its offset if it is a regular file */
+    red_status_t get_object_to_fd(std::weak_ptr<s3bucket>    bucket,
+                                  const std::string         &key,
+                                  int                        fd,
+                                  const stream_get_config_t &cfg    = {},
+                                  stream_get_result_t       *result = nullptr);
+
+    /* Open @p key for reads with read-ahead; its handle is closed with the reader */
+    red_status_t open_reader(std::weak_ptr<s3bucket>    bucket,
+                             const std::string         &key,
+                             std::unique_ptr<s3reader> *reader,
+                             const readahead_config_t  &cfg = {});
+
+    /* Open @p key, creating it, for write-behind; cached handles are dropped on close */
+    red_status_t open_writer(std::weak_ptr<s3bucket>      bucket,
+                             const std::string           &key,
+                             std::unique_ptr<s3writer>   *writer,
+                             const write_behind_config_t &cfg = {});
+
+    /* Keep the handles get_object() opens in a per-thread LRU; set up before first use */
+    void set_handle_cache(const handle_cache_config_t &cfg)
+    {
+        cache_cfg = cfg;
+    }
+
+    handle_cache_stats_t handle_cache_stats() const;
+
+    /* 64 KiB by default; 0 sends every iomem buffer through the zero-copy calls */
+    void set_zero_copy_threshold(size_t bytes)
+    {
+        zero_copy_min = bytes;
+    }
+
+    /* Pool of the lease overloads below; it must outlive their use */
+    void set_buffer_pool(common::buffer_pool_t *pool)
+    {
+        buffer_pool = pool;
+    }
+
+    /* The first @p size bytes of a lease, zero-copy if it carries an iomem region */
+    red_status_t put_object(std::weak_ptr<s3bucket>       bucket,
+                            const std::string            &key,
+                            const common::buffer_lease_t &data,
+                            size_t                        size);
+
+    /* Up to one buffer of the object, into a lease taken from the pool if empty */
+    red_status_t get_object(std::weak_ptr<s3bucket> bucket,
+                            const std::string      &key,
+                            common::buffer_lease_t *buffer,
+                            ssize_t                *bytes_read);
 };
@@ -0,0 +1,194 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_admission.cpp
+ *   Project:    RED
+ *
+ *   Description: Bursty producer of asynchronous writes with and without
+ *                per-dataset admission control
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <vector>
+
+#include <red/red_client_api.h>
+#include <red/red_fs_api.h>
+
+#include "admission.hpp"
+#include "reactor.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+constexpr size_t IO_SIZE = 4096;
+
+struct run_t;
+
+struct write_t
+{
+    run_t       *run;
+    uint64_t     submitted_ns;
+    ssize_t      ret;
+    rfs_usercb_t ucb;
+};
+
+struct run_t
+{
+    common::admission_controller_t *admission;
+    rfs_dataset_hndl_t              ds;
+    unsigned                        total;
+    unsigned                        completed;
+    unsigned                        in_flight;
+    unsigned                        max_in_flight;
+    std::vector<uint64_t>           latencies;
+    std::atomic<bool>               done;
+};
+
+void write_done(red_status_t rs, void *arg)
+{
+    auto  *w = static_cast<write_t *>(arg);
+    run_t *r = w->run;
+
+    if (rs != RED_SUCCESS)
+    {
+        fprintf(stderr, "pwrite failed: %d\n", rs);
+        exit(EXIT_FAILURE);
+    }
+    r->latencies.push_back(bench::now_ns() - w->submitted_ns);
+    r->in_flight--;
+    if (r->admission != nullptr)
+        r->admission->release(r->ds);
+    if (++r->completed == r->total)
+        r->done.store(true, std::memory_order_release);
+}
+
+void run(const char *label, rfs_dataset_hndl_t ds, rfs_open_hndl_t oh, unsigned writes,
+         unsigned limit)
+{
+    common::admission_controller_t admission({.max_inflight = limit});
+    std::vector<write_t>           ops(writes);
+    std::vector<char>              buf(IO_SIZE, 'x');
+    run_t                          r = {limit != 0 ? &admission : nullptr, ds, writes, 0, 0, 0, {},
+                                        {}};
+
+    r.latencies.reserve(writes);
+    uint64_t start = bench::now_ns();
+    for (unsigned i = 0; i < writes; i++)
+    {
+        if (r.admission != nullptr && admission.acquire_sync(ds) != RED_SUCCESS)
+        {
+            fprintf(stderr, "admission failed\n");
+            exit(EXIT_FAILURE);
+        }
+
+        write_t &w      = ops[i];
+        w.run           = &r;
+        w.submitted_ns  = bench::now_ns();
+        w.ucb.ucb_fun   = write_done;
+        w.ucb.ucb_arg   = &w;
+        r.max_in_flight = std::max(r.max_in_flight, ++r.in_flight);
+        if (::red_pwrite(oh, buf.data(), IO_SIZE, static_cast<off_t>(i % 64) * IO_SIZE,
+                         &w.ret, &w.ucb, nullptr) != 0)
+        {
+            fprintf(stderr, "pwrite submission failed\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    common::reactor_t::local().wait(r.done);
+    uint64_t elapsed = bench::now_ns() - start;
+
+    printf("%-22s %8.0f writes/s  max in flight %6u  p50 %8lu ns  p99 %8lu ns\n", label,
+           writes * 1e9 / static_cast<double>(elapsed), r.max_in_flight,
+           bench::percentile(r.latencies, 50), bench::percentile(r.latencies, 99));
+
+    if (r.admission != nullptr)
+    {
+        common::admission_stats_t stats = admission.stats(ds);
+        printf("%-22s waited %lu of %lu, %lu ns average queue wait, max %lu ns\n", "", stats.waited,
+               stats.admitted, stats.waited != 0 ? stats.wait_ns / stats.waited : 0,
+               stats.max_wait_ns);
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned writes  = 20000;
+    unsigned limit   = 64;
+    uint64_t latency = 20000;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:q:l:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            writes = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'q':
+            limit = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'l':
+            latency = strtoull(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n writes] [-q max_in_flight] [-l latency_ns]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    rfs_dataset_hndl_t ds;
+    rfs_open_hndl_t    root_oh;
+    rfs_open_hndl_t    oh;
+
+    red::red_obtain_dataset("bench", "local", nullptr, &ds, nullptr);
+    red::red_open_root(ds, &root_oh, nullptr);
+    red::red_openat(root_oh, "obj", O_CREAT | O_RDWR, 0644, &oh, nullptr);
+
+    /* One service thread: a burst queues up behind it */
+    fake_red::configure({.op_latency_ns = latency, .serialize = true});
+    printf("burst of %u x 4 KiB red_pwrite, service time %lu ns, one service thread\n", writes,
+           latency);
+
+    run("unbounded", ds, oh, writes, 0);
+    char label[32];
+    snprintf(label, sizeof(label), "admission limit %u", limit);
+    run(label, ds, oh, writes, limit);
+
+    fake_red::configure({});
+    red::red_close(oh, nullptr);
+    red::red_close(root_oh, nullptr);
+    red::red_close_dataset(ds, nullptr);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
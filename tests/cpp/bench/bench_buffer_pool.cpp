@@ -0,0 +1,180 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_buffer_pool.cpp
+ *   Project:    RED
+ *
+ *   Description: red_pwrite throughput from unregistered buffers, buffers
+ *                registered per I/O and buffers leased from
+ *                common::buffer_pool_t
+ *
+ ******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <vector>
+
+#include <red/red_client_api.h>
+#include <red/red_fs_api.h>
+
+#include "buffer_pool.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+enum class mode_e
+{
+    UNREGISTERED,
+    PER_IO,
+    POOLED,
+};
+
+void fill(void *buf, size_t size)
+{
+    memset(buf, 'x', size);
+}
+
+void run(const char *label, mode_e mode, rfs_open_hndl_t oh, unsigned ops, size_t size)
+{
+    common::buffer_pool_t pool({.buffer_size = size, .prealloc = 4});
+    std::vector<char>     heap(size);
+    std::vector<uint64_t> samples(ops);
+    ssize_t               ret;
+
+    if (mode == mode_e::POOLED && pool.init() != RED_SUCCESS)
+    {
+        fprintf(stderr, "pool init failed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    fake_red::stats_t before = fake_red::stats();
+    uint64_t          start  = bench::now_ns();
+
+    for (unsigned i = 0; i < ops; i++)
+    {
+        uint64_t               t   = bench::now_ns();
+        void                  *buf = heap.data();
+        common::buffer_lease_t lease;
+
+        if (mode == mode_e::PER_IO)
+        {
+            red_client_register_buffer(buf, size);
+        }
+        else if (mode == mode_e::POOLED)
+        {
+            if (pool.acquire(&lease) != RED_SUCCESS)
+            {
+                fprintf(stderr, "%s: acquire failed\n", label);
+                exit(EXIT_FAILURE);
+            }
+            buf = lease.data();
+        }
+
+        fill(buf, size);
+        if (red::red_pwrite(oh, buf, size, static_cast<off_t>(i % 16) * size, &ret, nullptr) !=
+            RED_SUCCESS)
+        {
+            fprintf(stderr, "%s: write %u failed\n", label, i);
+            exit(EXIT_FAILURE);
+        }
+
+        if (mode == mode_e::PER_IO)
+            red_client_unregister_buffer(buf);
+        samples[i] = bench::now_ns() - t;
+    }
+
+    uint64_t elapsed = bench::now_ns() - start;
+    uint64_t bounced = fake_red::stats().bounced - before.bounced;
+    printf("%-16s p50 %8lu ns  p99 %8lu ns  %8.1f MiB/s  bounced %lu\n", label,
+           bench::percentile(samples, 50), bench::percentile(samples, 99),
+           static_cast<double>(ops) * size / (1 << 20) * 1e9 / static_cast<double>(elapsed),
+           bounced);
+
+    if (mode == mode_e::POOLED)
+    {
+        common::buffer_pool_stats_t s = pool.stats();
+        printf("%-16s live %lu  allocs %lu  magazine hits %lu  depot hits %lu\n", "", s.live,
+               s.allocs, s.hits, s.depot_hits);
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned ops         = 2000;
+    size_t   size        = 1 << 20;
+    uint64_t register_ns = 50000;
+    double   ns_per_byte = 0.05;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:s:r:b:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            ops = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 's':
+            size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'r':
+            register_ns = strtoull(optarg, nullptr, 0);
+            break;
+        case 'b':
+            ns_per_byte = atof(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n ops] [-s size] [-r register_ns] [-b ns_per_byte]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    rfs_dataset_hndl_t ds;
+    rfs_open_hndl_t    root_oh;
+    rfs_open_hndl_t    oh;
+
+    red::red_obtain_dataset("bench", "local", nullptr, &ds, nullptr);
+    red::red_open_root(ds, &root_oh, nullptr);
+    red::red_openat(root_oh, "obj", O_CREAT | O_RDWR, 0644, &oh, nullptr);
+
+    fake_red::configure({.ns_per_byte = ns_per_byte, .register_ns = register_ns});
+    printf("%u x %zu byte red_pwrite, registration %lu ns, transfer %.3f ns/byte\n", ops, size,
+           register_ns, ns_per_byte);
+
+    run("unregistered", mode_e::UNREGISTERED, oh, ops, size);
+    run("register per io", mode_e::PER_IO, oh, ops, size);
+    run("pooled", mode_e::POOLED, oh, ops, size);
+
+    fake_red::configure({});
+    red::red_close(oh, nullptr);
+    red::red_close(root_oh, nullptr);
+    red::red_close_dataset(ds, nullptr);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,207 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_completion_drain.cpp
+ *   Project:    RED
+ *
+ *   Description: Event loop at high queue depth, one completion per poll()
+ *                wakeup versus batched draining
+ *
+ ******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <poll.h>
+#include <vector>
+
+#include <red/red_client_api.h>
+#include <red/red_fs_api.h>
+
+#include "completion_drain.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+struct loop_t
+{
+    rfs_open_hndl_t oh;
+    uint64_t        work_ns;   /* Application work simulated per completion */
+    unsigned        remaining; /* Operations still to submit */
+    unsigned        inflight;
+    char            buf[4096];
+};
+
+struct op_t
+{
+    loop_t      *loop;
+    rfs_usercb_t ucb;
+    ssize_t      ret;
+};
+
+void submit(op_t *op);
+
+void on_done(red_status_t rs, void *arg)
+{
+    auto *op = static_cast<op_t *>(arg);
+    if (rs != RED_SUCCESS)
+    {
+        fprintf(stderr, "pread failed: %d\n", rs);
+        exit(EXIT_FAILURE);
+    }
+    op->loop->inflight--;
+
+    uint64_t until = bench::now_ns() + op->loop->work_ns;
+    while (bench::now_ns() < until)
+    {
+    }
+    submit(op);
+}
+
+void submit(op_t *op)
+{
+    loop_t *loop = op->loop;
+    if (loop->remaining == 0)
+        return;
+    loop->remaining--;
+    loop->inflight++;
+    if (::red_pread(loop->oh, loop->buf, sizeof(loop->buf), 0, &op->ret, &op->ucb,
+                    nullptr) != 0)
+    {
+        fprintf(stderr, "pread submission failed\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+template <typename F>
+void run(const char     *label,
+         rfs_open_hndl_t oh,
+         uint64_t        work_ns,
+         unsigned        ops,
+         unsigned        depth,
+         F             &&dispatch)
+{
+    loop_t            loop = {oh, work_ns, ops, 0, {}};
+    std::vector<op_t> slots(depth);
+
+    bench::syscall_counts_t before = bench::syscalls();
+    uint64_t                start  = bench::now_ns();
+
+    for (op_t &op : slots)
+    {
+        op.loop        = &loop;
+        op.ucb.ucb_fun = on_done;
+        op.ucb.ucb_arg = &op;
+        submit(&op);
+    }
+
+    struct pollfd pfd = {.fd = red_client_lib_poll_fd(), .events = POLLIN, .revents = 0};
+    while (loop.inflight > 0)
+    {
+        if (poll(&pfd, 1, -1) > 0)
+            dispatch();
+    }
+
+    uint64_t elapsed = bench::now_ns() - start;
+    bench::print_syscalls(label, bench::syscalls() - before, ops);
+    printf("%-28s %8.0f ops/s\n", label, ops * 1e9 / static_cast<double>(elapsed));
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned ops     = 200000;
+    unsigned depth   = 64;
+    uint64_t latency = 20000;
+    uint64_t work    = 1000;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:q:l:w:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            ops = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'q':
+            depth = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'l':
+            latency = strtoull(optarg, nullptr, 0);
+            break;
+        case 'w':
+            work = strtoull(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-n ops] [-q queue_depth] [-l latency_ns] [-w work_ns]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    rfs_dataset_hndl_t ds;
+    rfs_open_hndl_t    root_oh;
+    rfs_open_hndl_t    oh;
+    char               buf[4096];
+    ssize_t            ret;
+
+    memset(buf, 'x', sizeof(buf));
+    red::red_obtain_dataset("bench", "local", nullptr, &ds, nullptr);
+    red::red_open_root(ds, &root_oh, nullptr);
+    red::red_openat(root_oh, "obj", O_CREAT | O_RDWR, 0644, &oh, nullptr);
+    red::red_pwrite(oh, buf, sizeof(buf), 0, &ret, nullptr);
+    fake_red::configure({.op_latency_ns = latency});
+
+    printf("%u x 4 KiB red_pread, queue depth %u, latency=%lu ns, work=%lu ns/op\n", ops,
+           depth, latency, work);
+
+    run("one completion per wakeup", oh, work, ops, depth, [] {
+        rfs_usercomp_t ucp = {};
+        if (red_client_lib_poll(&ucp, 1) == 1 && ucp.ucp_fun)
+            ucp.ucp_fun(ucp.ucp_res, ucp.ucp_arg);
+    });
+
+    common::drain_stats_t stats = {};
+    run("drain_completions()", oh, work, ops, depth,
+        [&] { common::drain_completions(&stats); });
+
+    printf("drained per wakeup: avg %.1f max %lu, red_client_lib_poll() calls %lu\n",
+           stats.wakeups ? static_cast<double>(stats.completions) / stats.wakeups : 0.0,
+           stats.max_per_wakeup, stats.polls);
+    printf("histogram (0, 1, 2-3, 4-7, 8-15, 16-31, 32-63, 64+):");
+    for (uint64_t h : stats.histogram)
+        printf(" %lu", h);
+    printf("\n");
+
+    fake_red::configure({});
+    red::red_close(oh, nullptr);
+    red::red_close(root_oh, nullptr);
+    red::red_close_dataset(ds, nullptr);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_consumable_ring.cpp
+ *   Project:    RED
+ *
+ *   Description: Queue consumer throughput with consumables allocated per
+ *                red_q_get() and with common::consumable_ring_t
+ *
+ ******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+
+#include <red/red_client_api.h>
+#include <red/red_queue_api.h>
+
+#include "consumable_ring.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+volatile uint64_t g_sink;
+
+void handle(const red_q_consumable_t &c)
+{
+    g_sink += c.rqo_msg.rqm_size + static_cast<unsigned char>(c.rqo_msg.rqm_data[0]);
+}
+
+double msgs_per_s(uint64_t msgs, uint64_t start)
+{
+    return static_cast<double>(msgs) * 1e9 / static_cast<double>(bench::now_ns() - start);
+}
+
+void fail(const char *what)
+{
+    fprintf(stderr, "%s failed\n", what);
+    exit(EXIT_FAILURE);
+}
+
+/* The pattern the ring replaces */
+double alloc_per_get(rfs_dataset_hndl_t ds, red_queue_hndl_t q, uint64_t batch, uint64_t msgs)
+{
+    red_q_gtx_t gtx   = {0, 0};
+    uint64_t    got   = 0;
+    uint64_t    start = bench::now_ns();
+
+    while (got < msgs)
+    {
+        red_q_consumable_t *consumables = red_q_alloc_consumables(batch);
+        uint64_t            count;
+        if (consumables == nullptr)
+            fail("red_q_alloc_consumables");
+        if (red::red_q_get(ds, q, 0, gtx, batch, consumables, &count, nullptr) != RED_SUCCESS)
+            fail("red_q_get");
+        for (uint64_t i = 0; i < count; i++)
+            handle(consumables[i]);
+        gtx.rqt_tick += count;
+        got += count;
+        red_q_dealloc_consumables(consumables, batch);
+    }
+    return msgs_per_s(got, start);
+}
+
+double ring(rfs_dataset_hndl_t ds, red_queue_hndl_t q, const common::consumable_ring_config_t &cfg,
+            uint64_t msgs, common::consumable_ring_stats_t *stats)
+{
+    common::consumable_ring_t r(cfg);
+    red_q_gtx_t               gtx   = {0, 0};
+    uint64_t                  got   = 0;
+    uint64_t                  start = bench::now_ns();
+
+    while (got < msgs)
+    {
+        if (r.fetch(ds, q, 0, gtx, nullptr) != RED_SUCCESS)
+            fail("fetch");
+        for (const red_q_consumable_t &c : r)
+            handle(c);
+        gtx.rqt_tick += r.count();
+        got += r.count();
+    }
+    *stats = r.stats();
+    return msgs_per_s(got, start);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    uint64_t msgs     = 200000;
+    size_t   msg_size = 64;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:s:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            msgs = strtoull(optarg, nullptr, 0);
+            break;
+        case 's':
+            msg_size = strtoull(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n messages] [-s msg_size]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    rfs_dataset_hndl_t ds;
+    red_queue_hndl_t   q = {nullptr};
+    red::red_obtain_dataset("bench", "local", nullptr, &ds, nullptr);
+
+    fake_red::configure({.q_msg_size = msg_size});
+    printf("%lu messages of %zu bytes per run, messages/s\n", msgs, msg_size);
+    printf("%6s  %12s %12s\n", "batch", "alloc/get", "ring");
+
+    common::consumable_ring_stats_t s;
+    for (uint64_t batch = 1; batch <= 1024; batch *= 4)
+    {
+        double plain = alloc_per_get(ds, q, batch, msgs);
+        double reuse = ring(ds, q, {.initial = batch, .max = batch}, msgs, &s);
+        printf("%6lu  %12.0f %12.0f\n", batch, plain, reuse);
+    }
+
+    /* Every batch comes back full, so a ring started small doubles up to max */
+    double grown = ring(ds, q, {.initial = 1, .max = 1024}, msgs, &s);
+    printf("ring from 1 to 1024: %.0f messages/s, %lu grows, high water %lu, %lu batches\n",
+           grown, s.grows, s.high_water, s.batches);
+
+    fake_red::configure({});
+    red::red_close_dataset(ds, nullptr);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_coro.cpp
+ *   Project:    RED
+ *
+ *   Description: PUT throughput of the synchronous wrappers versus coroutines
+ *                keeping several PUTs in flight from one thread
+ *
+ ******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <string>
+
+#include <red/red_client_api.h>
+#include <red/red_fs_api.h>
+#include <red/red_s3_api.h>
+
+#include "coro.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+constexpr size_t OBJ_SIZE = 4096;
+
+char obj_data[OBJ_SIZE];
+
+/* The PUT sequence of hello_world: create version, write, publish, close */
+red_status_t put_sync(rfs_open_hndl_t root_oh, const char *key)
+{
+    rfs_open_hndl_t oh;
+    ssize_t         ret;
+    uint64_t        version;
+    red_status_t    rs;
+
+    rs = red::red_s3_create_version(root_oh, key, 0, &oh, nullptr);
+    if (rs != RED_SUCCESS)
+        return rs;
+
+    rs = red::red_pwrite(oh, obj_data, OBJ_SIZE, 0, &ret, nullptr);
+    if (rs == RED_SUCCESS)
+        rs = red::red_s3_publish(oh, &version, nullptr);
+
+    red_status_t cls_rs = red::red_close(oh, nullptr);
+    return rs == RED_SUCCESS ? cls_rs : rs;
+}
+
+common::task<red_status_t> put_coro(rfs_open_hndl_t root_oh, const char *key)
+{
+    rfs_open_hndl_t oh;
+    ssize_t         ret;
+    uint64_t        version;
+    red_status_t    rs;
+
+    rs = co_await common::red_call(::red_s3_create_version, root_oh, key, 0, &oh, nullptr);
+    if (rs != RED_SUCCESS)
+        co_return rs;
+
+    rs = co_await common::red_call(::red_pwrite, oh, obj_data, OBJ_SIZE, 0, &ret, nullptr);
+    if (rs == RED_SUCCESS)
+        rs = co_await common::red_call(::red_s3_publish, oh, &version, nullptr);
+
+    red_status_t cls_rs = co_await common::red_call(::red_close, oh, nullptr);
+    co_return rs == RED_SUCCESS ? cls_rs : rs;
+}
+
+/* One of the concurrent PUT loops, taking object numbers from a shared counter */
+common::task<void> put_worker(rfs_open_hndl_t root_oh, unsigned *next, unsigned count)
+{
+    while (*next < count)
+    {
+        std::string key = "obj-" + std::to_string((*next)++);
+        if (co_await put_coro(root_oh, key.c_str()) != RED_SUCCESS)
+        {
+            fprintf(stderr, "PUT %s failed\n", key.c_str());
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void report(const char *label, unsigned count, uint64_t elapsed)
+{
+    printf("%-28s %8.0f PUT/s\n", label, count * 1e9 / static_cast<double>(elapsed));
+}
+
+void run_sync(rfs_open_hndl_t root_oh, unsigned count)
+{
+    uint64_t start = bench::now_ns();
+    for (unsigned i = 0; i < count; i++)
+    {
+        std::string key = "obj-" + std::to_string(i);
+        if (put_sync(root_oh, key.c_str()) != RED_SUCCESS)
+        {
+            fprintf(stderr, "PUT %s failed\n", key.c_str());
+            exit(EXIT_FAILURE);
+        }
+    }
+    report("sync_api_t", count, bench::now_ns() - start);
+}
+
+void run_coro(rfs_open_hndl_t root_oh, unsigned count, unsigned concurrency)
+{
+    common::scheduler_t &scheduler = common::scheduler_t::local();
+    unsigned             next      = 0;
+    char                 label[64];
+
+    uint64_t start = bench::now_ns();
+    for (unsigned i = 0; i < concurrency; i++)
+        scheduler.spawn(put_worker(root_oh, &next, count));
+    scheduler.run();
+
+    snprintf(label, sizeof(label), "coroutines x %u", concurrency);
+    report(label, count, bench::now_ns() - start);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned count       = 20000;
+    unsigned concurrency = 64;
+    uint64_t latency     = 20000;
+    bool     poller      = false;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:c:l:p")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            count = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'c':
+            concurrency = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'l':
+            latency = strtoull(optarg, nullptr, 0);
+            break;
+        case 'p':
+            poller = true;
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-n objects] [-c concurrency] [-l latency_ns] "
+                    "[-p (poller thread)]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = poller};
+    red_client_lib_init_v3(&opts);
+    fake_red::configure({.op_latency_ns = latency});
+
+    rfs_dataset_hndl_t ds;
+    rfs_open_hndl_t    root_oh;
+
+    memset(obj_data, 'x', sizeof(obj_data));
+    red::red_obtain_dataset("bench", "local", nullptr, &ds, nullptr);
+    red::red_open_root(ds, &root_oh, nullptr);
+
+    printf("%u x 4 KiB PUT (create version, write, publish, close), poller_thread=%s, "
+           "latency=%lu ns\n",
+           count, poller ? "true" : "false", latency);
+
+    run_sync(root_oh, count);
+    run_coro(root_oh, count, 1);
+    run_coro(root_oh, count, concurrency);
+
+    fake_red::configure({});
+    red::red_close(root_oh, nullptr);
+    red::red_close_dataset(ds, nullptr);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
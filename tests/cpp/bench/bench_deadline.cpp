@@ -0,0 +1,183 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_deadline.cpp
+ *   Project:    RED
+ *
+ *   Description: Cost of deadlines on the synchronous wrappers and behavior of
+ *                operations that complete after their waiter gave up
+ *
+ ******************************************************************************/
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <thread>
+#include <vector>
+
+#include <red/red_client_api.h>
+#include <red/red_fs_api.h>
+
+#include "completion_slot.hpp"
+#include "reactor.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+void run_overhead(const char *label, bool with_deadline, rfs_open_hndl_t oh, unsigned ops)
+{
+    char                  buf[4096];
+    ssize_t               ret;
+    std::vector<uint64_t> samples(ops);
+
+    for (unsigned i = 0; i < ops; i++)
+    {
+        common::deadline_t deadline = common::NO_DEADLINE;
+        if (with_deadline)
+            deadline = common::deadline_after(std::chrono::seconds(1));
+
+        uint64_t start = bench::now_ns();
+        if (red::red_pread(oh, buf, sizeof(buf), 0, &ret, nullptr, deadline) != RED_SUCCESS)
+        {
+            fprintf(stderr, "%s: op %u failed\n", label, i);
+            exit(EXIT_FAILURE);
+        }
+        samples[i] = bench::now_ns() - start;
+    }
+
+    printf("%-28s p50 %7lu ns  p99 %7lu ns\n", label, bench::percentile(samples, 50),
+           bench::percentile(samples, 99));
+}
+
+/*
+ * Every openat() times out; the late completions each open a handle that the
+ * wrapper has to close again.
+ */
+void run_timeouts(rfs_open_hndl_t root_oh,
+                  rfs_open_hndl_t oh,
+                  unsigned        ops,
+                  uint64_t        latency_ns,
+                  uint64_t        timeout_ns)
+{
+    common::deadline_stats_t before   = common::deadline_stats();
+    unsigned                 timeouts = 0;
+    uint64_t                 start    = bench::now_ns();
+
+    fake_red::configure({.op_latency_ns = latency_ns});
+    for (unsigned i = 0; i < ops; i++)
+    {
+        char               name[32];
+        rfs_open_hndl_t    new_oh;
+        common::deadline_t deadline = common::deadline_after(std::chrono::nanoseconds(timeout_ns));
+
+        snprintf(name, sizeof(name), "late-%u", i);
+        red_status_t rs = red::red_openat(root_oh, name, O_CREAT | O_RDWR, 0644, &new_oh, nullptr,
+                                          deadline);
+        if (rs == RED_ETIMEDOUT)
+            timeouts++;
+        else if (rs == RED_SUCCESS)
+            red::red_close(new_oh, nullptr);
+    }
+    uint64_t elapsed = bench::now_ns() - start;
+
+    /* Let the late completions, and the closes they issue, arrive */
+    fake_red::configure({});
+    char    buf[16];
+    ssize_t ret;
+    for (int i = 0; i < 100 && common::deadline_stats().late - before.late < timeouts; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(latency_ns));
+        red::red_pread(oh, buf, sizeof(buf), 0, &ret, nullptr);
+    }
+    red::red_pread(oh, buf, sizeof(buf), 0, &ret, nullptr);
+
+    common::deadline_stats_t after = common::deadline_stats();
+    printf("%u x openat, latency=%lu ns, deadline=%lu ns: %lu ns/call\n", ops, latency_ns,
+           timeout_ns, elapsed / ops);
+    printf("  timed out %u, timeouts counted %lu, late completions %lu, late handles closed %lu\n",
+           timeouts, after.timeouts - before.timeouts, after.late - before.late,
+           after.late_closed - before.late_closed);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned ops        = 20000;
+    unsigned late_ops   = 200;
+    uint64_t latency_ns = 1000000;
+    uint64_t timeout_ns = 100000;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:m:l:t:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            ops = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'm':
+            late_ops = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'l':
+            latency_ns = strtoull(optarg, nullptr, 0);
+            break;
+        case 't':
+            timeout_ns = strtoull(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-n ops] [-m timed_out_ops] [-l latency_ns] [-t deadline_ns]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    rfs_dataset_hndl_t ds;
+    rfs_open_hndl_t    root_oh;
+    rfs_open_hndl_t    oh;
+    char               buf[4096];
+    ssize_t            ret;
+
+    memset(buf, 'x', sizeof(buf));
+    red::red_obtain_dataset("bench", "local", nullptr, &ds, nullptr);
+    red::red_open_root(ds, &root_oh, nullptr);
+    red::red_openat(root_oh, "obj", O_CREAT | O_RDWR, 0644, &oh, nullptr);
+    red::red_pwrite(oh, buf, sizeof(buf), 0, &ret, nullptr);
+
+    printf("%u x 4 KiB red_pread, latency=0 ns\n", ops);
+    run_overhead("no deadline", false, oh, ops);
+    run_overhead("deadline", true, oh, ops);
+
+    run_timeouts(root_oh, oh, late_ops, latency_ns, timeout_ns);
+
+    red::red_close(oh, nullptr);
+    red::red_close(root_oh, nullptr);
+    red::red_close_dataset(ds, nullptr);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
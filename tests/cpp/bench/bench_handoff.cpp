@@ -0,0 +1,159 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_handoff.cpp
+ *   Project:    RED
+ *
+ *   Description: Completions handed over from the poller thread through the
+ *                eventfd and through the handoff ring
+ *
+ ******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <sched.h>
+#include <vector>
+
+#include <red/red_client_api.h>
+#include <red/red_fs_api.h>
+
+#include "reactor.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+/*
+ * Stand-in for processing the previous result. It yields so that on a
+ * single-CPU machine the poller thread still gets to deliver the completion
+ * in the meantime, as it would on a core of its own.
+ */
+void work(uint64_t ns)
+{
+    uint64_t end = bench::now_ns() + ns;
+    while (bench::now_ns() < end)
+        sched_yield();
+}
+
+void run(const char *label, bool handoff, rfs_open_hndl_t oh, unsigned ops, uint64_t work_ns)
+{
+    char                  buf[4096];
+    ssize_t               ret;
+    std::vector<uint64_t> samples(ops);
+
+    common::set_wait_policy({.mode = common::wait_mode_e::BLOCK, .handoff = handoff});
+
+    /* The first handoff elects the poller thread as the ring's producer */
+    for (unsigned i = 0; i < 100; i++)
+        red::red_pread(oh, buf, sizeof(buf), 0, &ret, nullptr);
+
+    bench::syscall_counts_t before = bench::syscalls();
+    uint64_t                start  = bench::now_ns();
+
+    for (unsigned i = 0; i < ops; i++)
+    {
+        common::sync_api_t sync;
+        uint64_t           t  = bench::now_ns();
+        int                rc = ::red_pread(oh, buf, sizeof(buf), 0, &ret, sync.get_ucb(), nullptr);
+
+        /* The next read is in flight while the previous result is processed */
+        if (work_ns != 0)
+            work(work_ns);
+        if (sync.wait(rc) != RED_SUCCESS)
+        {
+            fprintf(stderr, "%s: op %u failed\n", label, i);
+            exit(EXIT_FAILURE);
+        }
+        samples[i] = bench::now_ns() - t;
+    }
+
+    uint64_t elapsed = bench::now_ns() - start;
+    bench::print_syscalls(label, bench::syscalls() - before, ops);
+    printf("%-28s p50 %7lu ns  p99 %7lu ns  %8.0f ops/s\n", label,
+           bench::percentile(samples, 50), bench::percentile(samples, 99),
+           ops * 1e9 / static_cast<double>(elapsed));
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned ops     = 10000;
+    uint64_t latency = 5000;
+    uint64_t work_ns = 20000;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:l:w:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            ops = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'l':
+            latency = strtoull(optarg, nullptr, 0);
+            break;
+        case 'w':
+            work_ns = strtoull(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n ops] [-l latency_ns] [-w work_ns]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = true};
+    red_client_lib_init_v3(&opts);
+
+    rfs_dataset_hndl_t ds;
+    rfs_open_hndl_t    root_oh;
+    rfs_open_hndl_t    oh;
+    char               buf[4096];
+    ssize_t            ret;
+
+    memset(buf, 'x', sizeof(buf));
+    red::red_obtain_dataset("bench", "local", nullptr, &ds, nullptr);
+    red::red_open_root(ds, &root_oh, nullptr);
+    red::red_openat(root_oh, "obj", O_CREAT | O_RDWR, 0644, &oh, nullptr);
+    red::red_pwrite(oh, buf, sizeof(buf), 0, &ret, nullptr);
+
+    fake_red::configure({.op_latency_ns = latency});
+    printf("%u x 4 KiB red_pread with the poller thread, latency=%lu ns\n", ops, latency);
+
+    printf("back to back: the waiter is asleep when the completion arrives\n");
+    run("eventfd", false, oh, ops, 0);
+    run("handoff", true, oh, ops, 0);
+
+    printf("pipelined: %lu ns of work on the previous result while the read is in flight\n",
+           work_ns);
+    run("eventfd", false, oh, ops, work_ns);
+    run("handoff", true, oh, ops, work_ns);
+
+    fake_red::configure({});
+    common::set_wait_policy({});
+    red::red_close(oh, nullptr);
+    red::red_close(root_oh, nullptr);
+    red::red_close_dataset(ds, nullptr);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,221 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_iomem_arena.cpp
+ *   Project:    RED
+ *
+ *   Description: I/O memory allocated per request versus leased from
+ *                common::iomem_arena_t
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <red/red_client_api.h>
+
+#include "iomem_arena.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+/* Request sizes from 4 KiB to 1 MiB, not aligned to a size class */
+std::vector<size_t> make_sizes(unsigned count, unsigned seed)
+{
+    std::mt19937                            rng(seed);
+    std::uniform_int_distribution<unsigned> shift(12, 20);
+    std::vector<size_t>                     sizes(count);
+
+    for (size_t &s : sizes)
+    {
+        size_t base = size_t(1) << shift(rng);
+        s           = base + rng() % base;
+        s           = std::min<size_t>(s, 1 << 20);
+    }
+    return sizes;
+}
+
+void touch(void *addr, size_t size)
+{
+    static_cast<volatile char *>(addr)[0]        = 1;
+    static_cast<volatile char *>(addr)[size - 1] = 1;
+}
+
+/* red_iomem_alloc() and red_iomem_free() around every request */
+void per_request(const std::vector<size_t> &sizes, std::vector<uint64_t> *samples)
+{
+    for (size_t i = 0; i < sizes.size(); i++)
+    {
+        uint64_t         t = bench::now_ns();
+        red_iomem_hndl_t iomem;
+
+        if (red::red_iomem_alloc(sizes[i], &iomem, nullptr) != RED_SUCCESS)
+        {
+            fprintf(stderr, "red_iomem_alloc failed\n");
+            exit(EXIT_FAILURE);
+        }
+        touch(red_iomem_to_addr(iomem, 0), sizes[i]);
+        red::red_iomem_free(iomem, nullptr);
+        (*samples)[i] = bench::now_ns() - t;
+    }
+}
+
+/* A few leases held at once, as with requests in flight */
+void leased(common::iomem_arena_t *arena, const std::vector<size_t> &sizes,
+            std::vector<uint64_t> *samples)
+{
+    constexpr unsigned    DEPTH = 8;
+    common::iomem_lease_t held[DEPTH];
+
+    for (size_t i = 0; i < sizes.size(); i++)
+    {
+        uint64_t               t    = bench::now_ns();
+        common::iomem_lease_t &slot = held[i % DEPTH];
+
+        if (arena->acquire(sizes[i], &slot) != RED_SUCCESS)
+        {
+            fprintf(stderr, "acquire failed\n");
+            exit(EXIT_FAILURE);
+        }
+        touch(slot.addr(), slot.size());
+        (*samples)[i] = bench::now_ns() - t;
+    }
+}
+
+void report(const char *label, std::vector<uint64_t> &samples, uint64_t elapsed)
+{
+    printf("%-24s p50 %8lu ns  p99 %8lu ns  %10.0f allocs/s\n", label,
+           bench::percentile(samples, 50), bench::percentile(samples, 99),
+           samples.size() * 1e9 / static_cast<double>(elapsed));
+}
+
+void run_arena(unsigned threads, unsigned ops)
+{
+    common::iomem_arena_t arena({.region_size = 64 << 20, .reserve = 64 << 20});
+    if (arena.init() != RED_SUCCESS)
+    {
+        fprintf(stderr, "arena init failed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    std::vector<std::vector<uint64_t>> samples(threads, std::vector<uint64_t>(ops));
+    std::vector<std::thread>           workers;
+    uint64_t                           start = bench::now_ns();
+
+    for (unsigned t = 0; t < threads; t++)
+    {
+        workers.emplace_back([&, t] { leased(&arena, make_sizes(ops, t + 1), &samples[t]); });
+    }
+    for (std::thread &w : workers)
+        w.join();
+    uint64_t elapsed = bench::now_ns() - start;
+
+    std::vector<uint64_t> all;
+    for (const auto &s : samples)
+        all.insert(all.end(), s.begin(), s.end());
+
+    char label[32];
+    snprintf(label, sizeof(label), "arena, %u thread%s", threads, threads > 1 ? "s" : "");
+    report(label, all, elapsed);
+
+    common::iomem_arena_stats_t s = arena.stats();
+    printf("%-24s hit rate %.3f  regions %lu  reserved %lu MiB  carved %lu MiB\n", "",
+           s.hit_rate(), s.regions, s.reserved >> 20, s.carved >> 20);
+}
+
+/* Fragmentation while a set of leases is held */
+void run_fragmentation(unsigned held_count)
+{
+    common::iomem_arena_t              arena({.region_size = 64 << 20, .reserve = 0});
+    std::vector<size_t>                sizes = make_sizes(held_count, 99);
+    std::vector<common::iomem_lease_t> held(held_count);
+
+    for (unsigned i = 0; i < held_count; i++)
+    {
+        if (arena.acquire(sizes[i], &held[i]) != RED_SUCCESS)
+        {
+            fprintf(stderr, "acquire failed\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    common::iomem_arena_stats_t s = arena.stats();
+    printf("%u leases held: requested %lu MiB  in use %lu MiB  reserved %lu MiB\n", held_count,
+           s.requested >> 20, s.in_use >> 20, s.reserved >> 20);
+    printf("internal fragmentation %.3f  idle share of the mapping %.3f\n",
+           s.internal_fragmentation(), s.idle());
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned ops     = 20000;
+    unsigned threads = 4;
+    uint64_t latency = 20000;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:t:l:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            ops = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 't':
+            threads = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'l':
+            latency = strtoull(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n ops] [-t threads] [-l alloc_latency_ns]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    /* The arena maps its regions before the service time is applied */
+    printf("%u buffers of 4 KiB..1 MiB, red_iomem_alloc round trip %lu ns\n", ops, latency);
+    run_arena(1, ops);
+    run_arena(threads, ops);
+
+    fake_red::configure({.op_latency_ns = latency});
+    unsigned              direct_ops = std::min(ops, 2000u);
+    std::vector<uint64_t> samples(direct_ops);
+    uint64_t              start = bench::now_ns();
+    per_request(make_sizes(direct_ops, 1), &samples);
+    report("red_iomem_alloc/free", samples, bench::now_ns() - start);
+    fake_red::configure({});
+
+    run_fragmentation(1000);
+
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
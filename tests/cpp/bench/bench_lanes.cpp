@@ -0,0 +1,310 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_lanes.cpp
+ *   Project:    RED
+ *
+ *   Description: Small interactive reads next to bulk write streams, submitted
+ *                directly and through the lane scheduler
+ *
+ ******************************************************************************/
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <thread>
+#include <vector>
+
+#include <red/red_client_api.h>
+#include <red/red_fs_api.h>
+
+#include "lane_scheduler.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+constexpr size_t READ_SIZE = 4096;
+
+struct params_t
+{
+    unsigned reads;       /* Interactive reads issued */
+    uint64_t interval_ns; /* Between two interactive reads */
+    unsigned streams;     /* Bulk write streams */
+    unsigned depth;       /* Writes in flight per stream */
+    size_t   bulk_size;   /* Bytes per bulk write */
+    unsigned bulk_limit;  /* Bulk writes in flight through the scheduler */
+};
+
+struct run_t
+{
+    common::lane_scheduler_t *sched; /* nullptr: submit directly */
+    std::atomic<bool>         stop;
+    std::atomic<unsigned>     bulk_in_flight;
+    std::atomic<uint64_t>     bulk_bytes;
+    std::atomic<unsigned>     reads_done;
+};
+
+struct op_t
+{
+    run_t                 *run;
+    common::lane_request_t req;
+    struct red_iovec       iov;
+    rfs_usercb_t           ucb;
+    uint64_t               submitted_ns;
+    uint64_t               latency_ns;
+};
+
+void direct_done(red_status_t rs, void *arg)
+{
+    auto *op = static_cast<op_t *>(arg);
+    op->req.done(&op->req, rs);
+}
+
+void submit(op_t *op)
+{
+    op->submitted_ns = bench::now_ns();
+
+    int rc;
+    if (op->run->sched != nullptr)
+    {
+        rc = op->run->sched->submit(&op->req);
+    }
+    else
+    {
+        /* The same vectored calls, without flags and in arrival order */
+        op->ucb.ucb_fun = direct_done;
+        op->ucb.ucb_arg = op;
+        rc              = op->req.write
+                              ? ::red_pwritev2(op->req.oh, &op->iov, 1, op->req.offset, 0,
+                                               &op->req.bytes, &op->ucb, nullptr)
+                              : ::red_preadv2(op->req.oh, &op->iov, 1, op->req.offset, 0,
+                                              &op->req.bytes, &op->ucb, nullptr);
+    }
+    if (rc != 0)
+    {
+        fprintf(stderr, "submission failed: %d\n", rc);
+        exit(EXIT_FAILURE);
+    }
+}
+
+op_t *op_of(common::lane_request_t *req)
+{
+    return static_cast<op_t *>(req->arg);
+}
+
+void bulk_done(common::lane_request_t *req, red_status_t rs)
+{
+    op_t  *op = op_of(req);
+    run_t *r  = op->run;
+
+    if (rs != RED_SUCCESS)
+    {
+        fprintf(stderr, "bulk write failed: %d\n", rs);
+        exit(EXIT_FAILURE);
+    }
+    r->bulk_bytes.fetch_add(static_cast<uint64_t>(req->bytes), std::memory_order_relaxed);
+    if (r->stop.load(std::memory_order_acquire))
+        r->bulk_in_flight.fetch_sub(1, std::memory_order_release);
+    else
+        submit(op);
+}
+
+void read_done(common::lane_request_t *req, red_status_t rs)
+{
+    op_t *op = op_of(req);
+
+    if (rs != RED_SUCCESS || req->bytes != static_cast<ssize_t>(READ_SIZE))
+    {
+        fprintf(stderr, "read failed: %d\n", rs);
+        exit(EXIT_FAILURE);
+    }
+    op->latency_ns = bench::now_ns() - op->submitted_ns;
+    op->run->reads_done.fetch_add(1, std::memory_order_release);
+}
+
+void init_op(op_t *op, run_t *r, rfs_open_hndl_t oh, void *buf, size_t size, off_t offset,
+             bool write)
+{
+    op->run        = r;
+    op->iov        = {buf, size, 0};
+    op->req        = {};
+    op->req.oh     = oh;
+    op->req.iov    = &op->iov;
+    op->req.iovcnt = 1;
+    op->req.offset = offset;
+    op->req.write  = write;
+    op->req.lane   = write ? common::LANE_BULK : common::LANE_HIGH;
+    op->req.done   = write ? bulk_done : read_done;
+    op->req.arg    = op;
+}
+
+void run(const char *label, const params_t &p, rfs_open_hndl_t read_oh,
+         const std::vector<rfs_open_hndl_t> &bulk_ohs, common::lane_scheduler_t *sched)
+{
+    run_t r;
+    r.sched = sched;
+    r.stop.store(false);
+    r.bulk_in_flight.store(p.streams * p.depth);
+    r.bulk_bytes.store(0);
+    r.reads_done.store(0);
+
+    std::vector<char> bulk_buf(p.bulk_size, 'b');
+    std::vector<char> read_bufs(static_cast<size_t>(p.reads) * READ_SIZE);
+    std::vector<op_t> bulk(p.streams * p.depth);
+    std::vector<op_t> reads(p.reads);
+    uint64_t          hipri = fake_red::stats().hipri;
+
+    uint64_t start = bench::now_ns();
+    for (unsigned s = 0; s < p.streams; s++)
+    {
+        for (unsigned d = 0; d < p.depth; d++)
+        {
+            op_t *op = &bulk[s * p.depth + d];
+            init_op(op, &r, bulk_ohs[s], bulk_buf.data(), p.bulk_size,
+                    static_cast<off_t>(d * p.bulk_size), true);
+            submit(op);
+        }
+    }
+
+    /* Open loop: reads arrive at a fixed rate whatever the bulk streams do */
+    uint64_t next = bench::now_ns();
+    for (unsigned i = 0; i < p.reads; i++)
+    {
+        while (bench::now_ns() < next)
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        next += p.interval_ns;
+
+        op_t *op = &reads[i];
+        init_op(op, &r, read_oh, &read_bufs[i * READ_SIZE], READ_SIZE, 0, false);
+        submit(op);
+    }
+    while (r.reads_done.load(std::memory_order_acquire) != p.reads)
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    uint64_t elapsed = bench::now_ns() - start;
+    uint64_t bytes   = r.bulk_bytes.load();
+
+    r.stop.store(true, std::memory_order_release);
+    while (r.bulk_in_flight.load(std::memory_order_acquire) != 0)
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+
+    std::vector<uint64_t> latencies;
+    for (const op_t &op : reads)
+        latencies.push_back(op.latency_ns);
+    printf("%-10s read p50 %8lu ns  p99 %8lu ns  max %8lu ns  bulk %7.1f MB/s  hipri %lu\n", label,
+           bench::percentile(latencies, 50), bench::percentile(latencies, 99),
+           bench::percentile(latencies, 100), bytes * 1e3 / static_cast<double>(elapsed),
+           fake_red::stats().hipri - hipri);
+
+    if (sched != nullptr)
+    {
+        common::lane_stats_t high       = sched->stats(common::LANE_HIGH);
+        common::lane_stats_t bulk_stats = sched->stats(common::LANE_BULK);
+        printf("%-10s high lane max wait %lu ns; bulk lane max queued %lu\n", "",
+               high.max_wait_ns, bulk_stats.max_queued);
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    params_t p       = {200, 1000000, 2, 16, 1 << 20, 2};
+    uint64_t latency = 5000;
+    double   ns_byte = 0.25;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:i:s:d:b:q:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            p.reads = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'i':
+            p.interval_ns = strtoull(optarg, nullptr, 0);
+            break;
+        case 's':
+            p.streams = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'd':
+            p.depth = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'b':
+            p.bulk_size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'q':
+            p.bulk_limit = static_cast<unsigned>(atoi(optarg));
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-n reads] [-i interval_ns] [-s streams] [-d depth] "
+                    "[-b bulk_size] [-q bulk_in_flight]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = true};
+    red_client_lib_init_v3(&opts);
+
+    rfs_dataset_hndl_t           ds;
+    rfs_open_hndl_t              root_oh;
+    rfs_open_hndl_t              read_oh;
+    std::vector<rfs_open_hndl_t> bulk_ohs(p.streams);
+    std::vector<char>            data(READ_SIZE, 'r');
+    ssize_t                      ret;
+
+    red::red_obtain_dataset("bench", "local", nullptr, &ds, nullptr);
+    red::red_open_root(ds, &root_oh, nullptr);
+    red::red_openat(root_oh, "hot", O_CREAT | O_RDWR, 0644, &read_oh, nullptr);
+    red::red_pwrite(read_oh, data.data(), READ_SIZE, 0, &ret, nullptr);
+    for (unsigned s = 0; s < p.streams; s++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "backup.%u", s);
+        red::red_openat(root_oh, name, O_CREAT | O_RDWR, 0644, &bulk_ohs[s], nullptr);
+    }
+
+    /* One service thread: whatever is submitted first is served first */
+    fake_red::configure({.op_latency_ns = latency, .ns_per_byte = ns_byte, .serialize = true});
+    printf("%u x 4 KiB reads every %lu ns next to %u streams x %u x %zu B writes, "
+           "one service thread\n",
+           p.reads, p.interval_ns, p.streams, p.depth, p.bulk_size);
+
+    run("direct", p, read_oh, bulk_ohs, nullptr);
+
+    common::lane_scheduler_config_t cfg;
+    cfg.lanes[common::LANE_BULK].max_inflight = p.bulk_limit;
+    common::lane_scheduler_t sched(cfg);
+    run("lanes", p, read_oh, bulk_ohs, &sched);
+
+    fake_red::configure({});
+    for (rfs_open_hndl_t oh : bulk_ohs)
+        red::red_close(oh, nullptr);
+    red::red_close(read_oh, nullptr);
+    red::red_close(root_oh, nullptr);
+    red::red_close_dataset(ds, nullptr);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,189 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_numa_slabs.cpp
+ *   Project:    RED
+ *
+ *   Description: Random access and red_pwrite over a buffer pool fed from
+ *                4 KiB pages and from common::hugepage_source_t slabs
+ *
+ ******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <random>
+#include <vector>
+
+#include <red/red_client_api.h>
+#include <red/red_fs_api.h>
+
+#include "buffer_pool.hpp"
+#include "numa_slab.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+volatile uint64_t g_sink;
+
+/* AnonHugePages + Private_Hugetlb of the process, in KiB */
+uint64_t huge_kib()
+{
+    FILE *f = fopen("/proc/self/smaps_rollup", "r");
+    if (f == nullptr)
+        return 0;
+
+    char     line[256];
+    uint64_t total = 0;
+    while (fgets(line, sizeof(line), f) != nullptr)
+    {
+        unsigned long kib;
+        if (sscanf(line, "AnonHugePages: %lu kB", &kib) == 1 ||
+            sscanf(line, "Private_Hugetlb: %lu kB", &kib) == 1)
+            total += kib;
+    }
+    fclose(f);
+    return total;
+}
+
+void run(const char *label, common::buffer_source_t *source, rfs_open_hndl_t oh, unsigned nbufs,
+         size_t size, unsigned touches)
+{
+    common::buffer_pool_t               pool({.buffer_size = size, .source = source});
+    std::vector<common::buffer_lease_t> leases(nbufs);
+    uint64_t                            huge_before = huge_kib();
+
+    for (common::buffer_lease_t &l : leases)
+    {
+        if (pool.acquire(&l) != RED_SUCCESS)
+        {
+            fprintf(stderr, "%s: acquire failed\n", label);
+            exit(EXIT_FAILURE);
+        }
+        memset(l.data(), 'x', size);
+    }
+
+    /* One load per cache line at random across the whole working set */
+    std::mt19937_64 rng(42);
+    uint64_t        sum   = 0;
+    uint64_t        start = bench::now_ns();
+    for (unsigned i = 0; i < touches; i++)
+    {
+        uint64_t r = rng();
+        sum += static_cast<volatile char *>(leases[r % nbufs].data())[(r >> 32) % size];
+    }
+    uint64_t touch_ns = bench::now_ns() - start;
+
+    ssize_t           ret;
+    fake_red::stats_t before = fake_red::stats();
+    start                    = bench::now_ns();
+    for (unsigned i = 0; i < nbufs; i++)
+    {
+        if (red::red_pwrite(oh, leases[i].data(), size, static_cast<off_t>(i) * size, &ret,
+                            nullptr) != RED_SUCCESS)
+        {
+            fprintf(stderr, "%s: write %u failed\n", label, i);
+            exit(EXIT_FAILURE);
+        }
+    }
+    uint64_t write_ns = bench::now_ns() - start;
+    uint64_t bounced  = fake_red::stats().bounced - before.bounced;
+
+    g_sink = sum;
+    printf("%-10s %6.1f ns/access  %8.1f MiB/s pwrite  bounced %lu  huge pages %5lu MiB\n", label,
+           static_cast<double>(touch_ns) / touches,
+           static_cast<double>(nbufs) * size / (1 << 20) * 1e9 / static_cast<double>(write_ns),
+           bounced, (huge_kib() - huge_before) >> 10);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned nbufs       = 128;
+    size_t   size        = 1 << 20;
+    unsigned touches     = 20000000;
+    double   ns_per_byte = 0.05;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:s:t:b:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            nbufs = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 's':
+            size = strtoull(optarg, nullptr, 0);
+            break;
+        case 't':
+            touches = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'b':
+            ns_per_byte = atof(optarg);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n buffers] [-s size] [-t touches] [-b ns_per_byte]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    rfs_dataset_hndl_t ds;
+    rfs_open_hndl_t    root_oh;
+    rfs_open_hndl_t    oh;
+
+    red::red_obtain_dataset("bench", "local", nullptr, &ds, nullptr);
+    red::red_open_root(ds, &root_oh, nullptr);
+    red::red_openat(root_oh, "obj", O_CREAT | O_RDWR, 0644, &oh, nullptr);
+
+    /* Size the object up front so that neither run pays for growing it */
+    char    last = 0;
+    ssize_t ret;
+    red::red_pwrite(oh, &last, 1, static_cast<off_t>(nbufs) * size - 1, &ret, nullptr);
+
+    fake_red::configure({.ns_per_byte = ns_per_byte});
+    printf("%u x %zu byte buffers, %u random loads, transfer %.3f ns/byte, cpu0 on node %d\n",
+           nbufs, size, touches, ns_per_byte, common::cpu_to_node(0));
+
+    run("4k pages", &common::registered_buffer_source(), oh, nbufs, size, touches);
+    {
+        common::hugepage_source_t source({.node = common::cpu_to_node(0),
+                                          .slab_size = 32 * common::HUGE_PAGE_2M});
+        run("slabs", &source, oh, nbufs, size, touches);
+
+        common::hugepage_source_stats_t s = source.stats();
+        printf("%-10s slabs %lu (%lu MiB)  hugetlb %lu  thp %lu  unbound %lu\n", "", s.slabs,
+               s.mapped >> 20, s.hugetlb, s.thp, s.unbound);
+    }
+
+    fake_red::configure({});
+    red::red_close(oh, nullptr);
+    red::red_close(root_oh, nullptr);
+    red::red_close_dataset(ds, nullptr);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
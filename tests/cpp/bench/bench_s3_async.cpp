@@ -0,0 +1,157 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_s3_async.cpp
+ *   Project:    RED
+ *
+ *   Description: Small-object PUT throughput at several queue depths through
+ *                s3client's asynchronous calls
+ *
+ ******************************************************************************/
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <string>
+#include <vector>
+
+#include <red/red_client_api.h>
+
+#include "simple_s3_client.hpp"
+#include "reactor.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+void fail(const char *what, unsigned i)
+{
+    fprintf(stderr, "%s %u failed\n", what, i);
+    exit(EXIT_FAILURE);
+}
+
+void report(const char *label, unsigned ops, uint64_t elapsed_ns, std::vector<uint64_t> &samples)
+{
+    printf("%-16s %9.0f puts/s  p50 %8lu ns  p99 %8lu ns\n", label,
+           ops * 1e9 / static_cast<double>(elapsed_ns), bench::percentile(samples, 50),
+           bench::percentile(samples, 99));
+}
+
+/* -n puts with up to @p depth in flight, completions dispatched by this thread's reactor */
+void run_async(s3client &client, std::weak_ptr<s3bucket> bucket, unsigned ops, unsigned depth,
+               std::vector<char> &buf)
+{
+    std::vector<uint64_t> lat(ops);
+    unsigned              submitted = 0;
+    unsigned              completed = 0;
+    std::atomic<bool>     progress{false};
+    uint64_t              start = bench::now_ns();
+
+    while (completed < ops)
+    {
+        progress.store(false, std::memory_order_relaxed);
+        while (submitted < ops && submitted - completed < depth)
+        {
+            unsigned     i = submitted++;
+            std::string  key = "obj" + std::to_string(i % 1024);
+            uint64_t     t   = bench::now_ns();
+            red_status_t rs  = client.put_object_async(
+                bucket, key, red_buffer_t{{nullptr}, buf.data(), buf.size()},
+                [&lat, &completed, &progress, i, t](red_status_t s, ssize_t) {
+                    if (s != RED_SUCCESS)
+                        fail("put", i);
+                    lat[i] = bench::now_ns() - t;
+                    completed++;
+                    progress.store(true, std::memory_order_release);
+                });
+            if (rs != RED_SUCCESS)
+                fail("submit", i);
+        }
+        common::reactor_t::local().wait(progress);
+    }
+
+    char label[32];
+    snprintf(label, sizeof(label), "async, QD %u", depth);
+    report(label, ops, bench::now_ns() - start, lat);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned ops        = 10000;
+    size_t   size       = 4096;
+    uint64_t latency_ns = 20000;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:s:l:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            ops = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 's':
+            size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'l':
+            latency_ns = strtoull(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n ops] [-s size] [-l op_latency_ns]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 256,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    std::vector<char> buf(size, 'a');
+    {
+        s3client client(nullptr);
+        auto     bucket = client.create_bucket("local", "bench");
+        if (client.put_object(bucket, "obj0", buf.data(), size) != RED_SUCCESS)
+            fail("put", 0);
+
+        fake_red::configure({.op_latency_ns = latency_ns});
+        printf("%u x %zu byte puts, %lu ns per library operation\n", ops, size, latency_ns);
+
+        std::vector<uint64_t> lat(ops);
+        uint64_t              start = bench::now_ns();
+        for (unsigned i = 0; i < ops; i++)
+        {
+            std::string key = "obj" + std::to_string(i % 1024);
+            uint64_t    t   = bench::now_ns();
+            if (client.put_object(bucket, key, buf.data(), size) != RED_SUCCESS)
+                fail("put", i);
+            lat[i] = bench::now_ns() - t;
+        }
+        report("put_object", ops, bench::now_ns() - start, lat);
+
+        for (unsigned depth : {1u, 16u, 128u})
+            run_async(client, bucket, ops, depth, buf);
+
+        fake_red::configure({});
+    }
+
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,141 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_s3_handle_cache.cpp
+ *   Project:    RED
+ *
+ *   Description: Hot-key GET latency with and without s3client's object
+ *                handle cache
+ *
+ ******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <string>
+#include <vector>
+
+#include <red/red_client_api.h>
+
+#include "simple_s3_client.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+void fail(const char *what, unsigned i)
+{
+    fprintf(stderr, "%s %u failed\n", what, i);
+    exit(EXIT_FAILURE);
+}
+
+/* -n GETs over the first -k keys, p50/p99 of each */
+void run(s3client &client, std::weak_ptr<s3bucket> bucket, unsigned ops, unsigned keys,
+         std::vector<char> &buf, const char *label)
+{
+    std::vector<uint64_t> get(ops);
+    for (unsigned i = 0; i < ops; i++)
+    {
+        std::string key = "obj" + std::to_string(i % keys);
+        ssize_t     n;
+        uint64_t    t = bench::now_ns();
+        if (client.get_object(bucket, key, buf.data(), buf.size(), &n) != RED_SUCCESS)
+            fail("get", i);
+        get[i] = bench::now_ns() - t;
+    }
+    handle_cache_stats_t s = client.handle_cache_stats();
+    printf("%-22s p50 %8lu ns  p99 %8lu ns  hits %lu  misses %lu  evictions %lu\n", label,
+           bench::percentile(get, 50), bench::percentile(get, 99), s.hits, s.misses,
+           s.evictions);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned ops        = 5000;
+    unsigned keys       = 16;
+    size_t   size       = 4096;
+    size_t   capacity   = 64;
+    uint64_t latency_ns = 20000;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:k:s:c:l:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            ops = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'k':
+            keys = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 's':
+            size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'c':
+            capacity = strtoull(optarg, nullptr, 0);
+            break;
+        case 'l':
+            latency_ns = strtoull(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-n ops] [-k keys] [-s size] [-c capacity] [-l op_latency_ns]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (keys == 0)
+        keys = 1;
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    std::vector<char> buf(size, 'h');
+    {
+        s3client client(nullptr);
+        auto     bucket = client.create_bucket("local", "bench");
+        for (unsigned k = 0; k < keys; k++)
+        {
+            if (client.put_object(bucket, "obj" + std::to_string(k), buf.data(), size) !=
+                RED_SUCCESS)
+                fail("put", k);
+        }
+
+        fake_red::configure({.op_latency_ns = latency_ns});
+        printf("%u GETs over %u x %zu byte objects, %lu ns per library operation\n", ops, keys,
+               size, latency_ns);
+        run(client, bucket, ops, keys, buf, "GET, open per request");
+        fake_red::configure({});
+    }
+    {
+        s3client client(nullptr);
+        client.set_handle_cache({capacity, 0});
+        auto bucket = client.create_bucket("local", "bench");
+
+        fake_red::configure({.op_latency_ns = latency_ns});
+        run(client, bucket, ops, keys, buf, "GET, handle cache");
+        fake_red::configure({});
+    }
+
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
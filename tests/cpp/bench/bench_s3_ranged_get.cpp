@@ -0,0 +1,190 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_s3_ranged_get.cpp
+ *   Project:    RED
+ *
+ *   Description: Large-object GET throughput through s3client's parallel
+ *                ranged reads, by part and by byte range
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <vector>
+
+#include <red/red_client_api.h>
+
+#include "simple_s3_client.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+/* Best of RUNS reads */
+constexpr int RUNS = 3;
+
+void fail(const char *what)
+{
+    fprintf(stderr, "%s failed\n", what);
+    exit(EXIT_FAILURE);
+}
+
+void report(const char *label, size_t size, uint64_t elapsed_ns, std::vector<uint64_t> &lat)
+{
+    printf("%-22s %6.2f GB/s  %7.1f ms", label, size / static_cast<double>(elapsed_ns),
+           elapsed_ns / 1e6);
+    if (!lat.empty())
+        printf("  read p50 %6.2f ms  p99 %6.2f ms", bench::percentile(lat, 50) / 1e6,
+               bench::percentile(lat, 99) / 1e6);
+    printf("\n");
+}
+
+void run_parallel(s3client                 &client,
+                  std::weak_ptr<s3bucket>   bucket,
+                  const char               *key,
+                  const red_buffer_t       &buf,
+                  size_t                    size,
+                  const ranged_get_config_t &cfg,
+                  const char               *label)
+{
+    std::vector<uint64_t> lat;
+    uint64_t              best = UINT64_MAX;
+
+    for (int r = 0; r < RUNS; r++)
+    {
+        ranged_get_result_t result;
+        ssize_t             bytes = 0;
+        uint64_t            start = bench::now_ns();
+        if (client.get_object_parallel(bucket, key, buf, &bytes, cfg, &result) != RED_SUCCESS ||
+            static_cast<size_t>(bytes) != size)
+            fail(label);
+        uint64_t elapsed = bench::now_ns() - start;
+        if (elapsed < best)
+        {
+            best = elapsed;
+            lat.clear();
+            for (const ranged_read_t &read : result.reads)
+                lat.push_back(read.latency_ns);
+        }
+        if (result.by_part && result.verified != result.reads.size())
+            fail("verify");
+    }
+    report(label, size, best, lat);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t   size        = 256 << 20;
+    size_t   part_size   = 4 << 20;
+    uint64_t latency_ns  = 200000;
+    double   ns_per_byte = 4.0;
+    int      c;
+
+    while ((c = getopt(argc, argv, "s:p:l:b:")) != -1)
+    {
+        switch (c)
+        {
+        case 's':
+            size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'p':
+            part_size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'l':
+            latency_ns = strtoull(optarg, nullptr, 0);
+            break;
+        case 'b':
+            ns_per_byte = atof(optarg);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-s size] [-p part_or_range_size] [-l op_latency_ns] "
+                    "[-b ns_per_byte]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 256,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    red_iomem_hndl_t iomem;
+    if (red::red_iomem_alloc(size, &iomem, nullptr) != RED_SUCCESS)
+        fail("red_iomem_alloc");
+    void        *region = red_iomem_to_addr(iomem, 0);
+    red_buffer_t buf    = {iomem, region, size};
+    memset(region, 'g', size);
+
+    {
+        s3client client(nullptr);
+        auto     bucket = client.create_bucket("local", "bench");
+
+        /* The same data as a multipart object with checksums and as a plain one */
+        if (client.put_object_multipart(bucket, "parts", buf, {part_size, 64}) != RED_SUCCESS)
+            fail("multipart put");
+        if (client.put_object(bucket, "plain", buf) != RED_SUCCESS)
+            fail("put");
+
+        fake_red::configure({.op_latency_ns = latency_ns, .ns_per_byte = ns_per_byte});
+        printf("%zu MiB object, %zu MiB parts and ranges, %lu ns per library operation, "
+               "%.2f ns per byte\n",
+               size >> 20, part_size >> 20, latency_ns, ns_per_byte);
+
+        std::vector<uint64_t> none;
+        uint64_t              best = UINT64_MAX;
+        for (int r = 0; r < RUNS; r++)
+        {
+            ssize_t  bytes = 0;
+            uint64_t start = bench::now_ns();
+            if (client.get_object(bucket, "plain", buf, &bytes) != RED_SUCCESS)
+                fail("get_object");
+            best = std::min(best, bench::now_ns() - start);
+        }
+        report("get_object", size, best, none);
+
+        for (unsigned depth : {1u, 2u, 4u, 8u, 16u, 32u, 64u})
+        {
+            ranged_get_config_t cfg;
+            cfg.range_size  = part_size;
+            cfg.concurrency = depth;
+
+            char label[32];
+            snprintf(label, sizeof(label), "by part, %u in flight", depth);
+            run_parallel(client, bucket, "parts", buf, size, cfg, label);
+
+            snprintf(label, sizeof(label), "by range, %u in flight", depth);
+            run_parallel(client, bucket, "plain", buf, size, cfg, label);
+        }
+
+        fake_red::configure({});
+    }
+
+    red::red_iomem_free(iomem, nullptr);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
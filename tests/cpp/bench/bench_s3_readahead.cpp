@@ -0,0 +1,176 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_s3_readahead.cpp
+ *   Project:    RED
+ *
+ *   Description: Sequential and random small-read throughput of s3reader,
+ *                with and without read-ahead
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <random>
+#include <vector>
+
+#include <red/red_client_api.h>
+
+#include "simple_s3_client.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+/* Best of RUNS passes */
+constexpr int RUNS = 3;
+
+void fail(const char *what)
+{
+    fprintf(stderr, "%s failed\n", what);
+    exit(EXIT_FAILURE);
+}
+
+/* Read the object in @p chunk reads, in order or at @p count random chunk offsets */
+void run(s3client                 &client,
+         std::weak_ptr<s3bucket>   bucket,
+         size_t                    size,
+         size_t                    chunk,
+         bool                      random,
+         const readahead_config_t &cfg,
+         const char               *label)
+{
+    std::vector<char> buf(chunk);
+    std::mt19937_64   rng(42);
+    readahead_stats_t stats = {};
+    uint64_t          best  = UINT64_MAX;
+    uint64_t          bytes = 0;
+    size_t            count = random ? std::min<size_t>(size / chunk, 512) : size / chunk;
+
+    for (int r = 0; r < RUNS; r++)
+    {
+        std::unique_ptr<s3reader> reader;
+        if (client.open_reader(bucket, "obj", &reader, cfg) != RED_SUCCESS)
+            fail("open_reader");
+
+        uint64_t start = bench::now_ns();
+        bytes          = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            off_t   offset = static_cast<off_t>((random ? rng() % (size / chunk) : i) * chunk);
+            ssize_t n      = 0;
+            if (reader->read(buf.data(), chunk, offset, &n) != RED_SUCCESS ||
+                static_cast<size_t>(n) != chunk)
+                fail(label);
+            bytes += n;
+        }
+        uint64_t elapsed = bench::now_ns() - start;
+        if (elapsed < best)
+        {
+            best  = elapsed;
+            stats = reader->stats();
+        }
+    }
+    printf("%-28s %6.2f GB/s  %8.1f us/read  hits %5.1f%%  %6.1f MiB ahead, %6.1f MiB wasted\n",
+           label, bytes / static_cast<double>(best), best / 1e3 / count, 100 * stats.hit_rate(),
+           stats.prefetched / 1048576.0, stats.wasted / 1048576.0);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t   size        = 64 << 20;
+    size_t   max_window  = 8 << 20;
+    uint64_t latency_ns  = 200000;
+    double   ns_per_byte = 1.0;
+    int      c;
+
+    while ((c = getopt(argc, argv, "s:m:l:b:")) != -1)
+    {
+        switch (c)
+        {
+        case 's':
+            size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'm':
+            max_window = strtoull(optarg, nullptr, 0);
+            break;
+        case 'l':
+            latency_ns = strtoull(optarg, nullptr, 0);
+            break;
+        case 'b':
+            ns_per_byte = atof(optarg);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-s size] [-m max_window] [-l op_latency_ns] [-b ns_per_byte]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 256,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    {
+        s3client client(nullptr);
+        auto     bucket = client.create_bucket("local", "bench");
+
+        std::vector<char> data(size, 'a');
+        if (client.put_object(bucket, "obj", data.data(), size) != RED_SUCCESS)
+            fail("put_object");
+
+        fake_red::configure({.op_latency_ns = latency_ns, .ns_per_byte = ns_per_byte});
+        printf("%zu MiB object, read-ahead up to %zu MiB, %lu ns per library operation, "
+               "%.2f ns per byte\n",
+               size >> 20, max_window >> 20, latency_ns, ns_per_byte);
+
+        readahead_config_t off;
+        off.max_window = 0;
+        readahead_config_t on;
+        on.max_window = max_window;
+
+        for (size_t chunk : {size_t(64) << 10, size_t(256) << 10, size_t(1) << 20})
+        {
+            char label[48];
+            snprintf(label, sizeof(label), "sequential %4zu KiB, direct", chunk >> 10);
+            run(client, bucket, size, chunk, false, off, label);
+            snprintf(label, sizeof(label), "sequential %4zu KiB, ahead", chunk >> 10);
+            run(client, bucket, size, chunk, false, on, label);
+        }
+        for (size_t chunk : {size_t(64) << 10, size_t(1) << 20})
+        {
+            char label[48];
+            snprintf(label, sizeof(label), "random %4zu KiB, direct", chunk >> 10);
+            run(client, bucket, size, chunk, true, off, label);
+            snprintf(label, sizeof(label), "random %4zu KiB, ahead", chunk >> 10);
+            run(client, bucket, size, chunk, true, on, label);
+        }
+
+        fake_red::configure({});
+    }
+
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
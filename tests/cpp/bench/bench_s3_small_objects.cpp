@@ -0,0 +1,159 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_s3_small_objects.cpp
+ *   Project:    RED
+ *
+ *   Description: Small-object PUT/GET latency with a root handle opened per
+ *                request and with s3client's cached bucket root
+ *
+ ******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <string>
+#include <vector>
+
+#include <red/red_client_api.h>
+
+#include "simple_s3_client.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+void fail(const char *what, unsigned i)
+{
+    fprintf(stderr, "%s %u failed\n", what, i);
+    exit(EXIT_FAILURE);
+}
+
+void report(const char *label, std::vector<uint64_t> &samples)
+{
+    printf("%-22s p50 %8lu ns  p99 %8lu ns\n", label, bench::percentile(samples, 50),
+           bench::percentile(samples, 99));
+}
+
+/* What s3client did before caching the root: open_root, openat, I/O, close both */
+red_status_t per_request(rfs_dataset_hndl_t ds, const std::string &key, char *buf, size_t size,
+                         bool write)
+{
+    rfs_open_hndl_t root_oh;
+    rfs_open_hndl_t oh;
+    ssize_t         n;
+
+    red_status_t rs = red::red_open_root(ds, &root_oh, nullptr);
+    if (rs != RED_SUCCESS)
+        return rs;
+    rs = red::red_openat(root_oh, key.c_str(), write ? O_CREAT | O_WRONLY : O_RDONLY, 0644, &oh,
+                         nullptr);
+    if (rs == RED_SUCCESS)
+    {
+        rs = write ? red::red_pwrite(oh, buf, size, 0, &n, nullptr)
+                   : red::red_pread(oh, buf, size, 0, &n, nullptr);
+        red::red_close(oh, nullptr);
+    }
+    red::red_close(root_oh, nullptr);
+    return rs;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned ops        = 2000;
+    size_t   size       = 4096;
+    uint64_t latency_ns = 20000;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:s:l:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            ops = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 's':
+            size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'l':
+            latency_ns = strtoull(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n ops] [-s size] [-l op_latency_ns]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    std::vector<char>     buf(size, 's');
+    std::vector<uint64_t> put(ops);
+    std::vector<uint64_t> get(ops);
+    {
+        s3client client(nullptr);
+        auto     bucket = client.create_bucket("local", "bench");
+        auto     ds     = bucket.lock()->handle();
+
+        fake_red::configure({.op_latency_ns = latency_ns});
+        printf("%u x %zu byte objects, %lu ns per library operation\n", ops, size, latency_ns);
+
+        for (unsigned i = 0; i < ops; i++)
+        {
+            std::string key = "obj" + std::to_string(i % 64);
+            uint64_t    t   = bench::now_ns();
+            if (per_request(ds, key, buf.data(), size, true) != RED_SUCCESS)
+                fail("put", i);
+            put[i] = bench::now_ns() - t;
+
+            t = bench::now_ns();
+            if (per_request(ds, key, buf.data(), size, false) != RED_SUCCESS)
+                fail("get", i);
+            get[i] = bench::now_ns() - t;
+        }
+        report("PUT, root per request", put);
+        report("GET, root per request", get);
+
+        for (unsigned i = 0; i < ops; i++)
+        {
+            std::string key = "obj" + std::to_string(i % 64);
+            ssize_t     n;
+            uint64_t    t = bench::now_ns();
+            if (client.put_object(bucket, key, buf.data(), size) != RED_SUCCESS)
+                fail("put", i);
+            put[i] = bench::now_ns() - t;
+
+            t = bench::now_ns();
+            if (client.get_object(bucket, key, buf.data(), size, &n) != RED_SUCCESS)
+                fail("get", i);
+            get[i] = bench::now_ns() - t;
+        }
+        report("PUT, cached root", put);
+        report("GET, cached root", get);
+
+        fake_red::configure({});
+    }
+
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
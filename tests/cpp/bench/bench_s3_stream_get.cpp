@@ -0,0 +1,200 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_s3_stream_get.cpp
+ *   Project:    RED
+ *
+ *   Description: GET throughput, time to first byte and memory of s3client's
+ *                streaming reads into a file descriptor, against reading the
+ *                object whole
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <getopt.h>
+#include <unistd.h>
+#include <vector>
+
+#include <red/red_client_api.h>
+
+#include "simple_s3_client.hpp"
+#include "md5.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+/* Best of RUNS reads */
+constexpr int RUNS = 3;
+
+void fail(const char *what)
+{
+    fprintf(stderr, "%s failed\n", what);
+    exit(EXIT_FAILURE);
+}
+
+void report(const char *label, size_t size, uint64_t elapsed_ns, uint64_t first_ns, size_t memory)
+{
+    printf("%-24s %6.2f GB/s  %7.1f ms  first byte %7.2f ms  %5zu MiB held\n", label,
+           size / static_cast<double>(elapsed_ns), elapsed_ns / 1e6, first_ns / 1e6,
+           memory >> 20);
+}
+
+void run_stream(s3client                  &client,
+                std::weak_ptr<s3bucket>    bucket,
+                int                        fd,
+                size_t                     size,
+                const stream_get_config_t &cfg,
+                const char                *label)
+{
+    stream_get_result_t result;
+    uint64_t            best  = UINT64_MAX;
+    uint64_t            first = 0;
+
+    for (int r = 0; r < RUNS; r++)
+    {
+        uint64_t start = bench::now_ns();
+        if (client.get_object_to_fd(bucket, "obj", fd, cfg, &result) != RED_SUCCESS ||
+            result.bytes != size || result.verified != cfg.verify)
+            fail(label);
+        uint64_t elapsed = bench::now_ns() - start;
+        if (elapsed < best)
+        {
+            best  = elapsed;
+            first = result.first_byte_ns;
+        }
+    }
+    report(label, size, best, first, result.memory);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t   size        = 256 << 20;
+    size_t   window_size = 8 << 20;
+    uint64_t latency_ns  = 200000;
+    double   ns_per_byte = 4.0;
+    int      c;
+
+    while ((c = getopt(argc, argv, "s:w:l:b:")) != -1)
+    {
+        switch (c)
+        {
+        case 's':
+            size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'w':
+            window_size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'l':
+            latency_ns = strtoull(optarg, nullptr, 0);
+            break;
+        case 'b':
+            ns_per_byte = atof(optarg);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-s size] [-w window_size] [-l op_latency_ns] [-b ns_per_byte]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 256,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    /* The data goes nowhere: what is measured is getting it to the descriptor */
+    int fd = open("/dev/null", O_WRONLY);
+    if (fd < 0)
+        fail("open /dev/null");
+
+    {
+        s3client client(nullptr);
+        auto     bucket = client.create_bucket("local", "bench");
+
+        std::vector<char> data(size, 'r');
+        if (client.put_object(bucket, "obj", data.data(), size) != RED_SUCCESS)
+            fail("put_object");
+
+        /* The stand-in derives the ETag on its first read; keep that out of the timings */
+        stream_get_config_t warm;
+        warm.window_size = window_size;
+        run_stream(client, bucket, fd, size, warm, "warm-up");
+
+        fake_red::configure({.op_latency_ns = latency_ns, .ns_per_byte = ns_per_byte});
+        printf("%zu MiB object, %zu MiB windows, %lu ns per library operation, "
+               "%.2f ns per byte\n",
+               size >> 20, window_size >> 20, latency_ns, ns_per_byte);
+
+        /* Today's way: a buffer of the whole object, one get_object(), then the MD5 over it */
+        uint64_t best = UINT64_MAX;
+        uint64_t first = 0;
+        for (int r = 0; r < RUNS; r++)
+        {
+            uint64_t          start = bench::now_ns();
+            std::vector<char> whole(size);
+            ssize_t           bytes = 0;
+            if (client.get_object(bucket, "obj", whole.data(), size, &bytes) != RED_SUCCESS ||
+                static_cast<size_t>(bytes) != size)
+                fail("get_object");
+            uint64_t      got = bench::now_ns() - start;
+            common::md5_t md5;
+            char          etag[RED_S3_USER_ETAG_SIZE];
+            md5.update(whole.data(), size);
+            md5.final_hex(etag);
+            if (write(fd, whole.data(), size) != static_cast<ssize_t>(size))
+                fail("write");
+            uint64_t elapsed = bench::now_ns() - start;
+            if (elapsed < best)
+            {
+                best  = elapsed;
+                first = got;
+            }
+        }
+        report("get whole, hash, write", size, best, first, size);
+
+        for (bool verify : {false, true})
+        {
+            for (unsigned windows : {1u, 2u, 4u, 8u})
+            {
+                stream_get_config_t cfg;
+                cfg.window_size = window_size;
+                cfg.windows     = windows;
+                cfg.verify      = verify;
+
+                char label[32];
+                snprintf(label, sizeof(label), "stream, %u windows%s", windows,
+                         verify ? ", MD5" : "");
+                run_stream(client, bucket, fd, size, cfg, label);
+            }
+        }
+
+        fake_red::configure({});
+    }
+
+    close(fd);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_s3_stream_put.cpp
+ *   Project:    RED
+ *
+ *   Description: PUT throughput and memory of s3client's streaming upload
+ *                from a file descriptor, against reading the file whole
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <unistd.h>
+#include <vector>
+
+#include <red/red_client_api.h>
+
+#include "simple_s3_client.hpp"
+#include "crc32c.hpp"
+#include "md5.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+/* Best of RUNS uploads */
+constexpr int RUNS = 3;
+
+void fail(const char *what)
+{
+    fprintf(stderr, "%s failed\n", what);
+    exit(EXIT_FAILURE);
+}
+
+void report(const char *label, size_t size, uint64_t elapsed_ns, size_t memory)
+{
+    printf("%-30s %6.2f GB/s  %7.1f ms  %5zu MiB held\n", label,
+           size / static_cast<double>(elapsed_ns), elapsed_ns / 1e6, memory >> 20);
+}
+
+void run_stream(s3client                  &client,
+                std::weak_ptr<s3bucket>    bucket,
+                int                        fd,
+                size_t                     size,
+                const stream_put_config_t &cfg,
+                const char                *label)
+{
+    stream_put_result_t result;
+    uint64_t            best = UINT64_MAX;
+
+    for (int r = 0; r < RUNS; r++)
+    {
+        lseek(fd, 0, SEEK_SET);
+        uint64_t start = bench::now_ns();
+        if (client.put_object_from_fd(bucket, "obj", fd, cfg, &result) != RED_SUCCESS ||
+            result.bytes != size)
+            fail(label);
+        best = std::min(best, bench::now_ns() - start);
+    }
+    report(label, size, best, result.memory);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t   size        = 256 << 20;
+    size_t   chunk_size  = 8 << 20;
+    uint64_t latency_ns  = 200000;
+    double   ns_per_byte = 4.0;
+    int      c;
+
+    while ((c = getopt(argc, argv, "s:c:l:b:")) != -1)
+    {
+        switch (c)
+        {
+        case 's':
+            size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'c':
+            chunk_size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'l':
+            latency_ns = strtoull(optarg, nullptr, 0);
+            break;
+        case 'b':
+            ns_per_byte = atof(optarg);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-s size] [-c chunk_size] [-l op_latency_ns] [-b ns_per_byte]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 256,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    /* The source file, unlinked at once; reads of it come from the page cache */
+    char path[] = "/tmp/bench_s3_stream_put_XXXXXX";
+    int  fd     = mkstemp(path);
+    if (fd < 0)
+        fail("mkstemp");
+    unlink(path);
+    {
+        std::vector<char> data(size, 's');
+        if (write(fd, data.data(), size) != static_cast<ssize_t>(size))
+            fail("write");
+    }
+
+    {
+        s3client client(nullptr);
+        auto     bucket = client.create_bucket("local", "bench");
+
+        /* Warm the allocator up with the stand-in's part buffers, as bench_s3_multipart does */
+        stream_put_config_t warm;
+        warm.chunk_size          = chunk_size;
+        warm.multipart_threshold = 0;
+        for (int r = 0; r < 4; r++)
+            run_stream(client, bucket, fd, size, warm, "warm-up");
+
+        fake_red::configure({.op_latency_ns = latency_ns, .ns_per_byte = ns_per_byte});
+        printf("%zu MiB file, %zu MiB chunks, %lu ns per library operation, %.2f ns per byte\n",
+               size >> 20, chunk_size >> 20, latency_ns, ns_per_byte);
+
+        /* Today's way: the whole file in memory, one put_object(), then the hashes over it */
+        uint64_t best = UINT64_MAX;
+        uint32_t crc  = 0;
+        for (int r = 0; r < RUNS; r++)
+        {
+            uint64_t          start = bench::now_ns();
+            std::vector<char> whole(size);
+            if (pread(fd, whole.data(), size, 0) != static_cast<ssize_t>(size))
+                fail("pread");
+            if (client.put_object(bucket, "obj", whole.data(), size) != RED_SUCCESS)
+                fail("put_object");
+            common::md5_t md5;
+            char          etag[RED_S3_USER_ETAG_SIZE];
+            md5.update(whole.data(), size);
+            md5.final_hex(etag);
+            crc ^= common::crc32c(0, whole.data(), size);
+            best = std::min(best, bench::now_ns() - start);
+        }
+        report("read whole, put, hash", size, best, size);
+
+        for (bool multipart : {false, true})
+        {
+            for (unsigned buffers : {1u, 2u, 3u, 8u})
+            {
+                stream_put_config_t cfg;
+                cfg.chunk_size          = chunk_size;
+                cfg.buffers             = buffers;
+                cfg.memory_limit        = buffers * chunk_size;
+                cfg.multipart_threshold = multipart ? 0 : UINT64_MAX;
+
+                char label[48];
+                snprintf(label, sizeof(label), "%s, %u buffers",
+                         multipart ? "stream multipart" : "stream one object", buffers);
+                run_stream(client, bucket, fd, size, cfg, label);
+            }
+        }
+
+        fake_red::configure({});
+    }
+
+    close(fd);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,169 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_s3_write_behind.cpp
+ *   Project:    RED
+ *
+ *   Description: Throughput of a stream of small appends through s3writer,
+ *                written one by one and coalesced
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <vector>
+
+#include <red/red_client_api.h>
+
+#include "simple_s3_client.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+/* Best of RUNS streams */
+constexpr int RUNS = 3;
+
+void fail(const char *what)
+{
+    fprintf(stderr, "%s failed\n", what);
+    exit(EXIT_FAILURE);
+}
+
+/* Append @p size bytes in @p append byte writes and close */
+void run(s3client                    &client,
+         std::weak_ptr<s3bucket>      bucket,
+         size_t                       size,
+         size_t                       append,
+         const write_behind_config_t &cfg,
+         const char                  *label)
+{
+    std::vector<char>    buf(append, 'w');
+    write_behind_stats_t stats = {};
+    uint64_t             best  = UINT64_MAX;
+
+    for (int r = 0; r < RUNS; r++)
+    {
+        std::unique_ptr<s3writer> writer;
+        if (client.open_writer(bucket, "obj", &writer, cfg) != RED_SUCCESS)
+            fail("open_writer");
+
+        uint64_t start = bench::now_ns();
+        for (size_t offset = 0; offset < size; offset += append)
+        {
+            if (writer->write(buf.data(), append, static_cast<off_t>(offset)) != RED_SUCCESS)
+                fail(label);
+        }
+        if (writer->close() != RED_SUCCESS)
+            fail(label);
+        uint64_t elapsed = bench::now_ns() - start;
+        if (elapsed < best)
+        {
+            best  = elapsed;
+            stats = writer->stats();
+        }
+    }
+    printf("%-30s %6.2f GB/s  %7.2f us/write  %6lu flushes  %6lu stalls\n", label,
+           size / static_cast<double>(best), best / 1e3 / (size / append), stats.flushes,
+           stats.stalls);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t   size        = 16 << 20;
+    size_t   append      = 4 << 10;
+    uint64_t latency_ns  = 200000;
+    double   ns_per_byte = 1.0;
+    int      c;
+
+    while ((c = getopt(argc, argv, "s:a:l:b:")) != -1)
+    {
+        switch (c)
+        {
+        case 's':
+            size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'a':
+            append = strtoull(optarg, nullptr, 0);
+            break;
+        case 'l':
+            latency_ns = strtoull(optarg, nullptr, 0);
+            break;
+        case 'b':
+            ns_per_byte = atof(optarg);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-s size] [-a append_size] [-l op_latency_ns] [-b ns_per_byte]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (append == 0 || size < append)
+        fail("size check");
+    size -= size % append;
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 256,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    {
+        s3client client(nullptr);
+        auto     bucket = client.create_bucket("local", "bench");
+
+        fake_red::configure({.op_latency_ns = latency_ns, .ns_per_byte = ns_per_byte});
+        printf("%zu MiB in %zu KiB appends, %lu ns per library operation, %.2f ns per byte\n",
+               size >> 20, append >> 10, latency_ns, ns_per_byte);
+
+        /* Every append its own write, waited for before the next one */
+        write_behind_config_t direct;
+        direct.flush_size    = 1;
+        direct.max_in_flight = 1;
+        run(client, bucket, size, append, direct, "one write per append");
+
+        /* Every append its own write, several in flight */
+        direct.max_in_flight = 4;
+        run(client, bucket, size, append, direct, "one write per append, 4 ahead");
+
+        for (size_t flush_size : {size_t(256) << 10, size_t(1) << 20, size_t(4) << 20})
+        {
+            for (unsigned in_flight : {1u, 4u})
+            {
+                write_behind_config_t cfg;
+                cfg.flush_size    = flush_size;
+                cfg.max_in_flight = in_flight;
+
+                char label[48];
+                snprintf(label, sizeof(label), "coalesced %4zu KiB, %u in flight",
+                         flush_size >> 10, in_flight);
+                run(client, bucket, size, append, cfg, label);
+            }
+        }
+
+        fake_red::configure({});
+    }
+
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
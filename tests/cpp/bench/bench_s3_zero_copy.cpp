@@ -0,0 +1,160 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_s3_zero_copy.cpp
+ *   Project:    RED
+ *
+ *   Description: s3client PUT/GET throughput from plain memory and from an
+ *                iomem region through the zero-copy calls
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <vector>
+
+#include <red/red_client_api.h>
+
+#include "simple_s3_client.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+double mib_per_s(uint64_t bytes, uint64_t ns)
+{
+    return static_cast<double>(bytes) / (1 << 20) * 1e9 / static_cast<double>(ns);
+}
+
+/* PUT then GET the same object ops times; returns the MiB/s of each */
+void transfer(s3client &client, std::weak_ptr<s3bucket> bucket, const red_buffer_t &buf,
+              unsigned ops, double *put_rate, double *get_rate)
+{
+    ssize_t  got;
+    uint64_t start = bench::now_ns();
+    for (unsigned i = 0; i < ops; i++)
+    {
+        if (client.put_object(bucket, "obj", buf) != RED_SUCCESS)
+        {
+            fprintf(stderr, "put of %zu bytes failed\n", buf.size);
+            exit(EXIT_FAILURE);
+        }
+    }
+    *put_rate = mib_per_s(static_cast<uint64_t>(ops) * buf.size, bench::now_ns() - start);
+
+    start = bench::now_ns();
+    for (unsigned i = 0; i < ops; i++)
+    {
+        if (client.get_object(bucket, "obj", buf, &got) != RED_SUCCESS ||
+            got != static_cast<ssize_t>(buf.size))
+        {
+            fprintf(stderr, "get of %zu bytes failed\n", buf.size);
+            exit(EXIT_FAILURE);
+        }
+    }
+    *get_rate = mib_per_s(static_cast<uint64_t>(ops) * buf.size, bench::now_ns() - start);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t   min_size    = 64 << 10;
+    size_t   max_size    = 64 << 20;
+    uint64_t budget      = 512ull << 20;
+    double   ns_per_byte = 0.05;
+    int      c;
+
+    while ((c = getopt(argc, argv, "m:M:B:b:")) != -1)
+    {
+        switch (c)
+        {
+        case 'm':
+            min_size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'M':
+            max_size = strtoull(optarg, nullptr, 0);
+            break;
+        case 'B':
+            budget = strtoull(optarg, nullptr, 0);
+            break;
+        case 'b':
+            ns_per_byte = atof(optarg);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-m min_size] [-M max_size] [-B bytes_per_size] "
+                    "[-b ns_per_byte]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    red_iomem_hndl_t iomem;
+    if (red::red_iomem_alloc(max_size, &iomem, nullptr) != RED_SUCCESS)
+    {
+        fprintf(stderr, "red_iomem_alloc of %zu bytes failed\n", max_size);
+        return EXIT_FAILURE;
+    }
+    void             *region = red_iomem_to_addr(iomem, 0);
+    std::vector<char> heap(max_size);
+    memset(region, 'z', max_size);
+    memset(heap.data(), 'c', max_size);
+
+    {
+        s3client client(nullptr);
+        auto     bucket = client.create_bucket("local", "bench");
+
+        fake_red::configure({.ns_per_byte = ns_per_byte});
+        printf("s3client PUT/GET, transfer %.3f ns/byte, %lu MiB per size and path\n",
+               ns_per_byte, budget >> 20);
+        printf("%10s  %15s %15s  %15s %15s  %s\n", "size", "copy PUT", "zero-copy PUT",
+               "copy GET", "zero-copy GET", "bounced");
+
+        for (size_t size = min_size; size <= max_size; size *= 4)
+        {
+            unsigned ops = static_cast<unsigned>(std::max<uint64_t>(2, budget / size));
+            double   copy_put, copy_get, zc_put, zc_get;
+
+            fake_red::stats_t before = fake_red::stats();
+            transfer(client, bucket, {{nullptr}, heap.data(), size}, ops, &copy_put, &copy_get);
+            uint64_t bounced = fake_red::stats().bounced - before.bounced;
+
+            before = fake_red::stats();
+            transfer(client, bucket, {iomem, region, size}, ops, &zc_put, &zc_get);
+            bounced += fake_red::stats().bounced - before.bounced;
+
+            printf("%7zu KiB  %9.0f MiB/s %9.0f MiB/s  %9.0f MiB/s %9.0f MiB/s  %lu\n",
+                   size >> 10, copy_put, zc_put, copy_get, zc_get, bounced);
+        }
+        fake_red::configure({});
+    }
+
+    red::red_iomem_free(iomem, nullptr);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,172 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_sg_list.cpp
+ *   Project:    RED
+ *
+ *   Description: Cost of building a red_sg_list_t with new[] and with
+ *                common::sg_list_t
+ *
+ ******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+#include <vector>
+
+#include <red/red_client_api.h>
+
+#include "sg_list.hpp"
+#include "bench_utils.hpp"
+
+namespace
+{
+
+volatile uint64_t g_sink;
+
+/* Stands in for red_kv_put(): reads the list it is given */
+__attribute__((noinline)) void consume(const red_sg_list_t *list)
+{
+    g_sink += list->val_size + list->num_elems;
+}
+
+double ns_per_list(uint64_t start, unsigned iters)
+{
+    return static_cast<double>(bench::now_ns() - start) / iters;
+}
+
+/* The ad-hoc way: an element array allocated for every call */
+double build_new(const std::vector<red_buffer_t> &bufs, unsigned n, unsigned iters)
+{
+    uint64_t start = bench::now_ns();
+    for (unsigned it = 0; it < iters; it++)
+    {
+        auto  *elems = new red_sg_elem_t[n];
+        size_t bytes = 0;
+        for (unsigned i = 0; i < n; i++)
+        {
+            elems[i] = {bufs[i].iomem, bufs[i].addr, 0, bufs[i].size};
+            bytes += bufs[i].size;
+        }
+        red_sg_list_t list = {bytes, n, elems};
+        consume(&list);
+        delete[] elems;
+    }
+    return ns_per_list(start, iters);
+}
+
+double build_sg_list(const std::vector<red_buffer_t> &bufs, unsigned n, unsigned iters)
+{
+    uint64_t start = bench::now_ns();
+    for (unsigned it = 0; it < iters; it++)
+    {
+        common::sg_list_t sg;
+        for (unsigned i = 0; i < n; i++)
+            sg.append(bufs[i]);
+        consume(sg.list());
+    }
+    return ns_per_list(start, iters);
+}
+
+/* The element count known up front, as new[] has it */
+double build_reserved(const std::vector<red_buffer_t> &bufs, unsigned n, unsigned iters)
+{
+    uint64_t start = bench::now_ns();
+    for (unsigned it = 0; it < iters; it++)
+    {
+        common::sg_list_t sg;
+        sg.reserve(n);
+        for (unsigned i = 0; i < n; i++)
+            sg.append(bufs[i]);
+        consume(sg.list());
+    }
+    return ns_per_list(start, iters);
+}
+
+/* All the buffers appended in one call */
+double build_array(const std::vector<red_buffer_t> &bufs, unsigned n, unsigned iters)
+{
+    uint64_t start = bench::now_ns();
+    for (unsigned it = 0; it < iters; it++)
+    {
+        common::sg_list_t sg;
+        sg.append(bufs.data(), n);
+        consume(sg.list());
+    }
+    return ns_per_list(start, iters);
+}
+
+/* n consecutive ranges of one buffer, merged into a single element */
+double build_merged(const red_buffer_t &whole, unsigned n, unsigned iters)
+{
+    size_t   piece = whole.size / n;
+    uint64_t start = bench::now_ns();
+    for (unsigned it = 0; it < iters; it++)
+    {
+        common::sg_list_t sg;
+        for (unsigned i = 0; i < n; i++)
+            sg.append(whole, static_cast<off_t>(i * piece), piece);
+        consume(sg.list());
+    }
+    return ns_per_list(start, iters);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned iters = 1000000;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            iters = static_cast<unsigned>(atoi(optarg));
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n lists_per_size]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    /* Separate 4 KiB buffers, so that nothing merges */
+    const unsigned    max_elems = 256;
+    std::vector<char> memory(max_elems * 8192);
+    std::vector<red_buffer_t> bufs;
+    for (unsigned i = 0; i < max_elems; i++)
+        bufs.push_back({{nullptr}, memory.data() + i * 8192, 4096});
+    red_buffer_t whole = {{nullptr}, memory.data(), memory.size()};
+
+    printf("%u lists per size, ns per list\n", iters);
+    printf("%8s  %10s %10s %10s %10s %10s  %s\n", "elements", "new[]", "sg_list_t", "reserved",
+           "array", "merged", "mallocs");
+
+    for (unsigned n : {1u, 4u, 8u, 16u, 64u, 256u})
+    {
+        common::sg_arena_stats_t before   = common::sg_arena_stats();
+        double                   plain    = build_new(bufs, n, iters);
+        double                   sg       = build_sg_list(bufs, n, iters);
+        double                   reserved = build_reserved(bufs, n, iters);
+        double                   array    = build_array(bufs, n, iters);
+        double                   merged   = build_merged(whole, n, iters);
+        uint64_t mallocs = common::sg_arena_stats().mallocs - before.mallocs;
+
+        printf("%8u  %10.1f %10.1f %10.1f %10.1f %10.1f  %lu\n", n, plain, sg, reserved, array,
+               merged, mallocs);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,195 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_sync_reactor.cpp
+ *   Project:    RED
+ *
+ *   Description: Per-op syscall count and latency of the synchronous wrappers,
+ *                per-call eventfd waiter versus the per-thread reactor
+ *
+ ******************************************************************************/
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <poll.h>
+
+#include <red/red_client_api.h>
+#include <red/red_fs_api.h>
+
+#include "eventfd.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+/*
+ * The waiter sync_api_t used before the reactor: one eventfd per call and a
+ * pollfd set rebuilt on every wait.
+ */
+class legacy_sync_t
+{
+public:
+    legacy_sync_t()
+    : rs(RED_SUCCESS)
+    {
+        ucb.ucb_fun = callback;
+        ucb.ucb_arg = this;
+    }
+
+    rfs_usercb_t *get_ucb()
+    {
+        return &ucb;
+    }
+
+    red_status_t wait(int rc)
+    {
+        if (rc != 0)
+            return (red_status_t)rc;
+
+        struct pollfd pfds[2] = {
+            {.fd = eventfd.get_fd(), .events = POLLIN, .revents = 0},
+            {.fd = red_client_lib_poll_fd(), .events = POLLIN, .revents = 0}};
+
+        while (true)
+        {
+            rc = poll(pfds, 2, -1);
+            if (rc < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                return RED_EINVAL;
+            }
+            if (pfds[0].revents & POLLIN)
+            {
+                if (!eventfd.read())
+                    continue;
+                break;
+            }
+            if (pfds[1].revents & POLLIN)
+            {
+                rfs_usercomp_t ucp = {};
+                if (red_client_lib_poll(&ucp, 1) == 1 && ucp.ucp_fun)
+                    ucp.ucp_fun(ucp.ucp_res, ucp.ucp_arg);
+            }
+        }
+        return rs;
+    }
+
+private:
+    static void callback(red_status_t status, void *arg)
+    {
+        auto *me = static_cast<legacy_sync_t *>(arg);
+        me->rs   = status;
+        me->eventfd.kick();
+    }
+
+    red_status_t      rs;
+    rfs_usercb_t      ucb;
+    common::eventfd_t eventfd;
+};
+
+red_status_t legacy_pread(rfs_open_hndl_t oh, void *buf, size_t size, ssize_t *ret)
+{
+    legacy_sync_t sync;
+    int           rc = ::red_pread(oh, buf, size, 0, ret, sync.get_ucb(), nullptr);
+    return sync.wait(rc);
+}
+
+template <typename F>
+void run(const char *label, unsigned ops, F &&op)
+{
+    bench::syscall_counts_t before = bench::syscalls();
+    uint64_t                start  = bench::now_ns();
+    for (unsigned i = 0; i < ops; i++)
+    {
+        if (op() != RED_SUCCESS)
+        {
+            fprintf(stderr, "%s: op %u failed\n", label, i);
+            exit(EXIT_FAILURE);
+        }
+    }
+    uint64_t elapsed = bench::now_ns() - start;
+
+    bench::print_syscalls(label, bench::syscalls() - before, ops);
+    printf("%-28s %8.0f ns/op\n", label, static_cast<double>(elapsed) / ops);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned ops     = 100000;
+    bool     poller  = false;
+    uint64_t latency = 0;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:l:p")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            ops = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'l':
+            latency = strtoull(optarg, nullptr, 0);
+            break;
+        case 'p':
+            poller = true;
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n ops] [-l latency_ns] [-p (poller thread)]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = poller};
+    red_client_lib_init_v3(&opts);
+    fake_red::configure({.op_latency_ns = latency});
+
+    rfs_dataset_hndl_t ds;
+    rfs_open_hndl_t    root_oh;
+    rfs_open_hndl_t    oh;
+    char               buf[4096];
+    ssize_t            ret;
+
+    memset(buf, 'x', sizeof(buf));
+    red::red_obtain_dataset("bench", "local", nullptr, &ds, nullptr);
+    red::red_open_root(ds, &root_oh, nullptr);
+    red::red_openat(root_oh, "obj", O_CREAT | O_RDWR, 0644, &oh, nullptr);
+    red::red_pwrite(oh, buf, sizeof(buf), 0, &ret, nullptr);
+
+    printf("%u x 4 KiB red_pread, poller_thread=%s, latency=%lu ns\n", ops,
+           poller ? "true" : "false", latency);
+
+    run("per-call eventfd", ops, [&] { return legacy_pread(oh, buf, sizeof(buf), &ret); });
+    run("per-thread reactor", ops,
+        [&] { return red::red_pread(oh, buf, sizeof(buf), 0, &ret, nullptr); });
+
+    red::red_close(oh, nullptr);
+    red::red_close(root_oh, nullptr);
+    red::red_close_dataset(ds, nullptr);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
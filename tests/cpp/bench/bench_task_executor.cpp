@@ -0,0 +1,350 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_task_executor.cpp
+ *   Project:    RED
+ *
+ *   Description: Chained requests driven from the poller thread versus the
+ *                task thread executor
+ *
+ ******************************************************************************/
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <thread>
+#include <vector>
+
+#include <red/red_client_api.h>
+#include <red/red_fs_api.h>
+
+#include "reactor.hpp"
+#include "sync_api.hpp"
+#include "task_executor.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+constexpr size_t IO_SIZE = 4096;
+
+struct context_t;
+
+/*
+ * A request is a chain of dependent reads: each read is issued from the
+ * completion of the previous one, as a continuation would be.
+ */
+struct request_t : common::work_item_t
+{
+    context_t      *ctx;
+    unsigned        worker;
+    unsigned        step;
+    ssize_t         ret;
+    rfs_usercb_t    ucb;
+    rfs_open_hndl_t oh;
+    char            buf[IO_SIZE];
+};
+
+struct context_t
+{
+    common::reactor_t       *client; /* Reactor of the thread driving the requests */
+    common::task_executor_t *executor;
+    unsigned                 chain;
+    unsigned                 total;
+    unsigned                 started;
+    unsigned                 completed;
+    std::atomic<bool>        done;
+};
+
+void issue(request_t *req, void (*cb)(red_status_t, void *))
+{
+    req->ucb.ucb_fun = cb;
+    req->ucb.ucb_arg = req;
+    if (::red_pread(req->oh, req->buf, IO_SIZE, 0, &req->ret, &req->ucb, nullptr) != 0)
+    {
+        fprintf(stderr, "pread submission failed\n");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void check(red_status_t rs)
+{
+    if (rs != RED_SUCCESS)
+    {
+        fprintf(stderr, "pread failed: %d\n", rs);
+        exit(EXIT_FAILURE);
+    }
+}
+
+/* Runs on the client thread once a whole request has completed */
+bool next_request(context_t *ctx)
+{
+    if (++ctx->completed == ctx->total)
+        ctx->done.store(true, std::memory_order_release);
+    if (ctx->started == ctx->total)
+        return false;
+    ctx->started++;
+    return true;
+}
+
+/*
+ * Poller thread model: every completion runs on the library's poller thread
+ * and is handed back to the client thread, which owns the handle and issues
+ * the next read.
+ */
+void poller_step(void *arg);
+
+void poller_cb(red_status_t rs, void *arg)
+{
+    check(rs);
+    static_cast<request_t *>(arg)->ctx->client->post(poller_step, arg);
+}
+
+void poller_step(void *arg)
+{
+    auto *req = static_cast<request_t *>(arg);
+    if (++req->step < req->ctx->chain)
+    {
+        issue(req, poller_cb);
+        return;
+    }
+    if (next_request(req->ctx))
+    {
+        req->step = 0;
+        issue(req, poller_cb);
+    }
+}
+
+/*
+ * Task thread model: the client hands a request to a worker, the worker runs
+ * the whole chain from its own completions and hands the request back once.
+ */
+void executor_done(void *arg)
+{
+    auto *req = static_cast<request_t *>(arg);
+    if (next_request(req->ctx))
+    {
+        req->step = 0;
+        req->ctx->executor->post(req->worker, req);
+    }
+}
+
+void executor_cb(red_status_t rs, void *arg)
+{
+    auto *req = static_cast<request_t *>(arg);
+    check(rs);
+    if (++req->step < req->ctx->chain)
+        issue(req, executor_cb);
+    else
+        req->ctx->client->post(executor_done, req);
+}
+
+void executor_start(common::work_item_t *item)
+{
+    issue(static_cast<request_t *>(item), executor_cb);
+}
+
+void report(const char                    *label,
+            const bench::syscall_counts_t &before,
+            uint64_t                       start,
+            unsigned                       ops)
+{
+    uint64_t elapsed = bench::now_ns() - start;
+    bench::print_syscalls(label, bench::syscalls() - before, ops);
+    printf("%-28s %8.0f reads/s\n", label, ops * 1e9 / static_cast<double>(elapsed));
+}
+
+void init(bool poller, unsigned sthreads)
+{
+    struct red_client_lib_init_opts opts = {.num_sthreads     = sthreads,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = poller};
+    red_client_lib_init_v3(&opts);
+}
+
+/* Open the benchmark object on the calling thread */
+rfs_open_hndl_t open_object(rfs_dataset_hndl_t *ds, rfs_open_hndl_t *root_oh)
+{
+    rfs_open_hndl_t oh;
+    char            buf[IO_SIZE];
+    ssize_t         ret;
+
+    memset(buf, 'x', sizeof(buf));
+    red::red_obtain_dataset("bench", "local", nullptr, ds, nullptr);
+    red::red_open_root(*ds, root_oh, nullptr);
+    red::red_openat(*root_oh, "obj", O_CREAT | O_RDWR, 0644, &oh, nullptr);
+    red::red_pwrite(oh, buf, sizeof(buf), 0, &ret, nullptr);
+    return oh;
+}
+
+void close_object(rfs_dataset_hndl_t ds, rfs_open_hndl_t root_oh, rfs_open_hndl_t oh)
+{
+    red::red_close(oh, nullptr);
+    red::red_close(root_oh, nullptr);
+    red::red_close_dataset(ds, nullptr);
+}
+
+void run_poller(unsigned requests, unsigned chain, unsigned depth, uint64_t latency)
+{
+    rfs_dataset_hndl_t ds;
+    rfs_open_hndl_t    root_oh;
+
+    init(true, 1);
+    rfs_open_hndl_t oh = open_object(&ds, &root_oh);
+    fake_red::configure({.op_latency_ns = latency});
+
+    context_t              ctx = {&common::reactor_t::local(), nullptr, chain, requests, 0, 0, {}};
+    std::vector<request_t> reqs(depth);
+
+    bench::syscall_counts_t before = bench::syscalls();
+    uint64_t                start  = bench::now_ns();
+    for (request_t &req : reqs)
+    {
+        if (ctx.started == requests)
+            break;
+        ctx.started++;
+        req.ctx  = &ctx;
+        req.step = 0;
+        req.oh   = oh;
+        issue(&req, poller_cb);
+    }
+    ctx.client->wait(ctx.done);
+    report("poller thread", before, start, requests * chain);
+
+    fake_red::configure({});
+    close_object(ds, root_oh, oh);
+    red_client_lib_fini();
+}
+
+void run_executor(unsigned requests,
+                  unsigned chain,
+                  unsigned depth,
+                  uint64_t latency,
+                  unsigned workers)
+{
+    common::task_executor_t      executor;
+    std::vector<rfs_open_hndl_t> ohs(workers);
+    std::vector<rfs_open_hndl_t> roots(workers);
+    std::vector<rfs_dataset_hndl_t> dss(workers);
+    std::atomic<unsigned>        opened{0};
+
+    init(false, workers);
+    if (executor.start(nullptr) != RED_SUCCESS)
+    {
+        fprintf(stderr, "executor start failed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    /* Handles are affine to the thread that opened them: one per worker */
+    for (unsigned w = 0; w < workers; w++)
+    {
+        executor.submit(w, [&, w] {
+            ohs[w] = open_object(&dss[w], &roots[w]);
+            opened.fetch_add(1, std::memory_order_release);
+        });
+    }
+    while (opened.load(std::memory_order_acquire) < workers)
+        std::this_thread::yield();
+    fake_red::configure({.op_latency_ns = latency});
+
+    common::reactor_t     *reactor = &common::reactor_t::local();
+    context_t              ctx     = {reactor, &executor, chain, requests, 0, 0, {}};
+    std::vector<request_t> reqs(depth);
+
+    bench::syscall_counts_t before = bench::syscalls();
+    uint64_t                start  = bench::now_ns();
+    for (unsigned i = 0; i < depth && ctx.started < requests; i++)
+    {
+        request_t &req = reqs[i];
+        ctx.started++;
+        req.ctx    = &ctx;
+        req.worker = i % workers;
+        req.step   = 0;
+        req.oh     = ohs[req.worker];
+        req.fn     = executor_start;
+        executor.post(req.worker, &req);
+    }
+    ctx.client->wait(ctx.done);
+
+    char label[64];
+    snprintf(label, sizeof(label), "task executor x %u", workers);
+    report(label, before, start, requests * chain);
+
+    fake_red::configure({});
+    opened.store(0);
+    for (unsigned w = 0; w < workers; w++)
+    {
+        executor.submit(w, [&, w] {
+            close_object(dss[w], roots[w], ohs[w]);
+            opened.fetch_add(1, std::memory_order_release);
+        });
+    }
+    while (opened.load(std::memory_order_acquire) < workers)
+        std::this_thread::yield();
+    executor.stop();
+    red_client_lib_fini();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned requests = 20000;
+    unsigned chain    = 4;
+    unsigned depth    = 64;
+    unsigned workers  = 2;
+    uint64_t latency  = 20000;
+    int      c;
+
+    while ((c = getopt(argc, argv, "n:k:q:t:l:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            requests = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'k':
+            chain = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'q':
+            depth = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 't':
+            workers = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'l':
+            latency = strtoull(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr,
+                    "Usage: %s [-n requests] [-k reads_per_request] [-q requests_in_flight] "
+                    "[-t workers] [-l latency_ns]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    printf("%u requests x %u chained 4 KiB reads, %u in flight, latency=%lu ns\n", requests,
+           chain, depth, latency);
+
+    run_poller(requests, chain, depth, latency);
+    run_executor(requests, chain, depth, latency, workers);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_utils.hpp
+ *   Project:    RED
+ *
+ *   Description: Timing and syscall accounting helpers shared by the benchmarks
+ *
+ ******************************************************************************/
+#ifndef BENCH_UTILS_HPP
+#define BENCH_UTILS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace bench
+{
+
+/* Syscalls issued by the common library, see syscall_counter.cpp */
+enum syscall_e
+{
+    SYS_CNT_EVENTFD,
+    SYS_CNT_CLOSE,
+    SYS_CNT_POLL,
+    SYS_CNT_EPOLL_WAIT,
+    SYS_CNT_EVENTFD_READ,
+    SYS_CNT_EVENTFD_WRITE,
+    SYS_CNT_TOTAL
+};
+
+struct syscall_counts_t
+{
+    uint64_t count[SYS_CNT_TOTAL];
+
+    uint64_t total() const
+    {
+        uint64_t sum = 0;
+        for (uint64_t c : count)
+            sum += c;
+        return sum;
+    }
+};
+
+syscall_counts_t syscalls();
+
+inline syscall_counts_t operator-(const syscall_counts_t &a, const syscall_counts_t &b)
+{
+    syscall_counts_t d;
+    for (int i = 0; i < SYS_CNT_TOTAL; i++)
+        d.count[i] = a.count[i] - b.count[i];
+    return d;
+}
+
+inline uint64_t now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+/* Return the p-th percentile (0..100) of the samples, sorting them in place */
+inline uint64_t percentile(std::vector<uint64_t> &samples, double p)
+{
+    if (samples.empty())
+        return 0;
+    std::sort(samples.begin(), samples.end());
+    size_t idx = static_cast<size_t>(p / 100.0 * static_cast<double>(samples.size() - 1));
+    return samples[idx];
+}
+
+inline void print_syscalls(const char *label, const syscall_counts_t &d, uint64_t ops)
+{
+    double per_op = ops ? 1.0 / static_cast<double>(ops) : 0.0;
+    printf("%-28s syscalls/op %6.2f (eventfd %.2f close %.2f poll %.2f epoll_wait %.2f "
+           "read %.2f write %.2f)\n",
+           label, d.total() * per_op, d.count[SYS_CNT_EVENTFD] * per_op,
+           d.count[SYS_CNT_CLOSE] * per_op, d.count[SYS_CNT_POLL] * per_op,
+           d.count[SYS_CNT_EPOLL_WAIT] * per_op, d.count[SYS_CNT_EVENTFD_READ] * per_op,
+           d.count[SYS_CNT_EVENTFD_WRITE] * per_op);
+}
+
+} // namespace bench
+
+#endif /* BENCH_UTILS_HPP */
@@ -0,0 +1,153 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       bench_wait_policy.cpp
+ *   Project:    RED
+ *
+ *   Description: Latency and CPU cost of the synchronous wrappers per wait
+ *                policy
+ *
+ ******************************************************************************/
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <getopt.h>
+#include <time.h>
+#include <vector>
+
+#include <red/red_client_api.h>
+#include <red/red_fs_api.h>
+
+#include "reactor.hpp"
+#include "sync_api.hpp"
+#include "bench_utils.hpp"
+#include "fake_red_client.hpp"
+
+namespace
+{
+
+uint64_t thread_cpu_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull +
+           static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void run(const char *label, const common::wait_policy_t &policy, rfs_open_hndl_t oh,
+         unsigned ops)
+{
+    char                  buf[4096];
+    ssize_t               ret;
+    std::vector<uint64_t> samples(ops);
+
+    common::set_wait_policy(policy);
+
+    /* Let the adaptive policy learn the latency before measuring */
+    for (unsigned i = 0; i < 100; i++)
+        red::red_pread(oh, buf, sizeof(buf), 0, &ret, nullptr);
+
+    common::wait_stats_t    stats_before = common::reactor_t::local().spin_stats();
+    bench::syscall_counts_t before       = bench::syscalls();
+    uint64_t                cpu_start    = thread_cpu_ns();
+
+    for (unsigned i = 0; i < ops; i++)
+    {
+        uint64_t start = bench::now_ns();
+        if (red::red_pread(oh, buf, sizeof(buf), 0, &ret, nullptr) != RED_SUCCESS)
+        {
+            fprintf(stderr, "%s: op %u failed\n", label, i);
+            exit(EXIT_FAILURE);
+        }
+        samples[i] = bench::now_ns() - start;
+    }
+
+    uint64_t                    cpu   = thread_cpu_ns() - cpu_start;
+    const common::wait_stats_t &stats = common::reactor_t::local().spin_stats();
+
+    bench::print_syscalls(label, bench::syscalls() - before, ops);
+    printf("%-28s p50 %7lu ns  p99 %7lu ns  cpu %7lu ns/op  spun %5.1f%%\n", label,
+           bench::percentile(samples, 50), bench::percentile(samples, 99), cpu / ops,
+           100.0 * static_cast<double>(stats.spun - stats_before.spun) / ops);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned              ops       = 10000;
+    uint64_t              budget_ns = 50000;
+    std::vector<uint64_t> latencies = {0, 5000, 100000};
+    int                   c;
+
+    while ((c = getopt(argc, argv, "n:l:b:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            ops = static_cast<unsigned>(atoi(optarg));
+            break;
+        case 'l':
+            latencies = {strtoull(optarg, nullptr, 0)};
+            break;
+        case 'b':
+            budget_ns = strtoull(optarg, nullptr, 0);
+            break;
+        default:
+            fprintf(stderr, "Usage: %s [-n ops] [-l latency_ns] [-b spin_budget_ns]\n",
+                    argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    struct red_client_lib_init_opts opts = {.num_sthreads     = 1,
+                                            .coremask         = NULL,
+                                            .num_buffers      = RFS_NUM_DEF_BUFFERS,
+                                            .num_ring_entries = 64,
+                                            .poller_thread    = false};
+    red_client_lib_init_v3(&opts);
+
+    rfs_dataset_hndl_t ds;
+    rfs_open_hndl_t    root_oh;
+    rfs_open_hndl_t    oh;
+    char               buf[4096];
+    ssize_t            ret;
+
+    memset(buf, 'x', sizeof(buf));
+    red::red_obtain_dataset("bench", "local", nullptr, &ds, nullptr);
+    red::red_open_root(ds, &root_oh, nullptr);
+    red::red_openat(root_oh, "obj", O_CREAT | O_RDWR, 0644, &oh, nullptr);
+    red::red_pwrite(oh, buf, sizeof(buf), 0, &ret, nullptr);
+
+    for (uint64_t latency : latencies)
+    {
+        fake_red::configure({.op_latency_ns = latency});
+        printf("%u x 4 KiB red_pread, latency=%lu ns, spin budget=%lu ns\n", ops, latency,
+               budget_ns);
+
+        run("block", {common::wait_mode_e::BLOCK, budget_ns}, oh, ops);
+        run("spin then block", {common::wait_mode_e::SPIN, budget_ns}, oh, ops);
+        run("adaptive", {common::wait_mode_e::ADAPTIVE, budget_ns}, oh, ops);
+    }
+
+    fake_red::configure({});
+    common::set_wait_policy({});
+    red::red_close(oh, nullptr);
+    red::red_close(root_oh, nullptr);
+    red::red_close_dataset(ds, nullptr);
+    red_client_lib_fini();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,1288 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       fake_red_client.cpp
+ *   Project:    RED
+ *
+ *   Description: Local stand-in for libred_client used by the benchmarks
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <red/red_client_api.h>
+#include <red/red_ds_api.h>
+#include <red/red_fs_api.h>
+#include <red/red_queue_api.h>
+#include <red/red_s3_api.h>
+
+#include "fake_red_client.hpp"
+#include "md5.hpp"
+
+namespace
+{
+
+/*
+ * Raw syscalls keep the stand-in's own eventfd traffic out of the syscall
+ * counters that the benchmarks attach to the common library.
+ */
+int raw_eventfd()
+{
+    return static_cast<int>(syscall(SYS_eventfd2, 0, EFD_CLOEXEC | EFD_NONBLOCK));
+}
+
+void raw_signal(int fd)
+{
+    uint64_t one = 1;
+    (void)syscall(SYS_write, fd, &one, sizeof(one));
+}
+
+void raw_clear(int fd)
+{
+    uint64_t val;
+    (void)syscall(SYS_read, fd, &val, sizeof(val));
+}
+
+uint64_t now_ns()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull +
+           static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/*
+ * Completion ring of one submitting thread (poller_thread = false)
+ */
+struct ring_t
+{
+    std::mutex                 mu;
+    std::deque<rfs_usercomp_t> q;
+    int                        efd = raw_eventfd();
+};
+
+struct pending_t
+{
+    uint64_t       due_ns;
+    uint64_t       seq;
+    rfs_usercomp_t comp;
+    ring_t        *ring;
+
+    bool operator>(const pending_t &o) const
+    {
+        return due_ns != o.due_ns ? due_ns > o.due_ns : seq > o.seq;
+    }
+};
+
+class engine_t
+{
+public:
+    void start(bool poller)
+    {
+        std::lock_guard<std::mutex> lk(mu);
+        poller_thread = poller;
+        stopping      = false;
+        busy_until    = 0;
+        submitted     = 0;
+        completed     = 0;
+        hipri         = 0;
+        if (!worker.joinable())
+            worker = std::thread([this] { run(); });
+        if (poller_thread && !poller_worker.joinable())
+            poller_worker = std::thread([this] { run_poller(); });
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lk(mu);
+            stopping = true;
+        }
+        cv.notify_all();
+        if (worker.joinable())
+            worker.join();
+
+        {
+            std::lock_guard<std::mutex> lk(poller_mu);
+            poller_stopping = true;
+        }
+        poller_cv.notify_all();
+        if (poller_worker.joinable())
+            poller_worker.join();
+        poller_stopping = false;
+    }
+
+    void configure(const fake_red::config_t &c)
+    {
+        std::lock_guard<std::mutex> lk(mu);
+        cfg = c;
+    }
+
+    fake_red::stats_t stats()
+    {
+        return {submitted.load(), completed.load(), hipri.load(), 0};
+    }
+
+    uint64_t register_ns()
+    {
+        std::lock_guard<std::mutex> lk(mu);
+        return cfg.register_ns;
+    }
+
+    size_t q_msg_size()
+    {
+        std::lock_guard<std::mutex> lk(mu);
+        return cfg.q_msg_size;
+    }
+
+    /* Counted only: the service order stays FIFO */
+    void note_flags(int flags)
+    {
+        if (flags & RWF_HIPRI)
+            hipri.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    bool has_poller() const
+    {
+        return poller_thread;
+    }
+
+    ring_t *local_ring()
+    {
+        static thread_local ring_t *ring = nullptr;
+        if (ring == nullptr)
+        {
+            std::lock_guard<std::mutex> lk(mu);
+            rings.emplace_back(new ring_t);
+            ring = rings.back().get();
+        }
+        return ring;
+    }
+
+    void submit(rfs_usercb_t *ucb, red_status_t res, size_t bytes)
+    {
+        rfs_usercomp_t comp = {ucb->ucb_fun, ucb->ucb_arg, res};
+        ring_t        *ring = poller_thread ? nullptr : local_ring();
+
+        submitted.fetch_add(1, std::memory_order_relaxed);
+
+        std::unique_lock<std::mutex> lk(mu);
+        uint64_t service = cfg.op_latency_ns +
+                           static_cast<uint64_t>(cfg.ns_per_byte * static_cast<double>(bytes));
+        if (service == 0)
+        {
+            lk.unlock();
+            deliver(comp, ring);
+            return;
+        }
+
+        uint64_t start = now_ns();
+        if (cfg.serialize)
+        {
+            start      = std::max(start, busy_until);
+            busy_until = start + service;
+        }
+        pending.push({start + service, seq++, comp, ring});
+        lk.unlock();
+        cv.notify_one();
+    }
+
+    int poll(rfs_usercomp_t *ucps, unsigned num)
+    {
+        ring_t                     *ring = local_ring();
+        std::lock_guard<std::mutex> lk(ring->mu);
+
+        unsigned n = 0;
+        while (n < num && !ring->q.empty())
+        {
+            ucps[n++] = ring->q.front();
+            ring->q.pop_front();
+        }
+        if (ring->q.empty())
+            raw_clear(ring->efd);
+        return static_cast<int>(n);
+    }
+
+private:
+    void deliver(const rfs_usercomp_t &comp, ring_t *ring)
+    {
+        completed.fetch_add(1, std::memory_order_relaxed);
+        if (ring == nullptr)
+        {
+            /*
+             * Poller thread mode: like the real library, completions are
+             * handed from the service thread to a separate poller thread
+             */
+            std::lock_guard<std::mutex> lk(poller_mu);
+            bool                        was_empty = poller_q.empty();
+            poller_q.push_back(comp);
+            if (was_empty)
+                poller_cv.notify_one();
+            return;
+        }
+
+        std::lock_guard<std::mutex> lk(ring->mu);
+        bool                        was_empty = ring->q.empty();
+        ring->q.push_back(comp);
+        if (was_empty)
+            raw_signal(ring->efd);
+    }
+
+    void run_poller()
+    {
+        std::deque<rfs_usercomp_t> batch;
+        std::unique_lock<std::mutex> lk(poller_mu);
+        while (!poller_stopping || !poller_q.empty())
+        {
+            if (poller_q.empty())
+            {
+                poller_cv.wait(lk);
+                continue;
+            }
+            batch.swap(poller_q);
+            lk.unlock();
+            for (const rfs_usercomp_t &comp : batch)
+                comp.ucp_fun(comp.ucp_res, comp.ucp_arg);
+            batch.clear();
+            lk.lock();
+        }
+    }
+
+    void run()
+    {
+        std::unique_lock<std::mutex> lk(mu);
+        while (!stopping || !pending.empty())
+        {
+            if (pending.empty())
+            {
+                cv.wait(lk);
+                continue;
+            }
+
+            uint64_t now = now_ns();
+            uint64_t due = pending.top().due_ns;
+            if (due > now)
+            {
+                /* Sleeping is too coarse for microsecond service times */
+                if (due - now < 50000)
+                {
+                    lk.unlock();
+                    std::this_thread::yield();
+                    lk.lock();
+                }
+                else
+                {
+                    cv.wait_for(lk, std::chrono::nanoseconds(due - now - 20000));
+                }
+                continue;
+            }
+
+            pending_t p = pending.top();
+            pending.pop();
+            lk.unlock();
+            deliver(p.comp, p.ring);
+            lk.lock();
+        }
+    }
+
+    std::mutex                                                             mu;
+    std::condition_variable                                                cv;
+    std::priority_queue<pending_t, std::vector<pending_t>, std::greater<>> pending;
+    std::vector<std::unique_ptr<ring_t>>                                   rings;
+    std::thread                                                            worker;
+    std::thread                                                            poller_worker;
+    std::mutex                                                             poller_mu;
+    std::condition_variable                                                poller_cv;
+    std::deque<rfs_usercomp_t>                                             poller_q;
+    bool                                                                   poller_stopping = false;
+    fake_red::config_t                                                     cfg;
+    bool                                                                   poller_thread = false;
+    bool                                                                   stopping      = false;
+    uint64_t                                                               busy_until    = 0;
+    uint64_t                                                               seq           = 0;
+    std::atomic<uint64_t>                                                  submitted{0};
+    std::atomic<uint64_t>                                                  completed{0};
+    std::atomic<uint64_t>                                                  hipri{0};
+};
+
+engine_t g_engine;
+
+/*
+ * In-memory namespace: datasets hold objects, open handles point at either
+ * a dataset root or an object.
+ */
+/* Layout of a part of a completed multipart upload, with what red_close_part() stored */
+struct part_t
+{
+    size_t               offset;
+    size_t               size;
+    red_data_integrity_t integrity;
+};
+
+struct object_t
+{
+    std::vector<char>                  data;
+    std::map<std::string, std::string> xattrs;
+    uint64_t                           version = 0;
+    std::vector<part_t>                parts; /* Empty unless written by a multipart upload */
+    red_data_integrity_t               integrity = {};
+    std::string                        etag; /* Derived on the first read of it, reset by writes */
+};
+
+struct dataset_t
+{
+    std::string                     name;
+    std::map<std::string, object_t> objects;
+};
+
+struct handle_t
+{
+    dataset_t  *ds;
+    std::string key; /* empty for the root handle */
+};
+
+/* Parts are objects of the dataset, named after the upload, until it is completed */
+struct upload_t
+{
+    dataset_t            *ds;
+    std::string           key;
+    std::vector<uint32_t> completed; /* Part numbers given to red_comp_mpart_upload() so far */
+};
+
+struct store_t
+{
+    std::mutex                                        mu;
+    std::map<std::string, std::unique_ptr<dataset_t>> datasets;
+    std::map<uint64_t, handle_t>                      handles;
+    std::map<std::string, upload_t>                   uploads;
+    uint64_t                                          next_fd     = 1;
+    uint64_t                                          next_upload = 1;
+
+    handle_t *find(rfs_open_hndl_t oh)
+    {
+        auto it = handles.find(oh.fd);
+        return it == handles.end() ? nullptr : &it->second;
+    }
+
+    object_t *object(rfs_open_hndl_t oh)
+    {
+        handle_t *h = find(oh);
+        if (h == nullptr || h->key.empty())
+            return nullptr;
+        auto it = h->ds->objects.find(h->key);
+        return it == h->ds->objects.end() ? nullptr : &it->second;
+    }
+
+    rfs_open_hndl_t open(dataset_t *ds, const std::string &key)
+    {
+        rfs_open_hndl_t oh = {next_fd++};
+        handles[oh.fd]     = {ds, key};
+        return oh;
+    }
+
+    static std::string part_key(const std::string &upload_id, uint32_t part_num)
+    {
+        return upload_id + "/" + std::to_string(part_num);
+    }
+
+    /* Drop the parts of an upload that is completed or aborted */
+    void drop_upload(std::map<std::string, upload_t>::iterator it)
+    {
+        auto &objects = it->second.ds->objects;
+        objects.erase(objects.lower_bound(it->first + "/"), objects.lower_bound(it->first + "0"));
+        uploads.erase(it);
+    }
+};
+
+store_t g_store;
+
+struct iomem_region_t
+{
+    void  *base;
+    size_t size;
+};
+
+/*
+ * Registered memory. Data operations on anything else are copied through a
+ * bounce buffer first, as the library has to before the transfer.
+ */
+struct registry_t
+{
+    std::mutex                  mu;
+    std::map<uintptr_t, size_t> ranges;
+    std::atomic<uint64_t>       bounced{0};
+
+    red_status_t add(void *ptr, size_t nob)
+    {
+        std::lock_guard<std::mutex> lk(mu);
+        return ranges.emplace(reinterpret_cast<uintptr_t>(ptr), nob).second ? RED_SUCCESS
+                                                                          : RED_EEXIST;
+    }
+
+    red_status_t remove(void *ptr)
+    {
+        std::lock_guard<std::mutex> lk(mu);
+        return ranges.erase(reinterpret_cast<uintptr_t>(ptr)) ? RED_SUCCESS : RED_ENOENT;
+    }
+
+    bool covers(const void *ptr, size_t len)
+    {
+        auto                        p = reinterpret_cast<uintptr_t>(ptr);
+        std::lock_guard<std::mutex> lk(mu);
+        auto                        it = ranges.upper_bound(p);
+        if (it == ranges.begin())
+            return false;
+        --it;
+        return p + len <= it->first + it->second;
+    }
+};
+
+registry_t g_registry;
+
+/* Registration pins and maps the pages: charged to the caller */
+void pay_registration()
+{
+    uint64_t cost = g_engine.register_ns();
+    if (cost == 0)
+        return;
+    uint64_t end = now_ns() + cost;
+    while (now_ns() < end)
+        sched_yield();
+}
+
+/*
+ * Copy of the caller's data the library makes for unregistered memory,
+ * before a write or after a read
+ */
+void bounce(void *buf, size_t len)
+{
+    static thread_local std::vector<char> staging;
+
+    if (len == 0 || g_registry.covers(buf, len))
+        return;
+    g_registry.bounced.fetch_add(1, std::memory_order_relaxed);
+    if (staging.size() < len)
+        staging.resize(len);
+    memcpy(staging.data(), buf, len);
+    asm volatile("" : : "r"(staging.data()) : "memory");
+}
+
+/* Service threads requested at init; lcore n is served by thread n % count */
+unsigned g_num_sthreads = 1;
+
+int complete(rfs_usercb_t *ucb, red_status_t rs, size_t bytes = 0)
+{
+    g_engine.submit(ucb, rs, bytes);
+    return 0;
+}
+
+red_status_t obtain(const char *name, rfs_dataset_hndl_t *ds_hndl)
+{
+    std::lock_guard<std::mutex> lk(g_store.mu);
+    auto                       &ds = g_store.datasets[name];
+    if (!ds)
+    {
+        ds       = std::make_unique<dataset_t>();
+        ds->name = name;
+    }
+    ds_hndl->hndl = ds.get();
+    return RED_SUCCESS;
+}
+
+red_status_t open_object(rfs_open_hndl_t    dir_oh,
+                         const char        *key,
+                         bool               create,
+                         bool               truncate,
+                         rfs_open_hndl_t   *oh)
+{
+    std::lock_guard<std::mutex> lk(g_store.mu);
+    handle_t                   *dir = g_store.find(dir_oh);
+    if (dir == nullptr || !dir->key.empty())
+        return RED_EBADF;
+
+    auto it = dir->ds->objects.find(key);
+    if (it == dir->ds->objects.end())
+    {
+        if (!create)
+            return RED_ENOENT;
+        dir->ds->objects[key];
+    }
+    else if (truncate)
+    {
+        it->second.data.clear();
+        it->second.parts.clear();
+        it->second.etag.clear();
+    }
+    *oh = g_store.open(dir->ds, key);
+    return RED_SUCCESS;
+}
+
+} // namespace
+
+namespace fake_red
+{
+
+void configure(const config_t &cfg)
+{
+    g_engine.configure(cfg);
+}
+
+stats_t stats()
+{
+    stats_t s = g_engine.stats();
+    s.bounced = g_registry.bounced.load();
+    return s;
+}
+
+} // namespace fake_red
+
+extern "C"
+{
+
+int red_client_lib_init_v3(const struct red_client_lib_init_opts *opts)
+{
+    g_num_sthreads = opts->num_sthreads > 0 ? opts->num_sthreads : 1;
+    g_engine.start(opts->poller_thread);
+    g_registry.bounced = 0;
+    return RED_SUCCESS;
+}
+
+bool red_client_lib_is_ready(unsigned int)
+{
+    return true;
+}
+
+bool red_client_is_ready(unsigned int)
+{
+    return true;
+}
+
+void red_client_lib_fini(void)
+{
+    g_engine.stop();
+}
+
+int red_client_lib_poll_fd()
+{
+    return g_engine.has_poller() ? -1 : g_engine.local_ring()->efd;
+}
+
+int red_client_lib_poll(rfs_usercomp_t *ucps, unsigned int num_ucps)
+{
+    return g_engine.poll(ucps, num_ucps);
+}
+
+uint64_t red_client_get_timer_cycles(void)
+{
+    return now_ns();
+}
+
+uint64_t red_client_get_timer_hz(void)
+{
+    return 1000000000ull;
+}
+
+unsigned red_client_get_num_service_threads(void)
+{
+    return g_num_sthreads;
+}
+
+red_rc_t red_client_get_lcore_2_service_thread_id(uint32_t lcore)
+{
+    return lcore < CPU_SETSIZE ? static_cast<red_rc_t>(lcore % g_num_sthreads) : RED_ERANGE;
+}
+
+const char *red_strerror(red_status_t rc)
+{
+    return rc > -256 ? strerror(-rc) : "RED internal error";
+}
+
+int red_obtain_dataset(const char         *ds_name,
+                       const char         *,
+                       red_ds_props_t     *,
+                       rfs_dataset_hndl_t *ds_hndl,
+                       rfs_usercb_t       *ucb,
+                       red_api_user_t     *)
+{
+    return complete(ucb, obtain(ds_name, ds_hndl));
+}
+
+int red_s3_create_bucket(const char         *bucket_name,
+                         const char         *,
+                         const char         *,
+                         const char         *,
+                         red_ds_props_t     *,
+                         rfs_dataset_hndl_t *bucket_hndl,
+                         rfs_usercb_t       *ucb,
+                         red_api_user_t     *)
+{
+    return complete(ucb, obtain(bucket_name, bucket_hndl));
+}
+
+int red_close_dataset(rfs_dataset_hndl_t, rfs_usercb_t *ucb, red_api_user_t *)
+{
+    return complete(ucb, RED_SUCCESS);
+}
+
+int red_open_root(rfs_dataset_hndl_t ds_hndl,
+                  rfs_open_hndl_t   *root_dirfd,
+                  rfs_usercb_t      *ucb,
+                  red_api_user_t    *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    *root_dirfd = g_store.open(static_cast<dataset_t *>(ds_hndl.hndl), "");
+    lk.unlock();
+    return complete(ucb, RED_SUCCESS);
+}
+
+int red_openat(rfs_open_hndl_t  dir_oh,
+               const char      *pathname,
+               int              flags,
+               mode_t,
+               rfs_open_hndl_t *oh,
+               rfs_usercb_t    *ucb,
+               red_api_user_t  *)
+{
+    return complete(ucb, open_object(dir_oh, pathname, flags & O_CREAT, flags & O_TRUNC, oh));
+}
+
+int red_s3_create_version(rfs_open_hndl_t  dir_oh,
+                          const char      *s3_key,
+                          int,
+                          rfs_open_hndl_t *created_oh,
+                          rfs_usercb_t    *ucb,
+                          red_api_user_t  *)
+{
+    return complete(ucb, open_object(dir_oh, s3_key, true, true, created_oh));
+}
+
+int red_s3_open(rfs_open_hndl_t  dir_oh,
+                const char      *s3_key,
+                uint64_t,
+                int,
+                rfs_open_hndl_t *oh,
+                uint64_t        *out_version,
+                rfs_usercb_t    *ucb,
+                red_api_user_t  *)
+{
+    red_status_t rs = open_object(dir_oh, s3_key, false, false, oh);
+    if (rs == RED_SUCCESS)
+    {
+        std::lock_guard<std::mutex> lk(g_store.mu);
+        *out_version = g_store.object(*oh)->version;
+    }
+    return complete(ucb, rs);
+}
+
+int red_s3_publish(rfs_open_hndl_t oh, uint64_t *version, rfs_usercb_t *ucb, red_api_user_t *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    object_t                    *obj = g_store.object(oh);
+    if (obj == nullptr)
+        return RED_EBADF;
+    *version = ++obj->version;
+    lk.unlock();
+    return complete(ucb, RED_SUCCESS);
+}
+
+int red_close(rfs_open_hndl_t oh, rfs_usercb_t *ucb, red_api_user_t *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    red_status_t                 rs = g_store.handles.erase(oh.fd) ? RED_SUCCESS : RED_EBADF;
+    lk.unlock();
+    return complete(ucb, rs);
+}
+
+int red_pread(rfs_open_hndl_t oh,
+              void           *buf,
+              size_t          count,
+              off_t           offset,
+              ssize_t        *bytes_read,
+              rfs_usercb_t   *ucb,
+              red_api_user_t *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    object_t                    *obj = g_store.object(oh);
+    if (obj == nullptr)
+        return RED_EBADF;
+
+    size_t off = static_cast<size_t>(offset);
+    size_t n   = off < obj->data.size() ? std::min(count, obj->data.size() - off) : 0;
+    if (n > 0)
+        memcpy(buf, obj->data.data() + off, n);
+    *bytes_read = static_cast<ssize_t>(n);
+    lk.unlock();
+    bounce(buf, n);
+    return complete(ucb, RED_SUCCESS, n);
+}
+
+int red_pwrite(rfs_open_hndl_t oh,
+               void           *buf,
+               size_t          count,
+               off_t           offset,
+               ssize_t        *bytes_written,
+               rfs_usercb_t   *ucb,
+               red_api_user_t *)
+{
+    bounce(buf, count);
+
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    object_t                    *obj = g_store.object(oh);
+    if (obj == nullptr)
+        return RED_EBADF;
+
+    size_t off = static_cast<size_t>(offset);
+    if (obj->data.size() < off + count)
+        obj->data.resize(off + count);
+    memcpy(obj->data.data() + off, buf, count);
+    obj->parts.clear();
+    obj->etag.clear();
+    *bytes_written = static_cast<ssize_t>(count);
+    lk.unlock();
+    return complete(ucb, RED_SUCCESS, count);
+}
+
+int red_preadv2(rfs_open_hndl_t   oh,
+                struct red_iovec *iov,
+                int               iovcnt,
+                off_t             offset,
+                int               flags,
+                ssize_t          *bytes_read,
+                rfs_usercb_t     *ucb,
+                red_api_user_t   *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    object_t                    *obj = g_store.object(oh);
+    if (obj == nullptr)
+        return RED_EBADF;
+
+    size_t off   = static_cast<size_t>(offset);
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++)
+    {
+        size_t pos = off + iov[i].iov_offset;
+        size_t n   = pos < obj->data.size() ? std::min(iov[i].iov_len, obj->data.size() - pos) : 0;
+        if (n > 0)
+            memcpy(iov[i].iov_base, obj->data.data() + pos, n);
+        total += n;
+        off += iov[i].iov_len;
+    }
+    *bytes_read = static_cast<ssize_t>(total);
+    lk.unlock();
+    g_engine.note_flags(flags);
+    return complete(ucb, RED_SUCCESS, total);
+}
+
+int red_pwritev2(rfs_open_hndl_t   oh,
+                 struct red_iovec *iov,
+                 int               iovcnt,
+                 off_t             offset,
+                 int               flags,
+                 ssize_t          *bytes_written,
+                 rfs_usercb_t     *ucb,
+                 red_api_user_t   *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    object_t                    *obj = g_store.object(oh);
+    if (obj == nullptr)
+        return RED_EBADF;
+
+    size_t off   = static_cast<size_t>(offset);
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; i++)
+    {
+        size_t pos = off + iov[i].iov_offset;
+        if (obj->data.size() < pos + iov[i].iov_len)
+            obj->data.resize(pos + iov[i].iov_len);
+        memcpy(obj->data.data() + pos, iov[i].iov_base, iov[i].iov_len);
+        total += iov[i].iov_len;
+        off += iov[i].iov_len;
+    }
+    obj->etag.clear();
+    *bytes_written = static_cast<ssize_t>(total);
+    lk.unlock();
+    g_engine.note_flags(flags);
+    return complete(ucb, RED_SUCCESS, total);
+}
+
+void *red_client_alloc_buffer(size_t size)
+{
+    void *buf = aligned_alloc(4096, (size + 4095) & ~size_t(4095));
+    if (buf == nullptr)
+        return nullptr;
+    pay_registration();
+    g_registry.add(buf, size);
+    return buf;
+}
+
+void red_client_free_buffer(void *ptr)
+{
+    if (ptr == nullptr)
+        return;
+    pay_registration();
+    g_registry.remove(ptr);
+    free(ptr);
+}
+
+void *red_client_iomem_alloc(size_t size)
+{
+    return red_client_alloc_buffer(size);
+}
+
+void red_client_iomem_free(void *addr)
+{
+    red_client_free_buffer(addr);
+}
+
+red_status_t red_client_register_buffer(void *ptr, size_t nob)
+{
+    pay_registration();
+    return g_registry.add(ptr, nob);
+}
+
+red_status_t red_client_unregister_buffer(void *ptr)
+{
+    pay_registration();
+    return g_registry.remove(ptr);
+}
+
+red_status_t red_client_iomem_register(void *addr, size_t nob)
+{
+    return red_client_register_buffer(addr, nob);
+}
+
+red_status_t red_client_iomem_unregister(void *addr)
+{
+    return red_client_unregister_buffer(addr);
+}
+
+int red_pread_iomem(rfs_open_hndl_t  oh,
+                    red_iomem_hndl_t,
+                    void            *addr,
+                    size_t           size,
+                    off_t            offset,
+                    ssize_t         *bytes_read,
+                    rfs_usercb_t    *ucb,
+                    red_api_user_t  *api_user)
+{
+    return red_pread(oh, addr, size, offset, bytes_read, ucb, api_user);
+}
+
+int red_pwrite_iomem(rfs_open_hndl_t  oh,
+                     red_iomem_hndl_t,
+                     void            *addr,
+                     size_t           size,
+                     off_t            offset,
+                     ssize_t         *bytes_written,
+                     rfs_usercb_t    *ucb,
+                     red_api_user_t  *api_user)
+{
+    return red_pwrite(oh, addr, size, offset, bytes_written, ucb, api_user);
+}
+
+/* Regions are registered page-aligned memory; the round trip is what is modelled */
+red_status_t red_iomem_alloc(size_t            size,
+                             red_iomem_hndl_t *iomem,
+                             rfs_usercb_t     *ucb,
+                             red_api_user_t   *)
+{
+    auto *r = new iomem_region_t;
+    r->size = size;
+    r->base = aligned_alloc(4096, (size + 4095) & ~size_t(4095));
+    if (r->base == nullptr)
+    {
+        delete r;
+        return RED_ENOMEM;
+    }
+    g_registry.add(r->base, size);
+    iomem->hndl = r;
+    return static_cast<red_status_t>(complete(ucb, RED_SUCCESS));
+}
+
+red_status_t red_iomem_free(red_iomem_hndl_t iomem, rfs_usercb_t *ucb, red_api_user_t *)
+{
+    auto *r = static_cast<iomem_region_t *>(iomem.hndl);
+    if (r == nullptr)
+        return RED_EINVAL;
+    g_registry.remove(r->base);
+    free(r->base);
+    delete r;
+    return static_cast<red_status_t>(complete(ucb, RED_SUCCESS));
+}
+
+void *red_iomem_to_addr(red_iomem_hndl_t iomem, off_t offset)
+{
+    auto *r = static_cast<iomem_region_t *>(iomem.hndl);
+    if (r == nullptr || offset < 0 || static_cast<size_t>(offset) >= r->size)
+        return nullptr;
+    return static_cast<char *>(r->base) + offset;
+}
+
+size_t red_iomem_size(red_iomem_hndl_t iomem)
+{
+    auto *r = static_cast<iomem_region_t *>(iomem.hndl);
+    return r != nullptr ? r->size : 0;
+}
+
+int red_fsetxattr(rfs_open_hndl_t oh,
+                  const char     *name,
+                  const void     *value,
+                  size_t          size,
+                  int,
+                  rfs_usercb_t   *ucb,
+                  red_api_user_t *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    object_t                    *obj = g_store.object(oh);
+    if (obj != nullptr)
+        obj->xattrs[name].assign(static_cast<const char *>(value), size);
+    lk.unlock();
+    return complete(ucb, RED_SUCCESS);
+}
+
+namespace
+{
+
+/*
+ * The S3 ETag the library stores under RED_S3_ETAG_KEY: the MD5 of the data,
+ * or for a multipart object the MD5 of its parts' MD5s and "-<parts>"
+ */
+const std::string &s3_etag(object_t &obj)
+{
+    if (!obj.etag.empty())
+        return obj.etag;
+
+    char          hex[RED_S3_USER_MPART_ETAG_SIZE];
+    common::md5_t md5;
+    if (obj.parts.empty())
+    {
+        md5.update(obj.data.data(), obj.data.size());
+        md5.final_hex(hex);
+        obj.etag = hex;
+        return obj.etag;
+    }
+
+    for (const part_t &part : obj.parts)
+    {
+        common::md5_t part_md5;
+        uint8_t       digest[common::md5_t::DIGEST_SIZE];
+        part_md5.update(obj.data.data() + part.offset, part.size);
+        part_md5.final(digest);
+        md5.update(digest, sizeof(digest));
+    }
+    md5.final_hex(hex);
+    obj.etag = std::string(hex) + "-" + std::to_string(obj.parts.size());
+    return obj.etag;
+}
+
+} // namespace
+
+int red_fgetxattr(rfs_open_hndl_t oh,
+                  const char     *name,
+                  void           *value,
+                  size_t          size,
+                  size_t         *ret_size,
+                  rfs_usercb_t   *ucb,
+                  red_api_user_t *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    object_t                    *obj = g_store.object(oh);
+    red_status_t                 rs  = RED_ENODATA;
+    if (obj != nullptr && (obj->xattrs.count(name) || strcmp(name, RED_S3_ETAG_KEY) == 0))
+    {
+        const std::string &val = obj->xattrs.count(name) ? obj->xattrs[name] : s3_etag(*obj);
+        *ret_size              = std::min(size, val.size());
+        memcpy(value, val.data(), *ret_size);
+        rs = RED_SUCCESS;
+    }
+    lk.unlock();
+    return complete(ucb, rs);
+}
+
+int red_create_mpart_upload(rfs_open_hndl_t  root_oh,
+                            const char      *s3_key,
+                            int,
+                            char            *upload_id,
+                            size_t           upload_id_nob,
+                            rfs_open_hndl_t *created_oh,
+                            rfs_usercb_t    *ucb,
+                            red_api_user_t  *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    handle_t                    *dir = g_store.find(root_oh);
+    if (dir == nullptr || !dir->key.empty())
+        return RED_EBADF;
+
+    std::string id = "upload-" + std::to_string(g_store.next_upload++);
+    if (id.size() >= upload_id_nob)
+        return RED_ERANGE;
+    memcpy(upload_id, id.c_str(), id.size() + 1);
+    g_store.uploads[id] = {dir->ds, s3_key, {}};
+    *created_oh         = g_store.open(dir->ds, "");
+    lk.unlock();
+    return complete(ucb, RED_SUCCESS);
+}
+
+int red_upload_part(rfs_open_hndl_t,
+                    const char      *s3_key,
+                    const char      *upload_id,
+                    uint32_t         part_num,
+                    int,
+                    rfs_open_hndl_t *part_oh,
+                    rfs_usercb_t    *ucb,
+                    red_api_user_t  *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    auto                         it = g_store.uploads.find(upload_id);
+    if (it == g_store.uploads.end() || it->second.key != s3_key)
+        return RED_ENOENT;
+    if (part_num == 0 || part_num > RED_S3_MAX_PARTS)
+        return RED_EINVAL;
+
+    std::string key = store_t::part_key(upload_id, part_num);
+    it->second.ds->objects[key].data.clear();
+    *part_oh = g_store.open(it->second.ds, key);
+    lk.unlock();
+    return complete(ucb, RED_SUCCESS);
+}
+
+/* The part's ETag is its size; a CRC-32C checksum is taken as given, not verified */
+int red_close_part(rfs_open_hndl_t       oh,
+                   red_data_integrity_t *part_integrity,
+                   rfs_usercb_t         *ucb,
+                   red_api_user_t       *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    object_t                    *obj = g_store.object(oh);
+    if (obj == nullptr)
+        return RED_EBADF;
+    snprintf(part_integrity->etag, sizeof(part_integrity->etag), "%zx", obj->data.size());
+    obj->integrity = *part_integrity;
+    g_store.handles.erase(oh.fd);
+    lk.unlock();
+    return complete(ucb, RED_SUCCESS);
+}
+
+/* The final call concatenates every part listed, in the order given */
+int red_comp_mpart_upload(rfs_open_hndl_t,
+                          const char         *s3_key,
+                          const char         *upload_id,
+                          const uint32_t,
+                          const uint32_t      upload_parts,
+                          red_part_info_v2_t *parts,
+                          bool                final_parts,
+                          uint32_t,
+                          red_mp_info_t      *mp_obj_info,
+                          rfs_usercb_t       *ucb,
+                          red_api_user_t     *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    auto                         it = g_store.uploads.find(upload_id);
+    if (it == g_store.uploads.end() || it->second.key != s3_key)
+        return RED_ENOENT;
+
+    upload_t &upload = it->second;
+    for (uint32_t i = 0; i < upload_parts; i++)
+        upload.completed.push_back(parts[i].pi_part_num);
+    if (!final_parts)
+    {
+        lk.unlock();
+        return complete(ucb, RED_SUCCESS);
+    }
+
+    std::vector<const object_t *> sources;
+    std::vector<part_t>           layout;
+    size_t                        size = 0;
+    for (uint32_t part_num : upload.completed)
+    {
+        auto part = upload.ds->objects.find(store_t::part_key(upload_id, part_num));
+        if (part == upload.ds->objects.end())
+            return RED_EINVAL;
+        sources.push_back(&part->second);
+        layout.push_back({size, part->second.data.size(), part->second.integrity});
+        size += part->second.data.size();
+    }
+
+    /* Into the object's existing storage, which an overwrite of the same size reuses */
+    object_t &obj = upload.ds->objects[upload.key];
+    obj.data.clear();
+    obj.data.reserve(size);
+    for (const object_t *src : sources)
+        obj.data.insert(obj.data.end(), src->data.begin(), src->data.end());
+    obj.parts.swap(layout);
+    obj.etag.clear();
+    obj.version++;
+    memset(mp_obj_info, 0, sizeof(*mp_obj_info));
+    snprintf(mp_obj_info->etag, sizeof(mp_obj_info->etag), "%zx-%zu", obj.data.size(),
+             upload.completed.size());
+    g_store.drop_upload(it);
+    lk.unlock();
+    return complete(ucb, RED_SUCCESS);
+}
+
+int red_abort_mpart(rfs_open_hndl_t,
+                    const char     *s3_key,
+                    const char     *upload_id,
+                    rfs_usercb_t   *ucb,
+                    red_api_user_t *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    auto                         it = g_store.uploads.find(upload_id);
+    if (it == g_store.uploads.end() || it->second.key != s3_key)
+        return RED_ENOENT;
+    g_store.drop_upload(it);
+    lk.unlock();
+    return complete(ucb, RED_SUCCESS);
+}
+
+int red_get_part_size_v2(rfs_open_hndl_t obj_oh,
+                         const uint32_t  part_num,
+                         size_t         *part_size,
+                         uint64_t       *part_offset,
+                         char           *part_etag,
+                         rfs_usercb_t   *ucb,
+                         red_api_user_t *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    object_t                    *obj = g_store.object(obj_oh);
+    if (obj == nullptr)
+        return RED_EBADF;
+
+    red_status_t rs = RED_ENOENT;
+    if (part_num >= 1 && part_num <= obj->parts.size())
+    {
+        const part_t &part = obj->parts[part_num - 1];
+        *part_size         = part.size;
+        *part_offset       = part.offset;
+        strcpy(part_etag, part.integrity.etag);
+        rs = RED_SUCCESS;
+    }
+    lk.unlock();
+    return complete(ucb, rs);
+}
+
+/* By part number, or at an offset with UINT32_MAX; data lands in iomem, so it is never bounced */
+int red_pread_part(rfs_open_hndl_t        oh,
+                   red_iomem_hndl_t,
+                   void                  *addr,
+                   uint32_t               part_num,
+                   off_t                  offset,
+                   size_t                 size,
+                   ssize_t               *byte_cnt,
+                   red_part_xattr_info_t *xattr_info,
+                   rfs_usercb_t          *ucb,
+                   red_api_user_t        *)
+{
+    std::unique_lock<std::mutex> lk(g_store.mu);
+    object_t                    *obj = g_store.object(oh);
+    if (obj == nullptr)
+        return RED_EBADF;
+
+    size_t off = static_cast<size_t>(offset);
+    size_t end = obj->data.size();
+    if (part_num != UINT32_MAX)
+    {
+        if (part_num < 1 || part_num > obj->parts.size() || offset != 0)
+            return RED_EINVAL;
+        const part_t &part = obj->parts[part_num - 1];
+        off                = part.offset;
+        end                = part.offset + part.size;
+        if (xattr_info != nullptr)
+        {
+            uint32_t etag_len = static_cast<uint32_t>(strlen(part.integrity.etag));
+            xattr_info->checksum_type = part.integrity.checksum.type;
+            xattr_info->checksum      = part.integrity.checksum.checksum;
+            xattr_info->etag_size     = std::min(xattr_info->etag_size, etag_len);
+            memcpy(xattr_info->etag, part.integrity.etag, xattr_info->etag_size);
+        }
+    }
+
+    size_t n = off < end ? std::min(size, end - off) : 0;
+    if (n > 0)
+        memcpy(addr, obj->data.data() + off, n);
+    *byte_cnt = static_cast<ssize_t>(n);
+    lk.unlock();
+    return complete(ucb, RED_SUCCESS, n);
+}
+
+/* Every queue partition always holds as many messages as asked for */
+int red_q_get(rfs_dataset_hndl_t,
+              red_queue_hndl_t,
+              uint32_t              partition,
+              red_q_gtx_t           gtx,
+              uint64_t              size,
+              red_q_consumable_t   *consumables,
+              uint64_t             *count,
+              rfs_usercb_t         *ucb,
+              const red_api_user_t *)
+{
+    size_t msg_size = g_engine.q_msg_size();
+    for (uint64_t i = 0; i < size; i++)
+    {
+        red_q_consumable_t &c = consumables[i];
+        size_t              n = std::min<size_t>(msg_size, c.rqo_msg.rqm_size);
+
+        memset(c.rqo_msg.rqm_data, 'q', n);
+        c.rqo_msg.rqm_size = n;
+        c.rqo_gtx.rqt_uniq = gtx.rqt_uniq;
+        c.rqo_gtx.rqt_tick = gtx.rqt_tick + i;
+        c.rqo_partition    = partition;
+    }
+    *count = size;
+    return complete(ucb, RED_SUCCESS);
+}
+
+red_q_consumable_t *red_q_alloc_consumables(uint64_t size)
+{
+    auto *consumables = static_cast<red_q_consumable_t *>(calloc(size, sizeof(red_q_consumable_t)));
+    if (consumables == nullptr)
+        return nullptr;
+    for (uint64_t i = 0; i < size; i++)
+    {
+        consumables[i].rqo_msg.rqm_data = static_cast<char *>(malloc(1024));
+        consumables[i].rqo_msg.rqm_size = 1024;
+    }
+    return consumables;
+}
+
+void red_q_dealloc_consumables(red_q_consumable_t *consumables, uint64_t size)
+{
+    if (consumables == nullptr)
+        return;
+    for (uint64_t i = 0; i < size; i++)
+        free(consumables[i].rqo_msg.rqm_data);
+    free(consumables);
+}
+
+} /* extern "C" */
@@ -0,0 +1,69 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       fake_red_client.hpp
+ *   Project:    RED
+ *
+ *   Description: Local stand-in for libred_client used by the benchmarks
+ *
+ ******************************************************************************/
+#ifndef FAKE_RED_CLIENT_HPP
+#define FAKE_RED_CLIENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * The stand-in implements the subset of the C API used by the examples'
+ * common library with an in-memory object store. Submissions return at once
+ * and complete asynchronously, either through the submitting thread's ring
+ * (poller_thread = false, drained by red_client_lib_poll()) or on an internal
+ * poller thread (poller_thread = true), mirroring the real library. Only the
+ * service model is simulated: there is no network and no persistence.
+ */
+namespace fake_red
+{
+
+struct config_t
+{
+    uint64_t op_latency_ns = 0;     /* Fixed service time of every operation */
+    double   ns_per_byte   = 0.0;   /* Transfer cost of data operations */
+    bool     serialize     = false; /* Model one service thread: ops queue FIFO */
+    uint64_t register_ns   = 0;     /* Cost of registering or unregistering a buffer */
+    size_t   q_msg_size    = 64;    /* Payload of each message red_q_get() returns */
+};
+
+struct stats_t
+{
+    uint64_t submitted;
+    uint64_t completed;
+    uint64_t hipri;   /* Vectored reads and writes flagged RWF_HIPRI */
+    uint64_t bounced; /* Reads and writes copied through a bounce buffer */
+};
+
+/**
+ * @brief Change the service model; takes effect for subsequent submissions
+ */
+void configure(const config_t &cfg);
+
+/**
+ * @brief Return counters accumulated since red_client_lib_init_v3()
+ */
+stats_t stats();
+
+} // namespace fake_red
+
+#endif /* FAKE_RED_CLIENT_HPP */
@@ -0,0 +1,93 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       syscall_counter.cpp
+ *   Project:    RED
+ *
+ *   Description: Linker-wrapped libc entry points that count the syscalls the
+ *                common library issues (see -Wl,--wrap in the Makefile)
+ *
+ ******************************************************************************/
+#include <atomic>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "bench_utils.hpp"
+
+namespace
+{
+std::atomic<uint64_t> counters[bench::SYS_CNT_TOTAL];
+
+inline void count(bench::syscall_e s)
+{
+    counters[s].fetch_add(1, std::memory_order_relaxed);
+}
+} // namespace
+
+bench::syscall_counts_t bench::syscalls()
+{
+    syscall_counts_t c;
+    for (int i = 0; i < SYS_CNT_TOTAL; i++)
+        c.count[i] = counters[i].load(std::memory_order_relaxed);
+    return c;
+}
+
+extern "C"
+{
+int __real_eventfd(unsigned int initval, int flags);
+int __real_close(int fd);
+int __real_poll(struct pollfd *fds, nfds_t nfds, int timeout);
+int __real_epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout);
+int __real_eventfd_read(int fd, eventfd_t *value);
+int __real_eventfd_write(int fd, eventfd_t value);
+
+int __wrap_eventfd(unsigned int initval, int flags)
+{
+    count(bench::SYS_CNT_EVENTFD);
+    return __real_eventfd(initval, flags);
+}
+
+int __wrap_close(int fd)
+{
+    count(bench::SYS_CNT_CLOSE);
+    return __real_close(fd);
+}
+
+int __wrap_poll(struct pollfd *fds, nfds_t nfds, int timeout)
+{
+    count(bench::SYS_CNT_POLL);
+    return __real_poll(fds, nfds, timeout);
+}
+
+int __wrap_epoll_wait(int epfd, struct epoll_event *events, int maxevents, int timeout)
+{
+    count(bench::SYS_CNT_EPOLL_WAIT);
+    return __real_epoll_wait(epfd, events, maxevents, timeout);
+}
+
+int __wrap_eventfd_read(int fd, eventfd_t *value)
+{
+    count(bench::SYS_CNT_EVENTFD_READ);
+    return __real_eventfd_read(fd, value);
+}
+
+int __wrap_eventfd_write(int fd, eventfd_t value)
+{
+    count(bench::SYS_CNT_EVENTFD_WRITE);
+    return __real_eventfd_write(fd, value);
+}
+}
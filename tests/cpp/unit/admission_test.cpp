@@ -0,0 +1,148 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       admission_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the per-dataset admission controller
+ *
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "admission.hpp"
+#include "test_utils.hpp"
+
+namespace
+{
+
+struct test_waiter_t : common::admission_waiter_t
+{
+    std::vector<unsigned> *order;
+    unsigned               id;
+
+    test_waiter_t(std::vector<unsigned> *order, unsigned id)
+    : order(order),
+      id(id)
+    {
+        fn = [](common::admission_waiter_t *w) {
+            auto *me = static_cast<test_waiter_t *>(w);
+            me->order->push_back(me->id);
+        };
+    }
+};
+
+rfs_dataset_hndl_t dataset(uintptr_t id)
+{
+    rfs_dataset_hndl_t ds;
+    ds.hndl = reinterpret_cast<void *>(id);
+    return ds;
+}
+
+} // namespace
+
+class AdmissionTest : public TestBase
+{
+};
+
+TEST_F(AdmissionTest, AdmitsWaitersInFifoOrder)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    common::admission_controller_t admission({.max_inflight = 2});
+    rfs_dataset_hndl_t             ds = dataset(1);
+    std::vector<unsigned>          order;
+    std::vector<test_waiter_t>     waiters;
+
+    for (unsigned i = 0; i < 5; i++)
+        waiters.emplace_back(&order, i);
+
+    EXPECT_EQ(admission.acquire(ds, &waiters[0]), RED_SUCCESS);
+    EXPECT_EQ(admission.acquire(ds, &waiters[1]), RED_SUCCESS);
+    for (unsigned i = 2; i < 5; i++)
+        EXPECT_EQ(admission.acquire(ds, &waiters[i]), RED_EINPROGRESS);
+
+    /* Nobody may overtake the queue */
+    EXPECT_EQ(admission.try_acquire(ds), RED_EAGAIN);
+    EXPECT_TRUE(order.empty());
+
+    admission.release(ds);
+    EXPECT_EQ(order, (std::vector<unsigned>{2}));
+    admission.release(ds);
+    admission.release(ds);
+    EXPECT_EQ(order, (std::vector<unsigned>{2, 3, 4}));
+
+    common::admission_stats_t stats = admission.stats(ds);
+    EXPECT_EQ(stats.depth, 2u);
+    EXPECT_EQ(stats.max_depth, 2u);
+    EXPECT_EQ(stats.queued, 0u);
+    EXPECT_EQ(stats.max_queued, 3u);
+    EXPECT_EQ(stats.admitted, 5u);
+    EXPECT_EQ(stats.waited, 3u);
+    EXPECT_EQ(stats.rejected, 1u);
+}
+
+TEST_F(AdmissionTest, LimitsArePerDataset)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    common::admission_controller_t admission({.max_inflight = 1});
+    rfs_dataset_hndl_t             a = dataset(1);
+    rfs_dataset_hndl_t             b = dataset(2);
+
+    admission.set_limits(b, {.max_inflight = 3});
+
+    EXPECT_EQ(admission.try_acquire(a), RED_SUCCESS);
+    EXPECT_EQ(admission.try_acquire(a), RED_EAGAIN);
+    for (unsigned i = 0; i < 3; i++)
+        EXPECT_EQ(admission.try_acquire(b), RED_SUCCESS);
+    EXPECT_EQ(admission.try_acquire(b), RED_EAGAIN);
+
+    unsigned datasets = 0;
+    admission.for_each([&](rfs_dataset_hndl_t, const common::admission_stats_t &stats) {
+        datasets++;
+        EXPECT_EQ(stats.rejected, 1u);
+    });
+    EXPECT_EQ(datasets, 2u);
+}
+
+TEST_F(AdmissionTest, FullQueueRejectsAndCancelRemoves)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    common::admission_controller_t admission({.max_inflight = 1, .max_queued = 2});
+    rfs_dataset_hndl_t             ds = dataset(1);
+    std::vector<unsigned>          order;
+    test_waiter_t                  w0(&order, 0), w1(&order, 1), w2(&order, 2), w3(&order, 3);
+
+    EXPECT_EQ(admission.acquire(ds, &w0), RED_SUCCESS);
+    EXPECT_EQ(admission.acquire(ds, &w1), RED_EINPROGRESS);
+    EXPECT_EQ(admission.acquire(ds, &w2), RED_EINPROGRESS);
+    EXPECT_EQ(admission.acquire(ds, &w3), RED_EAGAIN);
+
+    EXPECT_TRUE(admission.cancel(&w1));
+    EXPECT_FALSE(admission.cancel(&w1));
+
+    admission.release(ds);
+    EXPECT_EQ(order, (std::vector<unsigned>{2}));
+    EXPECT_FALSE(admission.cancel(&w2));
+
+    /* Raising the limit admits the waiters at once */
+    EXPECT_EQ(admission.acquire(ds, &w3), RED_EINPROGRESS);
+    admission.set_limits(ds, {.max_inflight = 2, .max_queued = 2});
+    EXPECT_EQ(order, (std::vector<unsigned>{2, 3}));
+    EXPECT_EQ(admission.stats(ds).rejected, 1u);
+}
@@ -25,9 +25,7 @@
  ******************************************************************************/
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
-#include "../../../examples/cpp/simple_s3/simple_s3_client.hpp"
-#include "mock_red_client.hpp"
-#include "test_utils.hpp"
+#include "s3_client_fixture.hpp"
 
 using ::testing::_;
 using ::testing::DoAll;
@@ -35,27 +33,6 @@ using ::testing::Return;
 using ::testing::SetArgPointee;
 using ::testing::StrEq;
 
-class RfsBasicTest : public TestBase
-{
-protected:
-    void SetUp() override
-    {
-        TestBase::SetUp(); /* Call base class setup */
-        mock_client = new MockRedClient();
-        client      = std::make_unique<s3client>(nullptr,
-                                                 std::unique_ptr<IRedClient>(mock_client));
-    }
-
-    void TearDown() override
-    {
-        client.reset();
-        TestBase::TearDown(); /* Call base class teardown */
-    }
-
-    MockRedClient            *mock_client;
-    std::unique_ptr<s3client> client;
-};
-
 TEST_F(RfsBasicTest, CreateBucket)
 {
     SetTestCategory(TestCategory::UNIT);
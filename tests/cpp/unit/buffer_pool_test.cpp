@@ -0,0 +1,282 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       buffer_pool_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the registered buffer pool
+ *
+ ******************************************************************************/
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "buffer_pool.hpp"
+#include "mock_red_client.hpp"
+#include "test_utils.hpp"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+
+namespace
+{
+
+/* Heap buffers, counted; fails once out of budget */
+struct test_source_t : common::buffer_source_t
+{
+    unsigned allocs = 0;
+    unsigned frees  = 0;
+    unsigned budget = ~0u;
+    void    *region = nullptr; /* Reported as the iomem handle of every buffer */
+
+    void *alloc(size_t size) override
+    {
+        if (allocs - frees == budget)
+            return nullptr;
+        allocs++;
+        return aligned_alloc(4096, size);
+    }
+
+    void free(void *buf) override
+    {
+        ::free(buf);
+        frees++;
+    }
+
+    red_iomem_hndl_t iomem(void *) override
+    {
+        return {region};
+    }
+};
+
+common::buffer_pool_config_t small_config(test_source_t *source)
+{
+    common::buffer_pool_config_t cfg;
+    cfg.buffer_size   = 5000;
+    cfg.magazine_size = 4;
+    cfg.trim_ns       = 0;
+    cfg.source        = source;
+    return cfg;
+}
+
+} // namespace
+
+class BufferPoolTest : public TestBase
+{
+};
+
+TEST_F(BufferPoolTest, ReusesBuffersFromTheThreadMagazines)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    test_source_t source;
+    {
+        common::buffer_pool_config_t cfg = small_config(&source);
+        cfg.max_buffers                  = 2;
+        common::buffer_pool_t  pool(cfg);
+        common::buffer_lease_t a;
+
+        EXPECT_EQ(pool.buffer_size(), 8192u);
+        ASSERT_EQ(pool.acquire(&a), RED_SUCCESS);
+        void *first = a.data();
+        EXPECT_EQ(a.size(), 8192u);
+        a.reset();
+        EXPECT_FALSE(a);
+
+        for (unsigned i = 0; i < 100; i++)
+        {
+            common::buffer_lease_t lease;
+            ASSERT_EQ(pool.acquire(&lease), RED_SUCCESS);
+            EXPECT_EQ(lease.data(), first);
+        }
+        EXPECT_EQ(source.allocs, 1u);
+        EXPECT_EQ(pool.stats().hits, 100u);
+
+        /* Past max_buffers the pool refuses rather than growing */
+        common::buffer_lease_t b;
+        common::buffer_lease_t c;
+        ASSERT_EQ(pool.acquire(&a), RED_SUCCESS);
+        ASSERT_EQ(pool.acquire(&b), RED_SUCCESS);
+        EXPECT_EQ(pool.acquire(&c), RED_EAGAIN);
+        EXPECT_EQ(pool.stats().failures, 1u);
+
+        /* Moving hands the buffer over without returning it */
+        common::buffer_lease_t moved = std::move(b);
+        EXPECT_FALSE(b);
+        EXPECT_TRUE(moved);
+        EXPECT_EQ(pool.acquire(&c), RED_EAGAIN);
+    }
+    EXPECT_EQ(source.frees, source.allocs);
+
+    /* A failing source surfaces as RED_ENOMEM */
+    source.budget = 0;
+    common::buffer_pool_t  pool(small_config(&source));
+    common::buffer_lease_t lease;
+    EXPECT_EQ(pool.acquire(&lease), RED_ENOMEM);
+    EXPECT_EQ(pool.stats().live, 0u);
+}
+
+TEST_F(BufferPoolTest, TrimsBuffersAboveTheHighWaterMark)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    test_source_t                       source;
+    common::buffer_pool_t               pool(small_config(&source));
+    std::vector<common::buffer_lease_t> leases(16);
+
+    for (common::buffer_lease_t &l : leases)
+        ASSERT_EQ(pool.acquire(&l), RED_SUCCESS);
+    leases.clear();
+
+    /* Two magazines of the thread are full, two more went to the depot */
+    common::buffer_pool_stats_t s = pool.stats();
+    EXPECT_EQ(s.live, 16u);
+    EXPECT_EQ(s.depot, 8u);
+
+    /* Nothing was idle for a whole interval yet */
+    EXPECT_EQ(pool.trim(), 0u);
+
+    /* Demand reaches one depot magazine; the one never touched is freed */
+    leases.resize(9);
+    for (common::buffer_lease_t &l : leases)
+        ASSERT_EQ(pool.acquire(&l), RED_SUCCESS);
+    leases.clear();
+    EXPECT_EQ(pool.trim(), 4u);
+
+    s = pool.stats();
+    EXPECT_EQ(s.live, 12u);
+    EXPECT_EQ(s.trimmed, 4u);
+    EXPECT_EQ(source.frees, 4u);
+    EXPECT_EQ(s.depot_hits, 1u);
+}
+
+TEST_F(BufferPoolTest, ExitingThreadReturnsItsMagazines)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    test_source_t          source;
+    common::buffer_pool_t  pool(small_config(&source));
+    common::buffer_lease_t handed;
+
+    std::thread worker([&] {
+        common::buffer_lease_t leases[3];
+        for (common::buffer_lease_t &l : leases)
+            ASSERT_EQ(pool.acquire(&l), RED_SUCCESS);
+        ASSERT_EQ(pool.acquire(&handed), RED_SUCCESS);
+    });
+    worker.join();
+
+    common::buffer_pool_stats_t s = pool.stats();
+    EXPECT_EQ(s.depot, 3u);
+    EXPECT_EQ(s.live, 4u);
+
+    /* Released on this thread, then all four served without allocating */
+    handed.reset();
+    std::vector<common::buffer_lease_t> leases(4);
+    for (common::buffer_lease_t &l : leases)
+        ASSERT_EQ(pool.acquire(&l), RED_SUCCESS);
+    EXPECT_EQ(source.allocs, 4u);
+    EXPECT_EQ(pool.stats().depot_hits, 1u);
+}
+
+TEST_F(BufferPoolTest, S3ClientReadsIntoPooledBuffer)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    test_source_t         source;
+    common::buffer_pool_t pool(small_config(&source));
+    auto                 *mock = new MockRedClient();
+    s3client              client(nullptr, std::unique_ptr<IRedClient>(mock));
+
+    rfs_dataset_hndl_t ds_hndl = {reinterpret_cast<void *>(1)};
+    rfs_open_hndl_t    root_oh = {2};
+    rfs_open_hndl_t    obj_oh  = {3};
+    ssize_t            got     = 100;
+
+    EXPECT_CALL(*mock, obtain_dataset(_, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<3>(ds_hndl), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock, open_root(ds_hndl, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(root_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock, openat(root_oh, _, _, _, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<4>(obj_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock, close(_, _)).WillRepeatedly(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock, close_dataset(ds_hndl, _)).WillOnce(Return(RED_SUCCESS));
+
+    auto                   bucket = client.create_bucket("infinia", "test_bucket");
+    common::buffer_lease_t buf;
+    ssize_t                bytes_read;
+
+    /* Without a pool an empty lease cannot be filled */
+    EXPECT_EQ(client.get_object(bucket, "obj", &buf, &bytes_read), RED_EINVAL);
+
+    client.set_buffer_pool(&pool);
+    EXPECT_CALL(*mock, pread(obj_oh, _, pool.buffer_size(), 0, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(got), Return(RED_SUCCESS)));
+    ASSERT_EQ(client.get_object(bucket, "obj", &buf, &bytes_read), RED_SUCCESS);
+    EXPECT_TRUE(buf);
+    EXPECT_EQ(bytes_read, got);
+
+    /* The same registered buffer goes back out as the object's data */
+    EXPECT_CALL(*mock, pwrite(obj_oh, buf.data(), 100, 0, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(got), Return(RED_SUCCESS)));
+    EXPECT_EQ(client.put_object(bucket, "copy", buf, 100), RED_SUCCESS);
+    EXPECT_EQ(client.put_object(bucket, "copy", buf, buf.size() + 1), RED_EINVAL);
+}
+
+TEST_F(BufferPoolTest, S3ClientPassesLeaseIomem)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    test_source_t source;
+    source.region = reinterpret_cast<void *>(4);
+    common::buffer_pool_t pool(small_config(&source));
+    auto                 *mock = new MockRedClient();
+    s3client              client(nullptr, std::unique_ptr<IRedClient>(mock));
+
+    rfs_dataset_hndl_t ds_hndl = {reinterpret_cast<void *>(1)};
+    rfs_open_hndl_t    root_oh = {2};
+    rfs_open_hndl_t    obj_oh  = {3};
+    red_iomem_hndl_t   iomem   = {source.region};
+    ssize_t            got     = 100;
+
+    EXPECT_CALL(*mock, obtain_dataset(_, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<3>(ds_hndl), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock, open_root(ds_hndl, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(root_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock, openat(root_oh, _, _, _, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<4>(obj_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock, close(_, _)).WillRepeatedly(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock, close_dataset(ds_hndl, _)).WillOnce(Return(RED_SUCCESS));
+
+    auto                   bucket = client.create_bucket("infinia", "test_bucket");
+    common::buffer_lease_t buf;
+    ssize_t                bytes_read;
+
+    /* Leases of an iomem source go zero-copy both ways, with their region */
+    client.set_buffer_pool(&pool);
+    client.set_zero_copy_threshold(0);
+    EXPECT_CALL(*mock, pread_iomem(obj_oh, iomem, _, pool.buffer_size(), 0, _, _))
+        .WillOnce(DoAll(SetArgPointee<5>(got), Return(RED_SUCCESS)));
+    ASSERT_EQ(client.get_object(bucket, "obj", &buf, &bytes_read), RED_SUCCESS);
+    EXPECT_EQ(buf.iomem().hndl, source.region);
+
+    EXPECT_CALL(*mock, pwrite_iomem(obj_oh, iomem, buf.data(), 100, 0, _, _))
+        .WillOnce(DoAll(SetArgPointee<5>(got), Return(RED_SUCCESS)));
+    EXPECT_EQ(client.put_object(bucket, "copy", buf, 100), RED_SUCCESS);
+}
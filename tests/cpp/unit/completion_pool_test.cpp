@@ -0,0 +1,231 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       completion_pool_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the per-thread completion context pool
+ *
+ ******************************************************************************/
+#include <chrono>
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "completion_pool.hpp"
+#include "completion_slot.hpp"
+#include "test_utils.hpp"
+
+/* Count the heap allocations made by each thread */
+namespace
+{
+thread_local uint64_t tls_allocations = 0;
+} // namespace
+
+void *operator new(size_t size)
+{
+    tls_allocations++;
+    void *p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept
+{
+    free(p);
+}
+
+namespace
+{
+
+/* Run the callback the library would run for @p ucb */
+void complete(const rfs_usercb_t &ucb, red_status_t status)
+{
+    ucb.ucb_fun(status, ucb.ucb_arg);
+}
+
+void count_and_release(common::completion_ctx_t *ctx)
+{
+    (*static_cast<unsigned *>(ctx->waiter))++;
+    ctx->release();
+}
+
+} // namespace
+
+class CompletionPoolTest : public TestBase
+{
+};
+
+TEST_F(CompletionPoolTest, SteadyStateDoesNotAllocate)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    constexpr unsigned DEPTH = 32;
+    constexpr unsigned OPS   = 100000;
+
+    common::completion_pool_t &pool      = common::completion_pool_t::local();
+    unsigned                   completed = 0;
+    rfs_usercb_t               in_flight[DEPTH];
+
+    /* Create the pool's first slab and the thread's reactor */
+    pool.reserve(DEPTH);
+    common::completion_slot_t *warm = common::completion_slot_t::acquire();
+    complete(*warm->usercb(), RED_SUCCESS);
+    warm->release();
+
+    uint64_t before = tls_allocations;
+    for (unsigned i = 0; i < OPS / DEPTH; i++)
+    {
+        for (unsigned d = 0; d < DEPTH; d++)
+            in_flight[d] = *pool.acquire(count_and_release, &completed)->ucb();
+        for (unsigned d = 0; d < DEPTH; d++)
+            complete(in_flight[d], RED_SUCCESS);
+    }
+
+    /* The path taken by a synchronous wrapper called with a deadline */
+    for (unsigned i = 0; i < OPS; i++)
+    {
+        common::completion_slot_t *slot = common::completion_slot_t::acquire();
+        complete(*slot->usercb(), RED_SUCCESS);
+        ASSERT_TRUE(slot->completed.load());
+        slot->release();
+    }
+
+    EXPECT_EQ(tls_allocations - before, 0u);
+    EXPECT_EQ(completed, OPS / DEPTH * DEPTH);
+    EXPECT_EQ(pool.stats().in_use, 0u);
+}
+
+TEST_F(CompletionPoolTest, StaleCallbackIsDropped)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    common::completion_pool_t &pool      = common::completion_pool_t::local();
+    unsigned                   completed = 0;
+    uint64_t                   stale     = common::completion_pool_t::stale_callbacks();
+
+    common::completion_ctx_t *ctx = pool.acquire(count_and_release, &completed);
+    rfs_usercb_t              old = *ctx->ucb();
+    complete(old, RED_SUCCESS);
+    EXPECT_EQ(completed, 1u);
+
+    /* A second callback for the released context */
+    complete(old, RED_SUCCESS);
+    EXPECT_EQ(completed, 1u);
+    EXPECT_EQ(common::completion_pool_t::stale_callbacks(), stale + 1);
+
+    /* The context is reused: only its new token reaches the new owner */
+    common::completion_ctx_t *reused = pool.acquire(count_and_release, &completed);
+    EXPECT_EQ(reused, ctx);
+    rfs_usercb_t current = *reused->ucb();
+    complete(old, RED_EIO);
+    EXPECT_EQ(completed, 1u);
+    EXPECT_EQ(common::completion_pool_t::stale_callbacks(), stale + 2);
+    complete(current, RED_SUCCESS);
+    EXPECT_EQ(completed, 2u);
+}
+
+TEST_F(CompletionPoolTest, RemoteReleaseReturnsContexts)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    constexpr unsigned COUNT = 200;
+
+    common::completion_pool_t              &pool = common::completion_pool_t::local();
+    std::vector<common::completion_ctx_t *> ctxs;
+
+    pool.reserve(COUNT);
+    uint64_t capacity = pool.stats().capacity;
+    uint64_t remote   = pool.stats().remote_frees;
+
+    for (unsigned i = 0; i < COUNT; i++)
+        ctxs.push_back(pool.acquire([](common::completion_ctx_t *) {}));
+
+    /* Callbacks on another thread, as with the poller thread */
+    std::thread poller([&] {
+        for (common::completion_ctx_t *ctx : ctxs)
+        {
+            complete(*ctx->ucb(), RED_SUCCESS);
+            ctx->release();
+        }
+    });
+    poller.join();
+
+    for (unsigned i = 0; i < COUNT; i++)
+        ctxs[i] = pool.acquire([](common::completion_ctx_t *) {});
+    for (common::completion_ctx_t *ctx : ctxs)
+        ctx->release();
+
+    EXPECT_EQ(pool.stats().capacity, capacity);
+    EXPECT_EQ(pool.stats().remote_frees - remote, COUNT);
+    EXPECT_EQ(pool.stats().in_use, 0u);
+}
+
+TEST_F(CompletionPoolTest, LateCompletionAfterThreadExitIsClosed)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    common::deadline_stats_t before = common::deadline_stats();
+    rfs_usercb_t             ucb    = {};
+
+    /* The waiter gives up at its deadline and exits before the operation completes */
+    std::thread waiter([&] {
+        common::completion_slot_t *slot = common::completion_slot_t::acquire();
+        rfs_dataset_hndl_t         ds   = {};
+        slot->stage(&ds, sizeof(ds), common::completion_slot_t::cleanup_e::CLOSE_DATASET);
+        ucb = *slot->usercb();
+        ASSERT_TRUE(slot->abandon());
+        slot->release();
+    });
+    waiter.join();
+
+    /* The late completion arrives on another thread, as with the poller thread */
+    complete(ucb, RED_SUCCESS);
+
+    /* Its handle is closed by the orphan thread rather than the exited one */
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (common::deadline_stats().late_closed == before.late_closed &&
+           std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    common::deadline_stats_t after = common::deadline_stats();
+    EXPECT_EQ(after.timeouts - before.timeouts, 1u);
+    EXPECT_EQ(after.late - before.late, 1u);
+    EXPECT_EQ(after.late_closed - before.late_closed, 1u);
+}
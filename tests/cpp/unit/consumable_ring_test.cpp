@@ -0,0 +1,124 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       consumable_ring_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the reusable queue consumable array
+ *
+ ******************************************************************************/
+#include <cstring>
+#include <gtest/gtest.h>
+
+#include "consumable_ring.hpp"
+#include "test_utils.hpp"
+
+namespace
+{
+
+/* What red_q_get() does to the consumables it fills */
+void deliver(red_q_consumable_t *consumables, uint64_t count)
+{
+    static char other[8] = "elsewhr";
+    for (uint64_t i = 0; i < count; i++)
+    {
+        memset(consumables[i].rqo_msg.rqm_data, 'm', 3);
+        consumables[i].rqo_msg.rqm_size = 3;
+        consumables[i].rqo_gtx.rqt_tick = i;
+    }
+    if (count != 0)
+        consumables[0].rqo_msg.rqm_data = other;
+}
+
+} // namespace
+
+class ConsumableRingTest : public TestBase
+{
+};
+
+TEST_F(ConsumableRingTest, ReusesTheArrayAcrossBatches)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    common::consumable_ring_t ring({.initial = 4, .max = 4, .msg_size = 32});
+    red_q_consumable_t       *consumables;
+    uint64_t                  size;
+
+    ASSERT_EQ(ring.prepare(&consumables, &size), RED_SUCCESS);
+    ASSERT_EQ(size, 4u);
+    char *payload = consumables[0].rqo_msg.rqm_data;
+    for (uint64_t i = 0; i < size; i++)
+    {
+        EXPECT_EQ(consumables[i].rqo_msg.rqm_data, payload + i * 32);
+        EXPECT_EQ(consumables[i].rqo_msg.rqm_size, 32u);
+    }
+
+    deliver(consumables, 2);
+    ring.complete(2);
+    EXPECT_EQ(ring.count(), 2u);
+    EXPECT_EQ(ring.end() - ring.begin(), 2);
+    EXPECT_EQ(ring[1].rqo_msg.rqm_size, 3u);
+    EXPECT_EQ(ring[1].rqo_gtx.rqt_tick, 1u);
+
+    /* Same array and payload, pointed back at the slots */
+    red_q_consumable_t *again;
+    ASSERT_EQ(ring.prepare(&again, &size), RED_SUCCESS);
+    EXPECT_EQ(again, consumables);
+    EXPECT_EQ(ring.count(), 0u);
+    EXPECT_EQ(again[0].rqo_msg.rqm_data, payload);
+    EXPECT_EQ(again[1].rqo_msg.rqm_size, 32u);
+
+    common::consumable_ring_stats_t s = ring.stats();
+    EXPECT_EQ(s.batches, 1u);
+    EXPECT_EQ(s.full, 0u);
+    EXPECT_EQ(s.grows, 0u);
+    EXPECT_EQ(s.high_water, 2u);
+    EXPECT_EQ(s.capacity, 4u);
+}
+
+TEST_F(ConsumableRingTest, GrowsAfterFullBatchesUpToMax)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    common::consumable_ring_t ring({.initial = 2, .max = 5, .msg_size = 16});
+    red_q_consumable_t       *consumables;
+    uint64_t                  size;
+
+    /* 2 -> 4 -> 5, then full batches at max leave it alone */
+    for (uint64_t expected : {2u, 4u, 5u, 5u})
+    {
+        ASSERT_EQ(ring.prepare(&consumables, &size), RED_SUCCESS);
+        ASSERT_EQ(size, expected);
+        EXPECT_EQ(ring.capacity(), expected);
+        for (uint64_t i = 0; i < size; i++)
+            EXPECT_EQ(consumables[i].rqo_msg.rqm_size, 16u);
+        deliver(consumables, size);
+        ring.complete(size);
+    }
+
+    common::consumable_ring_stats_t s = ring.stats();
+    EXPECT_EQ(s.batches, 4u);
+    EXPECT_EQ(s.full, 4u);
+    EXPECT_EQ(s.grows, 2u);
+    EXPECT_EQ(s.high_water, 5u);
+
+    /* A short batch does not grow it either */
+    ASSERT_EQ(ring.prepare(&consumables, &size), RED_SUCCESS);
+    ring.complete(1);
+    ASSERT_EQ(ring.prepare(&consumables, &size), RED_SUCCESS);
+    EXPECT_EQ(size, 5u);
+    EXPECT_EQ(ring.stats().high_water, 5u);
+}
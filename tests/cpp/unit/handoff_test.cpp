@@ -0,0 +1,180 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       handoff_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the SPSC ring and the reactor's handoff mode
+ *
+ ******************************************************************************/
+#include <atomic>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "reactor.hpp"
+#include "spsc_ring.hpp"
+#include "test_utils.hpp"
+
+namespace
+{
+
+struct handed_t
+{
+    std::vector<unsigned> order;
+    std::thread::id       owner;
+    bool                  elsewhere = false;
+    std::atomic<bool>     done{false};
+};
+
+struct entry_t
+{
+    handed_t *h;
+    unsigned  id;
+    bool      last;
+};
+
+void run_entry(void *arg)
+{
+    auto *e = static_cast<entry_t *>(arg);
+    e->h->order.push_back(e->id);
+    if (std::this_thread::get_id() != e->h->owner)
+        e->h->elsewhere = true;
+    if (e->last)
+        e->h->done.store(true, std::memory_order_release);
+}
+
+} // namespace
+
+class HandoffTest : public TestBase
+{
+};
+
+TEST_F(HandoffTest, SpscRingKeepsOrderAndBound)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    common::spsc_ring_t<unsigned> small(3);
+    unsigned                      v;
+
+    EXPECT_EQ(small.capacity(), 4u);
+    for (unsigned i = 0; i < 4; i++)
+        EXPECT_TRUE(small.push(i));
+    EXPECT_FALSE(small.push(4));
+    EXPECT_TRUE(small.pop(&v));
+    EXPECT_EQ(v, 0u);
+    EXPECT_TRUE(small.push(4));
+
+    constexpr unsigned            COUNT = 100000;
+    common::spsc_ring_t<unsigned> ring(64);
+    std::thread                   producer([&] {
+        for (unsigned i = 0; i < COUNT; i++)
+            while (!ring.push(i))
+                std::this_thread::yield();
+    });
+
+    unsigned expected = 0;
+    bool     in_order = true;
+    while (expected < COUNT)
+    {
+        if (!ring.pop(&v))
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        in_order = in_order && v == expected;
+        expected++;
+    }
+    producer.join();
+    EXPECT_TRUE(in_order);
+    EXPECT_TRUE(ring.empty());
+}
+
+TEST_F(HandoffTest, EntriesRunOnTheOwningThread)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    constexpr unsigned COUNT = 500;
+
+    common::reactor_t    &reactor = common::reactor_t::local();
+    common::wait_policy_t saved   = reactor.policy();
+    handed_t              h;
+    std::vector<entry_t>  entries(COUNT);
+
+    h.owner = std::this_thread::get_id();
+    for (unsigned i = 0; i < COUNT; i++)
+        entries[i] = {&h, i, i == COUNT - 1};
+
+    /* Off by default: the caller falls back to post() */
+    EXPECT_FALSE(reactor.handoff(run_entry, &entries[0]));
+
+    common::wait_policy_t policy = saved;
+    policy.handoff               = true;
+    reactor.set_policy(policy);
+
+    bool              refused = false;
+    std::atomic<bool> checked{false};
+    std::thread       producer([&] {
+        for (entry_t &e : entries)
+        {
+            while (!reactor.handoff(run_entry, &e))
+            {
+                /* Only a full ring refuses the elected producer */
+                std::this_thread::yield();
+            }
+        }
+        while (!checked.load())
+            std::this_thread::yield();
+    });
+    EXPECT_EQ(reactor.wait(h.done), RED_SUCCESS);
+
+    /* The ring has one producer; other threads are turned away while it lives */
+    std::thread other([&] { refused = !reactor.handoff(run_entry, &entries[0]); });
+    other.join();
+    checked.store(true);
+    producer.join();
+
+    EXPECT_TRUE(refused);
+    EXPECT_FALSE(h.elsewhere);
+    ASSERT_EQ(h.order.size(), COUNT);
+    for (unsigned i = 0; i < COUNT; i++)
+        EXPECT_EQ(h.order[i], i);
+
+    reactor.set_policy(saved);
+}
+
+TEST_F(HandoffTest, WaitStatsCountEveryWait)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    /* A thread of its own, for a reactor with no waits behind it */
+    std::thread waiter([] {
+        common::reactor_t &reactor = common::reactor_t::local();
+        std::atomic<bool>  done{true};
+
+        EXPECT_EQ(reactor.wait(done), RED_SUCCESS);
+        EXPECT_EQ(reactor.spin_stats().waits, 1u);
+        EXPECT_EQ(reactor.spin_stats().samples, 1u);
+
+        /* A timed out wait counts, but is no latency sample */
+        done.store(false);
+        EXPECT_EQ(reactor.wait(done, common::deadline_after(std::chrono::milliseconds(1))),
+                  RED_ETIMEDOUT);
+        EXPECT_EQ(reactor.spin_stats().waits, 2u);
+        EXPECT_EQ(reactor.spin_stats().samples, 1u);
+    });
+    waiter.join();
+}
@@ -0,0 +1,201 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       iomem_arena_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the size-classed iomem arena
+ *
+ ******************************************************************************/
+#include <cstdlib>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "iomem_arena.hpp"
+#include "test_utils.hpp"
+
+namespace
+{
+
+/* Regions from aligned_alloc(), counted */
+struct test_provider_t : common::iomem_provider_t
+{
+    unsigned allocs = 0;
+    unsigned frees  = 0;
+
+    red_status_t alloc(size_t size, red_iomem_hndl_t *iomem, void **base) override
+    {
+        *base = aligned_alloc(4096, size);
+        if (*base == nullptr)
+            return RED_ENOMEM;
+        iomem->hndl = *base;
+        allocs++;
+        return RED_SUCCESS;
+    }
+
+    void free(red_iomem_hndl_t, void *base, size_t) override
+    {
+        ::free(base);
+        frees++;
+    }
+};
+
+common::iomem_arena_config_t small_config(test_provider_t *provider)
+{
+    common::iomem_arena_config_t cfg;
+    cfg.region_size = common::IOMEM_MAX_CLASS;
+    cfg.reserve     = 0;
+    cfg.cache_bytes = 64 << 10;
+    cfg.provider    = provider;
+    return cfg;
+}
+
+} // namespace
+
+class IomemArenaTest : public TestBase
+{
+};
+
+TEST_F(IomemArenaTest, RoundsUpToSizeClasses)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    test_provider_t provider;
+    {
+        common::iomem_arena_t arena(small_config(&provider));
+        common::iomem_lease_t a;
+        common::iomem_lease_t b;
+        common::iomem_lease_t c;
+
+        EXPECT_EQ(arena.acquire(0, &a), RED_EINVAL);
+        EXPECT_EQ(arena.acquire(common::IOMEM_MAX_CLASS + 1, &a), RED_EINVAL);
+        EXPECT_FALSE(a);
+
+        ASSERT_EQ(arena.acquire(5000, &a), RED_SUCCESS);
+        ASSERT_EQ(arena.acquire(4096, &b), RED_SUCCESS);
+        ASSERT_EQ(arena.acquire(common::IOMEM_MAX_CLASS, &c), RED_SUCCESS);
+        EXPECT_EQ(a.size(), 5000u);
+        EXPECT_EQ(a.capacity(), 8192u);
+        EXPECT_EQ(b.capacity(), 4096u);
+        EXPECT_EQ(c.capacity(), common::IOMEM_MAX_CLASS);
+
+        /* Blocks are aligned to their class in the region and resolve to it */
+        EXPECT_EQ(a.offset() % 8192, 0);
+        EXPECT_EQ(static_cast<char *>(a.addr()) - a.offset(),
+                  static_cast<char *>(a.iomem().hndl));
+        EXPECT_EQ(static_cast<char *>(c.addr()) - c.offset(),
+                  static_cast<char *>(c.iomem().hndl));
+
+        common::iomem_arena_stats_t s = arena.stats();
+        EXPECT_EQ(s.in_use, 8192u + 4096u + common::IOMEM_MAX_CLASS);
+        EXPECT_EQ(s.requested, 5000u + 4096u + common::IOMEM_MAX_CLASS);
+        EXPECT_GT(s.internal_fragmentation(), 0.0);
+
+        /* Moving hands over the block without releasing it */
+        common::iomem_lease_t moved = std::move(a);
+        EXPECT_FALSE(a);
+        EXPECT_TRUE(moved);
+        EXPECT_EQ(arena.stats().in_use, s.in_use);
+
+        moved.reset();
+        b.reset();
+        c.reset();
+        s = arena.stats();
+        EXPECT_EQ(s.in_use, 0u);
+        EXPECT_EQ(s.requested, 0u);
+        EXPECT_EQ(s.cached + s.free, s.carved);
+    }
+    EXPECT_EQ(provider.frees, provider.allocs);
+}
+
+TEST_F(IomemArenaTest, ReusesCachedBlocksAndHonorsMaxBytes)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    test_provider_t              provider;
+    common::iomem_arena_config_t cfg = small_config(&provider);
+    cfg.max_bytes                    = 2 * common::IOMEM_MAX_CLASS;
+
+    common::iomem_arena_t arena(cfg);
+    void                 *first;
+    {
+        common::iomem_lease_t lease;
+        ASSERT_EQ(arena.acquire(4096, &lease), RED_SUCCESS);
+        first = lease.addr();
+    }
+
+    /* Last released, first reused: the block is still warm */
+    for (unsigned i = 0; i < 100; i++)
+    {
+        common::iomem_lease_t lease;
+        ASSERT_EQ(arena.acquire(4096, &lease), RED_SUCCESS);
+        EXPECT_EQ(lease.addr(), first);
+    }
+    common::iomem_arena_stats_t s = arena.stats();
+    EXPECT_EQ(s.misses, 1u);
+    EXPECT_EQ(s.hits, 100u);
+    EXPECT_EQ(s.regions, 1u);
+
+    /* Two regions at most: a third largest block does not fit */
+    common::iomem_lease_t big[3];
+    EXPECT_EQ(arena.acquire(common::IOMEM_MAX_CLASS, &big[0]), RED_SUCCESS);
+    EXPECT_EQ(arena.acquire(common::IOMEM_MAX_CLASS, &big[1]), RED_ENOMEM);
+    EXPECT_EQ(arena.stats().reserved, cfg.max_bytes);
+
+    /* Once given back, it is found again without mapping more */
+    big[0].reset();
+    EXPECT_EQ(arena.acquire(common::IOMEM_MAX_CLASS, &big[2]), RED_SUCCESS);
+    EXPECT_EQ(provider.allocs, 2u);
+}
+
+TEST_F(IomemArenaTest, ExitingThreadReturnsItsCache)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    test_provider_t       provider;
+    common::iomem_arena_t arena(small_config(&provider));
+    common::iomem_lease_t handed;
+
+    std::thread worker([&] {
+        common::iomem_lease_t leases[8];
+        for (common::iomem_lease_t &l : leases)
+            ASSERT_EQ(arena.acquire(16384, &l), RED_SUCCESS);
+        ASSERT_EQ(arena.acquire(16384, &handed), RED_SUCCESS);
+    });
+    worker.join();
+
+    /* The worker's free blocks went back to the shared lists, its counters stay */
+    common::iomem_arena_stats_t s = arena.stats();
+    EXPECT_EQ(s.cached, 0u);
+    EXPECT_EQ(s.in_use, 16384u);
+    EXPECT_EQ(s.free, s.carved - s.in_use);
+    EXPECT_EQ(s.hits + s.misses, 9u);
+
+    /* A lease may be released by another thread than the one that took it */
+    handed.reset();
+    s = arena.stats();
+    EXPECT_EQ(s.in_use, 0u);
+    EXPECT_EQ(s.cached, 16384u);
+
+    unsigned regions = provider.allocs;
+    for (unsigned i = 0; i < 8; i++)
+    {
+        common::iomem_lease_t l;
+        ASSERT_EQ(arena.acquire(16384, &l), RED_SUCCESS);
+    }
+    EXPECT_EQ(provider.allocs, regions);
+}
@@ -0,0 +1,243 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       lane_scheduler_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the lane scheduler
+ *
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <sys/uio.h>
+#include <vector>
+
+#include "lane_scheduler.hpp"
+#include "test_utils.hpp"
+
+namespace
+{
+
+/* Records what would be handed to the library instead of submitting it */
+class test_scheduler_t : public common::lane_scheduler_t
+{
+public:
+    struct issued_t
+    {
+        common::lane_request_t *req;
+        int                     flags;
+    };
+
+    using common::lane_scheduler_t::lane_scheduler_t;
+
+    /* Complete the oldest operation still in flight */
+    void finish(red_status_t rs = RED_SUCCESS)
+    {
+        common::lane_request_t *req = issued[finished++].req;
+        complete(req, rs);
+    }
+
+    std::vector<issued_t> issued;
+    size_t                finished = 0;
+    red_status_t          reject   = RED_SUCCESS; /* Refuse the next issue() */
+
+protected:
+    red_status_t issue(common::lane_request_t *req, int flags) override
+    {
+        red_status_t rs = reject;
+        reject          = RED_SUCCESS;
+        if (rs != RED_SUCCESS)
+            return rs;
+        issued.push_back({req, flags});
+        return RED_SUCCESS;
+    }
+};
+
+struct op_t
+{
+    common::lane_request_t req;
+    struct red_iovec       iov;
+    std::vector<int>      *done;
+    red_status_t           rs;
+};
+
+void on_done(common::lane_request_t *req, red_status_t rs)
+{
+    auto *op = static_cast<op_t *>(req->arg);
+    op->rs   = rs;
+    op->done->push_back(req->lane);
+}
+
+void init_op(op_t *op, common::lane_e lane, size_t size, std::vector<int> *done)
+{
+    op->iov        = {nullptr, size, 0};
+    op->req        = {};
+    op->req.iov    = &op->iov;
+    op->req.iovcnt = 1;
+    op->req.write  = lane == common::LANE_BULK;
+    op->req.lane   = lane;
+    op->req.done   = on_done;
+    op->req.arg    = op;
+    op->done       = done;
+    op->rs         = RED_EINPROGRESS;
+}
+
+} // namespace
+
+class LaneSchedulerTest : public TestBase
+{
+};
+
+TEST_F(LaneSchedulerTest, HighLaneIsSubmittedWithHipri)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    test_scheduler_t sched;
+    std::vector<int> done;
+    op_t             high, normal, bulk;
+
+    init_op(&high, common::LANE_HIGH, 4096, &done);
+    init_op(&normal, common::LANE_NORMAL, 4096, &done);
+    init_op(&bulk, common::LANE_BULK, 1 << 20, &done);
+    bulk.req.flags = RWF_DSYNC;
+
+    EXPECT_EQ(sched.submit(&high.req), RED_SUCCESS);
+    EXPECT_EQ(sched.submit(&normal.req), RED_SUCCESS);
+    EXPECT_EQ(sched.submit(&bulk.req), RED_SUCCESS);
+
+    ASSERT_EQ(sched.issued.size(), 3u);
+    EXPECT_EQ(sched.issued[0].flags, RWF_HIPRI);
+    EXPECT_EQ(sched.issued[1].flags, 0);
+    EXPECT_EQ(sched.issued[2].flags, RWF_DSYNC);
+
+    /* An incomplete request is refused without touching the lanes */
+    op_t bad;
+    init_op(&bad, common::LANE_HIGH, 4096, &done);
+    bad.req.iovcnt = 0;
+    EXPECT_EQ(sched.submit(&bad.req), RED_EINVAL);
+
+    for (int i = 0; i < 3; i++)
+        sched.finish();
+    EXPECT_EQ(done, (std::vector<int>{common::LANE_HIGH, common::LANE_NORMAL, common::LANE_BULK}));
+    EXPECT_EQ(sched.stats(common::LANE_BULK).bytes, 1u << 20);
+    EXPECT_EQ(sched.stats(common::LANE_HIGH).in_flight, 0u);
+}
+
+TEST_F(LaneSchedulerTest, LanesShareSlotsByWeight)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    common::lane_scheduler_config_t cfg;
+    cfg.max_inflight                    = 1;
+    cfg.quantum                         = 4096;
+    cfg.lanes[common::LANE_HIGH].weight = 3;
+    cfg.lanes[common::LANE_BULK].weight = 1;
+
+    test_scheduler_t  sched(cfg);
+    std::vector<int>  done;
+    std::vector<op_t> ops(10);
+
+    /* The first write takes the only slot, the rest queue behind it */
+    init_op(&ops[0], common::LANE_BULK, 4096, &done);
+    sched.submit(&ops[0].req);
+    for (int i = 1; i < 7; i++)
+        init_op(&ops[i], common::LANE_HIGH, 4096, &done);
+    for (int i = 7; i < 10; i++)
+        init_op(&ops[i], common::LANE_BULK, 4096, &done);
+    for (int i = 1; i < 10; i++)
+        sched.submit(&ops[i].req);
+    EXPECT_EQ(sched.issued.size(), 1u);
+    EXPECT_EQ(sched.stats(common::LANE_HIGH).queued, 6u);
+
+    std::vector<int> order;
+    for (int i = 0; i < 10; i++)
+    {
+        sched.finish();
+        if (sched.issued.size() > sched.finished)
+            order.push_back(sched.issued[sched.finished].req->lane);
+    }
+
+    /* Three high-lane reads for each bulk write while both lanes have work */
+    constexpr int H = common::LANE_HIGH;
+    constexpr int B = common::LANE_BULK;
+    EXPECT_EQ(order, (std::vector<int>{H, H, H, B, H, H, H, B, B}));
+    EXPECT_EQ(done.size(), 10u);
+}
+
+TEST_F(LaneSchedulerTest, BulkCapAndRejectedSubmissions)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    common::lane_scheduler_config_t cfg;
+    cfg.lanes[common::LANE_BULK].max_inflight = 1;
+
+    test_scheduler_t  sched(cfg);
+    std::vector<int>  done;
+    std::vector<op_t> bulk(3);
+    op_t              high;
+
+    for (op_t &op : bulk)
+    {
+        init_op(&op, common::LANE_BULK, 1 << 20, &done);
+        sched.submit(&op.req);
+    }
+    init_op(&high, common::LANE_HIGH, 4096, &done);
+    sched.submit(&high.req);
+
+    /* Only one write is handed out; the read does not wait for the others */
+    ASSERT_EQ(sched.issued.size(), 2u);
+    EXPECT_EQ(sched.issued[1].req, &high.req);
+    EXPECT_EQ(sched.stats(common::LANE_BULK).queued, 2u);
+
+    /* A write the library refuses completes at once and frees its slot */
+    sched.reject = RED_EAGAIN;
+    sched.finish();
+    EXPECT_EQ(bulk[0].rs, RED_SUCCESS);
+    EXPECT_EQ(bulk[1].rs, RED_EAGAIN);
+    ASSERT_EQ(sched.issued.size(), 3u);
+    EXPECT_EQ(sched.issued[2].req, &bulk[2].req);
+
+    sched.finish();
+    sched.finish();
+    EXPECT_EQ(bulk[2].rs, RED_SUCCESS);
+    EXPECT_EQ(sched.stats(common::LANE_BULK).completed, 3u);
+    EXPECT_EQ(sched.stats(common::LANE_BULK).submitted, 3u);
+}
+
+TEST_F(LaneSchedulerTest, ZeroLaneLimitsAreClamped)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    common::lane_scheduler_config_t cfg;
+    cfg.lanes[common::LANE_BULK] = {0, 0};
+
+    test_scheduler_t  sched(cfg);
+    std::vector<int>  done;
+    std::vector<op_t> bulk(2);
+
+    for (op_t &op : bulk)
+    {
+        init_op(&op, common::LANE_BULK, 1 << 20, &done);
+        sched.submit(&op.req);
+    }
+
+    /* A lane without weight or slots still dispatches, one operation at a time */
+    ASSERT_EQ(sched.issued.size(), 1u);
+    sched.finish();
+    ASSERT_EQ(sched.issued.size(), 2u);
+    sched.finish();
+    EXPECT_EQ(bulk[0].rs, RED_SUCCESS);
+    EXPECT_EQ(bulk[1].rs, RED_SUCCESS);
+}
@@ -17,7 +17,7 @@
  *   Name:       mock_red_client.hpp
  *   Project:    RED
  *
- *   Description: Mock implementation of IRedClient for testing
+ *   Description: Mock implementations of IRedClient and IAsyncRedClient for testing
  *
  *   Created:    3/19/2025
  *   Author(s):  Bryant Ly (bly@ddn.com)
@@ -40,6 +40,11 @@ inline bool operator==(const rfs_open_hndl_t &a, const rfs_open_hndl_t &b)
     return a.fd == b.fd;
 }
 
+inline bool operator==(const red_iomem_hndl_t &a, const red_iomem_hndl_t &b)
+{
+    return a.hndl == b.hndl;
+}
+
 class MockRedClient : public IRedClient
 {
 public:
@@ -84,6 +89,26 @@ public:
                  ssize_t        *bytes_read,
                  red_api_user_t *user),
                 (override));
+    MOCK_METHOD(red_status_t,
+                pwrite_iomem,
+                (rfs_open_hndl_t  oh,
+                 red_iomem_hndl_t iomem,
+                 void            *addr,
+                 size_t           count,
+                 off_t            offset,
+                 ssize_t         *bytes_written,
+                 red_api_user_t  *user),
+                (override));
+    MOCK_METHOD(red_status_t,
+                pread_iomem,
+                (rfs_open_hndl_t  oh,
+                 red_iomem_hndl_t iomem,
+                 void            *addr,
+                 size_t           count,
+                 off_t            offset,
+                 ssize_t         *bytes_read,
+                 red_api_user_t  *user),
+                (override));
     MOCK_METHOD(red_status_t,
                 close,
                 (rfs_open_hndl_t oh, red_api_user_t *user),
@@ -94,4 +119,196 @@ public:
                 (override));
 };
 
+/*
+ * Mock of IAsyncRedClient. Complete a call inline with
+ * InvokeArgument<N>(status) on its red_done_t argument, or save the
+ * continuation with SaveArg<N>() and run it later to keep calls in flight.
+ */
+class MockAsyncRedClient : public IAsyncRedClient
+{
+public:
+    MOCK_METHOD(red_status_t,
+                obtain_dataset,
+                (const char         *name,
+                 const char         *cluster,
+                 red_ds_props_t     *props,
+                 rfs_dataset_hndl_t *hndl,
+                 red_api_user_t     *user,
+                 red_done_t          done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                open_root,
+                (rfs_dataset_hndl_t ds_hndl,
+                 rfs_open_hndl_t   *root_oh,
+                 red_api_user_t    *user,
+                 red_done_t         done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                openat,
+                (rfs_open_hndl_t  dir_oh,
+                 const char      *path,
+                 int              flags,
+                 mode_t           mode,
+                 rfs_open_hndl_t *oh,
+                 red_api_user_t  *user,
+                 red_done_t       done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                pwrite,
+                (rfs_open_hndl_t oh,
+                 void           *buf,
+                 size_t          count,
+                 off_t           offset,
+                 ssize_t        *bytes_written,
+                 red_api_user_t *user,
+                 red_done_t      done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                pread,
+                (rfs_open_hndl_t oh,
+                 void           *buf,
+                 size_t          count,
+                 off_t           offset,
+                 ssize_t        *bytes_read,
+                 red_api_user_t *user,
+                 red_done_t      done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                pwrite_iomem,
+                (rfs_open_hndl_t  oh,
+                 red_iomem_hndl_t iomem,
+                 void            *addr,
+                 size_t           count,
+                 off_t            offset,
+                 ssize_t         *bytes_written,
+                 red_api_user_t  *user,
+                 red_done_t       done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                pread_iomem,
+                (rfs_open_hndl_t  oh,
+                 red_iomem_hndl_t iomem,
+                 void            *addr,
+                 size_t           count,
+                 off_t            offset,
+                 ssize_t         *bytes_read,
+                 red_api_user_t  *user,
+                 red_done_t       done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                pwritev2,
+                (rfs_open_hndl_t   oh,
+                 struct red_iovec *iov,
+                 int               iovcnt,
+                 off_t             offset,
+                 int               flags,
+                 ssize_t          *bytes_written,
+                 red_api_user_t   *user,
+                 red_done_t        done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                close,
+                (rfs_open_hndl_t oh, red_api_user_t *user, red_done_t done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                close_dataset,
+                (rfs_dataset_hndl_t ds_hndl, red_api_user_t *user, red_done_t done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                create_mpart_upload,
+                (rfs_open_hndl_t  root_oh,
+                 const char      *key,
+                 int              flags,
+                 char            *upload_id,
+                 size_t           upload_id_nob,
+                 rfs_open_hndl_t *created_oh,
+                 red_api_user_t  *user,
+                 red_done_t       done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                upload_part,
+                (rfs_open_hndl_t  root_oh,
+                 const char      *key,
+                 const char      *upload_id,
+                 uint32_t         part_num,
+                 int              flags,
+                 rfs_open_hndl_t *part_oh,
+                 red_api_user_t  *user,
+                 red_done_t       done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                close_part,
+                (rfs_open_hndl_t       part_oh,
+                 red_data_integrity_t *integrity,
+                 red_api_user_t       *user,
+                 red_done_t            done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                comp_mpart_upload,
+                (rfs_open_hndl_t     root_oh,
+                 const char         *key,
+                 const char         *upload_id,
+                 uint32_t            num_parts,
+                 uint32_t            upload_parts,
+                 red_part_info_v2_t *parts,
+                 bool                final_parts,
+                 uint32_t            flags,
+                 red_mp_info_t      *info,
+                 red_api_user_t     *user,
+                 red_done_t          done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                abort_mpart,
+                (rfs_open_hndl_t root_oh,
+                 const char     *key,
+                 const char     *upload_id,
+                 red_api_user_t *user,
+                 red_done_t      done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                s3_open,
+                (rfs_open_hndl_t  root_oh,
+                 const char      *key,
+                 uint64_t         version,
+                 int              flags,
+                 rfs_open_hndl_t *oh,
+                 uint64_t        *out_version,
+                 red_api_user_t  *user,
+                 red_done_t       done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                get_part_size_v2,
+                (rfs_open_hndl_t oh,
+                 uint32_t        part_num,
+                 size_t         *part_size,
+                 uint64_t       *part_offset,
+                 char           *part_etag,
+                 red_api_user_t *user,
+                 red_done_t      done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                pread_part,
+                (rfs_open_hndl_t        oh,
+                 red_iomem_hndl_t       iomem,
+                 void                  *addr,
+                 uint32_t               part_num,
+                 off_t                  offset,
+                 size_t                 size,
+                 ssize_t               *byte_cnt,
+                 red_part_xattr_info_t *xattr_info,
+                 red_api_user_t        *user,
+                 red_done_t             done),
+                (override));
+    MOCK_METHOD(red_status_t,
+                fgetxattr,
+                (rfs_open_hndl_t oh,
+                 const char     *name,
+                 void           *value,
+                 size_t          size,
+                 size_t         *ret_size,
+                 red_api_user_t *user,
+                 red_done_t      done),
+                (override));
+};
+
 #endif /* MOCK_RED_CLIENT_HPP */
@@ -0,0 +1,137 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       numa_slab_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the hugepage slab buffer source
+ *
+ ******************************************************************************/
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "buffer_pool.hpp"
+#include "numa_slab.hpp"
+#include "test_utils.hpp"
+
+namespace
+{
+
+/* Unregistered slabs, so that the tests need no client library */
+common::hugepage_source_config_t unregistered(size_t slab_size)
+{
+    common::hugepage_source_config_t cfg;
+    cfg.slab_size      = slab_size;
+    cfg.register_slabs = false;
+    return cfg;
+}
+
+bool within(void *buf, void *base, size_t size)
+{
+    auto p = reinterpret_cast<uintptr_t>(buf);
+    auto b = reinterpret_cast<uintptr_t>(base);
+    return p >= b && p < b + size;
+}
+
+} // namespace
+
+class NumaSlabTest : public TestBase
+{
+};
+
+TEST_F(NumaSlabTest, CarvesBuffersFromHugePageSlabs)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    common::hugepage_source_t source(unregistered(0));
+    EXPECT_EQ(source.node(), -1);
+
+    /* Rounded up to whole 4 KiB pages, carved one after the other */
+    void *a = source.alloc(5000);
+    void *b = source.alloc(8192);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a) % common::HUGE_PAGE_2M, 0u);
+    EXPECT_EQ(static_cast<char *>(b), static_cast<char *>(a) + 8192);
+    memset(a, 'a', 8192);
+    memset(b, 'b', 8192);
+
+    common::hugepage_source_stats_t s = source.stats();
+    EXPECT_EQ(s.slabs, 1u);
+    EXPECT_EQ(s.mapped, common::HUGE_PAGE_2M);
+    EXPECT_EQ(s.hugetlb + s.thp, 1u);
+    EXPECT_EQ(s.unbound, 0u);
+    EXPECT_EQ(s.handed, 2u);
+
+    /* A freed buffer goes back out for the same size only */
+    source.free(a);
+    void *c = source.alloc(4096);
+    EXPECT_TRUE(within(c, a, common::HUGE_PAGE_2M));
+    EXPECT_NE(c, a);
+    EXPECT_EQ(source.alloc(8000), a);
+
+    /* A request larger than the slab size gets a slab of its own */
+    void *big = source.alloc(3 << 20);
+    ASSERT_NE(big, nullptr);
+    s = source.stats();
+    EXPECT_EQ(s.slabs, 2u);
+    EXPECT_EQ(s.mapped, 3 * common::HUGE_PAGE_2M);
+    EXPECT_EQ(s.handed, 4u);
+
+    /* Unknown buffers are refused */
+    int other;
+    source.free(&other);
+    EXPECT_EQ(source.stats().handed, 4u);
+
+    for (void *buf : {a, b, c, big})
+        source.free(buf);
+    EXPECT_EQ(source.stats().handed, 0u);
+    EXPECT_GE(common::cpu_to_node(0), -1);
+}
+
+TEST_F(NumaSlabTest, FeedsABufferPool)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    common::hugepage_source_t source(unregistered(4 * common::HUGE_PAGE_2M));
+    {
+        common::buffer_pool_config_t cfg;
+        cfg.buffer_size = 1 << 20;
+        cfg.prealloc    = 4;
+        cfg.source      = &source;
+        common::buffer_pool_t pool(cfg);
+        ASSERT_EQ(pool.init(), RED_SUCCESS);
+
+        std::vector<common::buffer_lease_t> leases(8);
+        for (common::buffer_lease_t &l : leases)
+        {
+            ASSERT_EQ(pool.acquire(&l), RED_SUCCESS);
+            memset(l.data(), 'x', l.size());
+        }
+
+        /* Eight 1 MiB buffers fill one 8 MiB slab */
+        common::hugepage_source_stats_t s = source.stats();
+        EXPECT_EQ(s.slabs, 1u);
+        EXPECT_EQ(s.handed, 8u);
+    }
+
+    /* The pool gave every buffer back; the slab stays mapped for reuse */
+    common::hugepage_source_stats_t s = source.stats();
+    EXPECT_EQ(s.handed, 0u);
+    EXPECT_EQ(s.mapped, 4 * common::HUGE_PAGE_2M);
+}
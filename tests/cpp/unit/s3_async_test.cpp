@@ -0,0 +1,222 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_async_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the asynchronous puts and gets of s3client
+ *
+ ******************************************************************************/
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "s3_client_fixture.hpp"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::InvokeArgument;
+using ::testing::Return;
+using ::testing::SaveArg;
+using ::testing::SetArgPointee;
+using ::testing::StrEq;
+
+class AsyncTest : public RfsAsyncTest
+{
+};
+
+TEST_F(AsyncTest, PutChainsOpenWriteClose)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing that each step of an async put is queued by the previous one");
+
+    rfs_open_hndl_t obj_oh  = {3};
+    char            data[]  = "async object";
+    ssize_t         written = sizeof(data);
+    red_done_t      opened, wrote, closed;
+
+    EXPECT_CALL(*mock_async, openat(root_oh, StrEq("obj"), O_CREAT | O_WRONLY, 0644, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(obj_oh), SaveArg<6>(&opened), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, pwrite(obj_oh, data, sizeof(data), 0, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(written), SaveArg<6>(&wrote), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, close(obj_oh, _, _))
+        .WillOnce(DoAll(SaveArg<2>(&closed), Return(RED_SUCCESS)));
+
+    int          calls = 0;
+    red_status_t rs    = RED_EINVAL;
+    ssize_t      bytes = 0;
+    ASSERT_EQ(client->put_object_async(bucket, "obj", red_buffer_t{{nullptr}, data, sizeof(data)},
+                                       [&](red_status_t s, ssize_t n) {
+                                           calls++;
+                                           rs    = s;
+                                           bytes = n;
+                                       }),
+              RED_SUCCESS);
+
+    /* Nothing blocks: every step waits for its continuation to run */
+    ASSERT_TRUE(opened);
+    EXPECT_FALSE(wrote);
+    opened(RED_SUCCESS);
+    ASSERT_TRUE(wrote);
+    EXPECT_FALSE(closed);
+    wrote(RED_SUCCESS);
+    ASSERT_TRUE(closed);
+    EXPECT_EQ(calls, 0);
+    closed(RED_SUCCESS);
+
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(rs, RED_SUCCESS);
+    EXPECT_EQ(bytes, written);
+}
+
+TEST_F(AsyncTest, PutInvalidatesCacheOnCompletion)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing that a handle cached while an async put runs is dropped once it is done");
+
+    rfs_open_hndl_t read_oh  = {3};
+    rfs_open_hndl_t write_oh = {4};
+    char            data[16] = {};
+    ssize_t         size     = sizeof(data);
+    ssize_t         bytes_read;
+    red_done_t      opened, wrote, closed;
+
+    EXPECT_CALL(*mock_client, openat(root_oh, StrEq("obj"), O_RDONLY, _, _, _))
+        .Times(3)
+        .WillRepeatedly(DoAll(SetArgPointee<4>(read_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, pread(read_oh, _, sizeof(data), 0, _, _))
+        .Times(3)
+        .WillRepeatedly(DoAll(SetArgPointee<4>(size), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, close(read_oh, _)).Times(3).WillRepeatedly(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_async, openat(root_oh, StrEq("obj"), O_CREAT | O_WRONLY, 0644, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(write_oh), SaveArg<6>(&opened), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, pwrite(write_oh, data, sizeof(data), 0, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(size), SaveArg<6>(&wrote), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, close(write_oh, _, _))
+        .WillOnce(DoAll(SaveArg<2>(&closed), Return(RED_SUCCESS)));
+
+    client->set_handle_cache({4, 0});
+    EXPECT_EQ(client->get_object(bucket, "obj", data, sizeof(data), &bytes_read), RED_SUCCESS);
+
+    red_status_t rs = RED_EINVAL;
+    ASSERT_EQ(client->put_object_async(bucket, "obj", red_buffer_t{{nullptr}, data, sizeof(data)},
+                                       [&](red_status_t s, ssize_t) { rs = s; }),
+              RED_SUCCESS);
+    ASSERT_TRUE(opened);
+    opened(RED_SUCCESS);
+
+    /* A get while the write runs caches the handle again */
+    EXPECT_EQ(client->get_object(bucket, "obj", data, sizeof(data), &bytes_read), RED_SUCCESS);
+    ASSERT_TRUE(wrote);
+    wrote(RED_SUCCESS);
+    ASSERT_TRUE(closed);
+    closed(RED_SUCCESS);
+    EXPECT_EQ(rs, RED_SUCCESS);
+
+    /* The completed put dropped it: the next get opens the new object */
+    EXPECT_EQ(client->get_object(bucket, "obj", data, sizeof(data), &bytes_read), RED_SUCCESS);
+
+    handle_cache_stats_t stats = client->handle_cache_stats();
+    EXPECT_EQ(stats.hits, 0u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.invalidated, 2u);
+}
+
+TEST_F(AsyncTest, GetsStayInFlightTogether)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing several async gets in flight on one thread");
+
+    const int               depth  = 4;
+    rfs_open_hndl_t         obj_oh = {3};
+    char                    data[depth][16];
+    ssize_t                 size = sizeof(data[0]);
+    std::vector<red_done_t> opens;
+    int                     done = 0;
+
+    EXPECT_CALL(*mock_async, openat(root_oh, _, O_RDONLY, _, _, _, _))
+        .Times(depth)
+        .WillRepeatedly(DoAll(SetArgPointee<4>(obj_oh),
+                              [&](rfs_open_hndl_t, const char *, int, mode_t, rfs_open_hndl_t *,
+                                  red_api_user_t *, red_done_t d) { opens.push_back(d); },
+                              Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, pread(obj_oh, _, sizeof(data[0]), 0, _, _, _))
+        .Times(depth)
+        .WillRepeatedly(
+            DoAll(SetArgPointee<4>(size), InvokeArgument<6>(RED_SUCCESS), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, close(obj_oh, _, _))
+        .Times(depth)
+        .WillRepeatedly(DoAll(InvokeArgument<2>(RED_SUCCESS), Return(RED_SUCCESS)));
+
+    for (int i = 0; i < depth; i++)
+    {
+        std::string key = "obj" + std::to_string(i);
+        ASSERT_EQ(client->get_object_async(bucket, key,
+                                           red_buffer_t{{nullptr}, data[i], sizeof(data[i])},
+                                           [&](red_status_t s, ssize_t n) {
+                                               EXPECT_EQ(s, RED_SUCCESS);
+                                               EXPECT_EQ(n, size);
+                                               done++;
+                                           }),
+                  RED_SUCCESS);
+    }
+
+    /* All opens were queued before the first completed */
+    ASSERT_EQ(opens.size(), static_cast<size_t>(depth));
+    EXPECT_EQ(done, 0);
+    for (red_done_t &opened : opens)
+        opened(RED_SUCCESS);
+    EXPECT_EQ(done, depth);
+}
+
+TEST_F(AsyncTest, Errors)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing the errors of async requests");
+
+    rfs_open_hndl_t obj_oh = {3};
+    char            data[16];
+    int             calls = 0;
+    red_status_t    rs    = RED_SUCCESS;
+    auto            done  = [&](red_status_t s, ssize_t) {
+        calls++;
+        rs = s;
+    };
+
+    /* Failing to queue the open fails the call and never runs done */
+    EXPECT_CALL(*mock_async, openat(root_oh, StrEq("busy"), _, _, _, _, _))
+        .WillOnce(Return(RED_ENOMEM));
+    EXPECT_EQ(client->get_object_async(bucket, "busy", red_buffer_t{{nullptr}, data, sizeof(data)},
+                                       done),
+              RED_ENOMEM);
+    EXPECT_EQ(calls, 0);
+
+    /* A failed transfer still closes the object, and done gets its status */
+    EXPECT_CALL(*mock_async, openat(root_oh, StrEq("obj"), _, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(obj_oh), InvokeArgument<6>(RED_SUCCESS),
+                        Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, pread(obj_oh, _, _, _, _, _, _))
+        .WillOnce(DoAll(InvokeArgument<6>(RED_EIO), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, close(obj_oh, _, _))
+        .WillOnce(DoAll(InvokeArgument<2>(RED_SUCCESS), Return(RED_SUCCESS)));
+    EXPECT_EQ(client->get_object_async(bucket, "obj", red_buffer_t{{nullptr}, data, sizeof(data)},
+                                       done),
+              RED_SUCCESS);
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(rs, RED_EIO);
+}
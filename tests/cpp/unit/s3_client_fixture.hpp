@@ -0,0 +1,137 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_client_fixture.hpp
+ *   Project:    RED
+ *
+ *   Description: Fixtures and expectations shared by the s3client unit tests
+ *
+ ******************************************************************************/
+#ifndef S3_CLIENT_FIXTURE_HPP
+#define S3_CLIENT_FIXTURE_HPP
+
+#include <cstdio>
+#include <fcntl.h>
+#include <memory>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../examples/cpp/simple_s3/simple_s3_client.hpp"
+#include "mock_red_client.hpp"
+#include "test_utils.hpp"
+
+class RfsBasicTest : public TestBase
+{
+protected:
+    void SetUp() override
+    {
+        TestBase::SetUp(); /* Call base class setup */
+        mock_client = new MockRedClient();
+        client      = std::make_unique<s3client>(nullptr,
+                                                 std::unique_ptr<IRedClient>(mock_client));
+    }
+
+    void TearDown() override
+    {
+        client.reset();
+        TestBase::TearDown(); /* Call base class teardown */
+    }
+
+    MockRedClient            *mock_client;
+    std::unique_ptr<s3client> client;
+};
+
+class RfsAsyncTest : public TestBase
+{
+protected:
+    void SetUp() override
+    {
+        TestBase::SetUp(); /* Call base class setup */
+        mock_client = new MockRedClient();
+        mock_async  = new MockAsyncRedClient();
+        client      = std::make_unique<s3client>(nullptr,
+                                                 std::unique_ptr<IRedClient>(mock_client),
+                                                 std::unique_ptr<IAsyncRedClient>(mock_async));
+
+        using ::testing::_;
+        using ::testing::DoAll;
+        using ::testing::Return;
+        using ::testing::SetArgPointee;
+
+        /* The bucket and its root stay on the synchronous calls */
+        EXPECT_CALL(*mock_client, obtain_dataset(_, _, _, _, _))
+            .WillOnce(DoAll(SetArgPointee<3>(ds_hndl), Return(RED_SUCCESS)));
+        EXPECT_CALL(*mock_client, open_root(ds_hndl, _, _))
+            .WillOnce(DoAll(SetArgPointee<1>(root_oh), Return(RED_SUCCESS)));
+        EXPECT_CALL(*mock_client, close(root_oh, _)).WillOnce(Return(RED_SUCCESS));
+        EXPECT_CALL(*mock_client, close_dataset(ds_hndl, _)).WillOnce(Return(RED_SUCCESS));
+        bucket = client->create_bucket("infinia", "test_bucket");
+    }
+
+    void TearDown() override
+    {
+        client.reset();
+        TestBase::TearDown(); /* Call base class teardown */
+    }
+
+    rfs_dataset_hndl_t        ds_hndl = {reinterpret_cast<void *>(1)};
+    rfs_open_hndl_t           root_oh = {2};
+    MockRedClient            *mock_client;
+    MockAsyncRedClient       *mock_async;
+    std::unique_ptr<s3client> client;
+    std::weak_ptr<s3bucket>   bucket;
+};
+
+/* Expectations for the create and the final close of a multipart upload of "obj" */
+inline void expect_mpart_upload(MockAsyncRedClient *mock_async,
+                                rfs_open_hndl_t     root_oh,
+                                rfs_open_hndl_t     created_oh)
+{
+    using ::testing::_;
+    using ::testing::DoAll;
+    using ::testing::InvokeArgument;
+    using ::testing::Return;
+    using ::testing::SetArgPointee;
+    using ::testing::StrEq;
+
+    EXPECT_CALL(*mock_async, create_mpart_upload(root_oh, StrEq("obj"), _, _, _, _, _, _))
+        .WillOnce(DoAll(
+            [](rfs_open_hndl_t, const char *, int, char *id, size_t nob, rfs_open_hndl_t *,
+               red_api_user_t *, red_done_t) { snprintf(id, nob, "upload-1"); },
+            SetArgPointee<5>(created_oh), InvokeArgument<7>(RED_SUCCESS), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, close(created_oh, _, _))
+        .WillOnce(DoAll(InvokeArgument<2>(RED_SUCCESS), Return(RED_SUCCESS)));
+}
+
+/* Open of the object read in parallel, and its close */
+inline void expect_ranged_open(MockAsyncRedClient *mock_async,
+                               rfs_open_hndl_t     root_oh,
+                               rfs_open_hndl_t     oh)
+{
+    using ::testing::_;
+    using ::testing::DoAll;
+    using ::testing::InvokeArgument;
+    using ::testing::Return;
+    using ::testing::SetArgPointee;
+    using ::testing::StrEq;
+
+    EXPECT_CALL(*mock_async, s3_open(root_oh, StrEq("obj"), 0, O_RDONLY, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(oh), InvokeArgument<7>(RED_SUCCESS),
+                        Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, close(oh, _, _))
+        .WillOnce(DoAll(InvokeArgument<2>(RED_SUCCESS), Return(RED_SUCCESS)));
+}
+
+#endif // S3_CLIENT_FIXTURE_HPP
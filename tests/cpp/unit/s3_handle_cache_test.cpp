@@ -0,0 +1,261 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_handle_cache_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the object handle cache of s3client
+ *
+ ******************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <thread>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "s3_client_fixture.hpp"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using ::testing::StrEq;
+
+class HandleCacheTest : public RfsBasicTest
+{
+};
+
+TEST_F(HandleCacheTest, ServesRepeatedGets)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing repeated gets of a hot key through the handle cache");
+
+    rfs_dataset_hndl_t ds_hndl = {reinterpret_cast<void *>(1)};
+    rfs_open_hndl_t    root_oh = {2};
+    rfs_open_hndl_t    obj_oh  = {3};
+    const int          gets    = 5;
+    char               data[16];
+    ssize_t            size = sizeof(data);
+    ssize_t            bytes_read;
+
+    EXPECT_CALL(*mock_client, obtain_dataset(_, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<3>(ds_hndl), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, open_root(ds_hndl, _, _))
+        .WillOnce(DoAll(SetArgPointee<1>(root_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, openat(root_oh, StrEq("hot"), O_RDONLY, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(obj_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, pread(obj_oh, _, sizeof(data), 0, _, _))
+        .Times(gets)
+        .WillRepeatedly(DoAll(SetArgPointee<4>(size), Return(RED_SUCCESS)));
+    {
+        /* The cached handle is closed with the client, before the bucket */
+        testing::InSequence seq;
+        EXPECT_CALL(*mock_client, close(obj_oh, _)).WillOnce(Return(RED_SUCCESS));
+        EXPECT_CALL(*mock_client, close(root_oh, _)).WillOnce(Return(RED_SUCCESS));
+        EXPECT_CALL(*mock_client, close_dataset(ds_hndl, _)).WillOnce(Return(RED_SUCCESS));
+    }
+
+    client->set_handle_cache({4, 0});
+    auto bucket = client->create_bucket("infinia", "test_bucket");
+    for (int i = 0; i < gets; i++)
+        ASSERT_EQ(client->get_object(bucket, "hot", data, sizeof(data), &bytes_read), RED_SUCCESS);
+
+    handle_cache_stats_t stats = client->handle_cache_stats();
+    EXPECT_EQ(stats.hits, static_cast<uint64_t>(gets - 1));
+    EXPECT_EQ(stats.misses, 1u);
+}
+
+TEST_F(HandleCacheTest, EvictsLeastRecentlyUsed)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing eviction from a full handle cache");
+
+    rfs_dataset_hndl_t ds_hndl = {reinterpret_cast<void *>(1)};
+    rfs_open_hndl_t    root_oh = {2};
+    rfs_open_hndl_t    a_oh    = {3};
+    rfs_open_hndl_t    b_oh    = {4};
+    rfs_open_hndl_t    c_oh    = {5};
+    char               data[16];
+    ssize_t            size = sizeof(data);
+    ssize_t            bytes_read;
+
+    EXPECT_CALL(*mock_client, obtain_dataset(_, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<3>(ds_hndl), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, open_root(ds_hndl, _, _))
+        .WillOnce(DoAll(SetArgPointee<1>(root_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, openat(root_oh, StrEq("a"), _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(a_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, openat(root_oh, StrEq("b"), _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(b_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, openat(root_oh, StrEq("c"), _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(c_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, pread(_, _, sizeof(data), 0, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<4>(size), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, close(a_oh, _)).WillOnce(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_client, close(b_oh, _)).WillOnce(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_client, close(c_oh, _)).WillOnce(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_client, close(root_oh, _)).WillOnce(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_client, close_dataset(ds_hndl, _)).WillOnce(Return(RED_SUCCESS));
+
+    client->set_handle_cache({2, 0});
+    auto bucket = client->create_bucket("infinia", "test_bucket");
+
+    /* "a" is used again before "c" comes in, so "b" is the one evicted */
+    for (const char *key : {"a", "b", "a", "c", "a"})
+        ASSERT_EQ(client->get_object(bucket, key, data, sizeof(data), &bytes_read), RED_SUCCESS);
+
+    handle_cache_stats_t stats = client->handle_cache_stats();
+    EXPECT_EQ(stats.hits, 2u);
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.evictions, 1u);
+}
+
+TEST_F(HandleCacheTest, PutInvalidatesCachedHandle)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing that a put reopens the object on the next get");
+
+    rfs_dataset_hndl_t ds_hndl  = {reinterpret_cast<void *>(1)};
+    rfs_open_hndl_t    root_oh  = {2};
+    rfs_open_hndl_t    read_oh  = {3};
+    rfs_open_hndl_t    write_oh = {4};
+    char               data[16] = {};
+    ssize_t            size     = sizeof(data);
+    ssize_t            bytes_read;
+
+    EXPECT_CALL(*mock_client, obtain_dataset(_, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<3>(ds_hndl), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, open_root(ds_hndl, _, _))
+        .WillOnce(DoAll(SetArgPointee<1>(root_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, openat(root_oh, StrEq("obj"), O_RDONLY, _, _, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<4>(read_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, openat(root_oh, StrEq("obj"), O_CREAT | O_WRONLY, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(write_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, pread(read_oh, _, sizeof(data), 0, _, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<4>(size), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, pwrite(write_oh, _, sizeof(data), 0, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(size), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, close(write_oh, _)).WillOnce(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_client, close(read_oh, _)).Times(2).WillRepeatedly(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_client, close(root_oh, _)).WillOnce(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_client, close_dataset(ds_hndl, _)).WillOnce(Return(RED_SUCCESS));
+
+    client->set_handle_cache({4, 0});
+    auto bucket = client->create_bucket("infinia", "test_bucket");
+    EXPECT_EQ(client->get_object(bucket, "obj", data, sizeof(data), &bytes_read), RED_SUCCESS);
+    EXPECT_EQ(client->put_object(bucket, "obj", data, sizeof(data)), RED_SUCCESS);
+    EXPECT_EQ(client->get_object(bucket, "obj", data, sizeof(data), &bytes_read), RED_SUCCESS);
+
+    handle_cache_stats_t stats = client->handle_cache_stats();
+    EXPECT_EQ(stats.hits, 0u);
+    EXPECT_EQ(stats.misses, 2u);
+    EXPECT_EQ(stats.invalidated, 1u);
+}
+
+TEST_F(HandleCacheTest, ExpiresAfterTtl)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing the reopening of a cached handle past its TTL");
+
+    rfs_dataset_hndl_t ds_hndl = {reinterpret_cast<void *>(1)};
+    rfs_open_hndl_t    root_oh = {2};
+    rfs_open_hndl_t    obj_oh  = {3};
+    char               data[16];
+    ssize_t            size = sizeof(data);
+    ssize_t            bytes_read;
+
+    EXPECT_CALL(*mock_client, obtain_dataset(_, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<3>(ds_hndl), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, open_root(ds_hndl, _, _))
+        .WillOnce(DoAll(SetArgPointee<1>(root_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, openat(root_oh, StrEq("obj"), O_RDONLY, _, _, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<4>(obj_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, pread(obj_oh, _, sizeof(data), 0, _, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<4>(size), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, close(obj_oh, _)).Times(2).WillRepeatedly(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_client, close(root_oh, _)).WillOnce(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_client, close_dataset(ds_hndl, _)).WillOnce(Return(RED_SUCCESS));
+
+    client->set_handle_cache({4, 1000000});
+    auto bucket = client->create_bucket("infinia", "test_bucket");
+    EXPECT_EQ(client->get_object(bucket, "obj", data, sizeof(data), &bytes_read), RED_SUCCESS);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(client->get_object(bucket, "obj", data, sizeof(data), &bytes_read), RED_SUCCESS);
+
+    handle_cache_stats_t stats = client->handle_cache_stats();
+    EXPECT_EQ(stats.hits, 0u);
+    EXPECT_EQ(stats.expired, 1u);
+}
+
+TEST_F(HandleCacheTest, ClosedOnOwningThread)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing client destruction while another thread holds cached handles");
+
+    rfs_dataset_hndl_t ds_hndl = {reinterpret_cast<void *>(1)};
+    rfs_open_hndl_t    root_oh = {2};
+    rfs_open_hndl_t    obj_oh  = {3};
+    char               data[16];
+    ssize_t            size = sizeof(data);
+    std::thread::id    closed_on;
+    std::atomic<int>   step{0};
+
+    EXPECT_CALL(*mock_client, obtain_dataset(_, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<3>(ds_hndl), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, open_root(ds_hndl, _, _))
+        .WillOnce(DoAll(SetArgPointee<1>(root_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, openat(root_oh, StrEq("hot"), O_RDONLY, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(obj_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, pread(obj_oh, _, sizeof(data), 0, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(size), Return(RED_SUCCESS)));
+    {
+        /* The handle is closed by its thread, the bucket only after it */
+        testing::InSequence seq;
+        EXPECT_CALL(*mock_client, close(obj_oh, _))
+            .WillOnce(testing::Invoke([&closed_on](rfs_open_hndl_t, red_api_user_t *) {
+                closed_on = std::this_thread::get_id();
+                return RED_SUCCESS;
+            }));
+        EXPECT_CALL(*mock_client, close(root_oh, _)).WillOnce(Return(RED_SUCCESS));
+        EXPECT_CALL(*mock_client, close_dataset(ds_hndl, _)).WillOnce(Return(RED_SUCCESS));
+    }
+
+    client->set_handle_cache({4, 0});
+    auto bucket = client->create_bucket("infinia", "test_bucket");
+
+    std::thread worker([&]() {
+        ssize_t bytes_read;
+        EXPECT_EQ(client->get_object(bucket, "hot", data, sizeof(data), &bytes_read),
+                  RED_SUCCESS);
+        step = 1;
+        while (step != 2)
+            std::this_thread::yield();
+    });
+    std::thread::id worker_id = worker.get_id();
+
+    while (step != 1)
+        std::this_thread::yield();
+    client.reset();
+    EXPECT_EQ(closed_on, std::thread::id());
+    step = 2;
+    worker.join();
+    EXPECT_EQ(closed_on, worker_id);
+}
@@ -0,0 +1,230 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_multipart_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the parallel multipart upload of s3client
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../examples/cpp/common/include/crc32c.hpp"
+#include "s3_client_fixture.hpp"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::InvokeArgument;
+using ::testing::Return;
+using ::testing::StrEq;
+
+class MultipartTest : public RfsAsyncTest
+{
+};
+
+TEST_F(MultipartTest, UploadsPartsWithChecksums)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing a multipart upload split into parts with their CRC-32C");
+
+    char            data[]        = "123456789";
+    const size_t    size          = sizeof(data) - 1;
+    rfs_open_hndl_t created_oh    = {3};
+    int             in_flight     = 0;
+    int             max_in_flight = 0;
+
+    /* The standard check value, also when continued block by block */
+    ASSERT_EQ(common::crc32c(0, data, size), 0xe3069283u);
+    ASSERT_EQ(common::crc32c(common::crc32c(0, data, 4), data + 4, size - 4), 0xe3069283u);
+
+    expect_mpart_upload(mock_async, root_oh, created_oh);
+    EXPECT_CALL(*mock_async, upload_part(root_oh, StrEq("obj"), StrEq("upload-1"), _, _, _, _, _))
+        .Times(3)
+        .WillRepeatedly([&](rfs_open_hndl_t, const char *, const char *, uint32_t part_num, int,
+                            rfs_open_hndl_t *part_oh, red_api_user_t *, red_done_t done) {
+            max_in_flight = std::max(max_in_flight, ++in_flight);
+            *part_oh      = {10 + part_num};
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    EXPECT_CALL(*mock_async, pwrite(_, _, _, 0, _, _, _))
+        .Times(3)
+        .WillRepeatedly([&](rfs_open_hndl_t oh, void *buf, size_t count, off_t, ssize_t *written,
+                            red_api_user_t *, red_done_t done) {
+            /* Each part writes its own slice of the object */
+            EXPECT_EQ(buf, data + (oh.fd - 11) * 4);
+            EXPECT_EQ(count, oh.fd == 13 ? 1u : 4u);
+            *written = static_cast<ssize_t>(count);
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+
+    /* Parts complete in reverse order of their numbers once both are closed */
+    std::vector<red_done_t> closes;
+    EXPECT_CALL(*mock_async, close_part(_, _, _, _))
+        .Times(3)
+        .WillRepeatedly([&](rfs_open_hndl_t oh, red_data_integrity_t *integrity,
+                            red_api_user_t *, red_done_t done) {
+            size_t off = (oh.fd - 11) * 4;
+            EXPECT_EQ(integrity->checksum.type, RED_S3CS_CRC32C);
+            EXPECT_EQ(integrity->checksum.checksum.crc32,
+                      common::crc32c(0, data + off, std::min<size_t>(4, size - off)));
+            snprintf(integrity->etag, sizeof(integrity->etag), "etag%lu", oh.fd);
+            closes.push_back(done);
+            if (closes.size() == 2)
+            {
+                in_flight -= 2;
+                closes[1](RED_SUCCESS);
+                closes[0](RED_SUCCESS);
+            }
+            else if (closes.size() == 3)
+            {
+                in_flight--;
+                done(RED_SUCCESS);
+            }
+            return RED_SUCCESS;
+        });
+    EXPECT_CALL(*mock_async,
+                comp_mpart_upload(root_oh, StrEq("obj"), StrEq("upload-1"), 3, 3, _, true, _, _, _,
+                                  _))
+        .WillOnce([&](rfs_open_hndl_t, const char *, const char *, uint32_t, uint32_t,
+                      red_part_info_v2_t *parts, bool, uint32_t, red_mp_info_t *info,
+                      red_api_user_t *, red_done_t done) {
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                EXPECT_EQ(parts[i].pi_part_num, i + 1);
+                EXPECT_EQ(parts[i].pi_range.offset, static_cast<off_t>(i * 4));
+                std::string etag = "etag" + std::to_string(11 + i);
+                EXPECT_STREQ(parts[i].pi_xattr_info.etag, etag.c_str());
+                EXPECT_EQ(parts[i].pi_xattr_info.checksum.checksum.crc32,
+                          common::crc32c(0, data + i * 4, std::min<size_t>(4, size - i * 4)));
+            }
+            snprintf(info->etag, sizeof(info->etag), "object-etag");
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    EXPECT_CALL(*mock_async, abort_mpart(_, _, _, _, _)).Times(0);
+
+    multipart_config_t cfg;
+    cfg.part_size   = 4;
+    cfg.concurrency = 2;
+    red_mp_info_t info;
+    EXPECT_EQ(client->put_object_multipart(bucket, "obj", red_buffer_t{{nullptr}, data, size}, cfg,
+                                           &info),
+              RED_SUCCESS);
+    EXPECT_EQ(max_in_flight, 2);
+    EXPECT_STREQ(info.etag, "object-etag");
+}
+
+TEST_F(MultipartTest, FailedPartAbortsUpload)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing the retry of a failed part and the abort of the upload");
+
+    char            data[8]    = {};
+    rfs_open_hndl_t created_oh = {3};
+    int             uploads    = 0;
+
+    expect_mpart_upload(mock_async, root_oh, created_oh);
+    EXPECT_CALL(*mock_async, upload_part(_, _, _, _, _, _, _, _))
+        .WillRepeatedly([&](rfs_open_hndl_t, const char *, const char *, uint32_t part_num, int,
+                            rfs_open_hndl_t *part_oh, red_api_user_t *, red_done_t done) {
+            uploads++;
+            *part_oh = {10 + part_num};
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+
+    /* Part 2 fails its write every time; the part is still closed */
+    EXPECT_CALL(*mock_async, pwrite(_, _, _, _, _, _, _))
+        .WillRepeatedly([&](rfs_open_hndl_t oh, void *, size_t count, off_t, ssize_t *written,
+                            red_api_user_t *, red_done_t done) {
+            *written = static_cast<ssize_t>(count);
+            done(oh.fd == 12 ? RED_EIO : RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    EXPECT_CALL(*mock_async, close_part(_, _, _, _))
+        .WillRepeatedly(DoAll(InvokeArgument<3>(RED_SUCCESS), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, comp_mpart_upload(_, _, _, _, _, _, _, _, _, _, _)).Times(0);
+    EXPECT_CALL(*mock_async, abort_mpart(root_oh, StrEq("obj"), StrEq("upload-1"), _, _))
+        .WillOnce(DoAll(InvokeArgument<4>(RED_SUCCESS), Return(RED_SUCCESS)));
+
+    /* One part at a time: parts 3 and 4 never start once part 2 has failed twice */
+    multipart_config_t cfg;
+    cfg.part_size   = 2;
+    cfg.concurrency = 1;
+    cfg.retries     = 1;
+    red_buffer_t buf = {{nullptr}, data, sizeof(data)};
+    EXPECT_EQ(client->put_object_multipart(bucket, "obj", buf, cfg), RED_EIO);
+    EXPECT_EQ(uploads, 3);
+}
+
+TEST_F(MultipartTest, ReleasesPartNotClosed)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing the retry of a part whose close cannot be queued");
+
+    char            data[8]    = {};
+    rfs_open_hndl_t created_oh = {3};
+    int             uploads    = 0;
+    int             closes     = 0;
+
+    expect_mpart_upload(mock_async, root_oh, created_oh);
+    EXPECT_CALL(*mock_async, upload_part(_, _, _, 1, _, _, _, _))
+        .Times(2)
+        .WillRepeatedly([&](rfs_open_hndl_t, const char *, const char *, uint32_t, int,
+                            rfs_open_hndl_t *part_oh, red_api_user_t *, red_done_t done) {
+            *part_oh = {static_cast<uint64_t>(10 + uploads++)};
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    EXPECT_CALL(*mock_async, pwrite(_, _, sizeof(data), _, _, _, _))
+        .Times(2)
+        .WillRepeatedly([](rfs_open_hndl_t, void *, size_t count, off_t, ssize_t *written,
+                           red_api_user_t *, red_done_t done) {
+            *written = static_cast<ssize_t>(count);
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+
+    /* The first close is refused: the part's handle is closed before the part is retried */
+    EXPECT_CALL(*mock_async, close_part(_, _, _, _))
+        .Times(2)
+        .WillRepeatedly([&](rfs_open_hndl_t, red_data_integrity_t *, red_api_user_t *,
+                            red_done_t done) {
+            if (closes++ == 0)
+                return RED_EAGAIN;
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    rfs_open_hndl_t refused_oh = {10};
+    EXPECT_CALL(*mock_client, close(refused_oh, _)).WillOnce(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_async, comp_mpart_upload(root_oh, StrEq("obj"), StrEq("upload-1"), 1, 1, _,
+                                               true, _, _, _, _))
+        .WillOnce(DoAll(InvokeArgument<10>(RED_SUCCESS), Return(RED_SUCCESS)));
+
+    multipart_config_t cfg;
+    cfg.part_size    = sizeof(data);
+    cfg.retries      = 1;
+    red_buffer_t buf = {{nullptr}, data, sizeof(data)};
+    EXPECT_EQ(client->put_object_multipart(bucket, "obj", buf, cfg), RED_SUCCESS);
+    EXPECT_EQ(uploads, 2);
+}
@@ -0,0 +1,371 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_ranged_get_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the parallel ranged GET of s3client
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <sys/resource.h>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../examples/cpp/common/include/crc32c.hpp"
+#include "../../../examples/cpp/common/include/md5.hpp"
+#include "s3_client_fixture.hpp"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::InvokeArgument;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+
+class RangedGetTest : public RfsAsyncTest
+{
+};
+
+TEST_F(RangedGetTest, ReadsPartsInParallel)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing a parallel GET of a multipart object part by part");
+
+    const char      object[]      = "123456789";
+    const size_t    size          = sizeof(object) - 1;
+    rfs_open_hndl_t obj_oh        = {5};
+    char            data[16]      = {};
+    int             in_flight     = 0;
+    int             max_in_flight = 0;
+
+    expect_ranged_open(mock_async, root_oh, obj_oh);
+
+    /* Parts of 4, 4 and 1 bytes; part 4 does not exist */
+    EXPECT_CALL(*mock_async, get_part_size_v2(obj_oh, _, _, _, _, _, _))
+        .Times(4)
+        .WillRepeatedly([&](rfs_open_hndl_t, uint32_t part_num, size_t *part_size,
+                            uint64_t *part_offset, char *, red_api_user_t *, red_done_t done) {
+            *part_offset = (part_num - 1) * 4;
+            *part_size   = part_num == 3 ? 1 : 4;
+            done(part_num > 3 ? RED_ENOENT : RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+
+    /* Reads complete two at a time, and the last one on its own */
+    std::vector<red_done_t> reads;
+    EXPECT_CALL(*mock_async, pread_part(obj_oh, _, _, _, 0, _, _, _, _, _))
+        .Times(3)
+        .WillRepeatedly([&](rfs_open_hndl_t, red_iomem_hndl_t, void *addr, uint32_t part_num,
+                            off_t, size_t count, ssize_t *byte_cnt,
+                            red_part_xattr_info_t *xattr, red_api_user_t *, red_done_t done) {
+            /* Each part lands at its own offset of the buffer */
+            size_t off = (part_num - 1) * 4;
+            EXPECT_EQ(addr, data + off);
+            memcpy(addr, object + off, count);
+            xattr->checksum_type  = RED_S3CS_CRC32C;
+            xattr->checksum.crc32 = common::crc32c(0, object + off, count);
+            *byte_cnt             = static_cast<ssize_t>(count);
+            reads.push_back(done);
+            max_in_flight = std::max(max_in_flight, ++in_flight);
+            if (in_flight == 2 || part_num == 3)
+            {
+                for (red_done_t &read : reads)
+                    read(RED_SUCCESS);
+                reads.clear();
+                in_flight = 0;
+            }
+            return RED_SUCCESS;
+        });
+
+    ranged_get_config_t cfg;
+    cfg.concurrency = 2;
+    red_buffer_t        buf = {{reinterpret_cast<void *>(1)}, data, sizeof(data)};
+    ranged_get_result_t result;
+    ssize_t             bytes_read = 0;
+    EXPECT_EQ(client->get_object_parallel(bucket, "obj", buf, &bytes_read, cfg, &result),
+              RED_SUCCESS);
+    EXPECT_EQ(bytes_read, static_cast<ssize_t>(size));
+    EXPECT_STREQ(data, object);
+    EXPECT_EQ(max_in_flight, 2);
+    EXPECT_TRUE(result.by_part);
+    EXPECT_EQ(result.verified, 3u);
+    EXPECT_EQ(result.unverified, 0u);
+    ASSERT_EQ(result.reads.size(), 3u);
+    EXPECT_EQ(result.reads[2].part_num, 3u);
+    EXPECT_EQ(result.reads[2].offset, 8);
+    EXPECT_EQ(result.reads[2].size, 1u);
+}
+
+TEST_F(RangedGetTest, FallsBackToByteRanges)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing a parallel GET by byte range of an object without parts");
+
+    const char      object[] = "abcdef";
+    rfs_open_hndl_t obj_oh   = {5};
+    char            data[12] = {};
+
+    expect_ranged_open(mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, get_part_size_v2(obj_oh, 1, _, _, _, _, _))
+        .WillOnce(DoAll(InvokeArgument<6>(RED_ENOENT), Return(RED_SUCCESS)));
+
+    /* The second range comes back short: the third is never read */
+    EXPECT_CALL(*mock_async, pread_part(obj_oh, _, _, UINT32_MAX, _, 4, _, nullptr, _, _))
+        .Times(2)
+        .WillRepeatedly([&](rfs_open_hndl_t, red_iomem_hndl_t, void *addr, uint32_t,
+                            off_t offset, size_t count, ssize_t *byte_cnt,
+                            red_part_xattr_info_t *, red_api_user_t *, red_done_t done) {
+            EXPECT_EQ(addr, data + offset);
+            size_t n = std::min<size_t>(count, sizeof(object) - 1 - offset);
+            memcpy(addr, object + offset, n);
+            *byte_cnt = static_cast<ssize_t>(n);
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+
+    ranged_get_config_t cfg;
+    cfg.range_size  = 4;
+    cfg.concurrency = 2;
+    red_buffer_t        buf = {{reinterpret_cast<void *>(1)}, data, sizeof(data)};
+    ranged_get_result_t result;
+    ssize_t             bytes_read = 0;
+    EXPECT_EQ(client->get_object_parallel(bucket, "obj", buf, &bytes_read, cfg, &result),
+              RED_SUCCESS);
+    EXPECT_EQ(bytes_read, 6);
+    EXPECT_STREQ(data, object);
+    EXPECT_FALSE(result.by_part);
+    EXPECT_EQ(result.verified, 0u);
+    ASSERT_EQ(result.reads.size(), 2u);
+    EXPECT_EQ(result.reads[1].part_num, 0u);
+    EXPECT_EQ(result.reads[1].size, 2u);
+}
+
+TEST_F(RangedGetTest, ChecksumMismatch)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing a parallel GET of a part that does not match its checksum");
+
+    rfs_open_hndl_t obj_oh  = {5};
+    char            data[8] = {};
+
+    expect_ranged_open(mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, get_part_size_v2(obj_oh, _, _, _, _, _, _))
+        .WillRepeatedly([&](rfs_open_hndl_t, uint32_t part_num, size_t *part_size,
+                            uint64_t *part_offset, char *, red_api_user_t *, red_done_t done) {
+            *part_offset = 0;
+            *part_size   = 4;
+            done(part_num == 1 ? RED_SUCCESS : RED_ENOENT);
+            return RED_SUCCESS;
+        });
+    EXPECT_CALL(*mock_async, pread_part(obj_oh, _, _, 1, 0, 4, _, _, _, _))
+        .WillOnce([&](rfs_open_hndl_t, red_iomem_hndl_t, void *addr, uint32_t, off_t,
+                      size_t count, ssize_t *byte_cnt, red_part_xattr_info_t *xattr,
+                      red_api_user_t *, red_done_t done) {
+            memcpy(addr, "abcd", count);
+            xattr->checksum_type  = RED_S3CS_CRC32C;
+            xattr->checksum.crc32 = common::crc32c(0, "abce", count);
+            *byte_cnt             = static_cast<ssize_t>(count);
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+
+    red_buffer_t buf        = {{reinterpret_cast<void *>(1)}, data, sizeof(data)};
+    ssize_t      bytes_read = 0;
+    EXPECT_EQ(client->get_object_parallel(bucket, "obj", buf, &bytes_read), RED_ECKSUM);
+}
+
+TEST_F(RangedGetTest, VerifiesCrc32AndMd5)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing the verification of parts by CRC-32, MD5 ETag and unknown checksum");
+
+    const char      object[] = "abcdefghijkl";
+    rfs_open_hndl_t obj_oh   = {5};
+    char            data[16] = {};
+    char            md5[RED_S3_USER_ETAG_SIZE];
+    common::md5_t   hash;
+
+    hash.update(object + 4, 4);
+    hash.final_hex(md5);
+
+    /* Part 1 has a CRC-32, part 2 only an MD5 ETag, part 3 a SHA-256 */
+    expect_ranged_open(mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, get_part_size_v2(obj_oh, _, _, _, _, _, _))
+        .WillRepeatedly([&](rfs_open_hndl_t, uint32_t part_num, size_t *part_size,
+                            uint64_t *part_offset, char *, red_api_user_t *, red_done_t done) {
+            *part_offset = (part_num - 1) * 4;
+            *part_size   = 4;
+            done(part_num > 3 ? RED_ENOENT : RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    EXPECT_CALL(*mock_async, pread_part(obj_oh, _, _, _, 0, 4, _, _, _, _))
+        .Times(5) /* Three parts, then two */
+        .WillRepeatedly([&](rfs_open_hndl_t, red_iomem_hndl_t, void *addr, uint32_t part_num,
+                            off_t, size_t count, ssize_t *byte_cnt,
+                            red_part_xattr_info_t *xattr, red_api_user_t *, red_done_t done) {
+            const char *src = object + (part_num - 1) * 4;
+            memcpy(addr, src, count);
+            if (part_num == 1)
+            {
+                xattr->checksum_type  = RED_S3CS_CRC32;
+                xattr->checksum.crc32 = common::crc32(0, src, count);
+            }
+            else if (part_num == 2)
+            {
+                xattr->checksum_type = RED_S3CS_NONE;
+                memcpy(xattr->etag, md5, sizeof(md5));
+                xattr->etag_size = 2 * common::md5_t::DIGEST_SIZE;
+            }
+            else
+            {
+                xattr->checksum_type = RED_S3CS_SHA256;
+            }
+            *byte_cnt = static_cast<ssize_t>(count);
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+
+    ranged_get_config_t cfg;
+    cfg.concurrency = 1;
+    red_buffer_t        buf = {{reinterpret_cast<void *>(1)}, data, sizeof(data)};
+    ranged_get_result_t result;
+    ssize_t             bytes_read = 0;
+    EXPECT_EQ(client->get_object_parallel(bucket, "obj", buf, &bytes_read, cfg, &result),
+              RED_ENOTSUP);
+
+    /* Without the SHA-256 part, both others verify */
+    memset(data, 0, sizeof(data));
+    expect_ranged_open(mock_async, root_oh, obj_oh);
+    buf.size = 8;
+    EXPECT_CALL(*mock_async, get_part_size_v2(obj_oh, _, _, _, _, _, _))
+        .WillRepeatedly([&](rfs_open_hndl_t, uint32_t part_num, size_t *part_size,
+                            uint64_t *part_offset, char *, red_api_user_t *, red_done_t done) {
+            *part_offset = (part_num - 1) * 4;
+            *part_size   = 4;
+            done(part_num > 2 ? RED_ENOENT : RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    EXPECT_EQ(client->get_object_parallel(bucket, "obj", buf, &bytes_read, cfg, &result),
+              RED_SUCCESS);
+    EXPECT_EQ(bytes_read, 8);
+    EXPECT_EQ(result.verified, 2u);
+    EXPECT_EQ(result.unverified, 0u);
+}
+
+TEST_F(RangedGetTest, FailsOnSizeError)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing a parallel GET whose part sizing fails");
+
+    rfs_open_hndl_t obj_oh  = {5};
+    char            data[8] = {};
+
+    /* An error other than a missing part is not mistaken for an object without parts */
+    expect_ranged_open(mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, get_part_size_v2(obj_oh, 1, _, _, _, _, _))
+        .WillOnce(DoAll(InvokeArgument<6>(RED_EINVAL), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, pread_part(_, _, _, _, _, _, _, _, _, _)).Times(0);
+
+    red_buffer_t buf        = {{reinterpret_cast<void *>(1)}, data, sizeof(data)};
+    ssize_t      bytes_read = 0;
+    EXPECT_EQ(client->get_object_parallel(bucket, "obj", buf, &bytes_read), RED_EINVAL);
+}
+
+TEST_F(RangedGetTest, WaitsOutCallsAfterFailedWait)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing a parallel GET whose wait fails with a call in flight");
+
+    rfs_open_hndl_t   obj_oh      = {5};
+    char              data[8]     = {};
+    size_t           *part_size   = nullptr;
+    uint64_t         *part_offset = nullptr;
+    red_done_t        sized;
+    std::atomic<bool> issued{false};
+    struct rlimit     files;
+
+    ASSERT_EQ(getrlimit(RLIMIT_NOFILE, &files), 0);
+    expect_ranged_open(mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, get_part_size_v2(obj_oh, 1, _, _, _, _, _))
+        .WillOnce([&](rfs_open_hndl_t, uint32_t, size_t *size, uint64_t *offset, char *,
+                      red_api_user_t *, red_done_t done) {
+            part_size   = size;
+            part_offset = offset;
+            sized       = std::move(done);
+
+            /* poll() fails with EINVAL on more fds than RLIMIT_NOFILE allows */
+            struct rlimit none = {0, files.rlim_max};
+            EXPECT_EQ(setrlimit(RLIMIT_NOFILE, &none), 0);
+            issued = true;
+            return RED_SUCCESS;
+        });
+    EXPECT_CALL(*mock_async, pread_part(_, _, _, _, _, _, _, _, _, _)).Times(0);
+
+    /* The call completes, writing its outputs, only after waits have failed */
+    std::thread late([&]() {
+        while (!issued)
+            std::this_thread::yield();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_EQ(setrlimit(RLIMIT_NOFILE, &files), 0);
+        *part_size   = 4;
+        *part_offset = 0;
+        sized(RED_SUCCESS);
+    });
+
+    red_buffer_t buf        = {{reinterpret_cast<void *>(1)}, data, sizeof(data)};
+    ssize_t      bytes_read = 0;
+    EXPECT_EQ(client->get_object_parallel(bucket, "obj", buf, &bytes_read), RED_EINVAL);
+    late.join();
+}
+
+TEST_F(RangedGetTest, ByteRangesTruncated)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing a parallel GET by byte range of an object larger than the buffer");
+
+    const char      object[] = "abcdefghij";
+    rfs_open_hndl_t obj_oh   = {5};
+    char            data[8]  = {};
+
+    expect_ranged_open(mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, get_part_size_v2(obj_oh, 1, _, _, _, _, _))
+        .WillOnce(DoAll(InvokeArgument<6>(RED_ENOENT), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, pread_part(obj_oh, _, _, UINT32_MAX, _, 4, _, nullptr, _, _))
+        .Times(2)
+        .WillRepeatedly([&](rfs_open_hndl_t, red_iomem_hndl_t, void *addr, uint32_t,
+                            off_t offset, size_t count, ssize_t *byte_cnt,
+                            red_part_xattr_info_t *, red_api_user_t *, red_done_t done) {
+            memcpy(addr, object + offset, count);
+            *byte_cnt = static_cast<ssize_t>(count);
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+
+    /* The buffer is full: the byte after it shows the object goes on */
+    EXPECT_CALL(*mock_async, pread(obj_oh, _, 1, static_cast<off_t>(sizeof(data)), _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(1), InvokeArgument<6>(RED_SUCCESS),
+                        Return(RED_SUCCESS)));
+
+    ranged_get_config_t cfg;
+    cfg.range_size          = 4;
+    red_buffer_t buf        = {{reinterpret_cast<void *>(1)}, data, sizeof(data)};
+    ssize_t      bytes_read = 0;
+    EXPECT_EQ(client->get_object_parallel(bucket, "obj", buf, &bytes_read, cfg), RED_ETRUNC);
+}
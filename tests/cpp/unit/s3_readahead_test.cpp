@@ -0,0 +1,143 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_readahead_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the read-ahead of s3reader
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "s3_client_fixture.hpp"
+
+using ::testing::_;
+
+class ReadaheadTest : public RfsAsyncTest
+{
+};
+
+TEST_F(ReadaheadTest, GrowsOnSequentialReads)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing read-ahead of 4-byte sequential reads");
+
+    std::string object;
+    for (int i = 0; i < 64; i++)
+        object += static_cast<char>('A' + i % 26);
+    rfs_open_hndl_t                       obj_oh = {5};
+    std::vector<std::pair<off_t, size_t>> preads;
+
+    expect_ranged_open(mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, pread(obj_oh, _, _, _, _, _, _))
+        .WillRepeatedly([&](rfs_open_hndl_t, void *buf, size_t count, off_t offset,
+                            ssize_t *bytes_read, red_api_user_t *, red_done_t done) {
+            size_t n = std::min<size_t>(count, object.size() - std::min<size_t>(offset, 64));
+            memcpy(buf, object.data() + std::min<off_t>(offset, 64), n);
+            *bytes_read = static_cast<ssize_t>(n);
+            preads.emplace_back(offset, count);
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+
+    readahead_config_t cfg;
+    cfg.initial_window = 8;
+    cfg.max_window     = 32;
+    std::unique_ptr<s3reader> reader;
+    ASSERT_EQ(client->open_reader(bucket, "obj", &reader, cfg), RED_SUCCESS);
+
+    std::string received;
+    for (off_t offset = 0; offset <= 64; offset += 4)
+    {
+        char    buf[4];
+        ssize_t bytes = -1;
+        ASSERT_EQ(reader->read(buf, sizeof(buf), offset, &bytes), RED_SUCCESS);
+        EXPECT_EQ(bytes, offset < 64 ? 4 : 0);
+        received.append(buf, std::max<ssize_t>(bytes, 0));
+    }
+    EXPECT_EQ(received, object);
+
+    /* The window doubles each time a read reaches the newest one, up to the maximum */
+    EXPECT_EQ(preads, (std::vector<std::pair<off_t, size_t>>{{0, 8}, {8, 16}, {24, 32}, {56, 32}}));
+
+    const readahead_stats_t &stats = reader->stats();
+    EXPECT_EQ(stats.reads, 17u);
+    EXPECT_EQ(stats.hits, 16u); /* All but the first; the end is found in the last window */
+    EXPECT_EQ(stats.random, 0u);
+    EXPECT_EQ(stats.prefetched, 64u);
+    EXPECT_EQ(stats.wasted, 0u);
+    EXPECT_EQ(stats.window, 32u);
+}
+
+TEST_F(ReadaheadTest, DropsWindowOnRandomRead)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing that a random read drops the read-ahead window");
+
+    const std::string                     object(64, 'r');
+    rfs_open_hndl_t                       obj_oh = {5};
+    std::vector<std::pair<off_t, size_t>> preads;
+    red_done_t                            held;
+
+    /* The second read-ahead stays in flight until the random read arrives */
+    expect_ranged_open(mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, pread(obj_oh, _, _, _, _, _, _))
+        .WillRepeatedly([&](rfs_open_hndl_t, void *buf, size_t count, off_t offset,
+                            ssize_t *bytes_read, red_api_user_t *, red_done_t done) {
+            size_t n = std::min<size_t>(count, object.size() - offset);
+            memcpy(buf, object.data() + offset, n);
+            *bytes_read = static_cast<ssize_t>(n);
+            preads.emplace_back(offset, count);
+            if (offset == 8)
+            {
+                held = done;
+                return RED_SUCCESS;
+            }
+            if (held)
+                std::exchange(held, nullptr)(RED_SUCCESS);
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+
+    readahead_config_t cfg;
+    cfg.initial_window = 8;
+    cfg.max_window     = 32;
+    std::unique_ptr<s3reader> reader;
+    ASSERT_EQ(client->open_reader(bucket, "obj", &reader, cfg), RED_SUCCESS);
+
+    char    buf[4];
+    ssize_t bytes = 0;
+    ASSERT_EQ(reader->read(buf, 4, 0, &bytes), RED_SUCCESS);
+    ASSERT_EQ(reader->read(buf, 4, 40, &bytes), RED_SUCCESS);
+    ASSERT_EQ(reader->read(buf, 4, 44, &bytes), RED_SUCCESS);
+    EXPECT_EQ(bytes, 4);
+
+    /* The random read goes to the object, and the next one starts a window afresh */
+    EXPECT_EQ(preads, (std::vector<std::pair<off_t, size_t>>{
+                          {0, 8}, {8, 16}, {40, 4}, {44, 8}, {52, 16}}));
+
+    const readahead_stats_t &stats = reader->stats();
+    EXPECT_EQ(stats.reads, 3u);
+    EXPECT_EQ(stats.hits, 0u);
+    EXPECT_EQ(stats.random, 1u);
+    EXPECT_EQ(stats.wasted, 20u); /* The unread half of the first window and all of the second */
+    EXPECT_EQ(stats.prefetched, 8u + 16 + 8 + 12);
+    EXPECT_DOUBLE_EQ(stats.hit_rate(), 0.0);
+}
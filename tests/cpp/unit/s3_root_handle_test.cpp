@@ -0,0 +1,113 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_root_handle_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the bucket root handle kept by s3bucket
+ *
+ ******************************************************************************/
+#include <string>
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "s3_client_fixture.hpp"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+
+class RootHandleTest : public RfsBasicTest
+{
+};
+
+TEST_F(RootHandleTest, OpenedOncePerBucket)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing the reuse of the bucket root handle");
+
+    rfs_dataset_hndl_t ds_hndl = {reinterpret_cast<void *>(1)};
+    rfs_open_hndl_t    root_oh = {2};
+    rfs_open_hndl_t    obj_oh  = {3};
+    const int          puts    = 10;
+    char               data[]  = "small object";
+    ssize_t            written = sizeof(data);
+    ssize_t            bytes_read;
+
+    EXPECT_CALL(*mock_client, obtain_dataset(_, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<3>(ds_hndl), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, open_root(ds_hndl, _, _))
+        .WillOnce(DoAll(SetArgPointee<1>(root_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, openat(root_oh, _, _, _, _, _))
+        .Times(puts + 1)
+        .WillRepeatedly(DoAll(SetArgPointee<4>(obj_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, pwrite(obj_oh, _, sizeof(data), 0, _, _))
+        .Times(puts)
+        .WillRepeatedly(DoAll(SetArgPointee<4>(written), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, pread(obj_oh, _, sizeof(data), 0, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(written), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, close(obj_oh, _)).Times(puts + 1).WillRepeatedly(Return(RED_SUCCESS));
+    {
+        /* The root goes when the bucket does, before its dataset */
+        testing::InSequence seq;
+        EXPECT_CALL(*mock_client, close(root_oh, _)).WillOnce(Return(RED_SUCCESS));
+        EXPECT_CALL(*mock_client, close_dataset(ds_hndl, _)).WillOnce(Return(RED_SUCCESS));
+    }
+
+    auto bucket = client->create_bucket("infinia", "test_bucket");
+    for (int i = 0; i < puts; i++)
+    {
+        std::string key = "obj" + std::to_string(i);
+        ASSERT_EQ(client->put_object(bucket, key, data, sizeof(data)), RED_SUCCESS);
+    }
+    EXPECT_EQ(client->get_object(bucket, "obj0", data, sizeof(data), &bytes_read), RED_SUCCESS);
+}
+
+TEST_F(RootHandleTest, StaleHandleIsReopened)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing the revalidation of a stale root handle");
+
+    rfs_dataset_hndl_t ds_hndl  = {reinterpret_cast<void *>(1)};
+    rfs_open_hndl_t    old_root = {2};
+    rfs_open_hndl_t    new_root = {4};
+    rfs_open_hndl_t    obj_oh   = {3};
+    char               data[]   = "small object";
+    ssize_t            written  = sizeof(data);
+
+    EXPECT_CALL(*mock_client, obtain_dataset(_, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<3>(ds_hndl), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, open_root(ds_hndl, _, _))
+        .WillOnce(DoAll(SetArgPointee<1>(old_root), Return(RED_SUCCESS)))
+        .WillOnce(DoAll(SetArgPointee<1>(new_root), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, openat(old_root, _, _, _, _, _)).WillOnce(Return(RED_ESTALE));
+    EXPECT_CALL(*mock_client, openat(new_root, _, _, _, _, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<4>(obj_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, pwrite(obj_oh, _, _, 0, _, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<4>(written), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, close(old_root, _)).WillOnce(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_client, close(obj_oh, _)).Times(2).WillRepeatedly(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_client, close(new_root, _)).WillOnce(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_client, close_dataset(ds_hndl, _)).WillOnce(Return(RED_SUCCESS));
+
+    /* The first put retries on a fresh root, the second reuses that one */
+    auto bucket = client->create_bucket("infinia", "test_bucket");
+    EXPECT_EQ(client->put_object(bucket, "obj", data, sizeof(data)), RED_SUCCESS);
+    EXPECT_EQ(client->put_object(bucket, "obj", data, sizeof(data)), RED_SUCCESS);
+}
@@ -0,0 +1,240 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_stream_get_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the streaming GET of s3client
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../examples/cpp/common/include/md5.hpp"
+#include "s3_client_fixture.hpp"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::InvokeArgument;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using ::testing::StrEq;
+
+class StreamGetTest : public RfsAsyncTest
+{
+};
+
+/* Reads of @p object through pread(), completed at once */
+static void expect_window_reads(MockAsyncRedClient *mock_async,
+                                rfs_open_hndl_t     oh,
+                                const std::string  &object)
+{
+    EXPECT_CALL(*mock_async, pread(oh, _, _, _, _, _, _))
+        .WillRepeatedly([&object](rfs_open_hndl_t, void *buf, size_t count, off_t offset,
+                                  ssize_t *bytes_read, red_api_user_t *, red_done_t done) {
+            size_t off = std::min<size_t>(offset, object.size());
+            size_t n   = std::min(count, object.size() - off);
+            memcpy(buf, object.data() + off, n);
+            *bytes_read = static_cast<ssize_t>(n);
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+}
+
+TEST_F(StreamGetTest, DeliversInOrder)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing a streaming GET through two windows completed out of order");
+
+    const std::string object = "0123456789";
+    rfs_open_hndl_t   obj_oh = {5};
+    int               preads = 0;
+
+    expect_ranged_open(mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, fgetxattr(obj_oh, StrEq(RED_S3_ETAG_KEY), _, _, _, _, _))
+        .WillOnce([](rfs_open_hndl_t, const char *, void *value, size_t size, size_t *ret_size,
+                     red_api_user_t *, red_done_t done) {
+            const char etag[] = "781e5e245d69b566979b86e28d23f2c7";
+            EXPECT_GE(size, sizeof(etag) - 1);
+            memcpy(value, etag, sizeof(etag) - 1);
+            *ret_size = sizeof(etag) - 1;
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+
+    /* Reads complete in pairs, the later one first; the last pair reads past the end */
+    std::vector<red_done_t> reads;
+    EXPECT_CALL(*mock_async, pread(obj_oh, _, 4, _, _, _, _))
+        .Times(4)
+        .WillRepeatedly([&](rfs_open_hndl_t, void *buf, size_t count, off_t offset,
+                            ssize_t *bytes_read, red_api_user_t *, red_done_t done) {
+            size_t n = offset < 10 ? std::min<size_t>(count, 10 - offset) : 0;
+            memcpy(buf, object.data() + std::min<off_t>(offset, 10), n);
+            *bytes_read = static_cast<ssize_t>(n);
+            preads++;
+            reads.push_back(done);
+            if (reads.size() == 2)
+            {
+                reads[1](RED_SUCCESS);
+                reads[0](RED_SUCCESS);
+                reads.clear();
+            }
+            return RED_SUCCESS;
+        });
+
+    std::string           received;
+    std::vector<uint64_t> offsets;
+    int                   preads_at_first = 0;
+    auto sink = [&](uint64_t offset, const void *data, size_t size) {
+        if (offsets.empty())
+            preads_at_first = preads;
+        offsets.push_back(offset);
+        received.append(static_cast<const char *>(data), size);
+        return RED_SUCCESS;
+    };
+
+    stream_get_config_t cfg;
+    cfg.window_size = 4;
+    cfg.windows     = 2;
+    stream_get_result_t result;
+    EXPECT_EQ(client->get_object_to_sink(bucket, "obj", sink, cfg, &result), RED_SUCCESS);
+
+    EXPECT_EQ(received, object);
+    EXPECT_EQ(offsets, (std::vector<uint64_t>{0, 4, 8}));
+    EXPECT_EQ(preads_at_first, 2);
+    EXPECT_EQ(result.bytes, object.size());
+    EXPECT_EQ(result.memory, 8u);
+    EXPECT_TRUE(result.verified);
+    EXPECT_STREQ(result.etag, "781e5e245d69b566979b86e28d23f2c7");
+}
+
+TEST_F(StreamGetTest, VerifiesMultipartEtag)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing a streaming GET of a multipart object into a file");
+
+    const std::string object = "abcdefghij";
+    rfs_open_hndl_t   obj_oh = {5};
+    char              path[] = "/tmp/stream_get_XXXXXX";
+
+    /* Parts of 6 and 4 bytes, across the 4-byte windows */
+    common::md5_t md5;
+    uint8_t       digest[2 * common::md5_t::DIGEST_SIZE];
+    md5.update("abcdef", 6);
+    md5.final(digest);
+    md5.reset();
+    md5.update("ghij", 4);
+    md5.final(digest + common::md5_t::DIGEST_SIZE);
+    md5.reset();
+    md5.update(digest, sizeof(digest));
+    char etag[RED_S3_USER_MPART_ETAG_SIZE];
+    md5.final_hex(etag);
+    strcat(etag, "-2");
+
+    expect_ranged_open(mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, fgetxattr(obj_oh, StrEq(RED_S3_ETAG_KEY), _, _, _, _, _))
+        .WillOnce([&](rfs_open_hndl_t, const char *, void *value, size_t, size_t *ret_size,
+                      red_api_user_t *, red_done_t done) {
+            *ret_size = strlen(etag);
+            memcpy(value, etag, *ret_size);
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    EXPECT_CALL(*mock_async, get_part_size_v2(obj_oh, _, _, _, _, _, _))
+        .Times(2)
+        .WillRepeatedly([](rfs_open_hndl_t, uint32_t part_num, size_t *part_size,
+                           uint64_t *part_offset, char *, red_api_user_t *, red_done_t done) {
+            *part_offset = part_num == 1 ? 0 : 6;
+            *part_size   = part_num == 1 ? 6 : 4;
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    expect_window_reads(mock_async, obj_oh, object);
+
+    /* Written after what the file already holds, leaving its offset at the end */
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    unlink(path);
+    ASSERT_EQ(write(fd, "xx", 2), 2);
+
+    stream_get_config_t cfg;
+    cfg.window_size = 4;
+    cfg.windows     = 3;
+    stream_get_result_t result;
+    EXPECT_EQ(client->get_object_to_fd(bucket, "obj", fd, cfg, &result), RED_SUCCESS);
+    EXPECT_EQ(lseek(fd, 0, SEEK_CUR), 12);
+
+    char contents[16] = {};
+    EXPECT_EQ(pread(fd, contents, sizeof(contents), 0), 12);
+    EXPECT_STREQ(contents, "xxabcdefghij");
+    close(fd);
+
+    EXPECT_TRUE(result.verified);
+    EXPECT_STREQ(result.etag, etag);
+    EXPECT_EQ(result.bytes, object.size());
+}
+
+TEST_F(StreamGetTest, Errors)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing the errors of a streaming GET");
+
+    const std::string object = "0123456789";
+    rfs_open_hndl_t   obj_oh = {5};
+
+    EXPECT_CALL(*mock_async, s3_open(root_oh, StrEq("obj"), 0, O_RDONLY, _, _, _, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(SetArgPointee<4>(obj_oh), InvokeArgument<7>(RED_SUCCESS),
+                              Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, close(obj_oh, _, _))
+        .Times(2)
+        .WillRepeatedly(DoAll(InvokeArgument<2>(RED_SUCCESS), Return(RED_SUCCESS)));
+    expect_window_reads(mock_async, obj_oh, object);
+
+    /* Data that does not hash to the ETag is all delivered, then refused */
+    EXPECT_CALL(*mock_async, fgetxattr(obj_oh, StrEq(RED_S3_ETAG_KEY), _, _, _, _, _))
+        .WillOnce([](rfs_open_hndl_t, const char *, void *value, size_t, size_t *ret_size,
+                     red_api_user_t *, red_done_t done) {
+            memset(value, '0', 32);
+            *ret_size = 32;
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    size_t delivered = 0;
+    auto   count     = [&](uint64_t, const void *, size_t size) {
+        delivered += size;
+        return RED_SUCCESS;
+    };
+    stream_get_config_t cfg;
+    cfg.window_size = 4;
+    EXPECT_EQ(client->get_object_to_sink(bucket, "obj", count, cfg), RED_ECKSUM);
+    EXPECT_EQ(delivered, object.size());
+
+    /* A failing sink stops the stream at its first window */
+    int  calls = 0;
+    auto fail  = [&](uint64_t, const void *, size_t) {
+        calls++;
+        return RED_EIO;
+    };
+    cfg.verify = false;
+    EXPECT_EQ(client->get_object_to_sink(bucket, "obj", fail, cfg), RED_EIO);
+    EXPECT_EQ(calls, 1);
+}
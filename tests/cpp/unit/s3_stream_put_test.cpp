@@ -0,0 +1,218 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_stream_put_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the streaming PUT of s3client
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "../../../examples/cpp/common/include/crc32c.hpp"
+#include "../../../examples/cpp/common/include/md5.hpp"
+#include "s3_client_fixture.hpp"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::InvokeArgument;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using ::testing::StrEq;
+
+class StreamPutTest : public RfsAsyncTest
+{
+};
+
+TEST_F(StreamPutTest, FileAsOneObject)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing a streaming PUT of a small file through two chunk buffers");
+
+    const char      data[]        = "0123456789";
+    const size_t    size          = sizeof(data) - 1;
+    rfs_open_hndl_t obj_oh        = {5};
+    int             max_in_flight = 0;
+    char            path[]        = "/tmp/stream_put_XXXXXX";
+
+    /* The hashes against their standard check values, whole and in pieces */
+    common::md5_t md5;
+    char          hex[33];
+    md5.update("The quick brown fox ", 20);
+    md5.update("jumps over the lazy dog", 23);
+    md5.final_hex(hex);
+    EXPECT_STREQ(hex, "9e107d9d372bb6826bd81d3542a419d6");
+    ASSERT_EQ(common::crc32(0, "123456789", 9), 0xcbf43926u);
+    ASSERT_EQ(common::crc32(common::crc32(0, "1234", 4), "56789", 5), 0xcbf43926u);
+
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    unlink(path);
+    ASSERT_EQ(write(fd, data, size), static_cast<ssize_t>(size));
+    lseek(fd, 0, SEEK_SET);
+
+    EXPECT_CALL(*mock_client, openat(root_oh, StrEq("obj"), O_CREAT | O_WRONLY, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(obj_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, close(obj_oh, _)).WillOnce(Return(RED_SUCCESS));
+
+    /* Writes complete two at a time, and the last one on its own */
+    std::vector<red_done_t> writes;
+    EXPECT_CALL(*mock_async, pwrite(obj_oh, _, _, _, _, _, _))
+        .Times(3)
+        .WillRepeatedly([&](rfs_open_hndl_t, void *buf, size_t count, off_t offset,
+                            ssize_t *written, red_api_user_t *, red_done_t done) {
+            EXPECT_EQ(memcmp(buf, data + offset, count), 0);
+            EXPECT_EQ(count, offset == 8 ? 2u : 4u);
+            *written = static_cast<ssize_t>(count);
+            writes.push_back(done);
+            max_in_flight = std::max(max_in_flight, static_cast<int>(writes.size()));
+            if (writes.size() == 2 || offset == 8)
+            {
+                for (red_done_t &w : writes)
+                    w(RED_SUCCESS);
+                writes.clear();
+            }
+            return RED_SUCCESS;
+        });
+
+    stream_put_config_t cfg;
+    cfg.chunk_size   = 4;
+    cfg.buffers      = 3;
+    cfg.memory_limit = 8; /* Two chunks, not the three asked for */
+    cfg.checksum     = RED_S3CS_CRC32;
+    stream_put_result_t result;
+    EXPECT_EQ(client->put_object_from_fd(bucket, "obj", fd, cfg, &result), RED_SUCCESS);
+    close(fd);
+
+    EXPECT_EQ(max_in_flight, 2);
+    EXPECT_EQ(result.bytes, size);
+    EXPECT_EQ(result.parts, 0u);
+    EXPECT_EQ(result.memory, 8u);
+    EXPECT_STREQ(result.etag, "781e5e245d69b566979b86e28d23f2c7");
+    EXPECT_EQ(result.checksum.type, RED_S3CS_CRC32);
+    EXPECT_EQ(result.checksum.checksum.crc32, common::crc32(0, data, size));
+}
+
+TEST_F(StreamPutTest, PipeGoesMultipart)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing a streaming PUT of a stream that outgrows its chunk buffers");
+
+    const char      data[]     = "0123456789";
+    const size_t    size       = sizeof(data) - 1;
+    rfs_open_hndl_t created_oh = {3};
+    int             fds[2];
+
+    ASSERT_EQ(pipe(fds), 0);
+    ASSERT_EQ(write(fds[1], data, size), static_cast<ssize_t>(size));
+    close(fds[1]);
+
+    expect_mpart_upload(mock_async, root_oh, created_oh);
+    EXPECT_CALL(*mock_async, upload_part(root_oh, StrEq("obj"), StrEq("upload-1"), _, _, _, _, _))
+        .Times(3)
+        .WillRepeatedly([&](rfs_open_hndl_t, const char *, const char *, uint32_t part_num, int,
+                            rfs_open_hndl_t *part_oh, red_api_user_t *, red_done_t done) {
+            *part_oh = {10 + part_num};
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    EXPECT_CALL(*mock_async, pwrite(_, _, _, 0, _, _, _))
+        .Times(3)
+        .WillRepeatedly([&](rfs_open_hndl_t oh, void *buf, size_t count, off_t, ssize_t *written,
+                            red_api_user_t *, red_done_t done) {
+            EXPECT_EQ(memcmp(buf, data + (oh.fd - 11) * 4, count), 0);
+            *written = static_cast<ssize_t>(count);
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    EXPECT_CALL(*mock_async, close_part(_, _, _, _))
+        .Times(3)
+        .WillRepeatedly([&](rfs_open_hndl_t oh, red_data_integrity_t *integrity,
+                            red_api_user_t *, red_done_t done) {
+            size_t off = (oh.fd - 11) * 4;
+            EXPECT_EQ(integrity->checksum.type, RED_S3CS_CRC32C);
+            EXPECT_EQ(integrity->checksum.checksum.crc32,
+                      common::crc32c(0, data + off, std::min<size_t>(4, size - off)));
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    EXPECT_CALL(*mock_async,
+                comp_mpart_upload(root_oh, StrEq("obj"), StrEq("upload-1"), 3, 3, _, true, _, _, _,
+                                  _))
+        .WillOnce(DoAll(InvokeArgument<10>(RED_SUCCESS), Return(RED_SUCCESS)));
+
+    /* Two chunks fill up before the end of the stream, far below the threshold */
+    stream_put_config_t cfg;
+    cfg.chunk_size = 4;
+    cfg.buffers    = 2;
+    stream_put_result_t result;
+    EXPECT_EQ(client->put_object_from_fd(bucket, "obj", fds[0], cfg, &result), RED_SUCCESS);
+    close(fds[0]);
+
+    /* The ETag and checksum of a multipart upload are those of its parts' */
+    common::md5_t parts_md5;
+    uint32_t      parts_crc = 0;
+    for (size_t off = 0; off < size; off += 4)
+    {
+        common::md5_t part_md5;
+        uint8_t       digest[common::md5_t::DIGEST_SIZE];
+        size_t        n = std::min<size_t>(4, size - off);
+        part_md5.update(data + off, n);
+        part_md5.final(digest);
+        parts_md5.update(digest, sizeof(digest));
+        uint32_t be = __builtin_bswap32(common::crc32c(0, data + off, n));
+        parts_crc   = common::crc32c(parts_crc, &be, sizeof(be));
+    }
+    char etag[33];
+    parts_md5.final_hex(etag);
+
+    EXPECT_EQ(result.bytes, size);
+    EXPECT_EQ(result.parts, 3u);
+    EXPECT_EQ(std::string(result.etag), std::string(etag) + "-3");
+    EXPECT_EQ(result.checksum.checksum.crc32, parts_crc);
+}
+
+TEST_F(StreamPutTest, Errors)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing the errors of a streaming PUT");
+
+    int             fds[2];
+    rfs_open_hndl_t oh;
+    ASSERT_EQ(pipe(fds), 0);
+
+    /* Neither call gets as far as the bucket's root, which the fixture expects opened */
+    ASSERT_EQ(bucket.lock()->root(&oh), RED_SUCCESS);
+
+    /* SHA-256 is not computed incrementally */
+    stream_put_config_t cfg;
+    cfg.checksum = RED_S3CS_SHA256;
+    EXPECT_EQ(client->put_object_from_fd(bucket, "obj", fds[0], cfg), RED_ENOTSUP);
+
+    /* A descriptor that cannot be read fails before the object is created */
+    EXPECT_CALL(*mock_client, openat(_, _, _, _, _, _)).Times(0);
+    EXPECT_CALL(*mock_async, create_mpart_upload(_, _, _, _, _, _, _, _)).Times(0);
+    EXPECT_EQ(client->put_object_from_fd(bucket, "obj", fds[1], {}), RED_EIO);
+
+    close(fds[0]);
+    close(fds[1]);
+}
@@ -0,0 +1,278 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_write_behind_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the write-behind of s3writer
+ *
+ ******************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fcntl.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "s3_client_fixture.hpp"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::InvokeArgument;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using ::testing::StrEq;
+
+class WriteBehindTest : public RfsAsyncTest
+{
+};
+
+/* Open of the object written behind, and its close */
+static void expect_writer_open(MockRedClient      *mock_client,
+                               MockAsyncRedClient *mock_async,
+                               rfs_open_hndl_t     root_oh,
+                               rfs_open_hndl_t     oh)
+{
+    EXPECT_CALL(*mock_client, openat(root_oh, StrEq("obj"), O_CREAT | O_WRONLY, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_async, close(oh, _, _))
+        .WillOnce(DoAll(InvokeArgument<2>(RED_SUCCESS), Return(RED_SUCCESS)));
+}
+
+TEST_F(WriteBehindTest, CoalescesAppends)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing that contiguous small writes go out in one gathered write");
+
+    const size_t                          page   = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    rfs_open_hndl_t                       obj_oh = {5};
+    std::string                           object;
+    std::vector<std::pair<off_t, size_t>> writes;
+    std::vector<int>                      iovcnts;
+
+    expect_writer_open(mock_client, mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, pwritev2(obj_oh, _, _, _, 0, _, _, _))
+        .WillRepeatedly([&](rfs_open_hndl_t, struct red_iovec *iov, int iovcnt, off_t offset,
+                            int, ssize_t *written, red_api_user_t *, red_done_t done) {
+            size_t pos = static_cast<size_t>(offset);
+            for (int i = 0; i < iovcnt; i++)
+            {
+                EXPECT_EQ(iov[i].iov_offset, 0u);
+                EXPECT_EQ(reinterpret_cast<uintptr_t>(iov[i].iov_base) % page, 0u);
+                if (object.size() < pos + iov[i].iov_len)
+                    object.resize(pos + iov[i].iov_len, '-');
+                object.replace(pos, iov[i].iov_len, static_cast<char *>(iov[i].iov_base),
+                               iov[i].iov_len);
+                pos += iov[i].iov_len;
+            }
+            writes.emplace_back(offset, pos - offset);
+            iovcnts.push_back(iovcnt);
+            *written = static_cast<ssize_t>(pos - offset);
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+
+    write_behind_config_t cfg;
+    cfg.buffer_size = 1; /* One page */
+    cfg.flush_size  = 3 * page;
+    cfg.flush_ns    = 0;
+    std::unique_ptr<s3writer> writer;
+    ASSERT_EQ(client->open_writer(bucket, "obj", &writer, cfg), RED_SUCCESS);
+
+    /* 1 KiB appends: three pages gather before the first flush */
+    std::string expected;
+    for (int i = 0; i < 14; i++)
+    {
+        std::string chunk(1024, static_cast<char>('a' + i));
+        ASSERT_EQ(writer->write(chunk.data(), chunk.size(), expected.size()), RED_SUCCESS);
+        expected += chunk;
+    }
+    EXPECT_EQ(writes.size(), 1u);
+
+    /* A write elsewhere flushes the run before it */
+    std::string tail(10, 'z');
+    ASSERT_EQ(writer->write(tail.data(), tail.size(), 64 << 10), RED_SUCCESS);
+    ASSERT_EQ(writer->close(), RED_SUCCESS);
+    EXPECT_EQ(writer->write(tail.data(), tail.size(), 0), RED_EBADF);
+
+    expected.resize(64 << 10, '-');
+    expected += tail;
+    EXPECT_EQ(object, expected);
+
+    EXPECT_EQ(writes, (std::vector<std::pair<off_t, size_t>>{
+                          {0, 3 * page}, {3 * page, 14 * 1024 - 3 * page}, {64 << 10, 10}}));
+    EXPECT_EQ(iovcnts[0], 3);
+
+    const write_behind_stats_t &stats = writer->stats();
+    EXPECT_EQ(stats.writes, 15u);
+    EXPECT_EQ(stats.bytes, 14u * 1024 + 10);
+    EXPECT_EQ(stats.flushes, 3u);
+    EXPECT_EQ(stats.by_size, 1u);
+    EXPECT_EQ(stats.by_age, 0u);
+    EXPECT_EQ(stats.stalls, 0u);
+}
+
+TEST_F(WriteBehindTest, BoundsFlushesInFlight)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing that flushes wait for a slot and for overlapping ones");
+
+    rfs_open_hndl_t          obj_oh = {5};
+    std::atomic<int>         in_flight{0};
+    std::atomic<int>         max_in_flight{0};
+    std::vector<std::thread> completers;
+    std::vector<off_t>       offsets;
+
+    /* Every write completes on another thread a little later */
+    expect_writer_open(mock_client, mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, pwritev2(obj_oh, _, 1, _, 0, _, _, _))
+        .WillRepeatedly([&](rfs_open_hndl_t, struct red_iovec *iov, int, off_t offset, int,
+                            ssize_t *written, red_api_user_t *, red_done_t done) {
+            int n = ++in_flight;
+            max_in_flight = std::max(max_in_flight.load(), n);
+            offsets.push_back(offset);
+            *written = static_cast<ssize_t>(iov[0].iov_len);
+            completers.emplace_back([&in_flight, done]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                in_flight--;
+                done(RED_SUCCESS);
+            });
+            return RED_SUCCESS;
+        });
+
+    write_behind_config_t cfg;
+    cfg.buffer_size   = 4096;
+    cfg.flush_size    = 4096;
+    cfg.max_in_flight = 2;
+    cfg.flush_ns      = 0;
+    std::unique_ptr<s3writer> writer;
+    ASSERT_EQ(client->open_writer(bucket, "obj", &writer, cfg), RED_SUCCESS);
+
+    std::vector<char> page(4096, 'w');
+    for (int i = 0; i < 6; i++)
+        ASSERT_EQ(writer->write(page.data(), page.size(), i * 4096), RED_SUCCESS);
+
+    /* A rewrite of the last page waits for the flush of it in flight */
+    ASSERT_EQ(writer->write(page.data(), 100, 5 * 4096), RED_SUCCESS);
+    ASSERT_EQ(writer->flush(), RED_SUCCESS);
+    EXPECT_EQ(in_flight.load(), 0);
+
+    ASSERT_EQ(writer->close(), RED_SUCCESS);
+    for (std::thread &t : completers)
+        t.join();
+
+    EXPECT_EQ(offsets, (std::vector<off_t>{0, 4096, 8192, 12288, 16384, 20480, 20480}));
+    EXPECT_EQ(max_in_flight.load(), 2);
+    EXPECT_GE(writer->stats().stalls, 1u);
+    EXPECT_EQ(writer->stats().by_size, 6u);
+}
+
+TEST_F(WriteBehindTest, ReportsFailedFlush)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing that a failed flush is returned by the next call and by close");
+
+    rfs_open_hndl_t obj_oh = {5};
+
+    /* The flush fails, and nothing more is written */
+    expect_writer_open(mock_client, mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, pwritev2(obj_oh, _, _, _, 0, _, _, _))
+        .WillOnce([](rfs_open_hndl_t, struct red_iovec *, int, off_t, int, ssize_t *,
+                     red_api_user_t *, red_done_t done) {
+            done(RED_EIO);
+            return RED_SUCCESS;
+        });
+
+    write_behind_config_t cfg;
+    cfg.flush_size = 8;
+    cfg.flush_ns   = 0;
+    std::unique_ptr<s3writer> writer;
+    ASSERT_EQ(client->open_writer(bucket, "obj", &writer, cfg), RED_SUCCESS);
+
+    /* The write that starts the failing flush learns nothing of it yet */
+    EXPECT_EQ(writer->write("01234567", 8, 0), RED_SUCCESS);
+    EXPECT_EQ(writer->write("89", 2, 8), RED_EIO);
+    EXPECT_EQ(writer->flush(), RED_EIO);
+    EXPECT_EQ(writer->close(), RED_EIO);
+    EXPECT_EQ(writer->stats().flushes, 1u);
+
+    /* A short write fails the same way, and the destructor closes the object */
+    rfs_open_hndl_t other_oh = {6};
+    expect_writer_open(mock_client, mock_async, root_oh, other_oh);
+    EXPECT_CALL(*mock_async, pwritev2(other_oh, _, _, _, 0, _, _, _))
+        .WillOnce([](rfs_open_hndl_t, struct red_iovec *iov, int, off_t, int, ssize_t *written,
+                     red_api_user_t *, red_done_t done) {
+            *written = static_cast<ssize_t>(iov[0].iov_len) - 1;
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+    ASSERT_EQ(client->open_writer(bucket, "obj", &writer, cfg), RED_SUCCESS);
+    EXPECT_EQ(writer->write("0123", 4, 0), RED_SUCCESS);
+    EXPECT_EQ(writer->flush(), RED_EIO);
+    writer.reset();
+
+    /* A flush that cannot start fails the write away from the end, before it gathers */
+    rfs_open_hndl_t third_oh = {7};
+    expect_writer_open(mock_client, mock_async, root_oh, third_oh);
+    EXPECT_CALL(*mock_async, pwritev2(third_oh, _, _, _, 0, _, _, _))
+        .WillOnce(Return(RED_ENOMEM));
+    ASSERT_EQ(client->open_writer(bucket, "obj", &writer, cfg), RED_SUCCESS);
+    EXPECT_EQ(writer->write("0123", 4, 0), RED_SUCCESS);
+    EXPECT_EQ(writer->write("89", 2, 8), RED_ENOMEM);
+    EXPECT_EQ(writer->stats().writes, 1u);
+    EXPECT_EQ(writer->stats().bytes, 4u);
+    EXPECT_EQ(writer->close(), RED_ENOMEM);
+}
+
+TEST_F(WriteBehindTest, FlushesIdleWriter)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing that poll() flushes the data of a writer gone idle");
+
+    rfs_open_hndl_t obj_oh  = {5};
+    int             flushes = 0;
+
+    expect_writer_open(mock_client, mock_async, root_oh, obj_oh);
+    EXPECT_CALL(*mock_async, pwritev2(obj_oh, _, 1, 0, 0, _, _, _))
+        .WillOnce([&](rfs_open_hndl_t, struct red_iovec *iov, int, off_t, int, ssize_t *written,
+                      red_api_user_t *, red_done_t done) {
+            flushes++;
+            *written = static_cast<ssize_t>(iov[0].iov_len);
+            done(RED_SUCCESS);
+            return RED_SUCCESS;
+        });
+
+    write_behind_config_t cfg;
+    cfg.flush_ns = 1000000;
+    std::unique_ptr<s3writer> writer;
+    ASSERT_EQ(client->open_writer(bucket, "obj", &writer, cfg), RED_SUCCESS);
+    ASSERT_EQ(writer->write("0123", 4, 0), RED_SUCCESS);
+
+    /* Young data stays gathered; once it is old, poll() sends it with no write to come */
+    EXPECT_EQ(writer->poll(), RED_SUCCESS);
+    EXPECT_EQ(flushes, 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(writer->poll(), RED_SUCCESS);
+    EXPECT_EQ(flushes, 1);
+    EXPECT_EQ(writer->stats().by_age, 1u);
+
+    ASSERT_EQ(writer->close(), RED_SUCCESS);
+    EXPECT_EQ(flushes, 1);
+    EXPECT_EQ(writer->poll(), RED_EBADF);
+}
@@ -0,0 +1,88 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       s3_zero_copy_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the zero-copy transfers of s3client
+ *
+ ******************************************************************************/
+#include <unistd.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include "s3_client_fixture.hpp"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using ::testing::StrEq;
+
+class ZeroCopyTest : public RfsBasicTest
+{
+};
+
+TEST_F(ZeroCopyTest, LargeIomemBuffers)
+{
+    SetTestCategory(TestCategory::UNIT);
+    SCOPED_TRACE("Testing the routing of red_buffer_t transfers");
+
+    rfs_dataset_hndl_t ds_hndl = {reinterpret_cast<void *>(1)};
+    rfs_open_hndl_t    root_oh = {2};
+    rfs_open_hndl_t    obj_oh  = {3};
+    red_iomem_hndl_t   iomem   = {reinterpret_cast<void *>(4)};
+    static char        region[256 << 10];
+
+    red_buffer_t large     = {iomem, region, sizeof(region)};
+    red_buffer_t small     = {iomem, region, 4096};
+    red_buffer_t plain     = {{nullptr}, region, sizeof(region)};
+    ssize_t      large_len = sizeof(region);
+    ssize_t      small_len = 4096;
+
+    EXPECT_CALL(*mock_client, obtain_dataset(_, _, _, _, _))
+        .WillOnce(DoAll(SetArgPointee<3>(ds_hndl), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, open_root(ds_hndl, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<1>(root_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, openat(root_oh, StrEq("test_object"), _, _, _, _))
+        .WillRepeatedly(DoAll(SetArgPointee<4>(obj_oh), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, close(_, _)).WillRepeatedly(Return(RED_SUCCESS));
+    EXPECT_CALL(*mock_client, close_dataset(ds_hndl, _)).WillOnce(Return(RED_SUCCESS));
+
+    /* Large iomem buffers are not copied; small or plain ones take the copy path */
+    EXPECT_CALL(*mock_client, pwrite_iomem(obj_oh, iomem, region, sizeof(region), 0, _, _))
+        .WillOnce(DoAll(SetArgPointee<5>(large_len), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, pread_iomem(obj_oh, iomem, region, sizeof(region), 0, _, _))
+        .WillOnce(DoAll(SetArgPointee<5>(large_len), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, pwrite(obj_oh, region, 4096, 0, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(small_len), Return(RED_SUCCESS)));
+    EXPECT_CALL(*mock_client, pread(obj_oh, region, sizeof(region), 0, _, _))
+        .WillOnce(DoAll(SetArgPointee<4>(large_len), Return(RED_SUCCESS)));
+
+    auto    bucket = client->create_bucket("infinia", "test_bucket");
+    ssize_t bytes_read;
+
+    EXPECT_EQ(client->put_object(bucket, "test_object", large), RED_SUCCESS);
+    EXPECT_EQ(client->put_object(bucket, "test_object", small), RED_SUCCESS);
+    EXPECT_EQ(client->get_object(bucket, "test_object", large, &bytes_read), RED_SUCCESS);
+    EXPECT_EQ(bytes_read, large_len);
+    EXPECT_EQ(client->get_object(bucket, "test_object", plain, &bytes_read), RED_SUCCESS);
+
+    /* With no threshold even a small iomem buffer goes zero-copy */
+    client->set_zero_copy_threshold(0);
+    EXPECT_CALL(*mock_client, pwrite_iomem(obj_oh, iomem, region, 4096, 0, _, _))
+        .WillOnce(DoAll(SetArgPointee<5>(small_len), Return(RED_SUCCESS)));
+    EXPECT_EQ(client->put_object(bucket, "test_object", small), RED_SUCCESS);
+}
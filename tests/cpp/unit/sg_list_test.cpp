@@ -0,0 +1,195 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       sg_list_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the scatter/gather list builder
+ *
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <utility>
+#include <vector>
+
+#include "sg_list.hpp"
+#include "test_utils.hpp"
+
+namespace
+{
+
+/* A registered region as the KV calls see it; the handle is never dereferenced */
+red_buffer_t region(uintptr_t hndl, char *addr, size_t size)
+{
+    return {{reinterpret_cast<void *>(hndl)}, addr, size};
+}
+
+} // namespace
+
+class SgListTest : public TestBase
+{
+};
+
+TEST_F(SgListTest, SmallListsDoNotAllocate)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    static char              memory[common::SG_INLINE_ELEMS][128];
+    common::sg_arena_stats_t before = common::sg_arena_stats();
+
+    common::sg_list_t sg;
+    for (auto &buf : memory)
+        ASSERT_EQ(sg.append(buf, 100), RED_SUCCESS);
+
+    /* Every element fits in the object; the arena was never asked */
+    EXPECT_FALSE(sg.spilled());
+    common::sg_arena_stats_t after = common::sg_arena_stats();
+    EXPECT_EQ(after.spills, before.spills);
+    EXPECT_EQ(after.mallocs, before.mallocs);
+
+    /* The view is the builder's own storage */
+    red_sg_list_t *list = sg.list();
+    EXPECT_EQ(list->num_elems, common::SG_INLINE_ELEMS);
+    EXPECT_EQ(list->val_size, common::SG_INLINE_ELEMS * 100);
+    EXPECT_EQ(list->sg_elem, &sg[0]);
+    EXPECT_EQ(sg[3].addr, memory[3]);
+    EXPECT_EQ(sg[3].offset, 0);
+    EXPECT_EQ(sg[3].iomem.hndl, nullptr);
+
+    /* Moving copies the inline elements over */
+    common::sg_list_t moved = std::move(sg);
+    EXPECT_TRUE(sg.empty());
+    EXPECT_EQ(moved.size(), common::SG_INLINE_ELEMS);
+    EXPECT_EQ(moved.list()->sg_elem, &moved[0]);
+    EXPECT_EQ(moved[7].addr, memory[7]);
+
+    moved.clear();
+    EXPECT_EQ(moved.bytes(), 0u);
+    EXPECT_EQ(common::sg_arena_stats().spills, before.spills);
+}
+
+TEST_F(SgListTest, MergesAdjacentElements)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    static char       memory[4096];
+    common::sg_list_t sg;
+
+    /* Plain memory merges at the next address */
+    sg.append(memory, 100);
+    sg.append(memory + 100, 50);
+    EXPECT_EQ(sg.size(), 1u);
+    EXPECT_EQ(sg[0].size, 150u);
+
+    /* Ranges of one region merge at the next offset, those of another do not */
+    red_buffer_t a = region(1, memory + 1024, 1024);
+    red_buffer_t b = region(2, memory + 2048, 1024);
+    ASSERT_EQ(sg.append(a, 0, 256), RED_SUCCESS);
+    ASSERT_EQ(sg.append(a, 256, 256), RED_SUCCESS);
+    ASSERT_EQ(sg.append(b), RED_SUCCESS);
+    ASSERT_EQ(sg.append(a, 512, 512), RED_SUCCESS);
+    EXPECT_EQ(sg.size(), 4u);
+    EXPECT_EQ(sg[1].addr, memory + 1024);
+    EXPECT_EQ(sg[1].offset, 0);
+    EXPECT_EQ(sg[1].size, 512u);
+    EXPECT_EQ(sg[3].offset, 512);
+
+    /* An iomem range does not merge into plain memory at the same address */
+    sg.append(memory, 100);
+    EXPECT_EQ(sg.size(), 5u);
+
+    /* Ranges outside the buffer are refused, empty ones ignored */
+    EXPECT_EQ(sg.append(a, 1000, 100), RED_EINVAL);
+    EXPECT_EQ(sg.append(a, -1, 1), RED_EINVAL);
+    EXPECT_EQ(sg.append(a, 1024, 0), RED_SUCCESS);
+    EXPECT_EQ(sg.size(), 5u);
+    EXPECT_EQ(sg.bytes(), 150u + 512 + 1024 + 512 + 100);
+}
+
+TEST_F(SgListTest, SpillsToTheThreadArena)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    static char memory[64][64];
+
+    for (int round = 0; round < 2; round++)
+    {
+        common::sg_arena_stats_t before = common::sg_arena_stats();
+        common::sg_list_t        moved;
+        {
+            common::sg_list_t sg;
+            for (auto &buf : memory)
+                ASSERT_EQ(sg.append(buf, 32), RED_SUCCESS);
+            EXPECT_TRUE(sg.spilled());
+            EXPECT_EQ(sg.size(), 64u);
+
+            /* Moving hands the spilled array over */
+            const red_sg_elem_t *elems = &sg[0];
+            moved                      = std::move(sg);
+            EXPECT_EQ(&moved[0], elems);
+        }
+        EXPECT_EQ(moved[63].addr, memory[63]);
+        EXPECT_EQ(moved.bytes(), 64u * 32);
+
+        /* 16, 32 and 64 elements; the second round finds all three cached */
+        common::sg_arena_stats_t after = common::sg_arena_stats();
+        EXPECT_EQ(after.spills - before.spills, 3u);
+        if (round == 1)
+        {
+            EXPECT_EQ(after.mallocs, before.mallocs);
+        }
+    }
+}
+
+TEST_F(SgListTest, ReservedListsSpillOnce)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    /* Rows past the first, 64 bytes apart, so that none continues another */
+    static char               memory[64][64];
+    std::vector<red_buffer_t> bufs;
+    for (size_t i = 1; i < 64; i++)
+        bufs.push_back({{nullptr}, memory[i], 32});
+
+    /* Reserving goes straight to the 64-element array, and appending fills it */
+    common::sg_arena_stats_t before = common::sg_arena_stats();
+    {
+        common::sg_list_t sg;
+        ASSERT_EQ(sg.reserve(64), RED_SUCCESS);
+        ASSERT_EQ(sg.reserve(10), RED_SUCCESS);
+        for (const red_buffer_t &b : bufs)
+            ASSERT_EQ(sg.append(b), RED_SUCCESS);
+        EXPECT_EQ(sg.size(), 63u);
+    }
+    EXPECT_EQ(common::sg_arena_stats().spills - before.spills, 1u);
+
+    /* Appending them all at once makes room first, and merges as append() does */
+    before = common::sg_arena_stats();
+    {
+        common::sg_list_t sg;
+        ASSERT_EQ(sg.append(memory[0], 64), RED_SUCCESS);
+        ASSERT_EQ(sg.append(bufs.data(), bufs.size()), RED_SUCCESS);
+        EXPECT_EQ(sg.size(), 63u);
+        EXPECT_EQ(sg[0].size, 96u);
+        EXPECT_EQ(sg[62].addr, memory[63]);
+        EXPECT_EQ(sg.bytes(), 64u + 63 * 32);
+
+        red_buffer_t tail = {{nullptr}, memory[63] + 32, 32};
+        ASSERT_EQ(sg.append(&tail, 1), RED_SUCCESS);
+        EXPECT_EQ(sg.size(), 63u);
+        EXPECT_EQ(sg[62].size, 64u);
+    }
+    EXPECT_EQ(common::sg_arena_stats().spills - before.spills, 1u);
+}
@@ -0,0 +1,173 @@
+/******************************************************************************
+ *
+ * @file
+ * @copyright
+ *                               --- WARNING ---
+ *
+ *     This work contains trade secrets of DataDirect Networks, Inc.  Any
+ *     unauthorized use or disclosure of the work, or any part thereof, is
+ *     strictly prohibited. Any use of this work without an express license
+ *     or permission is in violation of applicable laws.
+ *
+ * @copyright DataDirect Networks, Inc. CONFIDENTIAL AND PROPRIETARY
+ * @copyright DataDirect Networks Copyright, Inc. (c) 2021-2025. All rights reserved.
+ *
+ * @section DESCRIPTION
+ *
+ *   Name:       task_executor_test.cpp
+ *   Project:    RED
+ *
+ *   Description: Unit tests for the task executor coremask parsing, its
+ *                MPSC work queue and its workers
+ *
+ ******************************************************************************/
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+#include "mpsc_queue.hpp"
+#include "task_executor.hpp"
+#include "test_utils.hpp"
+
+class TaskExecutorTest : public TestBase
+{
+};
+
+TEST_F(TaskExecutorTest, ParseCoremask)
+{
+    SetTestCategory(TestCategory::UNIT);
+    std::vector<unsigned> cpus;
+
+    ASSERT_EQ(common::parse_coremask("0xf0", &cpus), RED_SUCCESS);
+    EXPECT_EQ(cpus, (std::vector<unsigned>{4, 5, 6, 7}));
+
+    /* Without ',' or '-' a bare string is a hexadecimal mask */
+    ASSERT_EQ(common::parse_coremask("3", &cpus), RED_SUCCESS);
+    EXPECT_EQ(cpus, (std::vector<unsigned>{0, 1}));
+
+    ASSERT_EQ(common::parse_coremask("1-3,8,10-11", &cpus), RED_SUCCESS);
+    EXPECT_EQ(cpus, (std::vector<unsigned>{1, 2, 3, 8, 10, 11}));
+
+    ASSERT_EQ(common::parse_coremask("0x100000000", &cpus), RED_SUCCESS);
+    EXPECT_EQ(cpus, (std::vector<unsigned>{32}));
+
+    EXPECT_EQ(common::parse_coremask("", &cpus), RED_EINVAL);
+    EXPECT_EQ(common::parse_coremask("0x0", &cpus), RED_EINVAL);
+    EXPECT_EQ(common::parse_coremask("0xfg", &cpus), RED_EINVAL);
+    EXPECT_EQ(common::parse_coremask("3-1", &cpus), RED_EINVAL);
+    EXPECT_EQ(common::parse_coremask("1,,2", &cpus), RED_EINVAL);
+    EXPECT_TRUE(cpus.empty());
+}
+
+TEST_F(TaskExecutorTest, MpscQueueKeepsPerProducerOrder)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    constexpr unsigned PRODUCERS = 4;
+    constexpr unsigned ITEMS     = 20000;
+
+    struct item_t : common::mpsc_node_t
+    {
+        unsigned producer;
+        unsigned seq;
+    };
+
+    common::mpsc_queue_t     queue;
+    std::vector<item_t>      items(PRODUCERS * ITEMS);
+    std::vector<std::thread> producers;
+
+    for (unsigned p = 0; p < PRODUCERS; p++)
+    {
+        producers.emplace_back([&, p] {
+            for (unsigned i = 0; i < ITEMS; i++)
+            {
+                item_t &item  = items[p * ITEMS + i];
+                item.producer = p;
+                item.seq      = i;
+                queue.push(&item);
+            }
+        });
+    }
+
+    std::vector<unsigned> next(PRODUCERS, 0);
+    unsigned              received = 0;
+    while (received < PRODUCERS * ITEMS)
+    {
+        common::mpsc_node_t *node = queue.pop();
+        if (node == nullptr)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        auto *item = static_cast<item_t *>(node);
+        ASSERT_EQ(item->seq, next[item->producer]++);
+        received++;
+    }
+
+    for (auto &t : producers)
+        t.join();
+    EXPECT_EQ(queue.pop(), nullptr);
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(TaskExecutorTest, PostedWorkRunsOnItsWorker)
+{
+    SetTestCategory(TestCategory::UNIT);
+
+    constexpr unsigned WORKERS   = 2;
+    constexpr unsigned PRODUCERS = 4;
+    constexpr unsigned ITEMS     = 1000;
+
+    struct item_t : common::work_item_t
+    {
+        unsigned        worker;
+        int             ran_on;
+        std::thread::id thread;
+    };
+
+    common::task_executor_t  executor;
+    std::vector<item_t>      items(PRODUCERS * ITEMS);
+    std::vector<std::thread> producers;
+
+    ASSERT_EQ(executor.start(nullptr, WORKERS), RED_SUCCESS);
+    EXPECT_EQ(executor.num_workers(), WORKERS);
+    EXPECT_EQ(executor.start(nullptr, WORKERS), RED_EINVAL);
+
+    for (unsigned p = 0; p < PRODUCERS; p++)
+    {
+        producers.emplace_back([&, p] {
+            for (unsigned i = 0; i < ITEMS; i++)
+            {
+                item_t &item = items[p * ITEMS + i];
+                item.worker  = (p + i) % WORKERS;
+                item.ran_on  = -1;
+                item.fn      = [](common::work_item_t *w) {
+                    auto *it   = static_cast<item_t *>(w);
+                    it->ran_on = common::task_executor_t::current_worker();
+                    it->thread = std::this_thread::get_id();
+                };
+                executor.post(item.worker, &item);
+            }
+        });
+    }
+    for (auto &t : producers)
+        t.join();
+
+    /* stop() runs what is still queued before joining the workers */
+    executor.stop();
+    EXPECT_EQ(executor.num_workers(), 0u);
+    executor.stop();
+
+    /* Each worker is one thread of its own */
+    std::vector<std::thread::id> threads(WORKERS);
+    for (const item_t &item : items)
+    {
+        ASSERT_EQ(item.ran_on, static_cast<int>(item.worker));
+        ASSERT_NE(item.thread, std::this_thread::get_id());
+        if (threads[item.worker] == std::thread::id())
+            threads[item.worker] = item.thread;
+        ASSERT_EQ(item.thread, threads[item.worker]);
+    }
+    EXPECT_NE(threads[0], threads[1]);
+    EXPECT_EQ(common::task_executor_t::current_worker(), -1);
+}